@@ -3,17 +3,61 @@
 #elif defined(__GNUC__) || defined(__clang__)
 #define _SIMD_INL_ __attribute__((always_inline)) inline
 #endif
+#if defined(__GNUC__) || defined(__clang__)
+#define _SIMD_ASSUME_ALIGNED_(PTR, ALIGNMENT) __builtin_assume_aligned(PTR, ALIGNMENT)
+#else
+#define _SIMD_ASSUME_ALIGNED_(PTR, ALIGNMENT) (PTR)
+#endif
 #include <immintrin.h>
 #include <type_traits>
 #include <iostream>
 #include <stdint.h>
 #include <array>
 #include <memory>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <vector>
+#include <bitset>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <cstdio>
 #ifdef _WIN32
 #include <malloc.h>
+// windows.h is only needed for the file mapping calls of MappedFile. It is included lean, and the min / max macros it
+// defines without NOMINMAX are hidden while this header is parsed and restored at its end, so the includer's choice
+// of NOMINMAX is left alone.
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#define _SIMD_UNDEF_WIN32_LEAN_AND_MEAN_
+#endif
+#include <windows.h>
+#if defined(_SIMD_UNDEF_WIN32_LEAN_AND_MEAN_)
+#undef WIN32_LEAN_AND_MEAN
+#undef _SIMD_UNDEF_WIN32_LEAN_AND_MEAN_
+#endif
+#pragma push_macro("min")
+#pragma push_macro("max")
+#undef min
+#undef max
 #elif defined(__linux__)
 #include <stdlib.h>
 #endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 #if !defined(BASIC_SIMD_NAMESPACE)
 #define BASIC_SIMD_NAMESPACE SIMD
@@ -22,21 +66,188 @@
 namespace AlignedMemory
 {
 
-template<typename T>
+// Allocators are stateless policies. Allocate(bytes, alignment) returns a block aligned to 'alignment' or throws
+// std::bad_alloc, Deallocate(pointer, bytes, alignment) gets the same bytes and alignment back.
+struct SystemAllocator
+{
+    static void* Allocate(size_t bytes, size_t alignment)
+    {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        bytes = (bytes + alignment - 1) / alignment * alignment;
+        #ifdef _WIN32
+            void* data = _aligned_malloc(bytes, alignment);
+        #else
+            void* data = aligned_alloc(alignment, bytes);
+        #endif
+        if (!data) throw std::bad_alloc();
+        return data;
+    }
+    static void Deallocate(void* pointer, size_t, size_t)
+    {
+        #ifdef _WIN32
+            _aligned_free(pointer);
+        #else
+            free(pointer);
+        #endif
+    }
+};
+
+// Blocks of at least one huge page are mapped on 2 MiB boundaries and marked with MADV_HUGEPAGE, so transparent huge
+// pages back them and a large array needs one TLB entry per 2 MiB instead of per 4 KiB. Smaller blocks and platforms
+// without MADV_HUGEPAGE use the system allocator.
+struct HugePageAllocator
+{
+    static constexpr size_t HugePageBytes = 2 << 20;
+
+    static void* Allocate(size_t bytes, size_t alignment)
+    {
+#if defined(MADV_HUGEPAGE)
+        if (IsHuge(bytes, alignment))
+        {
+            // Over map by one huge page and unmap the unaligned head and tail
+            const size_t length = RoundUp(bytes);
+            char* raw = static_cast<char*>(mmap(nullptr, length + HugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            char* aligned = raw + (HugePageBytes - reinterpret_cast<uintptr_t>(raw) % HugePageBytes) % HugePageBytes;
+            if (aligned != raw)
+            {
+                munmap(raw, static_cast<size_t>(aligned - raw));
+            }
+            munmap(aligned + length, static_cast<size_t>(raw + HugePageBytes - aligned));
+            madvise(aligned, length, MADV_HUGEPAGE);
+            return aligned;
+        }
+#endif
+        return SystemAllocator::Allocate(bytes, alignment);
+    }
+    static void Deallocate(void* pointer, size_t bytes, size_t alignment)
+    {
+#if defined(MADV_HUGEPAGE)
+        if (IsHuge(bytes, alignment))
+        {
+            munmap(pointer, RoundUp(bytes));
+            return;
+        }
+#endif
+        SystemAllocator::Deallocate(pointer, bytes, alignment);
+    }
+private:
+    static bool IsHuge(size_t bytes, size_t alignment) { return bytes >= HugePageBytes && alignment <= HugePageBytes; }
+    static size_t RoundUp(size_t bytes) { return (bytes + HugePageBytes - 1) / HugePageBytes * HugePageBytes; }
+};
+
+// Thread local free lists of small blocks in power of two size classes from 64 bytes to 64 KiB. Blocks are aligned to
+// their class size up to a page, so any cached block of a class serves any alignment the class accepts. A freed block
+// goes to the list of the freeing thread, every list caches at most CachedBlocks blocks and is released when its
+// thread exits. Blocks above 64 KiB go to HugePageAllocator.
+struct PoolAllocator
+{
+    static constexpr size_t MinBlockBytes = 64;
+    static constexpr size_t ClassCount = 11;
+    static constexpr size_t MaxBlockBytes = MinBlockBytes << (ClassCount - 1);
+    static constexpr size_t MaxBlockAlignment = 4096;
+    static constexpr size_t CachedBlocks = 64;
+
+    static void* Allocate(size_t bytes, size_t alignment)
+    {
+        if (!IsPooled(bytes, alignment))
+        {
+            return HugePageAllocator::Allocate(bytes, alignment);
+        }
+        const size_t sizeClass = ClassOf(bytes, alignment);
+        ThreadCache& cache = Cache();
+        FreeBlock* block = cache.Heads[sizeClass];
+        if (block != nullptr)
+        {
+            cache.Heads[sizeClass] = block->Next;
+            cache.Counts[sizeClass]--;
+            return block;
+        }
+        const size_t classBytes = MinBlockBytes << sizeClass;
+        return SystemAllocator::Allocate(classBytes, classBytes < MaxBlockAlignment ? classBytes : MaxBlockAlignment);
+    }
+    static void Deallocate(void* pointer, size_t bytes, size_t alignment)
+    {
+        if (!IsPooled(bytes, alignment))
+        {
+            HugePageAllocator::Deallocate(pointer, bytes, alignment);
+            return;
+        }
+        const size_t sizeClass = ClassOf(bytes, alignment);
+        ThreadCache& cache = Cache();
+        if (cache.Released || cache.Counts[sizeClass] == CachedBlocks)
+        {
+            SystemAllocator::Deallocate(pointer, bytes, alignment);
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->Next = cache.Heads[sizeClass];
+        cache.Heads[sizeClass] = block;
+        cache.Counts[sizeClass]++;
+    }
+private:
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+    // Trivially destructible, so blocks freed by thread locals destroyed after the releaser still find it
+    struct ThreadCache
+    {
+        FreeBlock* Heads[ClassCount];
+        size_t Counts[ClassCount];
+        bool Released;
+    };
+    struct CacheReleaser
+    {
+        explicit CacheReleaser(ThreadCache& cache) : Owner(cache) {}
+        ~CacheReleaser()
+        {
+            for (size_t i = 0; i < ClassCount; i++)
+            {
+                while (Owner.Heads[i] != nullptr)
+                {
+                    FreeBlock* block = Owner.Heads[i];
+                    Owner.Heads[i] = block->Next;
+                    SystemAllocator::Deallocate(block, MinBlockBytes << i, MinBlockBytes);
+                }
+                Owner.Counts[i] = 0;
+            }
+            Owner.Released = true;
+        }
+        ThreadCache& Owner;
+    };
+
+    static ThreadCache& Cache()
+    {
+        static thread_local ThreadCache cache;
+        static thread_local CacheReleaser releaser(cache);
+        (void)releaser;
+        return cache;
+    }
+    static bool IsPooled(size_t bytes, size_t alignment) { return bytes <= MaxBlockBytes && alignment <= MaxBlockAlignment; }
+    static size_t ClassOf(size_t bytes, size_t alignment)
+    {
+        size_t sizeClass = 0;
+        while ((MinBlockBytes << sizeClass) < bytes || (MinBlockBytes << sizeClass) < alignment)
+        {
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+};
+
+template<typename T, typename Allocator = SystemAllocator>
 class AlignedDeleter {
 public:
-    explicit AlignedDeleter(size_t alignment = 32) : alignment_(alignment) {}
+    explicit AlignedDeleter(size_t alignment = 32, size_t bytes = 0) : alignment_(alignment), bytes_(bytes) {}
     
     void operator()(T* ptr) const {
-        #ifdef _WIN32
-            _aligned_free(ptr);
-        #else
-            free(ptr);
-        #endif
+        Allocator::Deallocate(ptr, bytes_, alignment_);
     }
     
 private:
     size_t alignment_;
+    size_t bytes_;
 };
 
 template<typename T>
@@ -48,13 +259,7 @@ public:
     explicit AlignedAllocator(size_t alignment = 32) : alignment_(alignment) {}
     
     pointer allocate(size_type n) {
-        #ifdef _WIN32
-            data = _aligned_malloc(n * sizeof(T), alignment_);
-        #else
-            data = aligned_alloc(alignment_, n * sizeof(T));
-        #endif
-        
-        if (!data) throw std::bad_alloc();
+        data = SystemAllocator::Allocate(n * sizeof(T), alignment_);
         return static_cast<pointer>(data);
     }
     void* get() const {
@@ -65,14 +270,13 @@ private:
     size_t alignment_;
 };
 
-template<typename T>
-using AlignedPtr = std::unique_ptr<T, AlignedDeleter<T>>;
+template<typename T, typename Allocator = SystemAllocator>
+using AlignedPtr = std::unique_ptr<T, AlignedDeleter<T, Allocator>>;
 
-template<typename T>
-AlignedPtr<T> make_aligned(size_t size, size_t alignment = 32) {
-    AlignedAllocator<T> allocator(alignment);
-    AlignedDeleter<T> deleter(alignment);
-    return AlignedPtr<T>(allocator.allocate(size), deleter);
+template<typename T, typename Allocator = SystemAllocator>
+AlignedPtr<T, Allocator> make_aligned(size_t size, size_t alignment = 32) {
+    const size_t bytes = size * sizeof(T);
+    return AlignedPtr<T, Allocator>(static_cast<T*>(Allocator::Allocate(bytes, alignment)), AlignedDeleter<T, Allocator>(alignment, bytes));
 }
 
 }
@@ -100,8 +304,49 @@ private:
     static bool has_sse2_;
     static bool has_avx_;
     static bool has_avx2_;
+    static bool has_fma_;
     static bool has_avx512f_;
+    static bool has_avx512bw_;
+    static bool has_avx512dq_;
+    static bool has_f16c_;
+    static bool has_avx512bf16_;
+    static size_t last_level_cache_;
+
+
+    static std::array<unsigned int, 4> cpuid(unsigned int leaf, unsigned int subleaf) {
+        std::array<unsigned int, 4> regs{};
+        #if defined(_MSC_VER)
+            int cpui[4];
+            __cpuidex(cpui, static_cast<int>(leaf), static_cast<int>(subleaf));
+            for (int i = 0; i < 4; i++) regs[i] = static_cast<unsigned int>(cpui[i]);
+        #elif defined(__GNUC__) || defined(__clang__)
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+        #endif
+        return regs;
+    }
 
+    // Largest cache in the deterministic cache parameter leaves, CPUID 4 on Intel and 0x8000001D on AMD.
+    // Falls back to 8 MiB when neither leaf reports anything.
+    static size_t detectLastLevelCache() {
+        size_t largest = 0;
+        #if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+            const unsigned int leaves[2] = { 4, 0x8000001D };
+            for (unsigned int leaf : leaves) {
+                if (cpuid(leaf & 0x80000000, 0)[0] < leaf) continue;
+                for (unsigned int subleaf = 0; subleaf < 16; subleaf++) {
+                    std::array<unsigned int, 4> regs = cpuid(leaf, subleaf);
+                    if ((regs[0] & 0x1F) == 0) break;                  // EAX[4:0] cache type, 0 = no more caches
+                    size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;        // EBX[31:22]
+                    size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;  // EBX[21:12]
+                    size_t lineSize = (regs[1] & 0xFFF) + 1;            // EBX[11:0]
+                    size_t sets = static_cast<size_t>(regs[2]) + 1;     // ECX
+                    largest = std::max(largest, ways * partitions * lineSize * sets);
+                }
+                if (largest != 0) break;
+            }
+        #endif
+        return largest != 0 ? largest : size_t(8) << 20;
+    }
 
     static void initialize() {
         if (initialized_) return;
@@ -136,6 +381,8 @@ private:
                 bool cpu_has_sse2 = (cpui[3] & (1 << 26)) != 0;     // EDX bit 26
                 bool cpu_has_avx = (cpui[2] & (1 << 28)) != 0;      // ECX bit 28
                 bool cpu_uses_xsave = (cpui[2] & (1 << 27)) != 0;   // ECX bit 27
+                bool cpu_has_fma = (cpui[2] & (1 << 12)) != 0;      // ECX bit 12
+                bool cpu_has_f16c = (cpui[2] & (1 << 29)) != 0;     // ECX bit 29
                 
                 // Safely assign SSE/SSE2 flags (these don't need OS support)
                 has_sse_ = cpu_has_sse;
@@ -159,6 +406,8 @@ private:
                         bool avxSupportedByOS = (xcrFeatureMask & 0x6) == 0x6;
                         
                         has_avx_ = cpu_has_avx && avxSupportedByOS;
+                        has_fma_ = cpu_has_fma && avxSupportedByOS;
+                        has_f16c_ = cpu_has_f16c && avxSupportedByOS;
                         
                         // Check AVX2 and AVX-512
                         if (max_std_id >= 7) {
@@ -172,6 +421,8 @@ private:
                             
                             bool cpu_has_avx2 = (cpui[1] & (1 << 5)) != 0;         // EBX bit 5
                             bool cpu_has_avx512f = (cpui[1] & (1 << 16)) != 0;     // EBX bit 16
+                            bool cpu_has_avx512dq = (cpui[1] & (1 << 17)) != 0;    // EBX bit 17
+                            bool cpu_has_avx512bw = (cpui[1] & (1 << 30)) != 0;    // EBX bit 30
                             
                             has_avx2_ = cpu_has_avx2 && avxSupportedByOS;
                             
@@ -181,16 +432,33 @@ private:
                                                      ((xcrFeatureMask & 0xE0) == 0xE0);
                             
                             has_avx512f_ = cpu_has_avx512f && avx512SupportedByOS;
+                            has_avx512bw_ = cpu_has_avx512bw && has_avx512f_;
+                            has_avx512dq_ = cpu_has_avx512dq && has_avx512f_;
+
+                            // AVX512_BF16 is reported in subleaf 1, EAX bit 5
+                            if (cpuid(7, 0)[0] >= 1) {
+                                has_avx512bf16_ = (cpuid(7, 1)[0] & (1 << 5)) != 0 && has_avx512f_;
+                            }
                         }
                     } catch (...) {
                         has_avx_ = false;
+                        has_fma_ = false;
                         has_avx2_ = false;
                         has_avx512f_ = false;
+                        has_avx512bw_ = false;
+                        has_avx512dq_ = false;
+                        has_f16c_ = false;
+                        has_avx512bf16_ = false;
                     }
                 } else {
                     has_avx_ = false;
+                    has_fma_ = false;
                     has_avx2_ = false;
                     has_avx512f_ = false;
+                    has_avx512bw_ = false;
+                    has_avx512dq_ = false;
+                    has_f16c_ = false;
+                    has_avx512bf16_ = false;
                 }
             }
         #else
@@ -198,9 +466,15 @@ private:
             has_sse2_ = false;
             has_avx_ = false;
             has_avx2_ = false;
+            has_fma_ = false;
             has_avx512f_ = false;
+            has_avx512bw_ = false;
+            has_avx512dq_ = false;
+            has_f16c_ = false;
+            has_avx512bf16_ = false;
         #endif
 
+        last_level_cache_ = detectLastLevelCache();
         initialized_ = true;
         
     }
@@ -226,11 +500,41 @@ public:
         return has_avx2_;
     }
 
+    static bool hasFMA() {
+        if (!initialized_) initialize();
+        return has_fma_;
+    }
+
     static bool hasAVX512() {
         if (!initialized_) initialize();
         return has_avx512f_;
     }
 
+    static bool hasAVX512BW() {
+        if (!initialized_) initialize();
+        return has_avx512bw_;
+    }
+
+    static bool hasAVX512DQ() {
+        if (!initialized_) initialize();
+        return has_avx512dq_;
+    }
+
+    static bool hasF16C() {
+        if (!initialized_) initialize();
+        return has_f16c_;
+    }
+
+    static bool hasAVX512BF16() {
+        if (!initialized_) initialize();
+        return has_avx512bf16_;
+    }
+
+    static size_t lastLevelCacheSize() {
+        if (!initialized_) initialize();
+        return last_level_cache_;
+    }
+
     template<InstructionSet T>
     static typename std::enable_if<T == InstructionSet::NONE, bool>::type 
     supportsInstructionSet() {
@@ -277,7 +581,13 @@ public:
         std::cout << "SSE2:   " << (has_sse2_ ? "Yes" : "No") << std::endl;
         std::cout << "AVX:    " << (has_avx_ ? "Yes" : "No") << std::endl;
         std::cout << "AVX2:   " << (has_avx2_ ? "Yes" : "No") << std::endl;
+        std::cout << "FMA3:   " << (has_fma_ ? "Yes" : "No") << std::endl;
         std::cout << "AVX512: " << (has_avx512f_ ? "Yes" : "No") << std::endl;
+        std::cout << "AVX512BW: " << (has_avx512bw_ ? "Yes" : "No") << std::endl;
+        std::cout << "AVX512DQ: " << (has_avx512dq_ ? "Yes" : "No") << std::endl;
+        std::cout << "F16C:   " << (has_f16c_ ? "Yes" : "No") << std::endl;
+        std::cout << "AVX512BF16: " << (has_avx512bf16_ ? "Yes" : "No") << std::endl;
+        std::cout << "LLC:    " << (last_level_cache_ >> 10) << " KiB" << std::endl;
     }
 
     // New function to print all supported SIMD types
@@ -377,12 +687,20 @@ bool CPUFeatures::has_sse_ = false;
 bool CPUFeatures::has_sse2_ = false;  // Initialize SSE2 static member
 bool CPUFeatures::has_avx_ = false;
 bool CPUFeatures::has_avx2_ = false;
+bool CPUFeatures::has_fma_ = false;
 bool CPUFeatures::has_avx512f_ = false;
-
-// Primary template - default is NONE
+bool CPUFeatures::has_avx512bw_ = false;
+bool CPUFeatures::has_avx512dq_ = false;
+bool CPUFeatures::has_f16c_ = false;
+bool CPUFeatures::has_avx512bf16_ = false;
+size_t CPUFeatures::last_level_cache_ = 0;
+
+// Primary template - default is NONE. Register types whose kernels the build does not target run the lane loop
+// fallbacks of SIMD_Type_t, they keep the default and can be used on any CPU
 template<typename T, size_t BitWidth>
 struct RequiredInstructionSet {
     static constexpr InstructionSet value = InstructionSet::NONE;
+    static constexpr const char* name = "NONE";
 };
 
 // Macro for specializations
@@ -403,6 +721,7 @@ DEFINE_REQUIRED_INSTRUCTION_SET(uint32_t, 128, SSE)
 DEFINE_REQUIRED_INSTRUCTION_SET(int64_t, 128, SSE2)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint64_t, 128, SSE2)
 
+#if defined(__AVX2__)
 DEFINE_REQUIRED_INSTRUCTION_SET(int8_t, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint8_t, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(int16_t, 256, AVX)
@@ -411,7 +730,9 @@ DEFINE_REQUIRED_INSTRUCTION_SET(int32_t, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint32_t, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(int64_t, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint64_t, 256, AVX)
+#endif
 
+#if defined(__AVX512F__)
 DEFINE_REQUIRED_INSTRUCTION_SET(int8_t, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint8_t, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(int16_t, 512, AVX512)
@@ -420,22 +741,24 @@ DEFINE_REQUIRED_INSTRUCTION_SET(int32_t, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint32_t, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(int64_t, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(uint64_t, 512, AVX512)
+#endif
 
 // Floating-point types
 DEFINE_REQUIRED_INSTRUCTION_SET(float, 128, SSE)
 DEFINE_REQUIRED_INSTRUCTION_SET(double, 128, SSE2)
 
+#if defined(__AVX__)
 DEFINE_REQUIRED_INSTRUCTION_SET(float, 256, AVX)
 DEFINE_REQUIRED_INSTRUCTION_SET(double, 256, AVX)
+#endif
 
+#if defined(__AVX512F__)
 DEFINE_REQUIRED_INSTRUCTION_SET(float, 512, AVX512)
 DEFINE_REQUIRED_INSTRUCTION_SET(double, 512, AVX512)
+#endif
 
 #undef DEFINE_REQUIRED_INSTRUCTION_SET
 
-template<typename T>
-struct AssertFalse : std::false_type {};
-
 template<typename T>
 using IsSIMD_Int = typename std::enable_if<std::is_same<typename T::Type, int>::value, int>::type;
 
@@ -499,6 +822,198 @@ struct IsAllElementsCompatible_impl<TypeRequired, FirstElementType> : std::condi
 template<typename T, typename... Elements>
 using IsAllElementsCompatible = typename std::enable_if<IsAllElementsCompatible_impl<T, Elements...>::value, int>::type;
 
+// Register sized non temporal stores, widths the compile time ISA can not stream fall back to a plain copy
+template<int Bits>
+struct NonTemporal
+{
+    static _SIMD_INL_ void Store(void* to, const void* from) { memcpy(to, from, Bits / 8); }
+};
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2)
+template<>
+struct NonTemporal<128>
+{
+    static _SIMD_INL_ void Store(void* to, const void* from) { _mm_stream_si128((__m128i*)to, _mm_load_si128((const __m128i*)from)); }
+};
+#endif
+#if defined(__AVX__)
+template<>
+struct NonTemporal<256>
+{
+    static _SIMD_INL_ void Store(void* to, const void* from) { _mm256_stream_si256((__m256i*)to, _mm256_load_si256((const __m256i*)from)); }
+};
+#endif
+#if defined(__AVX512F__)
+template<>
+struct NonTemporal<512>
+{
+    static _SIMD_INL_ void Store(void* to, const void* from) { _mm512_stream_si512((__m512i*)to, _mm512_load_si512(from)); }
+};
+#endif
+
+// Masks returned by the lane wise comparisons. SSE and AVX2 types use vector masks with every bit of a true
+// lane set, AVX-512 types one bit per lane like __mmask. Any/All/CountTrue/Select work on either form.
+template<unsigned int Lanes>
+struct BitMask
+{
+    using Type = typename std::conditional<(Lanes <= 8), uint8_t,
+        typename std::conditional<(Lanes <= 16), uint16_t,
+        typename std::conditional<(Lanes <= 32), uint32_t, uint64_t>::type>::type>::type;
+    static constexpr uint64_t All = Lanes >= 64 ? ~uint64_t(0) : (uint64_t(1) << Lanes) - 1;
+};
+
+// Vector masks, one bit per byte of the register. Lanes are all ones or all zeros so byte blends are exact
+template<int Bits>
+struct VectorMask
+{
+    static _SIMD_INL_ uint64_t Bytes(const void* mask)
+    {
+        uint64_t bytes = 0;
+        for (unsigned int i = 0; i < Bits / 8; i++)
+        {
+            bytes |= static_cast<uint64_t>(static_cast<const unsigned char*>(mask)[i] >> 7) << i;
+        }
+        return bytes;
+    }
+    static _SIMD_INL_ void Select(void* to, const void* mask, const void* a, const void* b)
+    {
+        for (unsigned int i = 0; i < Bits / 8; i++)
+        {
+            const unsigned char m = static_cast<const unsigned char*>(mask)[i];
+            static_cast<unsigned char*>(to)[i] = (static_cast<const unsigned char*>(a)[i] & m) | (static_cast<const unsigned char*>(b)[i] & ~m);
+        }
+    }
+};
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2)
+template<>
+struct VectorMask<128>
+{
+    static _SIMD_INL_ uint64_t Bytes(const void* mask) { return static_cast<uint32_t>(_mm_movemask_epi8(_mm_load_si128((const __m128i*)mask))); }
+    static _SIMD_INL_ void Select(void* to, const void* mask, const void* a, const void* b)
+    {
+        const __m128i m = _mm_load_si128((const __m128i*)mask);
+        _mm_store_si128((__m128i*)to, _mm_or_si128(_mm_and_si128(m, _mm_load_si128((const __m128i*)a)), _mm_andnot_si128(m, _mm_load_si128((const __m128i*)b))));
+    }
+};
+#endif
+#if defined(__AVX2__)
+template<>
+struct VectorMask<256>
+{
+    static _SIMD_INL_ uint64_t Bytes(const void* mask) { return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_load_si256((const __m256i*)mask))); }
+    static _SIMD_INL_ void Select(void* to, const void* mask, const void* a, const void* b)
+    {
+        _mm256_store_si256((__m256i*)to, _mm256_blendv_epi8(_mm256_load_si256((const __m256i*)b), _mm256_load_si256((const __m256i*)a), _mm256_load_si256((const __m256i*)mask)));
+    }
+};
+#endif
+
+// One bit per lane masks, Select blends with the lane size of the register
+template<unsigned int LaneBytes>
+struct BitMaskBlend512
+{
+    template<typename M>
+    static _SIMD_INL_ void Select(void* to, M mask, const void* a, const void* b)
+    {
+        for (unsigned int i = 0; i < 64 / LaneBytes; i++)
+        {
+            memcpy(static_cast<unsigned char*>(to) + i * LaneBytes, static_cast<const unsigned char*>(((mask >> i) & 1) ? a : b) + i * LaneBytes, LaneBytes);
+        }
+    }
+};
+#if defined(__AVX512BW__)
+template<>
+struct BitMaskBlend512<1>
+{
+    static _SIMD_INL_ void Select(void* to, __mmask64 mask, const void* a, const void* b) { _mm512_store_si512(to, _mm512_mask_blend_epi8(mask, _mm512_load_si512(b), _mm512_load_si512(a))); }
+};
+template<>
+struct BitMaskBlend512<2>
+{
+    static _SIMD_INL_ void Select(void* to, __mmask32 mask, const void* a, const void* b) { _mm512_store_si512(to, _mm512_mask_blend_epi16(mask, _mm512_load_si512(b), _mm512_load_si512(a))); }
+};
+#endif
+#if defined(__AVX512F__)
+template<>
+struct BitMaskBlend512<4>
+{
+    static _SIMD_INL_ void Select(void* to, __mmask16 mask, const void* a, const void* b) { _mm512_store_si512(to, _mm512_mask_blend_epi32(mask, _mm512_load_si512(b), _mm512_load_si512(a))); }
+};
+template<>
+struct BitMaskBlend512<8>
+{
+    static _SIMD_INL_ void Select(void* to, __mmask8 mask, const void* a, const void* b) { _mm512_store_si512(to, _mm512_mask_blend_epi64(mask, _mm512_load_si512(b), _mm512_load_si512(a))); }
+};
+#endif
+
+template<int Bits, unsigned int LaneBytes>
+struct LaneMask
+{
+    static constexpr unsigned int Lanes = Bits / 8 / LaneBytes;
+    template<typename M> static _SIMD_INL_ void Set(M& mask, unsigned int lane, bool value)
+    {
+        memset(reinterpret_cast<unsigned char*>(mask.Data) + lane * LaneBytes, value ? 0xFF : 0, LaneBytes);
+    }
+    template<typename M> static _SIMD_INL_ bool Any(const M& mask) { return VectorMask<Bits>::Bytes(mask.Data) != 0; }
+    template<typename M> static _SIMD_INL_ bool All(const M& mask) { return VectorMask<Bits>::Bytes(mask.Data) == BitMask<Bits / 8>::All; }
+    template<typename M> static _SIMD_INL_ unsigned int CountTrue(const M& mask)
+    {
+        return static_cast<unsigned int>(std::bitset<64>(VectorMask<Bits>::Bytes(mask.Data)).count()) / LaneBytes;
+    }
+    template<typename M> static _SIMD_INL_ void Select(void* to, const M& mask, const void* a, const void* b)
+    {
+        VectorMask<Bits>::Select(to, mask.Data, a, b);
+    }
+    template<typename M> static _SIMD_INL_ bool Test(const M& mask, unsigned int lane)
+    {
+        return reinterpret_cast<const unsigned char*>(mask.Data)[lane * LaneBytes] != 0;
+    }
+    /* The first count lanes set, copied out of a window sliding over 64 set bytes followed by 64 clear ones */
+    template<typename M> static _SIMD_INL_ void FirstN(M& mask, unsigned int count)
+    {
+        alignas(64) static const unsigned char window[128] = {
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 };
+        memcpy(mask.Data, window + 64 - count * LaneBytes, Bits / 8);
+    }
+};
+template<unsigned int LaneBytes>
+struct LaneMask<512, LaneBytes>
+{
+    static constexpr unsigned int Lanes = 64 / LaneBytes;
+    template<typename M> static _SIMD_INL_ void Set(M& mask, unsigned int lane, bool value)
+    {
+        mask = static_cast<M>((mask & ~(M(1) << lane)) | (M(value) << lane));
+    }
+    template<typename M> static _SIMD_INL_ bool Any(M mask) { return mask != 0; }
+    template<typename M> static _SIMD_INL_ bool All(M mask) { return mask == BitMask<Lanes>::All; }
+    template<typename M> static _SIMD_INL_ unsigned int CountTrue(M mask) { return static_cast<unsigned int>(std::bitset<64>(mask).count()); }
+    template<typename M> static _SIMD_INL_ void Select(void* to, M mask, const void* a, const void* b)
+    {
+        BitMaskBlend512<LaneBytes>::Select(to, mask, a, b);
+    }
+    template<typename M> static _SIMD_INL_ bool Test(M mask, unsigned int lane) { return ((mask >> lane) & 1) != 0; }
+    template<typename M> static _SIMD_INL_ void FirstN(M& mask, unsigned int count)
+    {
+        mask = static_cast<M>(count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1);
+    }
+};
+
+// Integer quotients of count lanes, defined with the division kernels below
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Division
+{
+template<typename E>
+struct Quotient;
+}
+}
+
 template<typename ContainerType, int Bits, typename T_ElementType, 
 typename = IsElementValid<ContainerType, T_ElementType>,
 typename = typename std::enable_if<Bits%8 == 0, int>::type >
@@ -511,138 +1026,723 @@ public:
     static constexpr unsigned int SizeBytes = Bits/8;
     static constexpr unsigned int Alignment = Bits/8;
     static constexpr unsigned int ElementCount = (Bits/8)/sizeof(T_ElementType);
-    void* Data;
-    AlignedMemory::AlignedPtr<T_ElementType> AlignedData;
+    /* Horizontal sums and products of 8 and 16 bit lanes are widened to 32 bits */
+    using ReduceType = typename std::conditional<std::is_integral<T_ElementType>::value && (sizeof(T_ElementType) < 4),
+        typename std::conditional<std::is_signed<T_ElementType>::value, int32_t, uint32_t>::type, T_ElementType>::type;
+    /* Result of the lane wise comparisons, see LaneMask */
+    using MaskType = typename std::conditional<Bits == 512, typename BitMask<ElementCount>::Type, SIMD_Type_t>::type;
+    /* Lanes are stored inline so values can live in registers, no heap allocation per value */
+    alignas(Alignment) T_ElementType Data[ElementCount];
+
 private:
-    bool IsImported;
+    struct NoCheck {};
+    /* Used by the kernels for their results, the operands were already checked when they were constructed */
+    explicit SIMD_Type_t(NoCheck) {}
 
-public:
-    SIMD_Type_t() :Data(nullptr), IsImported(false)
+    static _SIMD_INL_ void CheckInstructionSet()
     {
-		if (!CPUFeatures::supportsInstructionSet<RequiredInstructionSet<ContainerType, Bits>::value>())
-		{
-            std::string errorMessage = "For SIMD Type " + std::string(typeid(ContainerType).name()) + "_" + std::to_string(Bits) + " the required instruction set " + std::string(RequiredInstructionSet<ContainerType, Bits>::name) + " does not supported in this device.";
-            throw std::runtime_error(errorMessage);
-		}
-        AlignedData = std::move(AlignedMemory::make_aligned<T_ElementType>(SizeBytes, Alignment));
-        Data = AlignedData.get();
+        if (!CPUFeatures::supportsInstructionSet<RequiredInstructionSet<ContainerType, Bits>::value>())
+        {
+            ThrowUnsupported();
+        }
     }
-    template<typename ...Args,
-                    IsElementValid<ContainerType, T_ElementType> = 0, 
-                    IsAllElementsCompatible<T_ElementType, Args...> = 0, 
-                    IsSizeValid< ElementCount, Args...> = 0>
-    SIMD_Type_t(Args... args) : Data(nullptr), IsImported(false) 
+    static void ThrowUnsupported()
     {
-        if (!CPUFeatures::supportsInstructionSet<RequiredInstructionSet<ContainerType, Bits>::value>())
+        std::string errorMessage = "For SIMD Type " + std::string(typeid(ContainerType).name()) + "_" + std::to_string(Bits) + " the required instruction set " + std::string(RequiredInstructionSet<ContainerType, Bits>::name) + " does not supported in this device.";
+        throw std::runtime_error(errorMessage);
+    }
+    template<typename Predicate>
+    static _SIMD_INL_ MaskType CompareLanes(const SIMD_Type_t& a, const SIMD_Type_t& b, Predicate predicate)
+    {
+        MaskType mask = MaskType();
+        for (unsigned int i = 0; i < ElementCount; i++)
         {
-            std::string errorMessage = "For SIMD Type " + std::string(typeid(ContainerType).name()) + "_" + std::to_string(Bits) + " the required instruction set " + std::string(RequiredInstructionSet<ContainerType, Bits>::name) + " does not supported in this device.";
-            throw std::runtime_error(errorMessage);
+            LaneMask<Bits, sizeof(T_ElementType)>::Set(mask, i, predicate(a.Data[i], b.Data[i]));
         }
-        alignas(Alignment) T_ElementType data[SizeBytes / sizeof(T_ElementType)] = { args... };
-        AlignedData = std::move(AlignedMemory::make_aligned<T_ElementType>(SizeBytes, Alignment));
-        Data = AlignedData.get();
-        std::copy(data, data + SizeBytes / sizeof(T_ElementType), reinterpret_cast<T_ElementType*>(Data));
+        return mask;
     }
-    SIMD_Type_t(void* data) : Data(nullptr)
+    template<typename Function>
+    static _SIMD_INL_ SIMD_Type_t MapLanes(const SIMD_Type_t& a, Function function)
     {
-        if(!CPUFeatures::supportsInstructionSet<RequiredInstructionSet<ContainerType, Bits>::value>())
+        static_assert(std::is_floating_point<T_ElementType>::value, "Elementary functions are only supported for float and double lanes.");
+        SIMD_Type_t result((NoCheck()));
+        for (unsigned int i = 0; i < ElementCount; i++)
         {
-            std::string errorMessage = "For SIMD Type " + std::string(typeid(ContainerType).name()) + "_" + std::to_string(Bits) + " the required instruction set " + std::string(RequiredInstructionSet<ContainerType, Bits>::name) + " does not supported in this device.";
-            throw std::runtime_error(errorMessage);
+            result.Data[i] = function(a.Data[i]);
         }
-        /*This will check for memory alignment*/
-        if((reinterpret_cast<uintptr_t>(data) & (Alignment - 1)) != 0)
+        return result;
+    }
+    template<T_ElementType (*Lane)(T_ElementType, T_ElementType)>
+    static _SIMD_INL_ void ApplyLanes(T_ElementType* to, const T_ElementType* a, const T_ElementType* b)
+    {
+        for (unsigned int i = 0; i < ElementCount; i++)
         {
-            throw std::runtime_error("Data is not aligned to the required boundary.");
+            to[i] = Lane(a[i], b[i]);
         }
-        IsImported = true;
-        Data = data;
     }
-    /* Move constructor */ 
-    SIMD_Type_t(SIMD_Type_t&& other) noexcept : Data(other.Data), IsImported(other.IsImported) { 
-        other.Data = nullptr; 
-        other.IsImported = false;
-    } 
-    SIMD_Type_t(const SIMD_Type_t& other) noexcept : Data(nullptr), IsImported(false) { 
-        AlignedData = std::move(AlignedMemory::make_aligned<T_ElementType>(SizeBytes, Alignment));
-        Data = AlignedData.get();
-        std::copy(other.Data, other.Data + SizeBytes / sizeof(T_ElementType), reinterpret_cast<T_ElementType*>(Data));
-    } 
-    ~SIMD_Type_t()
+    /* Scalar lanes of the saturating, averaging and absolute difference fallbacks */
+    static T_ElementType AddSaturateLane(T_ElementType a, T_ElementType b)
     {
+        typedef std::numeric_limits<T_ElementType> Limits;
+        static_assert(Limits::is_integer, "Saturating arithmetic is only supported for integer lanes.");
+        if (b > 0 && a > Limits::max() - b) return Limits::max();
+        if (Limits::is_signed && b < 0 && a < Limits::min() - b) return Limits::min();
+        return static_cast<T_ElementType>(a + b);
     }
-    static _SIMD_INL_ SIMD_Type_t Import(void* data)
+    static T_ElementType SubtractSaturateLane(T_ElementType a, T_ElementType b)
     {
-        return std::move(SIMD_Type_t(data));
+        typedef std::numeric_limits<T_ElementType> Limits;
+        static_assert(Limits::is_integer, "Saturating arithmetic is only supported for integer lanes.");
+        if (!Limits::is_signed) return a > b ? static_cast<T_ElementType>(a - b) : 0;
+        if (b < 0 && a > Limits::max() + b) return Limits::max();
+        if (b > 0 && a < Limits::min() + b) return Limits::min();
+        return static_cast<T_ElementType>(a - b);
     }
-    const T_ElementType *const Get()
+    static T_ElementType AverageLane(T_ElementType a, T_ElementType b)
     {
-        return reinterpret_cast<T_ElementType*>(Data);
+        static_assert(std::is_integral<T_ElementType>::value, "Average is only supported for integer lanes.");
+        /* (a + b + 1) >> 1 without the overflow of a + b */
+        return static_cast<T_ElementType>((a | b) - ((a ^ b) >> 1));
     }
-    /* Copy assignment operator */ 
-    SIMD_Type_t& operator=(const SIMD_Type_t& other) { 
-        Data = other.Data;\
-        return *this; \
-    } 
-    explicit operator bool() noexcept { 
-        return Data != nullptr; 
+    static T_ElementType AbsDiffLane(T_ElementType a, T_ElementType b)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "AbsDiff is only supported for integer lanes.");
+        typedef typename std::make_unsigned<T_ElementType>::type U;
+        return static_cast<T_ElementType>(a > b ? U(U(a) - U(b)) : U(U(b) - U(a)));
     }
-    
-    T_ElementType ElementAt(unsigned int index) const
-	{
-        if(index >= ElementCount)
-		{
-			return 0;
-		}
-		return *(reinterpret_cast<T_ElementType*>(Data) + index);
-	}
-    static _SIMD_INL_ SIMD_Type_t Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {
-        SIMD_Type_t result;
-        /* Implementation will be specialized */
-        return result;
+    /* Scalar lanes of the arithmetic fallbacks, used where the compile time ISA has no kernel for the register.
+       Integer lanes wrap around like the instructions, the arithmetic goes through uint64_t so that 8 and 16 bit
+       lanes are not promoted to a signed int that could overflow */
+    typedef typename std::conditional<std::is_integral<T_ElementType>::value, uint64_t, T_ElementType>::type WrapType;
+    static T_ElementType AddLane(T_ElementType a, T_ElementType b)
+    {
+        return static_cast<T_ElementType>(static_cast<WrapType>(a) + static_cast<WrapType>(b));
     }
-    static _SIMD_INL_ void AddInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
-        /* Implementation will be specialized */
+    static T_ElementType SubtractLane(T_ElementType a, T_ElementType b)
+    {
+        return static_cast<T_ElementType>(static_cast<WrapType>(a) - static_cast<WrapType>(b));
     }
-    static _SIMD_INL_ void AddInplaceRaw(T_ElementType* to, const T_ElementType* from) {
-        /* Implementation will be specialized */
+    static T_ElementType MultiplyLane(T_ElementType a, T_ElementType b)
+    {
+        return static_cast<T_ElementType>(static_cast<WrapType>(a) * static_cast<WrapType>(b));
     }
-    
-    static _SIMD_INL_ SIMD_Type_t Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {
-        SIMD_Type_t result;
-        /* Implementation will be specialized */
-        return result;
+    static T_ElementType DivideLane(T_ElementType a, T_ElementType b)
+    {
+        return a / b;
     }
-    static _SIMD_INL_ void SubtractInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
-        /* Implementation will be specialized */
+    /* Integer quotients go through Division, which picks its AVX2 kernels at runtime */
+    static _SIMD_INL_ void DivideLanes(T_ElementType* to, const T_ElementType* a, const T_ElementType* b, std::true_type /*integer*/)
+    {
+        BASIC_SIMD_NAMESPACE::Division::Quotient<T_ElementType>::Apply(to, a, b, ElementCount);
+    }
+    static _SIMD_INL_ void DivideLanes(T_ElementType* to, const T_ElementType* a, const T_ElementType* b, std::false_type /*floating*/)
+    {
+        ApplyLanes<DivideLane>(to, a, b);
+    }
+    static _SIMD_INL_ void FusedMultiplyAddLanes(T_ElementType* to, const T_ElementType* a, const T_ElementType* b, const T_ElementType* c, T_ElementType sign)
+    {
+        static_assert(std::is_floating_point<T_ElementType>::value, "Fused multiply add is only supported for float and double lanes.");
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            to[i] = std::fma(a[i], b[i], sign * c[i]);
+        }
+    }
+    /* Scalar lanes of the bitwise fallbacks. Counts of the lane width or more shift every bit out like the
+       instructions do, signed right shifts then leave the sign in every bit */
+    static T_ElementType AndLane(T_ElementType a, T_ElementType b)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Bitwise operations are only supported for integer lanes.");
+        return static_cast<T_ElementType>(a & b);
+    }
+    static T_ElementType OrLane(T_ElementType a, T_ElementType b)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Bitwise operations are only supported for integer lanes.");
+        return static_cast<T_ElementType>(a | b);
+    }
+    static T_ElementType XorLane(T_ElementType a, T_ElementType b)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Bitwise operations are only supported for integer lanes.");
+        return static_cast<T_ElementType>(a ^ b);
+    }
+    static T_ElementType AndNotLane(T_ElementType a, T_ElementType b)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Bitwise operations are only supported for integer lanes.");
+        return static_cast<T_ElementType>(a & ~b);
+    }
+    static T_ElementType ShiftLeftLane(T_ElementType a, T_ElementType count)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Shifts are only supported for integer lanes.");
+        typedef typename std::make_unsigned<T_ElementType>::type U;
+        return static_cast<U>(count) >= sizeof(T_ElementType) * 8 ? 0 : static_cast<T_ElementType>(static_cast<U>(a) << static_cast<U>(count));
+    }
+    static T_ElementType ShiftRightLane(T_ElementType a, T_ElementType count)
+    {
+        static_assert(std::is_integral<T_ElementType>::value, "Shifts are only supported for integer lanes.");
+        typedef typename std::make_unsigned<T_ElementType>::type U;
+        if (static_cast<U>(count) >= sizeof(T_ElementType) * 8)
+        {
+            return (std::is_signed<T_ElementType>::value && a < 0) ? static_cast<T_ElementType>(-1) : 0;
+        }
+        return static_cast<T_ElementType>(a >> static_cast<U>(count));
+    }
+    template<T_ElementType (*Lane)(T_ElementType, T_ElementType)>
+    static _SIMD_INL_ void ApplyLanes(T_ElementType* to, const T_ElementType* a, unsigned int count)
+    {
+        const T_ElementType counts = static_cast<T_ElementType>(std::min(count, static_cast<unsigned int>(sizeof(T_ElementType) * 8)));
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            to[i] = Lane(a[i], counts);
+        }
+    }
+    /* Scalar lane conversion of the Widen, Narrow and Convert fallbacks. Integer results saturate to the range of
+       To, floating point sources are truncated toward zero and NaN becomes 0 */
+    template<typename To, typename From>
+    static To ConvertLane(From v)
+    {
+        return ConvertLane<To>(v, std::is_floating_point<From>(), std::is_floating_point<To>());
+    }
+    template<typename To, typename From>
+    static To ConvertLane(From v, std::false_type /*integer source*/, std::false_type /*integer result*/)
+    {
+        if (std::is_signed<From>::value && static_cast<int64_t>(v) < 0)
+        {
+            return static_cast<int64_t>(v) < static_cast<int64_t>(std::numeric_limits<To>::min()) ? std::numeric_limits<To>::min() : static_cast<To>(v);
+        }
+        return static_cast<uint64_t>(v) > static_cast<uint64_t>(std::numeric_limits<To>::max()) ? std::numeric_limits<To>::max() : static_cast<To>(v);
+    }
+    template<typename To, typename From>
+    static To ConvertLane(From v, std::true_type /*floating source*/, std::false_type /*integer result*/)
+    {
+        const From limit = std::ldexp(From(1), std::numeric_limits<To>::digits);
+        if (v != v)
+        {
+            return 0;
+        }
+        if (v >= limit)
+        {
+            return std::numeric_limits<To>::max();
+        }
+        if (v <= (std::is_signed<To>::value ? -limit : From(-1)))
+        {
+            return std::numeric_limits<To>::min();
+        }
+        return static_cast<To>(v);
+    }
+    template<typename To, typename From, typename FromFloating>
+    static To ConvertLane(From v, FromFloating, std::true_type /*floating result*/)
+    {
+        return static_cast<To>(v);
+    }
+
+public:
+    SIMD_Type_t() : Data()
+    {
+        CheckInstructionSet();
+    }
+    template<typename ...Args,
+                    IsElementValid<ContainerType, T_ElementType> = 0, 
+                    IsAllElementsCompatible<T_ElementType, Args...> = 0, 
+                    IsSizeValid< ElementCount, Args...> = 0>
+    SIMD_Type_t(Args... args) : Data{ static_cast<T_ElementType>(args)... }
+    {
+        CheckInstructionSet();
+    }
+    /* Copies the lanes from external memory, use Export to write them back */
+    SIMD_Type_t(void* data)
+    {
+        CheckInstructionSet();
+        /*This will check for memory alignment*/
+        if((reinterpret_cast<uintptr_t>(data) & (Alignment - 1)) != 0)
+        {
+            throw std::runtime_error("Data is not aligned to the required boundary.");
+        }
+        memcpy(Data, data, SizeBytes);
+    }
+    SIMD_Type_t(const SIMD_Type_t& other) = default;
+    SIMD_Type_t(SIMD_Type_t&& other) = default;
+    SIMD_Type_t& operator=(const SIMD_Type_t& other) = default;
+    SIMD_Type_t& operator=(SIMD_Type_t&& other) = default;
+
+    static _SIMD_INL_ SIMD_Type_t Import(void* data)
+    {
+        return SIMD_Type_t(data);
+    }
+    void Export(void* data) const
+    {
+        if((reinterpret_cast<uintptr_t>(data) & (Alignment - 1)) != 0)
+        {
+            throw std::runtime_error("Data is not aligned to the required boundary.");
+        }
+        memcpy(data, Data, SizeBytes);
+    }
+    /* Unchecked aligned load and store, for kernels that already know the memory is valid */
+    static _SIMD_INL_ SIMD_Type_t Load(const T_ElementType* data)
+    {
+        SIMD_Type_t result((NoCheck()));
+        memcpy(result.Data, _SIMD_ASSUME_ALIGNED_(data, Alignment), SizeBytes);
+        return result;
+    }
+    _SIMD_INL_ void Store(T_ElementType* data) const
+    {
+        memcpy(_SIMD_ASSUME_ALIGNED_(data, Alignment), Data, SizeBytes);
+    }
+    /* Load and store without any alignment requirement, for lanes in buffers the library did not allocate.
+       They compile to the unaligned moves, which cost the same as the aligned ones on aligned addresses */
+    static _SIMD_INL_ SIMD_Type_t LoadUnaligned(const T_ElementType* data)
+    {
+        SIMD_Type_t result((NoCheck()));
+        memcpy(result.Data, data, SizeBytes);
+        return result;
+    }
+    _SIMD_INL_ void StoreUnaligned(T_ElementType* data) const
+    {
+        memcpy(data, Data, SizeBytes);
+    }
+    /* Aligned non temporal store, bypasses the caches. Callers issue _mm_sfence once they are done streaming */
+    _SIMD_INL_ void Stream(T_ElementType* data) const
+    {
+        NonTemporal<Bits>::Store(data, Data);
+    }
+    /* All lanes set to value */
+    static _SIMD_INL_ SIMD_Type_t Broadcast(T_ElementType value)
+    {
+        SIMD_Type_t result((NoCheck()));
+        std::fill(result.Data, result.Data + ElementCount, value);
+        return result;
+    }
+    const T_ElementType *const Get()
+    {
+        return Data;
+    }
+    /* Kept for source compatibility: it tested for a heap buffer, and inline lanes are always there */
+    explicit operator bool() const noexcept
+    {
+        return true;
+    }
+    
+    T_ElementType ElementAt(unsigned int index) const
+	{
+        if(index >= ElementCount)
+		{
+			return 0;
+		}
+		return Data[index];
+	}
+    /* Arithmetic of the whole register. The instruction set kernels are specialized below, the lane loops are the
+       fallback for registers the compile time ISA has no kernel for (e.g. float_256 without -mavx) */
+    static _SIMD_INL_ SIMD_Type_t Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AddLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void AddInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AddLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AddInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AddLane>(to, to, from);
+    }
+    
+    static _SIMD_INL_ SIMD_Type_t Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<SubtractLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void SubtractInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<SubtractLane>(to.Data, to.Data, from.Data);
     }
     static _SIMD_INL_ void SubtractInplaceRaw(T_ElementType* to, const T_ElementType* from) {
-        /* Implementation will be specialized */
+        ApplyLanes<SubtractLane>(to, to, from);
     }
     
     static _SIMD_INL_ SIMD_Type_t Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {
-        static_assert(AssertFalse<T_ElementType>::value, "Multiplication is not supported for this type.");
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<MultiplyLane>(result.Data, a.Data, b.Data);
+        return result;
     }
     static _SIMD_INL_ void MultiplyInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
-        static_assert(AssertFalse<T_ElementType>::value, "Multiplication is not supported for this type.");
+        ApplyLanes<MultiplyLane>(to.Data, to.Data, from.Data);
     }
     static _SIMD_INL_ void MultiplyInplaceRaw(T_ElementType* to, const T_ElementType* from) {
-        static_assert(AssertFalse<T_ElementType>::value, "Multiplication is not supported for this type.");
+        ApplyLanes<MultiplyLane>(to, to, from);
     }
     static _SIMD_INL_ SIMD_Type_t Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {
-        static_assert(AssertFalse<T_ElementType>::value, "Division is not supported for this type.");
+        SIMD_Type_t result((NoCheck()));
+        DivideLanes(result.Data, a.Data, b.Data, std::is_integral<T_ElementType>());
+        return result;
     }
     static _SIMD_INL_ void DivideInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
-        static_assert(AssertFalse<T_ElementType>::value, "Division is not supported for this type.");
+        DivideLanes(to.Data, to.Data, from.Data, std::is_integral<T_ElementType>());
     }
     static _SIMD_INL_ void DivideInplaceRaw(T_ElementType* to, const T_ElementType* from) {
-        static_assert(AssertFalse<T_ElementType>::value, "Division is not supported for this type.");
+        DivideLanes(to, to, from, std::is_integral<T_ElementType>());
+    }
+    /* a * b + c and a * b - c with a single rounding, Inplace and Raw variants compute to = to * b + c */
+    static _SIMD_INL_ SIMD_Type_t FusedMultiplyAdd(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {
+        SIMD_Type_t result((NoCheck()));
+        FusedMultiplyAddLanes(result.Data, a.Data, b.Data, c.Data, T_ElementType(1));
+        return result;
+    }
+    static _SIMD_INL_ void FusedMultiplyAddInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c) {
+        FusedMultiplyAddLanes(to.Data, to.Data, b.Data, c.Data, T_ElementType(1));
+    }
+    static _SIMD_INL_ void FusedMultiplyAddInplaceRaw(T_ElementType* to, const T_ElementType* b, const T_ElementType* c) {
+        FusedMultiplyAddLanes(to, to, b, c, T_ElementType(1));
+    }
+    static _SIMD_INL_ SIMD_Type_t FusedMultiplySubtract(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {
+        SIMD_Type_t result((NoCheck()));
+        FusedMultiplyAddLanes(result.Data, a.Data, b.Data, c.Data, T_ElementType(-1));
+        return result;
+    }
+    static _SIMD_INL_ void FusedMultiplySubtractInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c) {
+        FusedMultiplyAddLanes(to.Data, to.Data, b.Data, c.Data, T_ElementType(-1));
+    }
+    static _SIMD_INL_ void FusedMultiplySubtractInplaceRaw(T_ElementType* to, const T_ElementType* b, const T_ElementType* c) {
+        FusedMultiplyAddLanes(to, to, b, c, T_ElementType(-1));
+    }
+    /* Saturating, averaging and absolute difference arithmetic of integer lanes. 8 and 16 bit lanes are
+       specialized below, the lane loops are the fallback for the wider ones */
+    /* a + b and a - b clamped to the range of the element type instead of wrapping around */
+    static _SIMD_INL_ SIMD_Type_t AddSaturate(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AddSaturateLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void AddSaturateInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AddSaturateLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AddSaturateInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AddSaturateLane>(to, to, from);
+    }
+    static _SIMD_INL_ SIMD_Type_t SubtractSaturate(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<SubtractSaturateLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void SubtractSaturateInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<SubtractSaturateLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void SubtractSaturateInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<SubtractSaturateLane>(to, to, from);
+    }
+    /* (a + b + 1) >> 1 without intermediate overflow */
+    static _SIMD_INL_ SIMD_Type_t Average(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AverageLane>(result.Data, a.Data, b.Data);
+        return result;
     }
+    static _SIMD_INL_ void AverageInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AverageLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AverageInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AverageLane>(to, to, from);
+    }
+    /* |a - b|, signed lanes hold the magnitude modulo 2^N so read them as unsigned when it can exceed the maximum */
+    static _SIMD_INL_ SIMD_Type_t AbsDiff(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AbsDiffLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void AbsDiffInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AbsDiffLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AbsDiffInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AbsDiffLane>(to, to, from);
+    }
+    /* Bitwise logic of integer lanes, AndNot(a, b) is a & ~b */
+    static _SIMD_INL_ SIMD_Type_t And(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AndLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void AndInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AndLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AndInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AndLane>(to, to, from);
+    }
+    static _SIMD_INL_ SIMD_Type_t Or(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<OrLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void OrInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<OrLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void OrInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<OrLane>(to, to, from);
+    }
+    static _SIMD_INL_ SIMD_Type_t Xor(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<XorLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void XorInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<XorLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void XorInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<XorLane>(to, to, from);
+    }
+    static _SIMD_INL_ SIMD_Type_t AndNot(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<AndNotLane>(result.Data, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ void AndNotInplace(SIMD_Type_t& to, const SIMD_Type_t& from) {
+        ApplyLanes<AndNotLane>(to.Data, to.Data, from.Data);
+    }
+    static _SIMD_INL_ void AndNotInplaceRaw(T_ElementType* to, const T_ElementType* from) {
+        ApplyLanes<AndNotLane>(to, to, from);
+    }
+    static _SIMD_INL_ SIMD_Type_t Not(const SIMD_Type_t& a) {
+        SIMD_Type_t ones((NoCheck()));
+        std::fill(ones.Data, ones.Data + ElementCount, static_cast<T_ElementType>(~T_ElementType(0)));
+        return Xor(a, ones);
+    }
+    /* Shifts of every lane by count, right shifts are arithmetic for signed and logical for unsigned lanes */
+    static _SIMD_INL_ SIMD_Type_t ShiftLeft(const SIMD_Type_t& a, unsigned int count) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<ShiftLeftLane>(result.Data, a.Data, count);
+        return result;
+    }
+    static _SIMD_INL_ void ShiftLeftInplace(SIMD_Type_t& to, unsigned int count) {
+        ApplyLanes<ShiftLeftLane>(to.Data, to.Data, count);
+    }
+    static _SIMD_INL_ void ShiftLeftInplaceRaw(T_ElementType* to, unsigned int count) {
+        ApplyLanes<ShiftLeftLane>(to, to, count);
+    }
+    static _SIMD_INL_ SIMD_Type_t ShiftRight(const SIMD_Type_t& a, unsigned int count) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<ShiftRightLane>(result.Data, a.Data, count);
+        return result;
+    }
+    static _SIMD_INL_ void ShiftRightInplace(SIMD_Type_t& to, unsigned int count) {
+        ApplyLanes<ShiftRightLane>(to.Data, to.Data, count);
+    }
+    static _SIMD_INL_ void ShiftRightInplaceRaw(T_ElementType* to, unsigned int count) {
+        ApplyLanes<ShiftRightLane>(to, to, count);
+    }
+    /* Shifts by a compile time count, which the specializations encode as an immediate */
+    template<unsigned int Count>
+    static _SIMD_INL_ SIMD_Type_t ShiftLeft(const SIMD_Type_t& a) {
+        static_assert(Count <= sizeof(T_ElementType) * 8, "The shift count exceeds the lane width.");
+        return ShiftLeft(a, Count);
+    }
+    template<unsigned int Count>
+    static _SIMD_INL_ SIMD_Type_t ShiftRight(const SIMD_Type_t& a) {
+        static_assert(Count <= sizeof(T_ElementType) * 8, "The shift count exceeds the lane width.");
+        return ShiftRight(a, Count);
+    }
+    /* Shifts of every lane by the count in the same lane of counts (sllv, srlv and srav) */
+    static _SIMD_INL_ SIMD_Type_t ShiftLeft(const SIMD_Type_t& a, const SIMD_Type_t& counts) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<ShiftLeftLane>(result.Data, a.Data, counts.Data);
+        return result;
+    }
+    static _SIMD_INL_ void ShiftLeftInplace(SIMD_Type_t& to, const SIMD_Type_t& counts) {
+        ApplyLanes<ShiftLeftLane>(to.Data, to.Data, counts.Data);
+    }
+    static _SIMD_INL_ void ShiftLeftInplaceRaw(T_ElementType* to, const T_ElementType* counts) {
+        ApplyLanes<ShiftLeftLane>(to, to, counts);
+    }
+    static _SIMD_INL_ SIMD_Type_t ShiftRight(const SIMD_Type_t& a, const SIMD_Type_t& counts) {
+        SIMD_Type_t result((NoCheck()));
+        ApplyLanes<ShiftRightLane>(result.Data, a.Data, counts.Data);
+        return result;
+    }
+    static _SIMD_INL_ void ShiftRightInplace(SIMD_Type_t& to, const SIMD_Type_t& counts) {
+        ApplyLanes<ShiftRightLane>(to.Data, to.Data, counts.Data);
+    }
+    static _SIMD_INL_ void ShiftRightInplaceRaw(T_ElementType* to, const T_ElementType* counts) {
+        ApplyLanes<ShiftRightLane>(to, to, counts);
+    }
+    /* Conversions into this type from a value of the same width. Widen splits the lanes of a into the low and high
+       half, each lane twice as wide, Narrow joins two values of twice as wide lanes and Convert changes the lane type
+       at the same lane count. Integer results saturate, floating point sources are truncated toward zero and NaN
+       lanes become 0 */
+    template<typename From>
+    static _SIMD_INL_ void Widen(const From& a, SIMD_Type_t& low, SIMD_Type_t& high) {
+        static_assert(From::BitWidth == Bits && From::ElementCount == ElementCount * 2, "Widen takes a value with twice as many lanes of half the width.");
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            low.Data[i] = ConvertLane<T_ElementType>(a.Data[i]);
+            high.Data[i] = ConvertLane<T_ElementType>(a.Data[i + ElementCount]);
+        }
+    }
+    template<typename From>
+    static _SIMD_INL_ SIMD_Type_t Narrow(const From& low, const From& high) {
+        static_assert(From::BitWidth == Bits && From::ElementCount * 2 == ElementCount, "Narrow takes two values with half as many lanes of twice the width.");
+        SIMD_Type_t result((NoCheck()));
+        for (unsigned int i = 0; i < From::ElementCount; i++)
+        {
+            result.Data[i] = ConvertLane<T_ElementType>(low.Data[i]);
+            result.Data[i + From::ElementCount] = ConvertLane<T_ElementType>(high.Data[i]);
+        }
+        return result;
+    }
+    template<typename From>
+    static _SIMD_INL_ SIMD_Type_t Convert(const From& a) {
+        static_assert(From::BitWidth == Bits && From::ElementCount == ElementCount, "Convert takes a value with the same number of lanes.");
+        SIMD_Type_t result((NoCheck()));
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            result.Data[i] = ConvertLane<T_ElementType>(a.Data[i]);
+        }
+        return result;
+    }
+    /* True when every lane compares equal, NaN lanes never do */
     static _SIMD_INL_ bool IsEqual(const SIMD_Type_t& a, const SIMD_Type_t& b) {
-        static_assert(AssertFalse<T_ElementType>::value, "Equality check is not supported for this type.");
+        return std::equal(a.Data, a.Data + ElementCount, b.Data);
     }
     static _SIMD_INL_ bool IsEqualInplaceRaw(T_ElementType* to, const T_ElementType* from) {
-        static_assert(AssertFalse<T_ElementType>::value, "Equality check is not supported for this type.");
+        return std::equal(to, to + ElementCount, from);
+    }
+    /* Lane wise comparisons, the lane loops are the fallback for the specializations below */
+    static _SIMD_INL_ MaskType CompareEq(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareLanes(a, b, std::equal_to<T_ElementType>());
+    }
+    static _SIMD_INL_ MaskType CompareNe(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareLanes(a, b, std::not_equal_to<T_ElementType>());
+    }
+    static _SIMD_INL_ MaskType CompareGt(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareLanes(a, b, std::greater<T_ElementType>());
+    }
+    static _SIMD_INL_ MaskType CompareLe(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareLanes(a, b, std::less_equal<T_ElementType>());
+    }
+    static _SIMD_INL_ MaskType CompareLt(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareGt(b, a);
+    }
+    static _SIMD_INL_ MaskType CompareGe(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return CompareLe(b, a);
+    }
+    /* Lanes of a where the mask is set and of b elsewhere */
+    static _SIMD_INL_ SIMD_Type_t Select(const MaskType& mask, const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        SIMD_Type_t result((NoCheck()));
+        LaneMask<Bits, sizeof(T_ElementType)>::Select(result.Data, mask, a.Data, b.Data);
+        return result;
+    }
+    static _SIMD_INL_ bool Any(const MaskType& mask) {
+        return LaneMask<Bits, sizeof(T_ElementType)>::Any(mask);
+    }
+    static _SIMD_INL_ bool All(const MaskType& mask) {
+        return LaneMask<Bits, sizeof(T_ElementType)>::All(mask);
+    }
+    static _SIMD_INL_ unsigned int CountTrue(const MaskType& mask) {
+        return LaneMask<Bits, sizeof(T_ElementType)>::CountTrue(mask);
+    }
+    /* Mask of the lanes below count, all lanes for counts of ElementCount or more. Loop tails run the masked
+       operations below under FirstN(remaining) instead of a scalar epilogue */
+    static _SIMD_INL_ MaskType FirstN(unsigned int count) {
+        MaskType mask = MaskType();
+        LaneMask<Bits, sizeof(T_ElementType)>::FirstN(mask, std::min(count, ElementCount));
+        return mask;
+    }
+    /* Masked arithmetic, lanes where the mask is clear keep the lane of src. The 512 bit types run the
+       instruction under the __mmask, the fallback computes every lane and blends with Select */
+    static _SIMD_INL_ SIMD_Type_t MaskedAdd(const MaskType& mask, const SIMD_Type_t& src, const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return Select(mask, Add(a, b), src);
+    }
+    static _SIMD_INL_ SIMD_Type_t MaskedSubtract(const MaskType& mask, const SIMD_Type_t& src, const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return Select(mask, Subtract(a, b), src);
+    }
+    static _SIMD_INL_ SIMD_Type_t MaskedMultiply(const MaskType& mask, const SIMD_Type_t& src, const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return Select(mask, Multiply(a, b), src);
+    }
+    /* Divisors of the inactive lanes are replaced by 1, so a zero there does not trap or raise a flag */
+    static _SIMD_INL_ SIMD_Type_t MaskedDivide(const MaskType& mask, const SIMD_Type_t& src, const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        return Select(mask, Divide(a, Select(mask, b, Broadcast(1))), src);
+    }
+    /* Reads the active lanes from unaligned memory, inactive lanes are 0 and their memory is never touched,
+       so a tail load does not fault past the end of a buffer */
+    static _SIMD_INL_ SIMD_Type_t MaskedLoad(const MaskType& mask, const T_ElementType* data) {
+        SIMD_Type_t result((NoCheck()));
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            result.Data[i] = LaneMask<Bits, sizeof(T_ElementType)>::Test(mask, i) ? data[i] : T_ElementType(0);
+        }
+        return result;
+    }
+    /* Writes the active lanes to unaligned memory, the memory of inactive lanes is left alone */
+    _SIMD_INL_ void MaskedStore(const MaskType& mask, T_ElementType* data) const {
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            if (LaneMask<Bits, sizeof(T_ElementType)>::Test(mask, i)) data[i] = Data[i];
+        }
+    }
+    /* Active lanes of a moved down to the lowest lanes in order, the lanes above are 0 */
+    static _SIMD_INL_ SIMD_Type_t Compress(const MaskType& mask, const SIMD_Type_t& a) {
+        SIMD_Type_t result((NoCheck()));
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            if (LaneMask<Bits, sizeof(T_ElementType)>::Test(mask, i)) result.Data[count++] = a.Data[i];
+        }
+        std::fill(result.Data + count, result.Data + ElementCount, T_ElementType(0));
+        return result;
+    }
+    /* The inverse of Compress, the lowest lanes of a are moved up to the active lanes in order and the inactive lanes are 0 */
+    static _SIMD_INL_ SIMD_Type_t Expand(const MaskType& mask, const SIMD_Type_t& a) {
+        SIMD_Type_t result((NoCheck()));
+        unsigned int count = 0;
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            result.Data[i] = LaneMask<Bits, sizeof(T_ElementType)>::Test(mask, i) ? a.Data[count++] : T_ElementType(0);
+        }
+        return result;
+    }
+    /* Writes the active lanes contiguously to unaligned memory and returns how many were written, e.g. to filter a stream */
+    _SIMD_INL_ unsigned int CompressStore(const MaskType& mask, T_ElementType* data) const {
+        const unsigned int count = CountTrue(mask);
+        Compress(mask, *this).MaskedStore(FirstN(count), data);
+        return count;
+    }
+    /* Horizontal reductions across the lanes, the lane loops are the fallback for the specializations below.
+       Products of 64 bit integer lanes only have a kernel in 512 bit registers */
+    static _SIMD_INL_ ReduceType ReduceSum(const SIMD_Type_t& a) {
+        ReduceType result = 0;
+        for (unsigned int i = 0; i < ElementCount; i++) result += a.Data[i];
+        return result;
+    }
+    static _SIMD_INL_ ReduceType ReduceProduct(const SIMD_Type_t& a) {
+        ReduceType result = 1;
+        for (unsigned int i = 0; i < ElementCount; i++) result *= a.Data[i];
+        return result;
+    }
+    static _SIMD_INL_ T_ElementType ReduceMin(const SIMD_Type_t& a) {
+        return *std::min_element(a.Data, a.Data + ElementCount);
+    }
+    static _SIMD_INL_ T_ElementType ReduceMax(const SIMD_Type_t& a) {
+        return *std::max_element(a.Data, a.Data + ElementCount);
+    }
+    /* Elementary functions of float and double lanes. The 256 (with AVX2) and 512 bit specializations evaluate
+       the kernels in Math, the lane loops over the C library are the fallback */
+    static _SIMD_INL_ SIMD_Type_t Exp(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::exp(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t Log(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::log(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t Sin(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::sin(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t Cos(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::cos(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t Tanh(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::tanh(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t Sqrt(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return std::sqrt(v); });
+    }
+    static _SIMD_INL_ SIMD_Type_t RSqrt(const SIMD_Type_t& a) {
+        return MapLanes(a, [](T_ElementType v) { return T_ElementType(1) / std::sqrt(v); });
+    }
+    /* a to the power of b, lane wise */
+    static _SIMD_INL_ SIMD_Type_t Pow(const SIMD_Type_t& a, const SIMD_Type_t& b) {
+        static_assert(std::is_floating_point<T_ElementType>::value, "Elementary functions are only supported for float and double lanes.");
+        SIMD_Type_t result((NoCheck()));
+        for (unsigned int i = 0; i < ElementCount; i++) result.Data[i] = std::pow(a.Data[i], b.Data[i]);
+        return result;
     }
     
     _SIMD_INL_ SIMD_Type_t operator+(const SIMD_Type_t& other) const
@@ -677,17 +1777,79 @@ public:
     {
         DivideInplace(*this, other);
     }
+    _SIMD_INL_ SIMD_Type_t operator&(const SIMD_Type_t& other) const
+    {
+        return And(*this, other);
+    }
+    _SIMD_INL_ SIMD_Type_t operator|(const SIMD_Type_t& other) const
+    {
+        return Or(*this, other);
+    }
+    _SIMD_INL_ SIMD_Type_t operator^(const SIMD_Type_t& other) const
+    {
+        return Xor(*this, other);
+    }
+    _SIMD_INL_ SIMD_Type_t operator~() const
+    {
+        return Not(*this);
+    }
+    _SIMD_INL_ SIMD_Type_t operator<<(unsigned int count) const
+    {
+        return ShiftLeft(*this, count);
+    }
+    _SIMD_INL_ SIMD_Type_t operator>>(unsigned int count) const
+    {
+        return ShiftRight(*this, count);
+    }
+    _SIMD_INL_ SIMD_Type_t operator<<(const SIMD_Type_t& counts) const
+    {
+        return ShiftLeft(*this, counts);
+    }
+    _SIMD_INL_ SIMD_Type_t operator>>(const SIMD_Type_t& counts) const
+    {
+        return ShiftRight(*this, counts);
+    }
+    _SIMD_INL_ void operator&=(const SIMD_Type_t& other)
+    {
+        AndInplace(*this, other);
+    }
+    _SIMD_INL_ void operator|=(const SIMD_Type_t& other)
+    {
+        OrInplace(*this, other);
+    }
+    _SIMD_INL_ void operator^=(const SIMD_Type_t& other)
+    {
+        XorInplace(*this, other);
+    }
+    _SIMD_INL_ void operator<<=(unsigned int count)
+    {
+        ShiftLeftInplace(*this, count);
+    }
+    _SIMD_INL_ void operator>>=(unsigned int count)
+    {
+        ShiftRightInplace(*this, count);
+    }
     _SIMD_INL_ bool operator==(const SIMD_Type_t& other) const
     {
         return IsEqual(*this, other);
     }
     _SIMD_INL_ T_ElementType& operator[](unsigned int index)
     {
-        return *(reinterpret_cast<T_ElementType*>(Data) + index);
+        return Data[index];
     }
 
 };
 
+/* Out of class definitions, C++11 needs them once the constants are bound to references (EXPECT_EQ, std::min) */
+template<typename ContainerType, int Bits, typename T_ElementType, typename V, typename W>
+constexpr unsigned int SIMD_Type_t<ContainerType, Bits, T_ElementType, V, W>::BitWidth;
+template<typename ContainerType, int Bits, typename T_ElementType, typename V, typename W>
+constexpr unsigned int SIMD_Type_t<ContainerType, Bits, T_ElementType, V, W>::SizeBytes;
+template<typename ContainerType, int Bits, typename T_ElementType, typename V, typename W>
+constexpr unsigned int SIMD_Type_t<ContainerType, Bits, T_ElementType, V, W>::Alignment;
+template<typename ContainerType, int Bits, typename T_ElementType, typename V, typename W>
+constexpr unsigned int SIMD_Type_t<ContainerType, Bits, T_ElementType, V, W>::ElementCount;
+
 #define DECLARE_SIMD_USE_TYPE_INT(TYPE, XXX) \
 namespace BASIC_SIMD_NAMESPACE \
  {\
@@ -701,6 +1863,17 @@ namespace BASIC_SIMD_NAMESPACE \
     using TYPE##_##XXX = SIMD_Type_t<TYPE, XXX, TYPE>; \
  }
 
+// Every register type is declared whatever the compile time ISA. The kernels below are specialized for the
+// instruction sets the build targets, registers without them run the lane loops of SIMD_Type_t, so code using
+// float_256 or int_512 still compiles and runs in a baseline build.
+DECLARE_SIMD_USE_TYPE_INT(int, 128);
+DECLARE_SIMD_USE_TYPE_INT(int, 256);
+DECLARE_SIMD_USE_TYPE_INT(int, 512);
+DECLARE_SIMD_USE_TYPE_FLOATING(float, 256);
+DECLARE_SIMD_USE_TYPE_FLOATING(double, 256);
+DECLARE_SIMD_USE_TYPE_FLOATING(float, 512);
+DECLARE_SIMD_USE_TYPE_FLOATING(double, 512);
+
 // ██╗███╗   ██╗████████╗    ██╗██████╗  █████╗ 
 // ██║████╗  ██║╚══██╔══╝   ███║╚════██╗██╔══██╗
 // ██║██╔██╗ ██║   ██║█████╗╚██║ █████╔╝╚█████╔╝
@@ -711,13 +1884,13 @@ namespace BASIC_SIMD_NAMESPACE \
 #define CREATE_INT128_OPERATOR_PLUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, int##XX##_t> SIMD_Type_t<int, 128, int##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t<int, 128, int##XX##_t> result;\
+    SIMD_Type_t<int, 128, int##XX##_t> result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_add_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, uint##XX##_t> SIMD_Type_t<int, 128,uint##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t<int, 128, uint##XX##_t> result;\
+    SIMD_Type_t<int, 128, uint##XX##_t> result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_add_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
@@ -745,13 +1918,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 128, uint##XX##_t>::AddInplaceRaw(uint##XX##_t*
 #define CREATE_INT128_OPERATOR_MINUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, int##XX##_t> SIMD_Type_t<int, 128, int##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_sub_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, uint##XX##_t> SIMD_Type_t<int, 128,uint##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_sub_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
@@ -779,13 +1952,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 128, uint##XX##_t>::SubtractInplaceRaw(uint##XX
 #define CREATE_INT128_OPERATOR_MULTIPLY(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, int##XX##_t> SIMD_Type_t<int, 128, int##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_mullo_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, uint##XX##_t> SIMD_Type_t<int, 128,uint##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_mullo_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
@@ -813,13 +1986,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 128, uint##XX##_t>::MultiplyInplaceRaw(uint##XX
 #define CREATE_INT128_OPERATOR_DIVIDE(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, int##XX##_t> SIMD_Type_t<int, 128, int##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_div_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 128, uint##XX##_t> SIMD_Type_t<int, 128,uint##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm_store_si128((__m128i*)result.Data, _mm_div_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
     return result;\
 }\
@@ -862,7 +2035,53 @@ _SIMD_INL_ bool SIMD_Type_t<int, 128, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
     return _mm_movemask_epi8(_mm_cmpeq_epi##XX(_mm_load_si128((__m128i*)to), _mm_load_si128((__m128i*)from))) == 0xFFFF;\
 }
 
-
+#define CREATE_INT128_OPERATOR_REDUCE(XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, int##XX##_t>::ReduceType SIMD_Type_t<int, 128, int##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumI##XX(_mm_load_si128((__m128i*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, uint##XX##_t>::ReduceType SIMD_Type_t<int, 128, uint##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumU##XX(_mm_load_si128((__m128i*)a.Data));\
+}
+
+#define CREATE_INT128_COMPARE(T, XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, T>::MaskType SIMD_Type_t<int, 128, T>::CompareEq(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm_store_si128((__m128i*)result.Data, _mm_cmpeq_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, T>::MaskType SIMD_Type_t<int, 128, T>::CompareNe(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm_store_si128((__m128i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Not(_mm_cmpeq_epi##XX(_mm_load_si128((__m128i*)a.Data), _mm_load_si128((__m128i*)b.Data))));\
+    return result;\
+}
+
+// KEY maps the lanes to signed order for cmpgt, unsigned lanes get their sign bit flipped
+#define CREATE_INT128_ORDER(T, XX, KEY) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, T>::MaskType SIMD_Type_t<int, 128, T>::CompareGt(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm_store_si128((__m128i*)result.Data, _mm_cmpgt_epi##XX(KEY(_mm_load_si128((__m128i*)a.Data)), KEY(_mm_load_si128((__m128i*)b.Data))));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 128, T>::MaskType SIMD_Type_t<int, 128, T>::CompareLe(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm_store_si128((__m128i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Not(_mm_cmpgt_epi##XX(KEY(_mm_load_si128((__m128i*)a.Data)), KEY(_mm_load_si128((__m128i*)b.Data)))));\
+    return result;\
+}
+
+#define CREATE_INT128_OPERATOR_COMPARE(XX) \
+CREATE_INT128_COMPARE(int##XX##_t, XX) \
+CREATE_INT128_COMPARE(uint##XX##_t, XX)
+
+#define CREATE_INT128_OPERATOR_ORDER(XX) \
+CREATE_INT128_ORDER(int##XX##_t, XX, ) \
+CREATE_INT128_ORDER(uint##XX##_t, XX, BASIC_SIMD_NAMESPACE::Lanes::FlipSign##XX)
+
 // ██╗███╗   ██╗████████╗   ██████╗ ███████╗ ██████╗ 
 // ██║████╗  ██║╚══██╔══╝   ╚════██╗██╔════╝██╔════╝ 
 // ██║██╔██╗ ██║   ██║█████╗ █████╔╝███████╗███████╗ 
@@ -874,13 +2093,13 @@ _SIMD_INL_ bool SIMD_Type_t<int, 128, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
 #define CREATE_INT256_OPERATOR_PLUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, int##XX##_t> SIMD_Type_t<int, 256, int##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_add_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, uint##XX##_t> SIMD_Type_t<int, 256, uint##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_add_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
@@ -908,13 +2127,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 256, uint##XX##_t>::AddInplaceRaw(uint##XX##_t*
 #define CREATE_INT256_OPERATOR_MINUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, int##XX##_t> SIMD_Type_t<int, 256, int##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_sub_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, uint##XX##_t> SIMD_Type_t<int, 256, uint##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_sub_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
@@ -942,13 +2161,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 256, uint##XX##_t>::SubtractInplaceRaw(uint##XX
 #define CREATE_INT256_OPERATOR_MULTIPLY(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, int##XX##_t> SIMD_Type_t<int, 256, int##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_mullo_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, uint##XX##_t> SIMD_Type_t<int, 256,uint##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_mullo_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
@@ -976,13 +2195,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 256, uint##XX##_t>::MultiplyInplaceRaw(uint##XX
 #define CREATE_INT256_OPERATOR_DIVIDE(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, int##XX##_t> SIMD_Type_t<int, 256, int##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_div_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 256, uint##XX##_t> SIMD_Type_t<int, 256,uint##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm256_store_si256((__m256i*)result.Data, _mm256_div_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
     return result;\
 }\
@@ -1025,6 +2244,53 @@ _SIMD_INL_ bool SIMD_Type_t<int, 256, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
     return _mm256_movemask_epi8(_mm256_cmpeq_epi##XX(_mm256_load_si256((__m256i*)to), _mm256_load_si256((__m256i*)from))) == 0xFFFFFFFF;\
 }
 
+#define CREATE_INT256_OPERATOR_REDUCE(XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, int##XX##_t>::ReduceType SIMD_Type_t<int, 256, int##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumI##XX(_mm256_load_si256((__m256i*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, uint##XX##_t>::ReduceType SIMD_Type_t<int, 256, uint##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumU##XX(_mm256_load_si256((__m256i*)a.Data));\
+}
+
+#define CREATE_INT256_COMPARE(T, XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, T>::MaskType SIMD_Type_t<int, 256, T>::CompareEq(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_si256((__m256i*)result.Data, _mm256_cmpeq_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, T>::MaskType SIMD_Type_t<int, 256, T>::CompareNe(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_si256((__m256i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Not(_mm256_cmpeq_epi##XX(_mm256_load_si256((__m256i*)a.Data), _mm256_load_si256((__m256i*)b.Data))));\
+    return result;\
+}
+
+// KEY maps the lanes to signed order for cmpgt, unsigned lanes get their sign bit flipped
+#define CREATE_INT256_ORDER(T, XX, KEY) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, T>::MaskType SIMD_Type_t<int, 256, T>::CompareGt(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_si256((__m256i*)result.Data, _mm256_cmpgt_epi##XX(KEY(_mm256_load_si256((__m256i*)a.Data)), KEY(_mm256_load_si256((__m256i*)b.Data))));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 256, T>::MaskType SIMD_Type_t<int, 256, T>::CompareLe(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_si256((__m256i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Not(_mm256_cmpgt_epi##XX(KEY(_mm256_load_si256((__m256i*)a.Data)), KEY(_mm256_load_si256((__m256i*)b.Data)))));\
+    return result;\
+}
+
+#define CREATE_INT256_OPERATOR_COMPARE(XX) \
+CREATE_INT256_COMPARE(int##XX##_t, XX) \
+CREATE_INT256_COMPARE(uint##XX##_t, XX)
+
+#define CREATE_INT256_OPERATOR_ORDER(XX) \
+CREATE_INT256_ORDER(int##XX##_t, XX, ) \
+CREATE_INT256_ORDER(uint##XX##_t, XX, BASIC_SIMD_NAMESPACE::Lanes::FlipSign##XX)
+
 // ██╗███╗   ██╗████████╗   ███████╗ ██╗██████╗ 
 // ██║████╗  ██║╚══██╔══╝   ██╔════╝███║╚════██╗
 // ██║██╔██╗ ██║   ██║█████╗███████╗╚██║ █████╔╝
@@ -1036,13 +2302,13 @@ _SIMD_INL_ bool SIMD_Type_t<int, 256, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
 #define CREATE_INT512_OPERATOR_PLUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t> SIMD_Type_t<int, 512, int##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_add_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t> SIMD_Type_t<int, 512, uint##XX##_t>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_add_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
@@ -1070,13 +2336,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::AddInplaceRaw(uint##XX##_t*
 #define CREATE_INT512_OPERATOR_MINUS(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t> SIMD_Type_t<int, 512, int##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_sub_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t> SIMD_Type_t<int, 512, uint##XX##_t>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_sub_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
@@ -1104,13 +2370,13 @@ _SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::SubtractInplaceRaw(uint##XX
 #define CREATE_INT512_OPERATOR_MULTIPLY(XX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t> SIMD_Type_t<int, 512, int##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
 template<>\
 _SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t> SIMD_Type_t<int, 512,uint##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm512_store_si512((__m512i*)result.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
@@ -1137,36 +2403,36 @@ _SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::MultiplyInplaceRaw(uint##XX
 
 #define CREATE_INT512_OPERATOR_DIVIDE(XX) \
 template<>\
-_SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t> SIMD_Type_t<int, 512, int##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
-    _mm512_store_si512((__m512i*)result.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
+_SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t> SIMD_Type_t<int, 512, int##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_si512((__m512i*)result.Data, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
 template<>\
-_SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t> SIMD_Type_t<int, 512,uint##XX##_t>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
-    _mm512_store_si512((__m512i*)result.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
+_SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t> SIMD_Type_t<int, 512,uint##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_si512((__m512i*)result.Data, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data)));\
     return result;\
 }\
 template<>\
-_SIMD_INL_ void SIMD_Type_t<int, 512, int##XX##_t>::MultiplyInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
+_SIMD_INL_ void SIMD_Type_t<int, 512, int##XX##_t>::DivideInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
 {\
-    _mm512_store_si512((__m512i*)to.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)to.Data), _mm512_load_si512((__m512i*)from.Data)));\
+    _mm512_store_si512((__m512i*)to.Data, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)to.Data), _mm512_load_si512((__m512i*)from.Data)));\
 }\
 template<>\
-_SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::MultiplyInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
+_SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::DivideInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
 {\
-    _mm512_store_si512((__m512i*)to.Data, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)to.Data), _mm512_load_si512((__m512i*)from.Data)));\
+    _mm512_store_si512((__m512i*)to.Data, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)to.Data), _mm512_load_si512((__m512i*)from.Data)));\
 }\
 template<>\
-_SIMD_INL_ void SIMD_Type_t<int, 512, int##XX##_t>::MultiplyInplaceRaw(int##XX##_t* to, const int##XX##_t* from)\
+_SIMD_INL_ void SIMD_Type_t<int, 512, int##XX##_t>::DivideInplaceRaw(int##XX##_t* to, const int##XX##_t* from)\
 {\
-    _mm512_store_si512((__m512i*)to, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)to), _mm512_load_si512((__m512i*)from)));\
+    _mm512_store_si512((__m512i*)to, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)to), _mm512_load_si512((__m512i*)from)));\
 }\
 template<>\
-_SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::MultiplyInplaceRaw(uint##XX##_t* to, const uint##XX##_t* from)\
+_SIMD_INL_ void SIMD_Type_t<int, 512, uint##XX##_t>::DivideInplaceRaw(uint##XX##_t* to, const uint##XX##_t* from)\
 {\
-    _mm512_store_si512((__m512i*)to, _mm512_mullo_epi##XX(_mm512_load_si512((__m512i*)to), _mm512_load_si512((__m512i*)from)));\
+    _mm512_store_si512((__m512i*)to, _mm512_div_epi##XX(_mm512_load_si512((__m512i*)to), _mm512_load_si512((__m512i*)from)));\
 }
 
 #define CREATE_INT512_OPERATOR_EQUAL(XX) \
@@ -1187,6 +2453,32 @@ _SIMD_INL_ bool SIMD_Type_t<int, 512, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
     return _mm512_movemask_epi8(_mm512_cmpeq_epi##XX(_mm512_load_si512((__m512i*)to), _mm512_load_si512((__m512i*)from))) == 0xFFFF;\
 }
 
+#define CREATE_INT512_OPERATOR_REDUCE(XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 512, int##XX##_t>::ReduceType SIMD_Type_t<int, 512, int##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumI##XX(_mm512_load_si512((__m512i*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 512, uint##XX##_t>::ReduceType SIMD_Type_t<int, 512, uint##XX##_t>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::SumU##XX(_mm512_load_si512((__m512i*)a.Data));\
+}
+
+#define CREATE_INT512_COMPARE(T, SU, XX, NAME, PREDICATE) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, 512, T>::MaskType SIMD_Type_t<int, 512, T>::Compare##NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    return _mm512_cmp_ep##SU##XX##_mask(_mm512_load_si512((__m512i*)a.Data), _mm512_load_si512((__m512i*)b.Data), PREDICATE);\
+}
+
+#define CREATE_INT512_OPERATOR_COMPARE(XX) \
+CREATE_INT512_COMPARE(int##XX##_t, i, XX, Eq, _MM_CMPINT_EQ) \
+CREATE_INT512_COMPARE(int##XX##_t, i, XX, Ne, _MM_CMPINT_NE) \
+CREATE_INT512_COMPARE(int##XX##_t, i, XX, Gt, _MM_CMPINT_NLE) \
+CREATE_INT512_COMPARE(int##XX##_t, i, XX, Le, _MM_CMPINT_LE) \
+CREATE_INT512_COMPARE(uint##XX##_t, u, XX, Eq, _MM_CMPINT_EQ) \
+CREATE_INT512_COMPARE(uint##XX##_t, u, XX, Ne, _MM_CMPINT_NE) \
+CREATE_INT512_COMPARE(uint##XX##_t, u, XX, Gt, _MM_CMPINT_NLE) \
+CREATE_INT512_COMPARE(uint##XX##_t, u, XX, Le, _MM_CMPINT_LE)
+
 //  ███████╗ ██╗       ██████╗   █████╗  ████████╗
 //  ██╔════╝ ██║      ██╔══ ██╗ ██╔══██╗ ╚══██╔══╝
 //  █████╗   ██║      ██║   ██║ ███████║    ██║   
@@ -1197,7 +2489,7 @@ _SIMD_INL_ bool SIMD_Type_t<int, 512, uint##XX##_t>::IsEqualInplaceRaw(uint##XX#
 #define CREATE_FLOAT_OPERATOR_PLUS(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_add_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)));\
     return result;\
 }\
@@ -1216,7 +2508,7 @@ _SIMD_INL_ void SIMD_Type_t<float, XXX, float>::AddInplaceRaw(float* to, const f
 #define CREATE_FLOAT_OPERATOR_MINUS(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_sub_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)));\
     return result;\
 }\
@@ -1234,7 +2526,7 @@ _SIMD_INL_ void SIMD_Type_t<float, XXX, float>::SubtractInplaceRaw(float* to, co
 #define CREATE_FLOAT_OPERATOR_MULTIPLY(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_mul_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)));\
     return result;\
 }\
@@ -1252,7 +2544,7 @@ _SIMD_INL_ void SIMD_Type_t<float, XXX, float>::MultiplyInplaceRaw(float* to, co
 #define CREATE_FLOAT_OPERATOR_DIVIDE(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_div_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)));\
     return result;\
 }\
@@ -1270,15 +2562,84 @@ _SIMD_INL_ void SIMD_Type_t<float, XXX, float>::DivideInplaceRaw(float* to, cons
 #define CREATE_FLOAT_OPERATOR_EQUAL(XXX) \
 template<>\
 _SIMD_INL_ bool SIMD_Type_t<float, XXX, float>::IsEqual(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    return _mm##XXX##_cmpeq_ps_mask(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)) == 0xFFFFFFFFFFFFFFFF;\
+    return _mm##XXX##_cmpeq_ps_mask(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data)) == ((1u << ElementCount) - 1);\
 }\
 template<>\
 _SIMD_INL_ bool SIMD_Type_t<float, XXX, float>::IsEqualInplaceRaw(float* to, const float* from) {\
-    return _mm##XXX##_cmpeq_ps_mask(_mm##XXX##_load_ps((float*)to), _mm##XXX##_load_ps((float*)from)) == 0xFFFFFFFFFFFFFFFF;\
+    return _mm##XXX##_cmpeq_ps_mask(_mm##XXX##_load_ps((float*)to), _mm##XXX##_load_ps((float*)from)) == ((1u << ElementCount) - 1);\
+}
+
+#define CREATE_FLOAT_OPERATOR_REDUCE(XXX) \
+template<>\
+_SIMD_INL_ float SIMD_Type_t<float, XXX, float>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Sum(_mm##XXX##_load_ps((float*)a.Data));\
 }\
 template<>\
-_SIMD_INL_ bool SIMD_Type_t<float, XXX, float>::IsEqualInplaceRaw(float* to, const float* from) {\
-    return _mm##XXX##_cmpeq_ps_mask(_mm##XXX##_load_ps((float*)to), _mm##XXX##_load_ps((float*)from)) == 0xFFFFFFFFFFFFFFFF;\
+_SIMD_INL_ float SIMD_Type_t<float, XXX, float>::ReduceProduct(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Product(_mm##XXX##_load_ps((float*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ float SIMD_Type_t<float, XXX, float>::ReduceMin(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Min(_mm##XXX##_load_ps((float*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ float SIMD_Type_t<float, XXX, float>::ReduceMax(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Max(_mm##XXX##_load_ps((float*)a.Data));\
+}
+
+// Ordered predicates, NaN lanes compare false except for Ne
+#define CREATE_FLOAT_COMPARE_256(NAME, PREDICATE) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<float, 256, float>::MaskType SIMD_Type_t<float, 256, float>::Compare##NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_ps((float*)result.Data, _mm256_cmp_ps(_mm256_load_ps((float*)a.Data), _mm256_load_ps((float*)b.Data), PREDICATE));\
+    return result;\
+}
+
+#define CREATE_FLOAT_COMPARE_512(NAME, PREDICATE) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<float, 512, float>::MaskType SIMD_Type_t<float, 512, float>::Compare##NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    return _mm512_cmp_ps_mask(_mm512_load_ps((float*)a.Data), _mm512_load_ps((float*)b.Data), PREDICATE);\
+}
+
+#define CREATE_FLOAT_OPERATOR_COMPARE(XXX) \
+CREATE_FLOAT_COMPARE_##XXX(Eq, _CMP_EQ_OQ) \
+CREATE_FLOAT_COMPARE_##XXX(Ne, _CMP_NEQ_UQ) \
+CREATE_FLOAT_COMPARE_##XXX(Gt, _CMP_GT_OQ) \
+CREATE_FLOAT_COMPARE_##XXX(Le, _CMP_LE_OQ)
+
+#define CREATE_FLOAT_OPERATOR_FMA(XXX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::FusedMultiplyAdd(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_fmadd_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data), _mm##XXX##_load_ps((float*)c.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<float, XXX, float>::FusedMultiplyAddInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c)\
+{\
+    _mm##XXX##_store_ps((float*)to.Data, _mm##XXX##_fmadd_ps(_mm##XXX##_load_ps((float*)to.Data), _mm##XXX##_load_ps((float*)b.Data), _mm##XXX##_load_ps((float*)c.Data)));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<float, XXX, float>::FusedMultiplyAddInplaceRaw(float* to, const float* b, const float* c)\
+{\
+    _mm##XXX##_store_ps((float*)to, _mm##XXX##_fmadd_ps(_mm##XXX##_load_ps((float*)to), _mm##XXX##_load_ps((float*)b), _mm##XXX##_load_ps((float*)c)));\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::FusedMultiplySubtract(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_ps((float*)result.Data, _mm##XXX##_fmsub_ps(_mm##XXX##_load_ps((float*)a.Data), _mm##XXX##_load_ps((float*)b.Data), _mm##XXX##_load_ps((float*)c.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<float, XXX, float>::FusedMultiplySubtractInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c)\
+{\
+    _mm##XXX##_store_ps((float*)to.Data, _mm##XXX##_fmsub_ps(_mm##XXX##_load_ps((float*)to.Data), _mm##XXX##_load_ps((float*)b.Data), _mm##XXX##_load_ps((float*)c.Data)));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<float, XXX, float>::FusedMultiplySubtractInplaceRaw(float* to, const float* b, const float* c)\
+{\
+    _mm##XXX##_store_ps((float*)to, _mm##XXX##_fmsub_ps(_mm##XXX##_load_ps((float*)to), _mm##XXX##_load_ps((float*)b), _mm##XXX##_load_ps((float*)c)));\
 }
 
 
@@ -1292,7 +2653,7 @@ _SIMD_INL_ bool SIMD_Type_t<float, XXX, float>::IsEqualInplaceRaw(float* to, con
 #define CREATE_DOUBLE_OPERATOR_PLUS(XXX)\
 template<>\
 _SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::Add(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_add_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)));\
     return result;\
 }\
@@ -1310,7 +2671,7 @@ _SIMD_INL_ void SIMD_Type_t<double, XXX, double>::AddInplaceRaw(double* to, cons
 #define CREATE_DOUBLE_OPERATOR_MINUS(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::Subtract(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_sub_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)));\
     return result;\
 }\
@@ -1328,7 +2689,7 @@ _SIMD_INL_ void SIMD_Type_t<double, XXX, double>::SubtractInplaceRaw(double* to,
 #define CREATE_DOUBLE_OPERATOR_MULTIPLY(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::Multiply(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_mul_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)));\
     return result;\
 }\
@@ -1346,7 +2707,7 @@ _SIMD_INL_ void SIMD_Type_t<double, XXX, double>::MultiplyInplaceRaw(double* to,
 #define CREATE_DOUBLE_OPERATOR_DIVIDE(XXX) \
 template<>\
 _SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    SIMD_Type_t result;\
+    SIMD_Type_t result((NoCheck()));\
     _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_div_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)));\
     return result;\
 }\
@@ -1364,17 +2725,133 @@ _SIMD_INL_ void SIMD_Type_t<double, XXX, double>::DivideInplaceRaw(double* to, c
 #define CREATE_DOUBLE_OPERATOR_EQUAL(XXX) \
 template<>\
 _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqual(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
-    return _mm##XXX##_cmpeq_pd_mask(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)) == 0xFFFFFFFFFFFFFFFF;\
+    return _mm##XXX##_cmpeq_pd_mask(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data)) == ((1u << ElementCount) - 1);\
 }\
 template<>\
 _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to, const double* from) {\
-    return _mm##XXX##_cmpeq_pd_mask(_mm##XXX##_load_pd((double*)to), _mm##XXX##_load_pd((double*)from)) == 0xFFFFFFFFFFFFFFFF;\
+    return _mm##XXX##_cmpeq_pd_mask(_mm##XXX##_load_pd((double*)to), _mm##XXX##_load_pd((double*)from)) == ((1u << ElementCount) - 1);\
+}
+
+#define CREATE_DOUBLE_OPERATOR_REDUCE(XXX) \
+template<>\
+_SIMD_INL_ double SIMD_Type_t<double, XXX, double>::ReduceSum(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Sum(_mm##XXX##_load_pd((double*)a.Data));\
 }\
 template<>\
-_SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to, const double* from) {\
-    return _mm##XXX##_cmpeq_pd_mask(_mm##XXX##_load_pd((double*)to), _mm##XXX##_load_pd((double*)from)) == 0xFFFFFFFFFFFFFFFF;\
+_SIMD_INL_ double SIMD_Type_t<double, XXX, double>::ReduceProduct(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Product(_mm##XXX##_load_pd((double*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ double SIMD_Type_t<double, XXX, double>::ReduceMin(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Min(_mm##XXX##_load_pd((double*)a.Data));\
+}\
+template<>\
+_SIMD_INL_ double SIMD_Type_t<double, XXX, double>::ReduceMax(const SIMD_Type_t& a) {\
+    return BASIC_SIMD_NAMESPACE::Horizontal::Max(_mm##XXX##_load_pd((double*)a.Data));\
+}
+
+// Ordered predicates, NaN lanes compare false except for Ne
+#define CREATE_DOUBLE_COMPARE_256(NAME, PREDICATE) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<double, 256, double>::MaskType SIMD_Type_t<double, 256, double>::Compare##NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    MaskType result((NoCheck()));\
+    _mm256_store_pd((double*)result.Data, _mm256_cmp_pd(_mm256_load_pd((double*)a.Data), _mm256_load_pd((double*)b.Data), PREDICATE));\
+    return result;\
+}
+
+#define CREATE_DOUBLE_COMPARE_512(NAME, PREDICATE) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<double, 512, double>::MaskType SIMD_Type_t<double, 512, double>::Compare##NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    return _mm512_cmp_pd_mask(_mm512_load_pd((double*)a.Data), _mm512_load_pd((double*)b.Data), PREDICATE);\
+}
+
+#define CREATE_DOUBLE_OPERATOR_COMPARE(XXX) \
+CREATE_DOUBLE_COMPARE_##XXX(Eq, _CMP_EQ_OQ) \
+CREATE_DOUBLE_COMPARE_##XXX(Ne, _CMP_NEQ_UQ) \
+CREATE_DOUBLE_COMPARE_##XXX(Gt, _CMP_GT_OQ) \
+CREATE_DOUBLE_COMPARE_##XXX(Le, _CMP_LE_OQ)
+
+#define CREATE_DOUBLE_OPERATOR_FMA(XXX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::FusedMultiplyAdd(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_fmadd_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data), _mm##XXX##_load_pd((double*)c.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::FusedMultiplyAddInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c)\
+{\
+    _mm##XXX##_store_pd((double*)to.Data, _mm##XXX##_fmadd_pd(_mm##XXX##_load_pd((double*)to.Data), _mm##XXX##_load_pd((double*)b.Data), _mm##XXX##_load_pd((double*)c.Data)));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::FusedMultiplyAddInplaceRaw(double* to, const double* b, const double* c)\
+{\
+    _mm##XXX##_store_pd((double*)to, _mm##XXX##_fmadd_pd(_mm##XXX##_load_pd((double*)to), _mm##XXX##_load_pd((double*)b), _mm##XXX##_load_pd((double*)c)));\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<double, XXX, double> SIMD_Type_t<double, XXX, double>::FusedMultiplySubtract(const SIMD_Type_t& a, const SIMD_Type_t& b, const SIMD_Type_t& c) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_pd((double*)result.Data, _mm##XXX##_fmsub_pd(_mm##XXX##_load_pd((double*)a.Data), _mm##XXX##_load_pd((double*)b.Data), _mm##XXX##_load_pd((double*)c.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::FusedMultiplySubtractInplace(SIMD_Type_t& to, const SIMD_Type_t& b, const SIMD_Type_t& c)\
+{\
+    _mm##XXX##_store_pd((double*)to.Data, _mm##XXX##_fmsub_pd(_mm##XXX##_load_pd((double*)to.Data), _mm##XXX##_load_pd((double*)b.Data), _mm##XXX##_load_pd((double*)c.Data)));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::FusedMultiplySubtractInplaceRaw(double* to, const double* b, const double* c)\
+{\
+    _mm##XXX##_store_pd((double*)to, _mm##XXX##_fmsub_pd(_mm##XXX##_load_pd((double*)to), _mm##XXX##_load_pd((double*)b), _mm##XXX##_load_pd((double*)c)));\
+}
+
+
+//  ███╗   ███╗  █████╗ ████████╗██╗  ██╗
+//  ████╗ ████║ ██╔══██╗╚══██╔══╝██║  ██║
+//  ██╔████╔██║ ███████║   ██║   ███████║
+//  ██║╚██╔╝██║ ██╔══██║   ██║   ██╔══██║
+//  ██║ ╚═╝ ██║ ██║  ██║   ██║   ██║  ██║
+//  ╚═╝     ╚═╝ ╚═╝  ╚═╝   ╚═╝   ╚═╝  ╚═╝
+
+#define CREATE_MATH_FUNCTION(TYPE, XXX, SFX, NAME) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<TYPE, XXX, TYPE> SIMD_Type_t<TYPE, XXX, TYPE>::NAME(const SIMD_Type_t& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_##SFX(result.Data, BASIC_SIMD_NAMESPACE::Math::Kernels<TYPE, XXX>::NAME(_mm##XXX##_load_##SFX(a.Data)));\
+    return result;\
+}
+
+// Registers with a lane beyond the reduction range go through the C library
+#define CREATE_MATH_TRIG_FUNCTION(TYPE, XXX, SFX, NAME, LIBRARY) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<TYPE, XXX, TYPE> SIMD_Type_t<TYPE, XXX, TYPE>::NAME(const SIMD_Type_t& a) {\
+    const typename BASIC_SIMD_NAMESPACE::Math::Ops<TYPE, XXX>::V v = _mm##XXX##_load_##SFX(a.Data);\
+    if (!BASIC_SIMD_NAMESPACE::Math::Kernels<TYPE, XXX>::InTrigRange(v))\
+    {\
+        return MapLanes(a, [](TYPE x) { return std::LIBRARY(x); });\
+    }\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_##SFX(result.Data, BASIC_SIMD_NAMESPACE::Math::Kernels<TYPE, XXX>::NAME(v));\
+    return result;\
+}
+
+#define CREATE_FLOATING_OPERATOR_MATH(TYPE, XXX, SFX) \
+CREATE_MATH_FUNCTION(TYPE, XXX, SFX, Exp) \
+CREATE_MATH_FUNCTION(TYPE, XXX, SFX, Log) \
+CREATE_MATH_FUNCTION(TYPE, XXX, SFX, Tanh) \
+CREATE_MATH_FUNCTION(TYPE, XXX, SFX, Sqrt) \
+CREATE_MATH_FUNCTION(TYPE, XXX, SFX, RSqrt) \
+CREATE_MATH_TRIG_FUNCTION(TYPE, XXX, SFX, Sin, sin) \
+CREATE_MATH_TRIG_FUNCTION(TYPE, XXX, SFX, Cos, cos) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<TYPE, XXX, TYPE> SIMD_Type_t<TYPE, XXX, TYPE>::Pow(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_##SFX(result.Data, BASIC_SIMD_NAMESPACE::Math::Kernels<TYPE, XXX>::Pow(_mm##XXX##_load_##SFX(a.Data), _mm##XXX##_load_##SFX(b.Data)));\
+    return result;\
 }
 
+#define CREATE_FLOAT_OPERATOR_MATH(XXX) CREATE_FLOATING_OPERATOR_MATH(float, XXX, ps)
+#define CREATE_DOUBLE_OPERATOR_MATH(XXX) CREATE_FLOATING_OPERATOR_MATH(double, XXX, pd)
 
 //Get GCC/MSVC Compile Time SIMD Macros
 
@@ -1398,6 +2875,9 @@ _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to,
     #if defined(__SSE4_1__)
         #define SSE4_1_AVAILABLE 1
     #endif
+    #if defined(__SSE4_2__)
+        #define SSE4_2_AVAILABLE 1
+    #endif
 #endif
 
 #if defined(__AVX__)
@@ -1408,6 +2888,10 @@ _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to,
 #if defined(__AVX2__)
     #define AVX2_AVAILABLE 1
     #define SSE4_1_AVAILABLE 1
+    #define SSE4_2_AVAILABLE 1
+#endif
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define FMA_AVAILABLE 1
 #endif
 #if defined(__AVX512F__)
     #define AVX512F_AVAILABLE 1
@@ -1418,6 +2902,12 @@ _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to,
 #if defined(__AVX512DQ__)
     #define AVX512DQ_AVAILABLE 1
 #endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define F16C_AVAILABLE 1
+#endif
+#if defined(__AVX512BF16__)
+    #define AVX512BF16_AVAILABLE 1
+#endif
 
 //print pragma messages for debug
 #if defined(SSE_AVAILABLE)
@@ -1429,15 +2919,24 @@ _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to,
 #if defined(SSE4_1_AVAILABLE)
     #pragma message("SSE4.1 Available")
 #endif
+#if defined(SSE4_2_AVAILABLE)
+    #pragma message("SSE4.2 Available")
+#endif
 #if defined(AVX_AVAILABLE)
     #pragma message("AVX Available")
 #endif
 #if defined(AVX2_AVAILABLE)
     #pragma message("AVX2 Available")
 #endif
+#if defined(FMA_AVAILABLE)
+    #pragma message("FMA Available")
+#endif
 #if defined(AVX512F_AVAILABLE)
     #pragma message("AVX512F Available")
 #endif
+#if defined(F16C_AVAILABLE)
+    #pragma message("F16C Available")
+#endif
 #if defined(SVML_COMPATIBLE_COMPILER)
     #pragma message("SVML Compatible Compiler")
 #endif
@@ -1446,265 +2945,5850 @@ _SIMD_INL_ bool SIMD_Type_t<double, XXX, double>::IsEqualInplaceRaw(double* to,
     #pragma message("No SIMD Available")
 #endif
 
-#if defined(SSE2_AVAILABLE)
-    #define SIMD_USE_TYPE_INT_128
-
-    CREATE_INT128_OPERATOR_PLUS(8);
-    CREATE_INT128_OPERATOR_PLUS(16);
-    CREATE_INT128_OPERATOR_PLUS(32);
-    CREATE_INT128_OPERATOR_PLUS(64);
+// Horizontal reduction helpers for the ReduceXXX specializations. Wider registers are folded down to 128 bits,
+// 8 and 16 bit integer lanes are widened (sad / madd) before they are added so the sums cannot wrap.
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Horizontal
+{
+#define CREATE_HORIZONTAL_FLOATING_128(NAME, OP) \
+_SIMD_INL_ float NAME(__m128 v) { v = _mm_##OP##_ps(v, _mm_movehl_ps(v, v)); return _mm_cvtss_f32(_mm_##OP##_ss(v, _mm_shuffle_ps(v, v, 1))); } \
+_SIMD_INL_ double NAME(__m128d v) { return _mm_cvtsd_f64(_mm_##OP##_sd(v, _mm_unpackhi_pd(v, v))); }
 
-    CREATE_INT128_OPERATOR_MINUS(8);
-    CREATE_INT128_OPERATOR_MINUS(16);
-    CREATE_INT128_OPERATOR_MINUS(32);
-    CREATE_INT128_OPERATOR_MINUS(64);
+#define CREATE_HORIZONTAL_FLOATING_256(NAME, OP) \
+_SIMD_INL_ float NAME(__m256 v) { return NAME(_mm_##OP##_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1))); } \
+_SIMD_INL_ double NAME(__m256d v) { return NAME(_mm_##OP##_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1))); }
 
-    CREATE_INT128_OPERATOR_EQUAL(8);
-    CREATE_INT128_OPERATOR_EQUAL(16);
-    CREATE_INT128_OPERATOR_EQUAL(32);
-    
-    CREATE_INT128_OPERATOR_MULTIPLY(16);
-    
-    #if defined(SVML_COMPATIBLE_COMPILER)
-        CREATE_INT128_OPERATOR_DIVIDE(8);
-        CREATE_INT128_OPERATOR_DIVIDE(16);
-        CREATE_INT128_OPERATOR_DIVIDE(32);
-        CREATE_INT128_OPERATOR_DIVIDE(64);
-    #endif
-#endif
+#define CREATE_HORIZONTAL_FLOATING_512(NAME, OP) \
+_SIMD_INL_ float NAME(__m512 v) { return _mm512_reduce_##OP##_ps(v); } \
+_SIMD_INL_ double NAME(__m512d v) { return _mm512_reduce_##OP##_pd(v); }
 
-#if defined(SSE4_1_AVAILABLE)
-    #define SIMD_USE_TYPE_INT_128 1
-    #define SIMD_USE_TYPE_INT_256 1
-    
-    CREATE_INT128_OPERATOR_EQUAL(64)
-    CREATE_INT128_OPERATOR_MULTIPLY(32);
+#if defined(SSE2_AVAILABLE)
+    CREATE_HORIZONTAL_FLOATING_128(Sum, add)
+    CREATE_HORIZONTAL_FLOATING_128(Product, mul)
+    CREATE_HORIZONTAL_FLOATING_128(Min, min)
+    CREATE_HORIZONTAL_FLOATING_128(Max, max)
 
+    _SIMD_INL_ int32_t SumI32(__m128i v)
+    {
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+        return _mm_cvtsi128_si32(v);
+    }
+    _SIMD_INL_ int64_t SumI64(__m128i v)
+    {
+        return _mm_cvtsi128_si64(_mm_add_epi64(v, _mm_unpackhi_epi64(v, v)));
+    }
+    _SIMD_INL_ int32_t SumI16(__m128i v)
+    {
+        return SumI32(_mm_madd_epi16(v, _mm_set1_epi16(1)));
+    }
+    _SIMD_INL_ int32_t SumI8(__m128i v)
+    {
+        // sad against zero adds unsigned bytes, flipping the sign bit maps int8 to uint8 + 128
+        return static_cast<int32_t>(SumI64(_mm_sad_epu8(_mm_xor_si128(v, _mm_set1_epi8(-128)), _mm_setzero_si128()))) - 128 * 16;
+    }
+    _SIMD_INL_ uint32_t SumU32(__m128i v) { return static_cast<uint32_t>(SumI32(v)); }
+    _SIMD_INL_ uint64_t SumU64(__m128i v) { return static_cast<uint64_t>(SumI64(v)); }
+    _SIMD_INL_ uint32_t SumU16(__m128i v)
+    {
+        return static_cast<uint32_t>(SumI16(_mm_xor_si128(v, _mm_set1_epi16(-32768))) + 32768 * 8);
+    }
+    _SIMD_INL_ uint32_t SumU8(__m128i v)
+    {
+        return static_cast<uint32_t>(SumI64(_mm_sad_epu8(v, _mm_setzero_si128())));
+    }
 #endif
 
-#if defined(AVX2_AVAILABLE)
-    #define SIMD_USE_TYPE_INT_256 1
-
-    CREATE_INT256_OPERATOR_PLUS(8);
-    CREATE_INT256_OPERATOR_PLUS(16);
-    CREATE_INT256_OPERATOR_PLUS(32);
-    CREATE_INT256_OPERATOR_PLUS(64);
+#define CREATE_HORIZONTAL_INT32_128(NAME, T, OP) \
+_SIMD_INL_ T NAME(__m128i v) { v = OP(v, _mm_shuffle_epi32(v, 0x4E)); v = OP(v, _mm_shuffle_epi32(v, 0xB1)); return static_cast<T>(_mm_cvtsi128_si32(v)); }
 
-    CREATE_INT256_OPERATOR_MINUS(8);
-    CREATE_INT256_OPERATOR_MINUS(16);
-    CREATE_INT256_OPERATOR_MINUS(32);
-    CREATE_INT256_OPERATOR_MINUS(64);
+#if defined(SSE4_1_AVAILABLE)
+    // phminposuw finds the smallest unsigned 16 bit lane, the other orders are mapped onto it: flipping the sign bit
+    // orders signed lanes as unsigned ones and inverting every bit turns the largest lane into the smallest
+    _SIMD_INL_ uint16_t MinU16(__m128i v) { return static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(v))); }
+    _SIMD_INL_ uint16_t MaxU16(__m128i v) { return static_cast<uint16_t>(~MinU16(_mm_xor_si128(v, _mm_set1_epi32(-1)))); }
+    _SIMD_INL_ int16_t MinI16(__m128i v) { return static_cast<int16_t>(MinU16(_mm_xor_si128(v, _mm_set1_epi16(-32768))) ^ 0x8000); }
+    _SIMD_INL_ int16_t MaxI16(__m128i v) { return static_cast<int16_t>(MaxU16(_mm_xor_si128(v, _mm_set1_epi16(-32768))) ^ 0x8000); }
+    // Bytes are folded pairwise into the low byte of every 16 bit lane first
+    _SIMD_INL_ uint8_t MinU8(__m128i v)
+    {
+        return static_cast<uint8_t>(MinU16(_mm_and_si128(_mm_min_epu8(v, _mm_srli_epi16(v, 8)), _mm_set1_epi16(0xFF))));
+    }
+    _SIMD_INL_ uint8_t MaxU8(__m128i v)
+    {
+        return static_cast<uint8_t>(MaxU16(_mm_and_si128(_mm_max_epu8(v, _mm_srli_epi16(v, 8)), _mm_set1_epi16(0xFF))));
+    }
+    _SIMD_INL_ int8_t MinI8(__m128i v) { return static_cast<int8_t>(MinU8(_mm_xor_si128(v, _mm_set1_epi8(-128))) ^ 0x80); }
+    _SIMD_INL_ int8_t MaxI8(__m128i v) { return static_cast<int8_t>(MaxU8(_mm_xor_si128(v, _mm_set1_epi8(-128))) ^ 0x80); }
+
+    CREATE_HORIZONTAL_INT32_128(MinI32, int32_t, _mm_min_epi32)
+    CREATE_HORIZONTAL_INT32_128(MaxI32, int32_t, _mm_max_epi32)
+    CREATE_HORIZONTAL_INT32_128(MinU32, uint32_t, _mm_min_epu32)
+    CREATE_HORIZONTAL_INT32_128(MaxU32, uint32_t, _mm_max_epu32)
+    CREATE_HORIZONTAL_INT32_128(ProductI32, int32_t, _mm_mullo_epi32)
+    CREATE_HORIZONTAL_INT32_128(ProductU32, uint32_t, _mm_mullo_epi32)
+
+    // Products of 8 and 16 bit lanes are taken in their 32 bit ReduceType, the low 32 bits of a product do not
+    // depend on the sign so the lanes are only extended the right way
+    _SIMD_INL_ int32_t ProductI16(__m128i v) { return ProductI32(_mm_mullo_epi32(_mm_cvtepi16_epi32(v), _mm_cvtepi16_epi32(_mm_unpackhi_epi64(v, v)))); }
+    _SIMD_INL_ uint32_t ProductU16(__m128i v) { return ProductU32(_mm_mullo_epi32(_mm_cvtepu16_epi32(v), _mm_cvtepu16_epi32(_mm_unpackhi_epi64(v, v)))); }
+    _SIMD_INL_ int32_t ProductI8(__m128i v)
+    {
+        return ProductI32(_mm_mullo_epi32(_mm_mullo_epi32(_mm_cvtepi8_epi32(v), _mm_cvtepi8_epi32(_mm_srli_si128(v, 4))),
+                                          _mm_mullo_epi32(_mm_cvtepi8_epi32(_mm_srli_si128(v, 8)), _mm_cvtepi8_epi32(_mm_srli_si128(v, 12)))));
+    }
+    _SIMD_INL_ uint32_t ProductU8(__m128i v)
+    {
+        return ProductU32(_mm_mullo_epi32(_mm_mullo_epi32(_mm_cvtepu8_epi32(v), _mm_cvtepu8_epi32(_mm_srli_si128(v, 4))),
+                                          _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)), _mm_cvtepu8_epi32(_mm_srli_si128(v, 12)))));
+    }
+#endif
 
-    CREATE_INT256_OPERATOR_EQUAL(8);
-    CREATE_INT256_OPERATOR_EQUAL(16);
-    CREATE_INT256_OPERATOR_EQUAL(32);
-    CREATE_INT256_OPERATOR_EQUAL(64);
+#if defined(SSE4_2_AVAILABLE)
+    // There is no 64 bit min / max below AVX-512, the lanes are compared and blended. Unsigned lanes are
+    // compared with flipped sign bits
+    _SIMD_INL_ __m128i MinI64(__m128i a, __m128i b) { return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); }
+    _SIMD_INL_ __m128i MaxI64(__m128i a, __m128i b) { return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+    _SIMD_INL_ __m128i MinU64(__m128i a, __m128i b)
+    {
+        const __m128i sign = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+        return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)));
+    }
+    _SIMD_INL_ __m128i MaxU64(__m128i a, __m128i b)
+    {
+        const __m128i sign = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+        return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)));
+    }
+    _SIMD_INL_ int64_t MinI64(__m128i v) { return _mm_cvtsi128_si64(MinI64(v, _mm_unpackhi_epi64(v, v))); }
+    _SIMD_INL_ int64_t MaxI64(__m128i v) { return _mm_cvtsi128_si64(MaxI64(v, _mm_unpackhi_epi64(v, v))); }
+    _SIMD_INL_ uint64_t MinU64(__m128i v) { return static_cast<uint64_t>(_mm_cvtsi128_si64(MinU64(v, _mm_unpackhi_epi64(v, v)))); }
+    _SIMD_INL_ uint64_t MaxU64(__m128i v) { return static_cast<uint64_t>(_mm_cvtsi128_si64(MaxU64(v, _mm_unpackhi_epi64(v, v)))); }
+#endif
 
-    CREATE_INT256_OPERATOR_MULTIPLY(16);
-    CREATE_INT256_OPERATOR_MULTIPLY(32);
+#if defined(AVX_AVAILABLE)
+    CREATE_HORIZONTAL_FLOATING_256(Sum, add)
+    CREATE_HORIZONTAL_FLOATING_256(Product, mul)
+    CREATE_HORIZONTAL_FLOATING_256(Min, min)
+    CREATE_HORIZONTAL_FLOATING_256(Max, max)
 #endif
 
+#if defined(AVX2_AVAILABLE)
+    _SIMD_INL_ int32_t SumI32(__m256i v) { return SumI32(_mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))); }
+    _SIMD_INL_ int64_t SumI64(__m256i v) { return SumI64(_mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))); }
+    _SIMD_INL_ int32_t SumI16(__m256i v) { return SumI32(_mm256_madd_epi16(v, _mm256_set1_epi16(1))); }
+    _SIMD_INL_ int32_t SumI8(__m256i v)
+    {
+        return static_cast<int32_t>(SumI64(_mm256_sad_epu8(_mm256_xor_si256(v, _mm256_set1_epi8(-128)), _mm256_setzero_si256()))) - 128 * 32;
+    }
+    _SIMD_INL_ uint32_t SumU32(__m256i v) { return static_cast<uint32_t>(SumI32(v)); }
+    _SIMD_INL_ uint64_t SumU64(__m256i v) { return static_cast<uint64_t>(SumI64(v)); }
+    _SIMD_INL_ uint32_t SumU16(__m256i v)
+    {
+        return static_cast<uint32_t>(SumI16(_mm256_xor_si256(v, _mm256_set1_epi16(-32768))) + 32768 * 16);
+    }
+    _SIMD_INL_ uint32_t SumU8(__m256i v)
+    {
+        return static_cast<uint32_t>(SumI64(_mm256_sad_epu8(v, _mm256_setzero_si256())));
+    }
 
-#if defined(SIMD_USE_TYPE_INT_128)
-    DECLARE_SIMD_USE_TYPE_INT(int, 128);
+#define CREATE_HORIZONTAL_INT_256(NAME, T, FOLD) \
+_SIMD_INL_ T NAME(__m256i v) { return NAME(FOLD(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1))); }
+
+    CREATE_HORIZONTAL_INT_256(MinI8, int8_t, _mm_min_epi8)
+    CREATE_HORIZONTAL_INT_256(MaxI8, int8_t, _mm_max_epi8)
+    CREATE_HORIZONTAL_INT_256(MinU8, uint8_t, _mm_min_epu8)
+    CREATE_HORIZONTAL_INT_256(MaxU8, uint8_t, _mm_max_epu8)
+    CREATE_HORIZONTAL_INT_256(MinI16, int16_t, _mm_min_epi16)
+    CREATE_HORIZONTAL_INT_256(MaxI16, int16_t, _mm_max_epi16)
+    CREATE_HORIZONTAL_INT_256(MinU16, uint16_t, _mm_min_epu16)
+    CREATE_HORIZONTAL_INT_256(MaxU16, uint16_t, _mm_max_epu16)
+    CREATE_HORIZONTAL_INT_256(MinI32, int32_t, _mm_min_epi32)
+    CREATE_HORIZONTAL_INT_256(MaxI32, int32_t, _mm_max_epi32)
+    CREATE_HORIZONTAL_INT_256(MinU32, uint32_t, _mm_min_epu32)
+    CREATE_HORIZONTAL_INT_256(MaxU32, uint32_t, _mm_max_epu32)
+    CREATE_HORIZONTAL_INT_256(MinI64, int64_t, MinI64)
+    CREATE_HORIZONTAL_INT_256(MaxI64, int64_t, MaxI64)
+    CREATE_HORIZONTAL_INT_256(MinU64, uint64_t, MinU64)
+    CREATE_HORIZONTAL_INT_256(MaxU64, uint64_t, MaxU64)
+    CREATE_HORIZONTAL_INT_256(ProductI32, int32_t, _mm_mullo_epi32)
+    CREATE_HORIZONTAL_INT_256(ProductU32, uint32_t, _mm_mullo_epi32)
+
+    _SIMD_INL_ int32_t ProductI16(__m256i v)
+    {
+        return ProductI32(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(v)), _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1))));
+    }
+    _SIMD_INL_ uint32_t ProductU16(__m256i v)
+    {
+        return ProductU32(_mm256_mullo_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1))));
+    }
+    _SIMD_INL_ int32_t ProductI8(__m256i v)
+    {
+        const __m128i low = _mm256_castsi256_si128(v), high = _mm256_extracti128_si256(v, 1);
+        return ProductI32(_mm256_mullo_epi32(_mm256_mullo_epi32(_mm256_cvtepi8_epi32(low), _mm256_cvtepi8_epi32(_mm_unpackhi_epi64(low, low))),
+                                             _mm256_mullo_epi32(_mm256_cvtepi8_epi32(high), _mm256_cvtepi8_epi32(_mm_unpackhi_epi64(high, high)))));
+    }
+    _SIMD_INL_ uint32_t ProductU8(__m256i v)
+    {
+        const __m128i low = _mm256_castsi256_si128(v), high = _mm256_extracti128_si256(v, 1);
+        return ProductU32(_mm256_mullo_epi32(_mm256_mullo_epi32(_mm256_cvtepu8_epi32(low), _mm256_cvtepu8_epi32(_mm_unpackhi_epi64(low, low))),
+                                             _mm256_mullo_epi32(_mm256_cvtepu8_epi32(high), _mm256_cvtepu8_epi32(_mm_unpackhi_epi64(high, high)))));
+    }
 #endif
 
-#if defined(SIMD_USE_TYPE_INT_256)
-    DECLARE_SIMD_USE_TYPE_INT(int, 256);
+#if defined(AVX512F_AVAILABLE)
+    // GCC 12 reports the _mm256_undefined_si256 used inside its own 512 bit extract intrinsics as uninitialized
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    CREATE_HORIZONTAL_FLOATING_512(Sum, add)
+    CREATE_HORIZONTAL_FLOATING_512(Product, mul)
+    CREATE_HORIZONTAL_FLOATING_512(Min, min)
+    CREATE_HORIZONTAL_FLOATING_512(Max, max)
+
+    _SIMD_INL_ int32_t SumI32(__m512i v) { return _mm512_reduce_add_epi32(v); }
+    _SIMD_INL_ int64_t SumI64(__m512i v) { return _mm512_reduce_add_epi64(v); }
+    _SIMD_INL_ uint32_t SumU32(__m512i v) { return static_cast<uint32_t>(SumI32(v)); }
+    _SIMD_INL_ uint64_t SumU64(__m512i v) { return static_cast<uint64_t>(SumI64(v)); }
+
+    _SIMD_INL_ int32_t MinI32(__m512i v) { return _mm512_reduce_min_epi32(v); }
+    _SIMD_INL_ int32_t MaxI32(__m512i v) { return _mm512_reduce_max_epi32(v); }
+    _SIMD_INL_ uint32_t MinU32(__m512i v) { return _mm512_reduce_min_epu32(v); }
+    _SIMD_INL_ uint32_t MaxU32(__m512i v) { return _mm512_reduce_max_epu32(v); }
+    _SIMD_INL_ int64_t MinI64(__m512i v) { return _mm512_reduce_min_epi64(v); }
+    _SIMD_INL_ int64_t MaxI64(__m512i v) { return _mm512_reduce_max_epi64(v); }
+    _SIMD_INL_ uint64_t MinU64(__m512i v) { return _mm512_reduce_min_epu64(v); }
+    _SIMD_INL_ uint64_t MaxU64(__m512i v) { return _mm512_reduce_max_epu64(v); }
+    _SIMD_INL_ int32_t ProductI32(__m512i v) { return _mm512_reduce_mul_epi32(v); }
+    _SIMD_INL_ uint32_t ProductU32(__m512i v) { return static_cast<uint32_t>(ProductI32(v)); }
+    _SIMD_INL_ int64_t ProductI64(__m512i v) { return _mm512_reduce_mul_epi64(v); }
+    _SIMD_INL_ uint64_t ProductU64(__m512i v) { return static_cast<uint64_t>(ProductI64(v)); }
 #endif
 
+#if defined(AVX512BW_AVAILABLE)
+    _SIMD_INL_ int32_t SumI16(__m512i v) { return SumI32(_mm512_madd_epi16(v, _mm512_set1_epi16(1))); }
+    _SIMD_INL_ int32_t SumI8(__m512i v)
+    {
+        return static_cast<int32_t>(SumI64(_mm512_sad_epu8(_mm512_xor_si512(v, _mm512_set1_epi8(-128)), _mm512_setzero_si512()))) - 128 * 64;
+    }
+    _SIMD_INL_ uint32_t SumU16(__m512i v)
+    {
+        return static_cast<uint32_t>(SumI16(_mm512_xor_si512(v, _mm512_set1_epi16(-32768))) + 32768 * 32);
+    }
+    _SIMD_INL_ uint32_t SumU8(__m512i v)
+    {
+        return static_cast<uint32_t>(SumI64(_mm512_sad_epu8(v, _mm512_setzero_si512())));
+    }
 
-#if defined(AVX_AVAILABLE)
-    #define SIMD_USE_TYPE_FLOAT_256 1
-    #define SIMD_USE_TYPE_DOUBLE_256 1
-    CREATE_FLOAT_OPERATOR_PLUS(256);
-    CREATE_FLOAT_OPERATOR_MINUS(256);
-    CREATE_FLOAT_OPERATOR_MULTIPLY(256);
-    CREATE_FLOAT_OPERATOR_DIVIDE(256);
+#define CREATE_HORIZONTAL_INT_512(NAME, T, FOLD) \
+_SIMD_INL_ T NAME(__m512i v) { return NAME(FOLD(_mm512_castsi512_si256(v), _mm512_extracti64x4_epi64(v, 1))); }
 
-    CREATE_DOUBLE_OPERATOR_PLUS(256);
-    CREATE_DOUBLE_OPERATOR_MINUS(256);
-    CREATE_DOUBLE_OPERATOR_MULTIPLY(256);
-    CREATE_DOUBLE_OPERATOR_DIVIDE(256);
+    CREATE_HORIZONTAL_INT_512(MinI8, int8_t, _mm256_min_epi8)
+    CREATE_HORIZONTAL_INT_512(MaxI8, int8_t, _mm256_max_epi8)
+    CREATE_HORIZONTAL_INT_512(MinU8, uint8_t, _mm256_min_epu8)
+    CREATE_HORIZONTAL_INT_512(MaxU8, uint8_t, _mm256_max_epu8)
+    CREATE_HORIZONTAL_INT_512(MinI16, int16_t, _mm256_min_epi16)
+    CREATE_HORIZONTAL_INT_512(MaxI16, int16_t, _mm256_max_epi16)
+    CREATE_HORIZONTAL_INT_512(MinU16, uint16_t, _mm256_min_epu16)
+    CREATE_HORIZONTAL_INT_512(MaxU16, uint16_t, _mm256_max_epu16)
 
-    #if defined(SVML_COMPATIBLE_COMPILER)
-        CREATE_INT256_OPERATOR_DIVIDE(8);
-        CREATE_INT256_OPERATOR_DIVIDE(16);
-        CREATE_INT256_OPERATOR_DIVIDE(32);
-        CREATE_INT256_OPERATOR_DIVIDE(64);
-    #endif
+    _SIMD_INL_ int32_t ProductI16(__m512i v)
+    {
+        return ProductI32(_mm512_mullo_epi32(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(v)), _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(v, 1))));
+    }
+    _SIMD_INL_ uint32_t ProductU16(__m512i v)
+    {
+        return ProductU32(_mm512_mullo_epi32(_mm512_cvtepu16_epi32(_mm512_castsi512_si256(v)), _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(v, 1))));
+    }
+    _SIMD_INL_ int32_t ProductI8(__m512i v)
+    {
+        return ProductI32(_mm512_mullo_epi32(_mm512_mullo_epi32(_mm512_cvtepi8_epi32(_mm512_castsi512_si128(v)), _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(v, 1))),
+                                             _mm512_mullo_epi32(_mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(v, 2)), _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(v, 3)))));
+    }
+    _SIMD_INL_ uint32_t ProductU8(__m512i v)
+    {
+        return ProductU32(_mm512_mullo_epi32(_mm512_mullo_epi32(_mm512_cvtepu8_epi32(_mm512_castsi512_si128(v)), _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 1))),
+                                             _mm512_mullo_epi32(_mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 2)), _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(v, 3)))));
+    }
 #endif
 
-#if defined(SIMD_USE_TYPE_FLOAT_256)
-    DECLARE_SIMD_USE_TYPE_FLOATING(float, 256);
+#if defined(AVX512F_AVAILABLE) && defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+#undef CREATE_HORIZONTAL_FLOATING_128
+#undef CREATE_HORIZONTAL_FLOATING_256
+#undef CREATE_HORIZONTAL_FLOATING_512
+#undef CREATE_HORIZONTAL_INT32_128
+#undef CREATE_HORIZONTAL_INT_256
+#undef CREATE_HORIZONTAL_INT_512
+}
+
+// Lane helpers for the CompareXX specializations
+namespace Lanes
+{
+#if defined(SSE2_AVAILABLE)
+    _SIMD_INL_ __m128i Not(__m128i v) { return _mm_xor_si128(v, _mm_set1_epi32(-1)); }
+    _SIMD_INL_ __m128i FlipSign8(__m128i v) { return _mm_xor_si128(v, _mm_set1_epi8(static_cast<char>(0x80))); }
+    _SIMD_INL_ __m128i FlipSign16(__m128i v) { return _mm_xor_si128(v, _mm_set1_epi16(static_cast<short>(0x8000))); }
+    _SIMD_INL_ __m128i FlipSign32(__m128i v) { return _mm_xor_si128(v, _mm_set1_epi32(static_cast<int>(0x80000000u))); }
+    _SIMD_INL_ __m128i FlipSign64(__m128i v) { return _mm_xor_si128(v, _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ull))); }
 #endif
 
-#if defined(SIMD_USE_TYPE_DOUBLE_256)
-    DECLARE_SIMD_USE_TYPE_FLOATING(double, 256);
+#if defined(AVX2_AVAILABLE)
+    _SIMD_INL_ __m256i Not(__m256i v) { return _mm256_xor_si256(v, _mm256_set1_epi32(-1)); }
+    _SIMD_INL_ __m256i FlipSign8(__m256i v) { return _mm256_xor_si256(v, _mm256_set1_epi8(static_cast<char>(0x80))); }
+    _SIMD_INL_ __m256i FlipSign16(__m256i v) { return _mm256_xor_si256(v, _mm256_set1_epi16(static_cast<short>(0x8000))); }
+    _SIMD_INL_ __m256i FlipSign32(__m256i v) { return _mm256_xor_si256(v, _mm256_set1_epi32(static_cast<int>(0x80000000u))); }
+    _SIMD_INL_ __m256i FlipSign64(__m256i v) { return _mm256_xor_si256(v, _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull))); }
 #endif
 
 #if defined(AVX512BW_AVAILABLE)
-    #define SIMD_USE_TYPE_INT_512 1
-    CREATE_INT512_OPERATOR_PLUS(8);
-    CREATE_INT512_OPERATOR_PLUS(16);
-    CREATE_INT512_OPERATOR_MINUS(8);
-    CREATE_INT512_OPERATOR_MINUS(16);
+    _SIMD_INL_ __m512i FlipSign8(__m512i v) { return _mm512_xor_si512(v, _mm512_set1_epi8(static_cast<char>(0x80))); }
+    _SIMD_INL_ __m512i FlipSign16(__m512i v) { return _mm512_xor_si512(v, _mm512_set1_epi16(static_cast<short>(0x8000))); }
+#endif
+
+// |v - w| from the two saturating differences, one of them is zero. Signed lanes are moved to unsigned order
+// first, which keeps their differences, and the signed average is the unsigned one of the moved lanes.
+#define CREATE_LANES_AVERAGE_ABSDIFF(V, PREFIX, SI, XX) \
+    _SIMD_INL_ V AbsDiffU##XX(V v, V w) { return PREFIX##_or_##SI(PREFIX##_subs_epu##XX(v, w), PREFIX##_subs_epu##XX(w, v)); } \
+    _SIMD_INL_ V AbsDiffI##XX(V v, V w) { return AbsDiffU##XX(FlipSign##XX(v), FlipSign##XX(w)); } \
+    _SIMD_INL_ V AverageI##XX(V v, V w) { return FlipSign##XX(PREFIX##_avg_epu##XX(FlipSign##XX(v), FlipSign##XX(w))); }
+
+#if defined(SSE2_AVAILABLE)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m128i, _mm, si128, 8)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m128i, _mm, si128, 16)
+#endif
+
+#if defined(AVX2_AVAILABLE)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m256i, _mm256, si256, 8)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m256i, _mm256, si256, 16)
+#endif
+
+#if defined(AVX512BW_AVAILABLE)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m512i, _mm512, si512, 8)
+    CREATE_LANES_AVERAGE_ABSDIFF(__m512i, _mm512, si512, 16)
+#endif
+
+// Shifts by a count from a general register. The sll, srl and sra forms read the count as an unsigned 64 bit value,
+// counts of the lane width or more clear the lanes or fill them with the sign. There are no 8 bit shifts, those
+// shift 16 bit lanes and mask off the bits moved in from the neighbour, arithmetic 8 bit shifts restore the sign
+// with (t ^ m) - m where m is the shifted sign bit.
+#define CREATE_LANES_SHIFT(V, PREFIX, XX) \
+    _SIMD_INL_ V ShiftLeft##XX(V v, unsigned int n) { return PREFIX##_sll_epi##XX(v, _mm_cvtsi32_si128(static_cast<int>(n))); } \
+    _SIMD_INL_ V ShiftRightU##XX(V v, unsigned int n) { return PREFIX##_srl_epi##XX(v, _mm_cvtsi32_si128(static_cast<int>(n))); }
+
+#define CREATE_LANES_SHIFT_ARITHMETIC(V, PREFIX, XX) \
+    _SIMD_INL_ V ShiftRightI##XX(V v, unsigned int n) { return PREFIX##_sra_epi##XX(v, _mm_cvtsi32_si128(static_cast<int>(n))); }
+
+#define CREATE_LANES_SHIFT8(V, PREFIX, SI) \
+    _SIMD_INL_ V ShiftLeft8(V v, unsigned int n) { \
+        return PREFIX##_and_##SI(ShiftLeft16(v, n), PREFIX##_set1_epi8(static_cast<char>(n < 8 ? 0xFF << n : 0))); \
+    } \
+    _SIMD_INL_ V ShiftRightU8(V v, unsigned int n) { \
+        return PREFIX##_and_##SI(ShiftRightU16(v, n), PREFIX##_set1_epi8(static_cast<char>(n < 8 ? 0xFF >> n : 0))); \
+    } \
+    _SIMD_INL_ V ShiftRightI8(V v, unsigned int n) { \
+        n = n < 7 ? n : 7; \
+        const V m = PREFIX##_set1_epi8(static_cast<char>(0x80 >> n)); \
+        return PREFIX##_sub_epi8(PREFIX##_xor_##SI(ShiftRightU8(v, n), m), m); \
+    }
+
+#if defined(SSE2_AVAILABLE)
+    _SIMD_INL_ __m128i AndNot(__m128i v, __m128i w) { return _mm_andnot_si128(w, v); }
+    CREATE_LANES_SHIFT(__m128i, _mm, 16)
+    CREATE_LANES_SHIFT(__m128i, _mm, 32)
+    CREATE_LANES_SHIFT(__m128i, _mm, 64)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m128i, _mm, 16)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m128i, _mm, 32)
+    CREATE_LANES_SHIFT8(__m128i, _mm, si128)
+    // sra has no 64 bit form below AVX-512, the sign of each lane is spread from its high half instead
+    _SIMD_INL_ __m128i SignMask64(__m128i v) { return _mm_shuffle_epi32(_mm_srai_epi32(v, 31), _MM_SHUFFLE(3, 3, 1, 1)); }
+    _SIMD_INL_ __m128i ShiftRightI64(__m128i v, unsigned int n) {
+        const __m128i sign = SignMask64(v);
+        return _mm_xor_si128(ShiftRightU64(_mm_xor_si128(v, sign), n), sign);
+    }
+#endif
+
+#if defined(AVX2_AVAILABLE)
+    _SIMD_INL_ __m256i AndNot(__m256i v, __m256i w) { return _mm256_andnot_si256(w, v); }
+    CREATE_LANES_SHIFT(__m256i, _mm256, 16)
+    CREATE_LANES_SHIFT(__m256i, _mm256, 32)
+    CREATE_LANES_SHIFT(__m256i, _mm256, 64)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m256i, _mm256, 16)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m256i, _mm256, 32)
+    CREATE_LANES_SHIFT8(__m256i, _mm256, si256)
+    _SIMD_INL_ __m256i SignMask64(__m256i v) { return _mm256_shuffle_epi32(_mm256_srai_epi32(v, 31), _MM_SHUFFLE(3, 3, 1, 1)); }
+    _SIMD_INL_ __m256i ShiftRightI64(__m256i v, unsigned int n) {
+        const __m256i sign = SignMask64(v);
+        return _mm256_xor_si256(ShiftRightU64(_mm256_xor_si256(v, sign), n), sign);
+    }
+    // Per lane counts, srav_epi64 needs AVX-512
+    _SIMD_INL_ __m128i ShiftRightI64(__m128i v, __m128i counts) {
+        const __m128i sign = SignMask64(v);
+        return _mm_xor_si128(_mm_srlv_epi64(_mm_xor_si128(v, sign), counts), sign);
+    }
+    _SIMD_INL_ __m256i ShiftRightI64(__m256i v, __m256i counts) {
+        const __m256i sign = SignMask64(v);
+        return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(v, sign), counts), sign);
+    }
+#endif
+
+// Halves and joins of registers for the conversions. The packs saturate within each 128 bit lane, OrderPacked puts
+// the 64 bit blocks of the low operand before those of the high one. Unsigned sources are clamped with min_epu first
+// as the packs read their sources as signed.
+#define CREATE_LANES_PACK(V, PREFIX, XX, HALF) \
+    _SIMD_INL_ V PackII##XX(V v, V w) { return OrderPacked(PREFIX##_packs_epi##XX(v, w)); } \
+    _SIMD_INL_ V PackIU##XX(V v, V w) { return OrderPacked(PREFIX##_packus_epi##XX(v, w)); } \
+    _SIMD_INL_ V PackUU##XX(V v, V w) { \
+        const V m = PREFIX##_set1_epi##XX(static_cast<int>((1u << HALF) - 1)); \
+        return OrderPacked(PREFIX##_packus_epi##XX(PREFIX##_min_epu##XX(v, m), PREFIX##_min_epu##XX(w, m))); \
+    } \
+    _SIMD_INL_ V PackUI##XX(V v, V w) { \
+        const V m = PREFIX##_set1_epi##XX(static_cast<int>((1u << (HALF - 1)) - 1)); \
+        return OrderPacked(PREFIX##_packs_epi##XX(PREFIX##_min_epu##XX(v, m), PREFIX##_min_epu##XX(w, m))); \
+    }
+
+#if defined(SSE2_AVAILABLE)
+    _SIMD_INL_ __m128i LowHalf(__m128i v) { return v; }
+    _SIMD_INL_ __m128i HighHalf(__m128i v) { return _mm_unpackhi_epi64(v, v); }
+    _SIMD_INL_ __m128i OrderPacked(__m128i v) { return v; }
+#endif
+
+#if defined(SSE4_1_AVAILABLE)
+    CREATE_LANES_PACK(__m128i, _mm, 16, 8)
+    CREATE_LANES_PACK(__m128i, _mm, 32, 16)
+#endif
+
+#if defined(AVX2_AVAILABLE)
+    _SIMD_INL_ __m128i LowHalf(__m256i v) { return _mm256_castsi256_si128(v); }
+    _SIMD_INL_ __m128i HighHalf(__m256i v) { return _mm256_extracti128_si256(v, 1); }
+    _SIMD_INL_ __m128 LowHalf(__m256 v) { return _mm256_castps256_ps128(v); }
+    _SIMD_INL_ __m128 HighHalf(__m256 v) { return _mm256_extractf128_ps(v, 1); }
+    _SIMD_INL_ __m256i Join(__m128i low, __m128i high) { return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1); }
+    _SIMD_INL_ __m256 Join(__m128 low, __m128 high) { return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1); }
+    _SIMD_INL_ __m256i OrderPacked(__m256i v) { return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)); }
+    CREATE_LANES_PACK(__m256i, _mm256, 16, 8)
+    CREATE_LANES_PACK(__m256i, _mm256, 32, 16)
+    // cvtt returns INT_MIN for every lane out of range, lanes at or above 2^31 are flipped to INT_MAX and NaN lanes cleared
+    _SIMD_INL_ __m256i ConvertF32ToI32(__m256 v) {
+        const __m256i above = _mm256_castps_si256(_mm256_cmp_ps(v, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ));
+        const __m256i ordered = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_ORD_Q));
+        return _mm256_and_si256(_mm256_xor_si256(_mm256_cvttps_epi32(v), above), ordered);
+    }
+    // Doubles hold the int32 range exactly, so the lanes are clamped before the conversion
+    _SIMD_INL_ __m128i ConvertF64ToI32(__m256d v) {
+        v = _mm256_and_pd(v, _mm256_cmp_pd(v, v, _CMP_ORD_Q));
+        return _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(v, _mm256_set1_pd(-2147483648.0)), _mm256_set1_pd(2147483647.0)));
+    }
+#endif
+
+// Compress and Expand of 32 bit lanes, 64 bit lanes move as pairs of them. AVX2 has no compress instruction, so the
+// permutation for every 8 bit lane mask is looked up, packed as 4 bit lane indices, and applied with permutevar8x32.
+#if defined(AVX2_AVAILABLE)
+    struct PermuteTable
+    {
+        uint32_t Compress[256];
+        uint32_t Expand[256];
+        PermuteTable()
+        {
+            for (unsigned int mask = 0; mask < 256; mask++)
+            {
+                uint32_t compress = 0, expand = 0;
+                unsigned int count = 0;
+                for (unsigned int lane = 0; lane < 8; lane++)
+                {
+                    if ((mask >> lane) & 1)
+                    {
+                        compress |= lane << (4 * count);
+                        expand |= count << (4 * lane);
+                        count++;
+                    }
+                }
+                Compress[mask] = compress;
+                Expand[mask] = expand;
+            }
+        }
+    };
+    inline const PermuteTable& Permutes()
+    {
+        static const PermuteTable table;
+        return table;
+    }
+    _SIMD_INL_ __m256i PermuteIndices(uint32_t packed)
+    {
+        return _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(packed)), _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28)), _mm256_set1_epi32(0xF));
+    }
+    _SIMD_INL_ __m256i Compress32(__m256i v, unsigned int mask)
+    {
+        const int count = static_cast<int>(std::bitset<8>(mask).count());
+        const __m256i kept = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        return _mm256_and_si256(_mm256_permutevar8x32_epi32(v, PermuteIndices(Permutes().Compress[mask])), kept);
+    }
+    _SIMD_INL_ __m256i Expand32(__m256i v, unsigned int mask, __m256i lanes)
+    {
+        return _mm256_and_si256(_mm256_permutevar8x32_epi32(v, PermuteIndices(Permutes().Expand[mask])), lanes);
+    }
+#endif
+
+// Same GCC 12 false positive as in Horizontal, for the undefined passthrough of the unmasked logic, shifts and
+// conversions
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#if defined(AVX512F_AVAILABLE)
+    _SIMD_INL_ __m256i LowHalf(__m512i v) { return _mm512_castsi512_si256(v); }
+    _SIMD_INL_ __m256i HighHalf(__m512i v) { return _mm512_extracti64x4_epi64(v, 1); }
+    _SIMD_INL_ __m256 LowHalf(__m512 v) { return _mm512_castps512_ps256(v); }
+    _SIMD_INL_ __m256 HighHalf(__m512 v) { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+    _SIMD_INL_ __m512i Join(__m256i low, __m256i high) { return _mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1); }
+    _SIMD_INL_ __m512 Join(__m256 low, __m256 high) {
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(low)), _mm256_castps_pd(high), 1));
+    }
+    _SIMD_INL_ __m512i OrderPacked(__m512i v) { return _mm512_permutexvar_epi64(_mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7), v); }
+    _SIMD_INL_ __m512i PackII64(__m512i v, __m512i w) { return Join(_mm512_cvtsepi64_epi32(v), _mm512_cvtsepi64_epi32(w)); }
+    _SIMD_INL_ __m512i PackUU64(__m512i v, __m512i w) { return Join(_mm512_cvtusepi64_epi32(v), _mm512_cvtusepi64_epi32(w)); }
+    _SIMD_INL_ __m512i ConvertF32ToI32(__m512 v) {
+        const __m512i r = _mm512_mask_mov_epi32(_mm512_cvttps_epi32(v), _mm512_cmp_ps_mask(v, _mm512_set1_ps(2147483648.0f), _CMP_GE_OQ), _mm512_set1_epi32(INT32_MAX));
+        return _mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(v, v, _CMP_ORD_Q), r);
+    }
+    _SIMD_INL_ __m256i ConvertF64ToI32(__m512d v) {
+        v = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(v, v, _CMP_ORD_Q), v);
+        return _mm512_cvttpd_epi32(_mm512_min_pd(_mm512_max_pd(v, _mm512_set1_pd(-2147483648.0)), _mm512_set1_pd(2147483647.0)));
+    }
+#endif
+
+#if defined(AVX512DQ_AVAILABLE)
+    _SIMD_INL_ __m512i ConvertF64ToI64(__m512d v) {
+        const __m512i r = _mm512_mask_mov_epi64(_mm512_cvttpd_epi64(v), _mm512_cmp_pd_mask(v, _mm512_set1_pd(9223372036854775808.0), _CMP_GE_OQ), _mm512_set1_epi64(INT64_MAX));
+        return _mm512_maskz_mov_epi64(_mm512_cmp_pd_mask(v, v, _CMP_ORD_Q), r);
+    }
+#endif
+
+#if defined(AVX512F_AVAILABLE)
+    _SIMD_INL_ __m512i AndNot(__m512i v, __m512i w) { return _mm512_andnot_si512(w, v); }
+    CREATE_LANES_SHIFT(__m512i, _mm512, 32)
+    CREATE_LANES_SHIFT(__m512i, _mm512, 64)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m512i, _mm512, 32)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m512i, _mm512, 64)
+#endif
+
+#if defined(AVX512BW_AVAILABLE)
+    CREATE_LANES_SHIFT(__m512i, _mm512, 16)
+    CREATE_LANES_SHIFT_ARITHMETIC(__m512i, _mm512, 16)
+    CREATE_LANES_SHIFT8(__m512i, _mm512, si512)
+    CREATE_LANES_PACK(__m512i, _mm512, 16, 8)
+    CREATE_LANES_PACK(__m512i, _mm512, 32, 16)
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+}
+}
+
+// Saturating, averaging and absolute difference kernels of 8 and 16 bit lanes, FUNCTION combines two registers
+#define CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, T, NAME, FUNCTION) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, T> SIMD_Type_t<int, XXX, T>::NAME(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t<int, XXX, T> result((NoCheck()));\
+    PREFIX##_store_##SI((__m##XXX##i*)result.Data, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)a.Data), PREFIX##_load_##SI((__m##XXX##i*)b.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, T>::NAME##Inplace(SIMD_Type_t& to, const SIMD_Type_t& from) {\
+    PREFIX##_store_##SI((__m##XXX##i*)to.Data, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)to.Data), PREFIX##_load_##SI((__m##XXX##i*)from.Data)));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, T>::NAME##InplaceRaw(T* to, const T* from) {\
+    PREFIX##_store_##SI((__m##XXX##i*)to, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)to), PREFIX##_load_##SI((__m##XXX##i*)from)));\
+}
+
+#define CREATE_INT_OPERATOR_SATURATE(XXX, PREFIX, SI, XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, AddSaturate, PREFIX##_adds_epi##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, AddSaturate, PREFIX##_adds_epu##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, SubtractSaturate, PREFIX##_subs_epi##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, SubtractSaturate, PREFIX##_subs_epu##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, Average, BASIC_SIMD_NAMESPACE::Lanes::AverageI##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, Average, PREFIX##_avg_epu##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, AbsDiff, BASIC_SIMD_NAMESPACE::Lanes::AbsDiffI##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, AbsDiff, BASIC_SIMD_NAMESPACE::Lanes::AbsDiffU##XX)
+
+// Horizontal minimum, maximum and product of both signs of XX bit lanes, KIND is the member type of the result
+#define CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, T, KIND, NAME, FUNCTION) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, T>::KIND SIMD_Type_t<int, XXX, T>::NAME(const SIMD_Type_t& a) {\
+    return FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)a.Data));\
+}
+
+#define CREATE_INT_OPERATOR_REDUCE_ORDER(XXX, PREFIX, SI, XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, int##XX##_t, ElementType, ReduceMin, BASIC_SIMD_NAMESPACE::Horizontal::MinI##XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ElementType, ReduceMin, BASIC_SIMD_NAMESPACE::Horizontal::MinU##XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, int##XX##_t, ElementType, ReduceMax, BASIC_SIMD_NAMESPACE::Horizontal::MaxI##XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ElementType, ReduceMax, BASIC_SIMD_NAMESPACE::Horizontal::MaxU##XX)
+
+#define CREATE_INT_OPERATOR_REDUCE_PRODUCT(XXX, PREFIX, SI, XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, int##XX##_t, ReduceType, ReduceProduct, BASIC_SIMD_NAMESPACE::Horizontal::ProductI##XX) \
+CREATE_INT_REDUCE_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ReduceType, ReduceProduct, BASIC_SIMD_NAMESPACE::Horizontal::ProductU##XX)
+
+// Bitwise logic of both signs of XX bit lanes, the lane width only matters to the type
+#define CREATE_INT_NOT_KERNEL(XXX, PREFIX, SI, T) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, T> SIMD_Type_t<int, XXX, T>::Not(const SIMD_Type_t& a) {\
+    SIMD_Type_t<int, XXX, T> result((NoCheck()));\
+    PREFIX##_store_##SI((__m##XXX##i*)result.Data, PREFIX##_xor_##SI(PREFIX##_load_##SI((__m##XXX##i*)a.Data), PREFIX##_set1_epi32(-1)));\
+    return result;\
+}
+
+#define CREATE_INT_OPERATOR_BITWISE(XXX, PREFIX, SI, XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, And, PREFIX##_and_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, And, PREFIX##_and_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, Or, PREFIX##_or_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, Or, PREFIX##_or_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, Xor, PREFIX##_xor_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, Xor, PREFIX##_xor_##SI) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, AndNot, BASIC_SIMD_NAMESPACE::Lanes::AndNot) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, AndNot, BASIC_SIMD_NAMESPACE::Lanes::AndNot) \
+CREATE_INT_NOT_KERNEL(XXX, PREFIX, SI, int##XX##_t) \
+CREATE_INT_NOT_KERNEL(XXX, PREFIX, SI, uint##XX##_t)
+
+// Shifts of all lanes by one count, signed lanes shift right arithmetically
+#define CREATE_INT_SHIFT_KERNEL(XXX, PREFIX, SI, T, NAME, FUNCTION) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, T> SIMD_Type_t<int, XXX, T>::NAME(const SIMD_Type_t& a, unsigned int count) {\
+    SIMD_Type_t<int, XXX, T> result((NoCheck()));\
+    PREFIX##_store_##SI((__m##XXX##i*)result.Data, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)a.Data), count));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, T>::NAME##Inplace(SIMD_Type_t& to, unsigned int count) {\
+    PREFIX##_store_##SI((__m##XXX##i*)to.Data, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)to.Data), count));\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, T>::NAME##InplaceRaw(T* to, unsigned int count) {\
+    PREFIX##_store_##SI((__m##XXX##i*)to, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)to), count));\
+}
+
+#define CREATE_INT_OPERATOR_SHIFT(XXX, PREFIX, SI, XX) \
+CREATE_INT_SHIFT_KERNEL(XXX, PREFIX, SI, int##XX##_t, ShiftLeft, BASIC_SIMD_NAMESPACE::Lanes::ShiftLeft##XX) \
+CREATE_INT_SHIFT_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ShiftLeft, BASIC_SIMD_NAMESPACE::Lanes::ShiftLeft##XX) \
+CREATE_INT_SHIFT_KERNEL(XXX, PREFIX, SI, int##XX##_t, ShiftRight, BASIC_SIMD_NAMESPACE::Lanes::ShiftRightI##XX) \
+CREATE_INT_SHIFT_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ShiftRight, BASIC_SIMD_NAMESPACE::Lanes::ShiftRightU##XX)
+
+// Shifts by the count in the same lane, ARITHMETIC is the signed right shift
+#define CREATE_INT_OPERATOR_SHIFT_LANES(XXX, PREFIX, SI, XX, ARITHMETIC) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, ShiftLeft, PREFIX##_sllv_epi##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ShiftLeft, PREFIX##_sllv_epi##XX) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, int##XX##_t, ShiftRight, ARITHMETIC) \
+CREATE_INT_BINARY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, ShiftRight, PREFIX##_srlv_epi##XX)
+
+// Widening of FROM bit lanes, each half of the source register is sign or zero extended into a full register.
+// Signed sources only widen into signed lanes here, int to unsigned saturates and takes the generic path.
+#define CREATE_INT_WIDEN_KERNEL(XXX, PREFIX, SI, FROM_T, TO_T, FUNCTION) \
+template<> template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, TO_T>::Widen<SIMD_Type_t<int, XXX, FROM_T> >(const SIMD_Type_t<int, XXX, FROM_T>& a, SIMD_Type_t& low, SIMD_Type_t& high) {\
+    const __m##XXX##i v = PREFIX##_load_##SI((__m##XXX##i*)a.Data);\
+    PREFIX##_store_##SI((__m##XXX##i*)low.Data, FUNCTION(BASIC_SIMD_NAMESPACE::Lanes::LowHalf(v)));\
+    PREFIX##_store_##SI((__m##XXX##i*)high.Data, FUNCTION(BASIC_SIMD_NAMESPACE::Lanes::HighHalf(v)));\
+}
+
+#define CREATE_INT_OPERATOR_WIDEN(XXX, PREFIX, SI, FROM, TO) \
+CREATE_INT_WIDEN_KERNEL(XXX, PREFIX, SI, int##FROM##_t, int##TO##_t, PREFIX##_cvtepi##FROM##_epi##TO) \
+CREATE_INT_WIDEN_KERNEL(XXX, PREFIX, SI, uint##FROM##_t, uint##TO##_t, PREFIX##_cvtepu##FROM##_epi##TO) \
+CREATE_INT_WIDEN_KERNEL(XXX, PREFIX, SI, uint##FROM##_t, int##TO##_t, PREFIX##_cvtepu##FROM##_epi##TO)
+
+// Saturating narrowing of FROM bit lanes, FUNCTION joins the two sources into one register of half as wide lanes
+#define CREATE_INT_NARROW_KERNEL(XXX, PREFIX, SI, FROM_T, TO_T, FUNCTION) \
+template<> template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, TO_T> SIMD_Type_t<int, XXX, TO_T>::Narrow<SIMD_Type_t<int, XXX, FROM_T> >(const SIMD_Type_t<int, XXX, FROM_T>& low, const SIMD_Type_t<int, XXX, FROM_T>& high) {\
+    SIMD_Type_t<int, XXX, TO_T> result((NoCheck()));\
+    PREFIX##_store_##SI((__m##XXX##i*)result.Data, FUNCTION(PREFIX##_load_##SI((__m##XXX##i*)low.Data), PREFIX##_load_##SI((__m##XXX##i*)high.Data)));\
+    return result;\
+}
+
+#define CREATE_INT_OPERATOR_NARROW(XXX, PREFIX, SI, FROM, TO) \
+CREATE_INT_NARROW_KERNEL(XXX, PREFIX, SI, int##FROM##_t, int##TO##_t, BASIC_SIMD_NAMESPACE::Lanes::PackII##FROM) \
+CREATE_INT_NARROW_KERNEL(XXX, PREFIX, SI, int##FROM##_t, uint##TO##_t, BASIC_SIMD_NAMESPACE::Lanes::PackIU##FROM) \
+CREATE_INT_NARROW_KERNEL(XXX, PREFIX, SI, uint##FROM##_t, uint##TO##_t, BASIC_SIMD_NAMESPACE::Lanes::PackUU##FROM) \
+CREATE_INT_NARROW_KERNEL(XXX, PREFIX, SI, uint##FROM##_t, int##TO##_t, BASIC_SIMD_NAMESPACE::Lanes::PackUI##FROM)
+
+// int32 <-> float at the same lane count, int32 <-> double and float <-> double through Widen and Narrow
+#define CREATE_FLOATING_OPERATOR_CONVERT(XXX) \
+template<> template<>\
+_SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Convert<SIMD_Type_t<int, XXX, int32_t> >(const SIMD_Type_t<int, XXX, int32_t>& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_ps(result.Data, _mm##XXX##_cvtepi32_ps(_mm##XXX##_load_si##XXX((__m##XXX##i*)a.Data)));\
+    return result;\
+}\
+template<> template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, int32_t> SIMD_Type_t<int, XXX, int32_t>::Convert<SIMD_Type_t<float, XXX, float> >(const SIMD_Type_t<float, XXX, float>& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_si##XXX((__m##XXX##i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::ConvertF32ToI32(_mm##XXX##_load_ps(a.Data)));\
+    return result;\
+}\
+template<> template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::Widen<SIMD_Type_t<int, XXX, int32_t> >(const SIMD_Type_t<int, XXX, int32_t>& a, SIMD_Type_t& low, SIMD_Type_t& high) {\
+    const __m##XXX##i v = _mm##XXX##_load_si##XXX((__m##XXX##i*)a.Data);\
+    _mm##XXX##_store_pd(low.Data, _mm##XXX##_cvtepi32_pd(BASIC_SIMD_NAMESPACE::Lanes::LowHalf(v)));\
+    _mm##XXX##_store_pd(high.Data, _mm##XXX##_cvtepi32_pd(BASIC_SIMD_NAMESPACE::Lanes::HighHalf(v)));\
+}\
+template<> template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, int32_t> SIMD_Type_t<int, XXX, int32_t>::Narrow<SIMD_Type_t<double, XXX, double> >(const SIMD_Type_t<double, XXX, double>& low, const SIMD_Type_t<double, XXX, double>& high) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_si##XXX((__m##XXX##i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Join(BASIC_SIMD_NAMESPACE::Lanes::ConvertF64ToI32(_mm##XXX##_load_pd(low.Data)), BASIC_SIMD_NAMESPACE::Lanes::ConvertF64ToI32(_mm##XXX##_load_pd(high.Data))));\
+    return result;\
+}\
+template<> template<>\
+_SIMD_INL_ void SIMD_Type_t<double, XXX, double>::Widen<SIMD_Type_t<float, XXX, float> >(const SIMD_Type_t<float, XXX, float>& a, SIMD_Type_t& low, SIMD_Type_t& high) {\
+    const __m##XXX v = _mm##XXX##_load_ps(a.Data);\
+    _mm##XXX##_store_pd(low.Data, _mm##XXX##_cvtps_pd(BASIC_SIMD_NAMESPACE::Lanes::LowHalf(v)));\
+    _mm##XXX##_store_pd(high.Data, _mm##XXX##_cvtps_pd(BASIC_SIMD_NAMESPACE::Lanes::HighHalf(v)));\
+}\
+template<> template<>\
+_SIMD_INL_ SIMD_Type_t<float, XXX, float> SIMD_Type_t<float, XXX, float>::Narrow<SIMD_Type_t<double, XXX, double> >(const SIMD_Type_t<double, XXX, double>& low, const SIMD_Type_t<double, XXX, double>& high) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm##XXX##_store_ps(result.Data, BASIC_SIMD_NAMESPACE::Lanes::Join(_mm##XXX##_cvtpd_ps(_mm##XXX##_load_pd(low.Data)), _mm##XXX##_cvtpd_ps(_mm##XXX##_load_pd(high.Data))));\
+    return result;\
+}
+
+// Masked kernels of the 512 bit types, the mask goes straight into the __mmask operand. V is the load and store
+// suffix (si512, ps or pd) and SFX the lane suffix of the instruction.
+#define CREATE_MASKED_BINARY_KERNEL(CONTAINER, T, V, NAME, FUNCTION) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 512, T> SIMD_Type_t<CONTAINER, 512, T>::Masked##NAME(const MaskType& mask, const SIMD_Type_t& src, const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_##V(result.Data, FUNCTION(_mm512_load_##V(src.Data), mask, _mm512_load_##V(a.Data), _mm512_load_##V(b.Data)));\
+    return result;\
+}
+
+#define CREATE_MASKED_MEMORY_KERNEL(CONTAINER, T, V, SFX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 512, T> SIMD_Type_t<CONTAINER, 512, T>::MaskedLoad(const MaskType& mask, const T* data) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_##V(result.Data, _mm512_maskz_loadu_##SFX(mask, data));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<CONTAINER, 512, T>::MaskedStore(const MaskType& mask, T* data) const {\
+    _mm512_mask_storeu_##SFX(data, mask, _mm512_load_##V(Data));\
+}
+
+#define CREATE_MASKED_COMPRESS_KERNEL(CONTAINER, T, V, SFX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 512, T> SIMD_Type_t<CONTAINER, 512, T>::Compress(const MaskType& mask, const SIMD_Type_t& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_##V(result.Data, _mm512_maskz_compress_##SFX(mask, _mm512_load_##V(a.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 512, T> SIMD_Type_t<CONTAINER, 512, T>::Expand(const MaskType& mask, const SIMD_Type_t& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm512_store_##V(result.Data, _mm512_maskz_expand_##SFX(mask, _mm512_load_##V(a.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ unsigned int SIMD_Type_t<CONTAINER, 512, T>::CompressStore(const MaskType& mask, T* data) const {\
+    _mm512_mask_compressstoreu_##SFX(data, mask, _mm512_load_##V(Data));\
+    return CountTrue(mask);\
+}
+
+#define CREATE_INT512_OPERATOR_MASKED(XX) \
+CREATE_MASKED_BINARY_KERNEL(int, int##XX##_t, si512, Add, _mm512_mask_add_epi##XX) \
+CREATE_MASKED_BINARY_KERNEL(int, uint##XX##_t, si512, Add, _mm512_mask_add_epi##XX) \
+CREATE_MASKED_BINARY_KERNEL(int, int##XX##_t, si512, Subtract, _mm512_mask_sub_epi##XX) \
+CREATE_MASKED_BINARY_KERNEL(int, uint##XX##_t, si512, Subtract, _mm512_mask_sub_epi##XX) \
+CREATE_MASKED_MEMORY_KERNEL(int, int##XX##_t, si512, epi##XX) \
+CREATE_MASKED_MEMORY_KERNEL(int, uint##XX##_t, si512, epi##XX)
+
+#define CREATE_INT512_OPERATOR_MASKED_MULTIPLY(XX) \
+CREATE_MASKED_BINARY_KERNEL(int, int##XX##_t, si512, Multiply, _mm512_mask_mullo_epi##XX) \
+CREATE_MASKED_BINARY_KERNEL(int, uint##XX##_t, si512, Multiply, _mm512_mask_mullo_epi##XX)
+
+#define CREATE_INT512_OPERATOR_COMPRESS(XX) \
+CREATE_MASKED_COMPRESS_KERNEL(int, int##XX##_t, si512, epi##XX) \
+CREATE_MASKED_COMPRESS_KERNEL(int, uint##XX##_t, si512, epi##XX)
+
+#define CREATE_FLOATING512_OPERATOR_MASKED(TYPE, SFX) \
+CREATE_MASKED_BINARY_KERNEL(TYPE, TYPE, SFX, Add, _mm512_mask_add_##SFX) \
+CREATE_MASKED_BINARY_KERNEL(TYPE, TYPE, SFX, Subtract, _mm512_mask_sub_##SFX) \
+CREATE_MASKED_BINARY_KERNEL(TYPE, TYPE, SFX, Multiply, _mm512_mask_mul_##SFX) \
+CREATE_MASKED_BINARY_KERNEL(TYPE, TYPE, SFX, Divide, _mm512_mask_div_##SFX) \
+CREATE_MASKED_MEMORY_KERNEL(TYPE, TYPE, SFX, SFX) \
+CREATE_MASKED_COMPRESS_KERNEL(TYPE, TYPE, SFX, SFX)
+
+// Masked loads and stores of 32 and 64 bit lanes on 128 and 256 bit types with vmaskmov, which reads the sign bit
+// of every lane of the vector mask and suppresses faults on the inactive lanes. E is the element type of the intrinsic.
+#define CREATE_INT_MASKED_MEMORY_KERNEL(XXX, PREFIX, SI, T, XX, E) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, T> SIMD_Type_t<int, XXX, T>::MaskedLoad(const MaskType& mask, const T* data) {\
+    SIMD_Type_t result((NoCheck()));\
+    PREFIX##_store_##SI((__m##XXX##i*)result.Data, PREFIX##_maskload_epi##XX((const E*)data, PREFIX##_load_##SI((const __m##XXX##i*)mask.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, T>::MaskedStore(const MaskType& mask, T* data) const {\
+    PREFIX##_maskstore_epi##XX((E*)data, PREFIX##_load_##SI((const __m##XXX##i*)mask.Data), PREFIX##_load_##SI((const __m##XXX##i*)Data));\
+}
+
+#define CREATE_INT_OPERATOR_MASKED_MEMORY(XXX, PREFIX, SI, XX, E) \
+CREATE_INT_MASKED_MEMORY_KERNEL(XXX, PREFIX, SI, int##XX##_t, XX, E) \
+CREATE_INT_MASKED_MEMORY_KERNEL(XXX, PREFIX, SI, uint##XX##_t, XX, E)
+
+#define CREATE_FLOATING_MASKED_MEMORY_KERNEL(TYPE, SFX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<TYPE, 256, TYPE> SIMD_Type_t<TYPE, 256, TYPE>::MaskedLoad(const MaskType& mask, const TYPE* data) {\
+    SIMD_Type_t result((NoCheck()));\
+    _mm256_store_##SFX(result.Data, _mm256_maskload_##SFX(data, _mm256_load_si256((const __m256i*)mask.Data)));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<TYPE, 256, TYPE>::MaskedStore(const MaskType& mask, TYPE* data) const {\
+    _mm256_maskstore_##SFX(data, _mm256_load_si256((const __m256i*)mask.Data), _mm256_load_##SFX(Data));\
+}
+
+// Compress and Expand of 32 and 64 bit lanes on 256 bit types through the Lanes permutation tables. movemask_ps
+// of a vector mask gives one bit per 32 bit lane, true 64 bit lanes set both of theirs.
+#define CREATE_MASKED_PERMUTE_KERNEL(CONTAINER, T) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 256, T> SIMD_Type_t<CONTAINER, 256, T>::Compress(const MaskType& mask, const SIMD_Type_t& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    const __m256i m = _mm256_load_si256((const __m256i*)mask.Data);\
+    _mm256_store_si256((__m256i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Compress32(_mm256_load_si256((const __m256i*)a.Data), _mm256_movemask_ps(_mm256_castsi256_ps(m))));\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<CONTAINER, 256, T> SIMD_Type_t<CONTAINER, 256, T>::Expand(const MaskType& mask, const SIMD_Type_t& a) {\
+    SIMD_Type_t result((NoCheck()));\
+    const __m256i m = _mm256_load_si256((const __m256i*)mask.Data);\
+    _mm256_store_si256((__m256i*)result.Data, BASIC_SIMD_NAMESPACE::Lanes::Expand32(_mm256_load_si256((const __m256i*)a.Data), _mm256_movemask_ps(_mm256_castsi256_ps(m)), m));\
+    return result;\
+}
+
+// Functions between a _SIMD_BEGIN_TARGET_*_ and _SIMD_END_TARGET_ are compiled for that instruction set whatever the
+// build flags, so they can be picked at runtime once the CPU is known to support it.
+#if defined(__clang__)
+    #define _SIMD_BEGIN_TARGET_SSE2_ _Pragma("clang attribute push (__attribute__((target(\"sse2\"))), apply_to = function)")
+    #define _SIMD_BEGIN_TARGET_AVX2_ _Pragma("clang attribute push (__attribute__((target(\"avx2\"))), apply_to = function)")
+    #define _SIMD_BEGIN_TARGET_AVX2_FMA_ _Pragma("clang attribute push (__attribute__((target(\"avx2,fma\"))), apply_to = function)")
+    #define _SIMD_BEGIN_TARGET_AVX512_ _Pragma("clang attribute push (__attribute__((target(\"avx512f,avx512bw,avx512dq\"))), apply_to = function)")
+    #define _SIMD_END_TARGET_ _Pragma("clang attribute pop")
+#elif defined(__GNUC__)
+    #define _SIMD_BEGIN_TARGET_SSE2_ _Pragma("GCC push_options") _Pragma("GCC target(\"sse2\")")
+    #define _SIMD_BEGIN_TARGET_AVX2_ _Pragma("GCC push_options") _Pragma("GCC target(\"avx2\")")
+    #define _SIMD_BEGIN_TARGET_AVX2_FMA_ _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma\")")
+    #define _SIMD_BEGIN_TARGET_AVX512_ _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx512bw,avx512dq\")")
+    #define _SIMD_END_TARGET_ _Pragma("GCC pop_options")
+#else
+    // MSVC allows every intrinsic regardless of /arch
+    #define _SIMD_BEGIN_TARGET_SSE2_
+    #define _SIMD_BEGIN_TARGET_AVX2_
+    #define _SIMD_BEGIN_TARGET_AVX2_FMA_
+    #define _SIMD_BEGIN_TARGET_AVX512_
+    #define _SIMD_END_TARGET_
+#endif
+
+// Integer division without SVML. Lanes go through float (8 and 16 bit) or double (32 bit), both are exact: the
+// operands convert exactly and the correctly rounded quotient truncates to the integer quotient. The AVX2 kernels are
+// compiled whatever the build flags and Quotient picks them at runtime, 64 bit lanes and CPUs without AVX2 divide
+// lane by lane. Division by zero is undefined as in scalar code, overflowing quotients (INT_MIN / -1) wrap.
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Division
+{
+// Scalar lane division, x86 traps on INT_MIN / -1 so that quotient is wrapped here
+template<typename E>
+_SIMD_INL_ E Lane(E a, E b)
+{
+    typedef typename std::make_unsigned<E>::type U;
+    return (std::is_signed<E>::value && b == static_cast<E>(-1)) ? static_cast<E>(U(0) - static_cast<U>(a)) : static_cast<E>(a / b);
+}
+
+// Lane by lane quotients, the fallback for 64 bit lanes and CPUs without AVX2
+template<typename E>
+struct Scalar
+{
+    static _SIMD_INL_ void Apply(E* to, const E* a, const E* b, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            to[i] = Lane(a[i], b[i]);
+        }
+    }
+};
+
+// The kernels take counts that are a multiple of 8 lanes (4 for 32 bit lanes). They are not force inlined, callers
+// compiled without AVX2 could not inline them
+_SIMD_BEGIN_TARGET_AVX2_
+namespace AVX2
+{
+    template<typename E>
+    struct Quotient : Scalar<E> {};
+
+    // 8 int32 lanes to 8 int16 lanes, truncating like the scalar conversion
+    _SIMD_INL_ __m128i Narrow32To16(__m256i v)
+    {
+        v = _mm256_and_si256(v, _mm256_set1_epi32(0xFFFF));
+        return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    }
+    _SIMD_INL_ __m256i Quotient8(__m256i a, __m256i b)
+    {
+        return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(a), _mm256_cvtepi32_ps(b)));
+    }
+
+#define CREATE_DIVISION_QUOTIENT_16(TYPE, WIDEN) \
+template<> \
+struct Quotient<TYPE> \
+{ \
+    static void Apply(TYPE* to, const TYPE* a, const TYPE* b, unsigned int count) \
+    { \
+        for (unsigned int i = 0; i < count; i += 8) \
+        { \
+            const __m256i q = Quotient8(WIDEN(_mm_loadu_si128((const __m128i*)(a + i))), WIDEN(_mm_loadu_si128((const __m128i*)(b + i)))); \
+            _mm_storeu_si128((__m128i*)(to + i), Narrow32To16(q)); \
+        } \
+    } \
+};
+
+#define CREATE_DIVISION_QUOTIENT_8(TYPE, WIDEN) \
+template<> \
+struct Quotient<TYPE> \
+{ \
+    static void Apply(TYPE* to, const TYPE* a, const TYPE* b, unsigned int count) \
+    { \
+        for (unsigned int i = 0; i < count; i += 8) \
+        { \
+            const __m256i q = Quotient8(WIDEN(_mm_loadl_epi64((const __m128i*)(a + i))), WIDEN(_mm_loadl_epi64((const __m128i*)(b + i)))); \
+            const __m128i bytes = _mm_and_si128(Narrow32To16(q), _mm_set1_epi16(0xFF)); \
+            _mm_storel_epi64((__m128i*)(to + i), _mm_packus_epi16(bytes, bytes)); \
+        } \
+    } \
+};
+
+    CREATE_DIVISION_QUOTIENT_8(int8_t, _mm256_cvtepi8_epi32)
+    CREATE_DIVISION_QUOTIENT_8(uint8_t, _mm256_cvtepu8_epi32)
+    CREATE_DIVISION_QUOTIENT_16(int16_t, _mm256_cvtepi16_epi32)
+    CREATE_DIVISION_QUOTIENT_16(uint16_t, _mm256_cvtepu16_epi32)
+
+    template<>
+    struct Quotient<int32_t>
+    {
+        static void Apply(int32_t* to, const int32_t* a, const int32_t* b, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 4)
+            {
+                const __m256d q = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(a + i))), _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(b + i))));
+                _mm_storeu_si128((__m128i*)(to + i), _mm256_cvttpd_epi32(q));
+            }
+        }
+    };
+    // Unsigned lanes are biased into the signed range for the conversions and the bias is added back as a double
+    template<>
+    struct Quotient<uint32_t>
+    {
+        static _SIMD_INL_ __m256d ToDouble(__m128i v)
+        {
+            return _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(v, _mm_set1_epi32(static_cast<int>(0x80000000u)))), _mm256_set1_pd(2147483648.0));
+        }
+        static void Apply(uint32_t* to, const uint32_t* a, const uint32_t* b, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i += 4)
+            {
+                const __m256d q = _mm256_round_pd(_mm256_div_pd(ToDouble(_mm_loadu_si128((const __m128i*)(a + i))), ToDouble(_mm_loadu_si128((const __m128i*)(b + i)))), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                const __m128i biased = _mm256_cvttpd_epi32(_mm256_sub_pd(q, _mm256_set1_pd(2147483648.0)));
+                _mm_storeu_si128((__m128i*)(to + i), _mm_xor_si128(biased, _mm_set1_epi32(static_cast<int>(0x80000000u))));
+            }
+        }
+    };
+
+#undef CREATE_DIVISION_QUOTIENT_8
+#undef CREATE_DIVISION_QUOTIENT_16
+}
+_SIMD_END_TARGET_
+
+// The AVX2 kernels when the build targets AVX2, otherwise they are picked when the CPU supports them
+template<typename E>
+struct Quotient
+{
+    static _SIMD_INL_ void Apply(E* to, const E* a, const E* b, unsigned int count)
+    {
+#if defined(AVX2_AVAILABLE)
+        AVX2::Quotient<E>::Apply(to, a, b, count);
+#else
+        if (CPUFeatures::hasAVX2())
+        {
+            AVX2::Quotient<E>::Apply(to, a, b, count);
+        }
+        else
+        {
+            Scalar<E>::Apply(to, a, b, count);
+        }
+#endif
+    }
+};
+}
+}
+
+#define CREATE_INT_OPERATOR_PORTABLE_DIVIDE(XXX, XX) \
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, int##XX##_t> SIMD_Type_t<int, XXX, int##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<int##XX##_t>::Apply(result.Data, a.Data, b.Data, ElementCount);\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ SIMD_Type_t<int, XXX, uint##XX##_t> SIMD_Type_t<int, XXX, uint##XX##_t>::Divide(const SIMD_Type_t& a, const SIMD_Type_t& b) {\
+    SIMD_Type_t result((NoCheck()));\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<uint##XX##_t>::Apply(result.Data, a.Data, b.Data, ElementCount);\
+    return result;\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, int##XX##_t>::DivideInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
+{\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<int##XX##_t>::Apply(to.Data, to.Data, from.Data, ElementCount);\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, uint##XX##_t>::DivideInplace(SIMD_Type_t& to, const SIMD_Type_t& from)\
+{\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<uint##XX##_t>::Apply(to.Data, to.Data, from.Data, ElementCount);\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, int##XX##_t>::DivideInplaceRaw(int##XX##_t* to, const int##XX##_t* from)\
+{\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<int##XX##_t>::Apply(to, to, from, ElementCount);\
+}\
+template<>\
+_SIMD_INL_ void SIMD_Type_t<int, XXX, uint##XX##_t>::DivideInplaceRaw(uint##XX##_t* to, const uint##XX##_t* from)\
+{\
+    BASIC_SIMD_NAMESPACE::Division::Quotient<uint##XX##_t>::Apply(to, to, from, ElementCount);\
+}
+
+// GCC 12 reports the undefined sources of the masked AVX-512 builtins as uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// Elementary functions of float and double registers without SVML. Arguments are reduced to a small interval
+// (multiples of ln2 for exp, the exponent for log, multiples of pi/2 for sin and cos) and a truncated Taylor
+// series is evaluated with Horner's scheme. The Ops specializations are the only register specific code, the
+// Kernels are shared by float and double and by 256 and 512 bits. Error bounds are listed in the README.
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Math
+{
+template<typename E, int Bits> struct Ops;
+
+// c0 + x * (c1 + x * (c2 + ...))
+template<typename O>
+_SIMD_INL_ typename O::V Polynomial(typename O::V, typename O::E c)
+{
+    return O::Set(c);
+}
+template<typename O, typename... Rest>
+_SIMD_INL_ typename O::V Polynomial(typename O::V x, typename O::E c, Rest... rest)
+{
+    return O::MulAdd(Polynomial<O>(x, rest...), x, O::Set(c));
+}
+
+template<typename E> struct Coefficients;
+template<typename E, int Bits> struct Power;
+
+template<>
+struct Coefficients<float>
+{
+    static constexpr float Log2e = 1.44269504f;
+    /* ln2 and pi/2 split into parts whose products with the small integers of the reduction are exact */
+    static constexpr float Ln2Hi = 0.693359375f;
+    static constexpr float Ln2Lo = -2.12194440e-4f;
+    static constexpr float TwoOverPi = 0.636619772f;
+    static constexpr float PiOver2_1 = 1.5703125f;
+    static constexpr float PiOver2_2 = 4.83751297e-4f;
+    static constexpr float PiOver2_3 = 7.54953362e-8f;
+    static constexpr float PiOver2_4 = 2.56334415e-12f;
+    /* Beyond it the reduction loses bits and Sin/Cos fall back to the C library */
+    static constexpr float TrigLimit = 8192.0f;
+    /* Past these exp over or underflows, clamping keeps the scale factors finite */
+    static constexpr float ExpMin = -104.0f;
+    static constexpr float ExpMax = 89.0f;
+    static constexpr float MinNormal = 1.17549435e-38f;
+    static constexpr float DenormalScale = 8388608.0f;
+    static constexpr float DenormalExponent = 23.0f;
+    static constexpr float Sqrt2 = 1.41421356f;
+    static constexpr float TanhSmall = 0.55f;
+
+    template<typename O> static _SIMD_INL_ typename O::V Exp(typename O::V r)
+    {
+        return Polynomial<O>(r, 1.0f, 1.0f, 0.5f, 0.166666672f, 0.0416666679f, 0.00833333377f, 0.00138888892f, 0.000198412701f);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Log(typename O::V z)
+    {
+        return Polynomial<O>(z, 0.666666687f, 0.400000006f, 0.285714298f, 0.222222224f, 0.181818187f);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Sin(typename O::V z)
+    {
+        return Polynomial<O>(z, -0.166666672f, 0.00833333377f, -0.000198412701f, 2.75573188e-06f);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Cos(typename O::V z)
+    {
+        return Polynomial<O>(z, 0.0416666679f, -0.00138888892f, 2.48015876e-05f, -2.755732e-07f);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Tanh(typename O::V z)
+    {
+        return Polynomial<O>(z, -0.333333343f, 0.13333334f, -0.0539682545f, 0.0218694881f, -0.00886323582f, 0.00359212793f,
+            -0.00145583437f, 0.000590027426f);
+    }
+};
+
+template<>
+struct Coefficients<double>
+{
+    static constexpr double Log2e = 1.4426950408889634;
+    static constexpr double Ln2Hi = 6.93145751953125e-1;
+    static constexpr double Ln2Lo = 1.42860682030941723212e-6;
+    static constexpr double TwoOverPi = 0.63661977236758138;
+    static constexpr double PiOver2_1 = 1.5707963267341256;
+    static constexpr double PiOver2_2 = 6.0771005063039660e-11;
+    static constexpr double PiOver2_3 = 2.0222662487111665e-21;
+    static constexpr double PiOver2_4 = 8.4784276603688996e-32;
+    static constexpr double TrigLimit = 1048576.0;
+    static constexpr double ExpMin = -746.0;
+    static constexpr double ExpMax = 710.0;
+    static constexpr double MinNormal = 2.2250738585072014e-308;
+    static constexpr double DenormalScale = 4503599627370496.0;
+    static constexpr double DenormalExponent = 52.0;
+    static constexpr double Sqrt2 = 1.4142135623730951;
+    static constexpr double TanhSmall = 0.4;
+
+    template<typename O> static _SIMD_INL_ typename O::V Exp(typename O::V r)
+    {
+        return Polynomial<O>(r, 1.0, 1.0, 0.5, 0.16666666666666666, 0.041666666666666664, 0.0083333333333333332,
+            0.0013888888888888889, 0.00019841269841269841, 2.4801587301587302e-05, 2.7557319223985893e-06,
+            2.7557319223985888e-07, 2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Log(typename O::V z)
+    {
+        return Polynomial<O>(z, 0.66666666666666663, 0.40000000000000002, 0.2857142857142857, 0.22222222222222221,
+            0.18181818181818182, 0.15384615384615385, 0.13333333333333333, 0.11764705882352941, 0.10526315789473684,
+            0.095238095238095233, 0.086956521739130432);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Sin(typename O::V z)
+    {
+        return Polynomial<O>(z, -0.16666666666666666, 0.0083333333333333332, -0.00019841269841269841, 2.7557319223985893e-06,
+            -2.505210838544172e-08, 1.6059043836821613e-10, -7.6471637318198164e-13, 2.8114572543455206e-15);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Cos(typename O::V z)
+    {
+        return Polynomial<O>(z, 0.041666666666666664, -0.0013888888888888889, 2.4801587301587302e-05, -2.7557319223985888e-07,
+            2.08767569878681e-09, -1.1470745597729725e-11, 4.7794773323873853e-14, -1.5619206968586225e-16);
+    }
+    template<typename O> static _SIMD_INL_ typename O::V Tanh(typename O::V z)
+    {
+        return Polynomial<O>(z, -0.33333333333333331, 0.13333333333333333, -0.053968253968253971, 0.021869488536155203,
+            -0.0088632355299021973, 0.0035921280365724811, -0.0014558343870513183, 0.00059002744094558595,
+            -0.00023912911424355248, 9.6915379569294509e-05, -3.9278323883316833e-05, 1.5918905069328964e-05,
+            -6.4516892156554306e-06, 2.6147711512907546e-06);
+    }
+};
+
+// Arithmetic shared by the four register types. Min and Max return the second operand when either is NaN, the
+// kernels rely on that to pass NaN through the clamps.
+#define CREATE_MATH_OPS_ARITHMETIC(XXX, SFX, SET1) \
+    static _SIMD_INL_ V Set(E a) { return _mm##XXX##_set1_##SFX(a); }\
+    static _SIMD_INL_ V Add(V a, V b) { return _mm##XXX##_add_##SFX(a, b); }\
+    static _SIMD_INL_ V Sub(V a, V b) { return _mm##XXX##_sub_##SFX(a, b); }\
+    static _SIMD_INL_ V Mul(V a, V b) { return _mm##XXX##_mul_##SFX(a, b); }\
+    static _SIMD_INL_ V Div(V a, V b) { return _mm##XXX##_div_##SFX(a, b); }\
+    static _SIMD_INL_ V Min(V a, V b) { return _mm##XXX##_min_##SFX(a, b); }\
+    static _SIMD_INL_ V Max(V a, V b) { return _mm##XXX##_max_##SFX(a, b); }\
+    static _SIMD_INL_ V Sqrt(V a) { return _mm##XXX##_sqrt_##SFX(a); }\
+    static _SIMD_INL_ V Abs(V a) { return And(a, FromBits(SET1(std::numeric_limits<BitsType>::max()))); }\
+    static _SIMD_INL_ V SignBits(V a) { return And(a, FromBits(SET1(std::numeric_limits<BitsType>::min()))); }
+
+// Bit level helpers on integer lanes as wide as the floating point lanes. Adding 1.5 * 2^Mantissa to an integral
+// value leaves it in the low bits of the sum, which avoids 64 bit conversions that AVX2 does not have.
+#define CREATE_MATH_OPS_BITS(XXX, SFX, SI, EPI, SET1, BITS) \
+    static _SIMD_INL_ V FromBits(I a) { return _mm##XXX##_castsi##XXX##_##SFX(a); }\
+    static _SIMD_INL_ I ToBits(V a) { return _mm##XXX##_cast##SFX##_si##XXX(a); }\
+    static _SIMD_INL_ V And(V a, V b) { return FromBits(_mm##XXX##_and_##SI(ToBits(a), ToBits(b))); }\
+    static _SIMD_INL_ V Or(V a, V b) { return FromBits(_mm##XXX##_or_##SI(ToBits(a), ToBits(b))); }\
+    static _SIMD_INL_ V Xor(V a, V b) { return FromBits(_mm##XXX##_xor_##SI(ToBits(a), ToBits(b))); }\
+    /* Low bits of integral n */\
+    static _SIMD_INL_ I Integer(V n) { return ToBits(Add(n, Set(E(1.5) * One))); }\
+    /* 2^k for integral k whose biased exponent is between 1 and the largest finite one */\
+    static _SIMD_INL_ V Pow2(V k)\
+    {\
+        return FromBits(_mm##XXX##_slli_##EPI(_mm##XXX##_add_##EPI(Integer(k), SET1(Bias)), Mantissa));\
+    }\
+    /* Unbiased exponent of a positive normal a */\
+    static _SIMD_INL_ V Exponent(V a)\
+    {\
+        const I field = _mm##XXX##_srli_##EPI(ToBits(a), Mantissa);\
+        return Sub(FromBits(_mm##XXX##_or_##SI(field, ToBits(Set(One)))), Set(One + E(Bias)));\
+    }\
+    /* Significand of a positive normal a, in [1, 2) */\
+    static _SIMD_INL_ V Significand(V a)\
+    {\
+        const I fraction = _mm##XXX##_and_##SI(ToBits(a), SET1((BitsType(1) << Mantissa) - 1));\
+        return FromBits(_mm##XXX##_or_##SI(fraction, ToBits(Set(E(1)))));\
+    }\
+    /* Bit 1 of integral n moved to the sign bit */\
+    static _SIMD_INL_ V QuadrantSign(V n)\
+    {\
+        return FromBits(_mm##XXX##_slli_##EPI(_mm##XXX##_and_##SI(Integer(n), SET1(2)), BITS - 2));\
+    }
+
+#if defined(AVX2_AVAILABLE)
+#define CREATE_MATH_OPS_256(SFX, BITS, SET1) \
+    static _SIMD_INL_ V MulAdd(V a, V b, V c) { return FUSED_OR_SEPARATE_256(SFX, a, b, c); }\
+    static _SIMD_INL_ V Round(V a) { return _mm256_round_##SFX(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }\
+    static _SIMD_INL_ V Floor(V a) { return _mm256_floor_##SFX(a); }\
+    static _SIMD_INL_ M Lt(V a, V b) { return _mm256_cmp_##SFX(a, b, _CMP_LT_OQ); }\
+    static _SIMD_INL_ M Le(V a, V b) { return _mm256_cmp_##SFX(a, b, _CMP_LE_OQ); }\
+    static _SIMD_INL_ M Eq(V a, V b) { return _mm256_cmp_##SFX(a, b, _CMP_EQ_OQ); }\
+    static _SIMD_INL_ M Unordered(V a, V b) { return _mm256_cmp_##SFX(a, b, _CMP_UNORD_Q); }\
+    static _SIMD_INL_ M MaskAnd(M a, M b) { return _mm256_and_##SFX(a, b); }\
+    static _SIMD_INL_ M MaskOr(M a, M b) { return _mm256_or_##SFX(a, b); }\
+    static _SIMD_INL_ M MaskAndNot(M a, M b) { return _mm256_andnot_##SFX(b, a); }\
+    static _SIMD_INL_ V Select(M m, V a, V b) { return _mm256_blendv_##SFX(b, a, m); }\
+    static _SIMD_INL_ bool Any(M m) { return _mm256_movemask_##SFX(m) != 0; }\
+    static _SIMD_INL_ M OddLanes(V n)\
+    {\
+        const I one = SET1(1);\
+        return FromBits(_mm256_cmpeq_epi##BITS(_mm256_and_si256(Integer(n), one), one));\
+    }
+
+#if defined(FMA_AVAILABLE)
+    #define FUSED_OR_SEPARATE_256(SFX, A, B, C) _mm256_fmadd_##SFX(A, B, C)
+#else
+    #define FUSED_OR_SEPARATE_256(SFX, A, B, C) _mm256_add_##SFX(_mm256_mul_##SFX(A, B), C)
+#endif
+
+template<>
+struct Ops<float, 256>
+{
+    typedef __m256 V;
+    typedef __m256 M;
+    typedef __m256i I;
+    typedef float E;
+    typedef int32_t BitsType;
+    static constexpr int Mantissa = 23;
+    static constexpr BitsType Bias = 127;
+    static constexpr float One = 8388608.0f;
+    CREATE_MATH_OPS_BITS(256, ps, si256, epi32, _mm256_set1_epi32, 32)
+    CREATE_MATH_OPS_ARITHMETIC(256, ps, _mm256_set1_epi32)
+    CREATE_MATH_OPS_256(ps, 32, _mm256_set1_epi32)
+    static _SIMD_INL_ void Widen(V a, __m256d& low, __m256d& high)
+    {
+        low = _mm256_cvtps_pd(_mm256_castps256_ps128(a));
+        high = _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1));
+    }
+    static _SIMD_INL_ V Narrow(__m256d low, __m256d high)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1);
+    }
+    /* Rounding error of the product p = a * b, zero without FMA */
+    static _SIMD_INL_ V ProductError(V a, V b, V p)
+    {
+#if defined(FMA_AVAILABLE)
+        return _mm256_fmsub_ps(a, b, p);
+#else
+        return _mm256_setzero_ps();
+#endif
+    }
+    /* 12 bit estimate refined by one Newton step. Zero, infinity, NaN, negative and denormal lanes keep the estimate */
+    static _SIMD_INL_ V RSqrt(V a)
+    {
+        const V y = _mm256_rsqrt_ps(a);
+        const V n = Mul(y, MulAdd(Mul(Set(-0.5f), a), Mul(y, y), Set(1.5f)));
+        return Select(MaskAnd(Le(Set(Coefficients<float>::MinNormal), a), Lt(a, Set(std::numeric_limits<float>::infinity()))), n, y);
+    }
+};
+
+template<>
+struct Ops<double, 256>
+{
+    typedef __m256d V;
+    typedef __m256d M;
+    typedef __m256i I;
+    typedef double E;
+    typedef int64_t BitsType;
+    static constexpr int Mantissa = 52;
+    static constexpr BitsType Bias = 1023;
+    static constexpr double One = 4503599627370496.0;
+    CREATE_MATH_OPS_BITS(256, pd, si256, epi64, _mm256_set1_epi64x, 64)
+    CREATE_MATH_OPS_ARITHMETIC(256, pd, _mm256_set1_epi64x)
+    CREATE_MATH_OPS_256(pd, 64, _mm256_set1_epi64x)
+    /* table[index] for integral index, the masked form has a defined source */
+    static _SIMD_INL_ V Gather(const double* table, V index)
+    {
+        return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, _mm256_cvttpd_epi32(index), _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+    }
+    static _SIMD_INL_ V ProductError(V a, V b, V p)
+    {
+#if defined(FMA_AVAILABLE)
+        return _mm256_fmsub_pd(a, b, p);
+#else
+        return _mm256_setzero_pd();
+#endif
+    }
+    /* No double estimate below AVX-512, the division keeps it within one ulp */
+    static _SIMD_INL_ V RSqrt(V a)
+    {
+        return Div(Set(1.0), Sqrt(a));
+    }
+};
+#endif
+
+#if defined(AVX512F_AVAILABLE)
+#define CREATE_MATH_OPS_512(SFX, BITS) \
+    static _SIMD_INL_ V MulAdd(V a, V b, V c) { return _mm512_fmadd_##SFX(a, b, c); }\
+    static _SIMD_INL_ V ProductError(V a, V b, V p) { return _mm512_fmsub_##SFX(a, b, p); }\
+    static _SIMD_INL_ V Round(V a) { return _mm512_roundscale_##SFX(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }\
+    static _SIMD_INL_ V Floor(V a) { return _mm512_roundscale_##SFX(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }\
+    static _SIMD_INL_ M Lt(V a, V b) { return _mm512_cmp_##SFX##_mask(a, b, _CMP_LT_OQ); }\
+    static _SIMD_INL_ M Le(V a, V b) { return _mm512_cmp_##SFX##_mask(a, b, _CMP_LE_OQ); }\
+    static _SIMD_INL_ M Eq(V a, V b) { return _mm512_cmp_##SFX##_mask(a, b, _CMP_EQ_OQ); }\
+    static _SIMD_INL_ M Unordered(V a, V b) { return _mm512_cmp_##SFX##_mask(a, b, _CMP_UNORD_Q); }\
+    static _SIMD_INL_ M MaskAnd(M a, M b) { return static_cast<M>(a & b); }\
+    static _SIMD_INL_ M MaskOr(M a, M b) { return static_cast<M>(a | b); }\
+    static _SIMD_INL_ M MaskAndNot(M a, M b) { return static_cast<M>(a & ~b); }\
+    static _SIMD_INL_ V Select(M m, V a, V b) { return _mm512_mask_blend_##SFX(m, b, a); }\
+    static _SIMD_INL_ bool Any(M m) { return m != 0; }\
+    static _SIMD_INL_ M OddLanes(V n) { return _mm512_test_epi##BITS##_mask(Integer(n), _mm512_set1_epi##BITS(1)); }
+
+template<>
+struct Ops<float, 512>
+{
+    typedef __m512 V;
+    typedef __mmask16 M;
+    typedef __m512i I;
+    typedef float E;
+    typedef int32_t BitsType;
+    static constexpr int Mantissa = 23;
+    static constexpr BitsType Bias = 127;
+    static constexpr float One = 8388608.0f;
+    CREATE_MATH_OPS_BITS(512, ps, si512, epi32, _mm512_set1_epi32, 32)
+    CREATE_MATH_OPS_ARITHMETIC(512, ps, _mm512_set1_epi32)
+    CREATE_MATH_OPS_512(ps, 32)
+    static _SIMD_INL_ void Widen(V a, __m512d& low, __m512d& high)
+    {
+        low = _mm512_cvtps_pd(_mm512_castps512_ps256(a));
+        high = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+    }
+    static _SIMD_INL_ V Narrow(__m512d low, __m512d high)
+    {
+        return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(_mm512_cvtpd_ps(low))), _mm256_castps_pd(_mm512_cvtpd_ps(high)), 1));
+    }
+    /* 14 bit estimate refined by one Newton step, the special lanes keep the estimate */
+    static _SIMD_INL_ V RSqrt(V a)
+    {
+        const V y = _mm512_rsqrt14_ps(a);
+        const V n = Mul(y, MulAdd(Mul(Set(-0.5f), a), Mul(y, y), Set(1.5f)));
+        return Select(MaskAnd(Le(Set(Coefficients<float>::MinNormal), a), Lt(a, Set(std::numeric_limits<float>::infinity()))), n, y);
+    }
+};
+
+template<>
+struct Ops<double, 512>
+{
+    typedef __m512d V;
+    typedef __mmask8 M;
+    typedef __m512i I;
+    typedef double E;
+    typedef int64_t BitsType;
+    static constexpr int Mantissa = 52;
+    static constexpr BitsType Bias = 1023;
+    static constexpr double One = 4503599627370496.0;
+    CREATE_MATH_OPS_BITS(512, pd, si512, epi64, _mm512_set1_epi64, 64)
+    CREATE_MATH_OPS_ARITHMETIC(512, pd, _mm512_set1_epi64)
+    CREATE_MATH_OPS_512(pd, 64)
+    static _SIMD_INL_ V Gather(const double* table, V index)
+    {
+        return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, _mm512_cvttpd_epi32(index), table, 8);
+    }
+    static _SIMD_INL_ V RSqrt(V a)
+    {
+        return Div(Set(1.0), Sqrt(a));
+    }
+};
+#endif
+
+template<typename E, int Bits>
+struct Kernels
+{
+    typedef Ops<E, Bits> O;
+    typedef typename O::V V;
+    typedef typename O::M M;
+    typedef Coefficients<E> C;
+
+    /* e^(hi + lo), lo is a correction below the precision of hi. The scale 2^k is applied in two halves so
+       results in the denormal range round once and exp(ExpMax) still overflows to infinity. */
+    static _SIMD_INL_ V Exp(V hi, V lo)
+    {
+        const V x = O::Min(O::Set(C::ExpMax), O::Max(O::Set(C::ExpMin), hi));
+        const V k = O::Round(O::Mul(x, O::Set(C::Log2e)));
+        V r = O::MulAdd(k, O::Set(-C::Ln2Hi), x);
+        r = O::Add(O::MulAdd(k, O::Set(-C::Ln2Lo), r), lo);
+        const V half = O::Floor(O::Mul(k, O::Set(E(0.5))));
+        return O::Mul(O::Mul(C::template Exp<O>(r), O::Pow2(half)), O::Pow2(O::Sub(k, half)));
+    }
+    static _SIMD_INL_ V Exp(V x)
+    {
+        return Exp(x, O::Set(E(0)));
+    }
+
+    /* fdlibm: x = 2^e * (1 + f) with 1 + f in [sqrt(2)/2, sqrt(2)], s = f / (2 + f) and
+       ln(1 + f) = f - f^2/2 + s * (f^2/2 + R(s^2)). Denormals are scaled into the normal range first */
+    static _SIMD_INL_ V Log(V x)
+    {
+        const V zero = O::Set(E(0));
+        const M denormal = O::Lt(x, O::Set(C::MinNormal));
+        const V scaled = O::Select(denormal, O::Mul(x, O::Set(C::DenormalScale)), x);
+        V e = O::Sub(O::Exponent(scaled), O::Select(denormal, O::Set(C::DenormalExponent), zero));
+        V m = O::Significand(scaled);
+        const M high = O::Lt(O::Set(C::Sqrt2), m);
+        m = O::Select(high, O::Mul(m, O::Set(E(0.5))), m);
+        e = O::Select(high, O::Add(e, O::Set(E(1))), e);
+        const V f = O::Sub(m, O::Set(E(1)));
+        const V s = O::Div(f, O::Add(f, O::Set(E(2))));
+        const V z = O::Mul(s, s);
+        const V halfSquare = O::Mul(O::Mul(f, O::Set(E(0.5))), f);
+        const V tail = O::MulAdd(s, O::MulAdd(z, C::template Log<O>(z), halfSquare), O::Mul(e, O::Set(C::Ln2Lo)));
+        V r = O::MulAdd(e, O::Set(C::Ln2Hi), O::Sub(f, O::Sub(halfSquare, tail)));
+        r = O::Select(O::Eq(x, O::Set(std::numeric_limits<E>::infinity())), x, r);
+        r = O::Select(O::Lt(x, zero), O::Set(std::numeric_limits<E>::quiet_NaN()), r);
+        r = O::Select(O::Eq(x, zero), O::Set(-std::numeric_limits<E>::infinity()), r);
+        return O::Select(O::Unordered(x, x), x, r);
+    }
+
+    static _SIMD_INL_ V Pow(V x, V y)
+    {
+        return Power<E, Bits>::Apply(x, y);
+    }
+
+    /* False when a lane is beyond TrigLimit (or infinite), the caller then uses the C library */
+    static _SIMD_INL_ bool InTrigRange(V x)
+    {
+        return !O::Any(O::Lt(O::Set(C::TrigLimit), O::Abs(x)));
+    }
+    /* sin(x + quadrant * pi/2) */
+    static _SIMD_INL_ V SinCos(V x, E quadrant)
+    {
+        const V q = O::Round(O::Mul(x, O::Set(C::TwoOverPi)));
+        V r = O::MulAdd(q, O::Set(-C::PiOver2_1), x);
+        r = O::MulAdd(q, O::Set(-C::PiOver2_2), r);
+        r = O::MulAdd(q, O::Set(-C::PiOver2_3), r);
+        r = O::MulAdd(q, O::Set(-C::PiOver2_4), r);
+        const V z = O::Mul(r, r);
+        const V sine = O::MulAdd(O::Mul(z, r), C::template Sin<O>(z), r);
+        const V cosine = O::MulAdd(O::Mul(z, z), C::template Cos<O>(z), O::MulAdd(z, O::Set(E(-0.5)), O::Set(E(1))));
+        const V n = O::Add(q, O::Set(quadrant));
+        return O::Xor(O::Select(O::OddLanes(n), cosine, sine), O::QuadrantSign(n));
+    }
+    static _SIMD_INL_ V Sin(V x)
+    {
+        return SinCos(x, E(0));
+    }
+    static _SIMD_INL_ V Cos(V x)
+    {
+        return SinCos(x, E(1));
+    }
+
+    static _SIMD_INL_ V Sqrt(V x)
+    {
+        return O::Sqrt(x);
+    }
+    static _SIMD_INL_ V RSqrt(V x)
+    {
+        return O::RSqrt(x);
+    }
+
+    /* Taylor series below TanhSmall, 1 - 2 / (e^2|x| + 1) with the sign of x above */
+    static _SIMD_INL_ V Tanh(V x)
+    {
+        const V ax = O::Abs(x);
+        const V z = O::Mul(x, x);
+        const V small = O::MulAdd(O::Mul(z, x), C::template Tanh<O>(z), x);
+        const V e = Exp(O::Add(ax, ax));
+        const V large = O::Or(O::Sub(O::Set(E(1)), O::Div(O::Set(E(2)), O::Add(e, O::Set(E(1))))), O::SignBits(x));
+        return O::Select(O::Lt(ax, O::Set(C::TanhSmall)), small, large);
+    }
+};
+// y * ln(x) is reduced modulo ln2 by Exp, so ln(x) is needed to about 2^-62 relative or the error grows with
+// |y * ln(x)|. Double lanes look up 1/c and ln(c) for one of 128 intervals of the significand, which leaves
+// ln(1 + r) with |r| < 2^-8 where a short series is exact enough. Float lanes are evaluated in double.
+template<int Bits>
+struct Power<double, Bits>
+{
+    typedef Ops<double, Bits> O;
+    typedef typename O::V V;
+    typedef typename O::M M;
+    typedef Coefficients<double> C;
+
+    /* Rows of 1/c, ln(c) and the rounding error of ln(c). 1/c is the reciprocal of the center of interval i of
+       [sqrt(2)/2, sqrt(2)) rounded to 8 bits, so r = m / c - 1 is exact. The interval holding 1 uses c = 1 */
+    static const double* Table()
+    {
+        alignas(64) static const double table[] = {
+            1.40625, -0.34092658697059319, -1.7467136443544747e-17,
+            1.3984375, -0.33535554192113781, -1.834564437059473e-17,
+            1.390625, -0.32975328637246798, -2.122020616196946e-18,
+            1.375, -0.31845373111853459, -2.7114779367326236e-17,
+            1.3671875, -0.3127557100038969, 1.4518083530989511e-17,
+            1.359375, -0.30702503529491187, 1.2319916200101964e-17,
+            1.34375, -0.2954642128938359, 2.16461086040599e-17,
+            1.3359375, -0.28963329258304266, -2.0535953219858174e-17,
+            1.328125, -0.28376817313064462, 2.0326655811266561e-17,
+            1.3203125, -0.27786845100345631, 9.1601829490926308e-19,
+            1.3046875, -0.26596354849713794, -5.3393802761314314e-18,
+            1.296875, -0.25995752443692605, -2.069806938978935e-17,
+            1.2890625, -0.25391520998096345, 8.0480973944242013e-18,
+            1.28125, -0.24783616390458127, 1.2432209578702523e-17,
+            1.2734375, -0.24171993688714516, -8.9009900221666426e-18,
+            1.2578125, -0.22937410106484582, -9.9276718239780255e-18,
+            1.25, -0.22314355131420976, 9.091270597324799e-18,
+            1.2421875, -0.21687393830061436, -4.5510261932342832e-18,
+            1.234375, -0.21056476910734964, 4.2494053147298953e-18,
+            1.2265625, -0.20421554142869089, -2.7338281018722773e-18,
+            1.21875, -0.19782574332991987, -1.2821194372980142e-17,
+            1.2109375, -0.19139485299962947, 1.2129496905792884e-17,
+            1.203125, -0.18492233849401199, -3.0236614153574064e-18,
+            1.1953125, -0.17840765747281831, 1.2432553788701131e-17,
+            1.1875, -0.17185025692665923, 6.0224538210113705e-18,
+            1.1796875, -0.16524957289530717, 1.0094935622322628e-17,
+            1.171875, -0.15860503017663857, -1.1257003872182592e-17,
+            1.1640625, -0.15191604202584197, -6.4838631244022194e-18,
+            1.15625, -0.14518200984449789, -8.2424187830224754e-18,
+            1.1484375, -0.13840232285911913, -4.4477773013575269e-18,
+            1.140625, -0.13157635778871926, -1.1123000879729588e-17,
+            1.1328125, -0.12470347850095724, 4.6522609636496624e-18,
+            1.125, -0.11778303565638346, 1.1971685747593677e-18,
+            1.1171875, -0.11081436634029011, -1.1837483428256489e-18,
+            1.1171875, -0.11081436634029011, -1.1837483428256489e-18,
+            1.109375, -0.10379679368164356, -5.4777241572665901e-18,
+            1.1015625, -0.096729626458551113, 5.5973974862899648e-19,
+            1.09375, -0.089612158689687138, 5.4268129336647135e-18,
+            1.0859375, -0.082443669211074586, -5.7004377738139872e-18,
+            1.078125, -0.075223421237587532, 5.9306041962932407e-18,
+            1.078125, -0.075223421237587532, 5.9306041962932407e-18,
+            1.0703125, -0.067950661908507751, 1.2802141240611733e-18,
+            1.0625, -0.06062462181643484, -2.6424025938726934e-18,
+            1.0546875, -0.053244514518812285, 1.6655758169736629e-18,
+            1.046875, -0.045809536031294201, -1.9029598664742571e-18,
+            1.046875, -0.045809536031294201, -1.9029598664742571e-18,
+            1.0390625, -0.038318864302136602, 2.3579961573512861e-18,
+            1.03125, -0.030771658666753687, -1.0431732029005968e-18,
+            1.0234375, -0.023167059281534379, 1.1769544932063305e-18,
+            1.0234375, -0.023167059281534379, 1.1769544932063305e-18,
+            1.015625, -0.015504186535965254, 3.2783210228924291e-19,
+            1.0078125, -0.007782140442054949, 1.2819179123343845e-20,
+            1.0, 0.0, 0.0,
+            1.0, 0.0, 0.0,
+            0.9921875, 0.0078431774610258926, 2.7647081541249038e-19,
+            0.98828125, 0.01178795575204224, 2.2081546667966221e-19,
+            0.98046875, 0.01972450534777859, -1.3445979863167511e-18,
+            0.9765625, 0.023716526617316044, -1.5774243488668215e-18,
+            0.96875, 0.031748698314580298, 3.0382263084680858e-18,
+            0.96484375, 0.035789107851585282, -2.7409846740241849e-18,
+            0.9609375, 0.039845908547199674, -3.1295476803152081e-18,
+            0.95703125, 0.043919233934835489, 1.7623552700046292e-18,
+            0.94921875, 0.052116001139014018, 7.1036769831546065e-19,
+            0.9453125, 0.056239718322876081, -3.2835149805605613e-18,
+            0.94140625, 0.060380510988907482, -2.1569637373409678e-18,
+            0.93359375, 0.068713892548051811, -2.5298812881248404e-18,
+            0.9296875, 0.072906770808087787, -6.3068602575327778e-18,
+            0.92578125, 0.077117303344431287, 2.5654358635266204e-18,
+            0.921875, 0.081345639453952401, 5.0770763559311699e-18,
+            0.91796875, 0.085591930335403507, 6.769872319991152e-18,
+            0.91015625, 0.094138990913861909, 1.4973805419956277e-18,
+            0.90625, 0.098440072813252524, -4.4390096336751359e-18,
+            0.90234375, 0.10275973395776894, -4.7076308665606809e-18,
+            0.8984375, 0.1070981355563671, -1.73705104015906e-18,
+            0.89453125, 0.11145544092532282, 5.6859579190228389e-18,
+            0.890625, 0.1158318155251217, 4.338484369808096e-18,
+            0.88671875, 0.1202274269981598, -2.8375497328444001e-18,
+            0.8828125, 0.1246424452072766, -5.8089126789409707e-18,
+            0.875, 0.13353139262452263, -3.6644576636600847e-18,
+            0.87109375, 0.13800567301944372, -3.0827530029602492e-18,
+            0.8671875, 0.14250006260728304, -9.9263882342257491e-18,
+            0.86328125, 0.14701474296180966, -4.4669471850010201e-18,
+            0.859375, 0.15154989812720093, 5.1669593684615594e-18,
+            0.85546875, 0.15610571466306167, -1.2806970330932862e-17,
+            0.8515625, 0.16068238169047347, -3.6501835530478371e-18,
+            0.84765625, 0.16528009093910292, -6.2623135519199867e-19,
+            0.84375, 0.16989903679539747, -4.8680087644390708e-19,
+            0.83984375, 0.17453941635189968, -1.5833038914101321e-18,
+            0.8359375, 0.179201429457711, -1.0785017454858423e-17,
+            0.83203125, 0.18388527877013736, 6.7160941993445913e-18,
+            0.828125, 0.18859116980755003, -7.4321642191969251e-18,
+            0.82421875, 0.19331931100349597, 4.6304403151071438e-18,
+            0.8203125, 0.19806991376209379, 3.742843482461439e-18,
+            0.81640625, 0.20284319251475147, 2.0981425921481313e-18,
+            0.8125, 0.20763936477824449, 1.2053243216686129e-17,
+            0.80859375, 0.21245865121419341, -9.6311530627244906e-18,
+            0.8046875, 0.21730127568998139, 1.6168452453763015e-18,
+            0.8046875, 0.21730127568998139, 1.6168452453763015e-18,
+            0.80078125, 0.22216746534115431, -1.0797202916767509e-17,
+            0.796875, 0.22705745063534608, 9.5514157627384884e-18,
+            0.79296875, 0.23197146543777514, 5.7743205104792369e-18,
+            0.7890625, 0.23690974707835771, 1.9682402978398164e-18,
+            0.78515625, 0.24187253642048673, -3.5869293176775316e-18,
+            0.78125, 0.24686007793152578, 1.361743371748368e-17,
+            0.77734375, 0.25187261975507008, -1.8984402852371785e-18,
+            0.7734375, 0.25691041378502721, 2.502843296152504e-17,
+            0.7734375, 0.25691041378502721, 2.502843296152504e-17,
+            0.76953125, 0.26197371574157396, 3.769957084925505e-18,
+            0.765625, 0.26706278524904525, -7.3289153273201695e-18,
+            0.76171875, 0.27217788591581565, 1.9460544362807653e-17,
+            0.7578125, 0.27731928541623435, -7.4452840558351297e-18,
+            0.75390625, 0.28248725557467691, 1.3652325538490778e-17,
+            0.75390625, 0.28248725557467691, 1.3652325538490778e-17,
+            0.75, 0.2876820724517809, 2.607160616442564e-17,
+            0.74609375, 0.29290401643293262, -2.097144388760612e-17,
+            0.7421875, 0.29815337231907635, -1.720695867445866e-17,
+            0.7421875, 0.29815337231907635, -1.720695867445866e-17,
+            0.73828125, 0.3034304294199201, -4.1512585401039919e-18,
+            0.734375, 0.30873548164961329, -1.6199186085148102e-17,
+            0.73046875, 0.31406882762497584, 7.3110739850785249e-18,
+            0.7265625, 0.31943077076636123, 1.3542568572648111e-18,
+            0.7265625, 0.31943077076636123, 1.3542568572648111e-18,
+            0.72265625, 0.32482161940123766, -3.7162556628635935e-18,
+            0.71875, 0.33024168687057687, -1.0828321637483858e-17,
+            0.71875, 0.33024168687057687, -1.0828321637483858e-17,
+            0.71484375, 0.33569129163814154, -7.1837730203812826e-18,
+            0.7109375, 0.34117075740276714, -1.9366790062602867e-17,
+            0.70703125, 0.34668041321373672, 1.2904632283500345e-17
+        };
+        return table;
+    }
+    static _SIMD_INL_ V TwoSum(V a, V b, V& error)
+    {
+        const V sum = O::Add(a, b);
+        const V part = O::Sub(sum, a);
+        error = O::Add(O::Sub(a, O::Sub(sum, part)), O::Sub(b, part));
+        return sum;
+    }
+    /* x = 2^e * c * (1 + r) with c from the table row, r is exact */
+    static _SIMD_INL_ V Reduce(V x, V& e, V& row)
+    {
+        const M denormal = O::Lt(x, O::Set(C::MinNormal));
+        x = O::Select(denormal, O::Mul(x, O::Set(C::DenormalScale)), x);
+        e = O::Sub(O::Exponent(x), O::Select(denormal, O::Set(C::DenormalExponent), O::Set(0.0)));
+        V m = O::Significand(x);
+        const M high = O::Lt(O::Set(C::Sqrt2), m);
+        m = O::Select(high, O::Mul(m, O::Set(0.5)), m);
+        e = O::Select(high, O::Add(e, O::Set(1.0)), e);
+        row = O::Mul(O::Min(O::Floor(O::Mul(O::Sub(m, O::Set(0.70710678118654757)), O::Set(181.01933598375618))), O::Set(127.0)), O::Set(3.0));
+        return O::MulAdd(m, O::Gather(Table(), row), O::Set(-1.0));
+    }
+    /* ln(x) of a positive finite x to about 2^-45, enough for float results. |r| < 0.006 */
+    static _SIMD_INL_ V ShortLog(V x)
+    {
+        V e, row;
+        const V r = Reduce(x, e, row);
+        const V base = O::MulAdd(e, O::Set(C::Ln2Hi), O::Add(O::Gather(Table() + 1, row), O::Mul(e, O::Set(C::Ln2Lo))));
+        return O::MulAdd(r, Polynomial<O>(r, 1.0, -0.5, 0.33333333333333331, -0.25, 0.20000000000000001), base);
+    }
+    /* ln(x) of a positive finite x as hi + lo */
+    static _SIMD_INL_ V Log(V x, V& lo)
+    {
+        V e, row;
+        const V r = Reduce(x, e, row);
+        const double* table = Table();
+        /* ln(x) = e * ln2 + ln(c) + ln(1 + r), e * Ln2Hi is exact and the two large sums keep their rounding errors */
+        V firstError, secondError;
+        const V first = TwoSum(O::Mul(e, O::Set(C::Ln2Hi)), O::Gather(table + 1, row), firstError);
+        const V second = TwoSum(first, r, secondError);
+        const V halfR = O::Mul(r, O::Set(0.5));
+        const V halfSquare = O::Mul(halfR, r);
+        const V series = O::Sub(O::Mul(O::Mul(halfSquare, r), Polynomial<O>(r, 0.66666666666666663, -0.5, 0.40000000000000002,
+            -0.33333333333333331, 0.2857142857142857, -0.25, 0.22222222222222221, -0.20000000000000001)), O::Add(halfSquare, O::ProductError(halfR, r, halfSquare)));
+        const V low = O::Add(O::Add(firstError, secondError), O::Add(O::MulAdd(e, O::Set(C::Ln2Lo), O::Gather(table + 2, row)), series));
+        const V hi = O::Add(second, low);
+        lo = O::Sub(low, O::Sub(hi, second));
+        return hi;
+    }
+
+    /* Special cases follow C99 pow */
+    static _SIMD_INL_ V Apply(V x, V y)
+    {
+        const V zero = O::Set(0.0);
+        V lo;
+        const V hi = Log(O::Abs(x), lo);
+        const V t = O::Mul(y, hi);
+        /* The correction is dropped where Exp clamps t, it would only move the clamped argument */
+        const V tlo = O::MulAdd(y, lo, O::ProductError(y, hi, t));
+        const M clamped = O::MaskOr(O::Le(t, O::Set(C::ExpMin)), O::Le(O::Set(C::ExpMax), t));
+        return Special(x, y, Kernels<double, Bits>::Exp(t, O::Select(O::MaskOr(clamped, O::Unordered(t, t)), zero, tlo)));
+    }
+    /* The C99 results for zero, infinite, negative and NaN arguments patched into r = |x|^y */
+    static _SIMD_INL_ V Special(V x, V y, V r)
+    {
+        const V zero = O::Set(0.0);
+        const V one = O::Set(1.0);
+        const V infinity = O::Set(std::numeric_limits<double>::infinity());
+        const V ax = O::Abs(x);
+        const M negativeY = O::Lt(y, zero);
+        r = O::Select(O::Eq(ax, zero), O::Select(negativeY, infinity, zero), r);
+        r = O::Select(O::Eq(ax, infinity), O::Select(negativeY, zero, infinity), r);
+        const V halfY = O::Mul(y, O::Set(0.5));
+        const M integral = O::Eq(O::Round(y), y);
+        r = O::Select(O::MaskAndNot(integral, O::Eq(O::Round(halfY), halfY)), O::Xor(r, O::SignBits(x)), r);
+        const M negativeX = O::MaskAnd(O::Lt(x, zero), O::Lt(O::Set(-std::numeric_limits<double>::infinity()), x));
+        r = O::Select(O::MaskAndNot(negativeX, integral), O::Set(std::numeric_limits<double>::quiet_NaN()), r);
+        r = O::Select(O::Unordered(x, y), O::Add(x, y), r);
+        r = O::Select(O::MaskAnd(O::Eq(ax, one), O::Eq(O::Abs(y), infinity)), one, r);
+        return O::Select(O::MaskOr(O::Eq(x, one), O::Eq(y, zero)), one, r);
+    }
+};
+
+template<int Bits>
+struct Power<float, Bits>
+{
+    typedef Ops<float, Bits> O;
+    typedef typename O::V V;
+    typedef typename Ops<double, Bits>::V Wide;
+
+    typedef Ops<double, Bits> D;
+    typedef Coefficients<double> C;
+
+    /* e^t to about 2^-37, t is clamped to the float range so 2^k is a normal double */
+    static _SIMD_INL_ Wide Exp(Wide t)
+    {
+        t = D::Min(D::Set(Coefficients<float>::ExpMax), D::Max(D::Set(Coefficients<float>::ExpMin), t));
+        const Wide k = D::Round(D::Mul(t, D::Set(C::Log2e)));
+        const Wide r = D::MulAdd(k, D::Set(-C::Ln2Lo), D::MulAdd(k, D::Set(-C::Ln2Hi), t));
+        return D::Mul(Polynomial<D>(r, 1.0, 1.0, 0.5, 0.16666666666666666, 0.041666666666666664, 0.0083333333333333332,
+            0.0013888888888888889, 0.00019841269841269841, 2.4801587301587302e-05, 2.7557319223985893e-06), D::Pow2(k));
+    }
+    /* Evaluated in double, where y * ln(x) is accurate enough without the extended logarithm */
+    static _SIMD_INL_ Wide Half(Wide x, Wide y)
+    {
+        return Power<double, Bits>::Special(x, y, Exp(D::Mul(y, Power<double, Bits>::ShortLog(D::Abs(x)))));
+    }
+    static _SIMD_INL_ V Apply(V x, V y)
+    {
+        Wide xLow, xHigh, yLow, yHigh;
+        O::Widen(x, xLow, xHigh);
+        O::Widen(y, yLow, yHigh);
+        return O::Narrow(Half(xLow, yLow), Half(xHigh, yHigh));
+    }
+};
+} // namespace Math
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#if defined(SSE2_AVAILABLE)
+
+    CREATE_INT128_OPERATOR_PLUS(8);
+    CREATE_INT128_OPERATOR_PLUS(16);
+    CREATE_INT128_OPERATOR_PLUS(32);
+    CREATE_INT128_OPERATOR_PLUS(64);
+
+    CREATE_INT128_OPERATOR_MINUS(8);
+    CREATE_INT128_OPERATOR_MINUS(16);
+    CREATE_INT128_OPERATOR_MINUS(32);
+    CREATE_INT128_OPERATOR_MINUS(64);
+
+    CREATE_INT128_OPERATOR_EQUAL(8);
+    CREATE_INT128_OPERATOR_EQUAL(16);
+    CREATE_INT128_OPERATOR_EQUAL(32);
+    
+    CREATE_INT128_OPERATOR_MULTIPLY(16);
+
+    CREATE_INT128_OPERATOR_REDUCE(8);
+    CREATE_INT128_OPERATOR_REDUCE(16);
+    CREATE_INT128_OPERATOR_REDUCE(32);
+    CREATE_INT128_OPERATOR_REDUCE(64);
+
+    CREATE_INT128_OPERATOR_COMPARE(8);
+    CREATE_INT128_OPERATOR_COMPARE(16);
+    CREATE_INT128_OPERATOR_COMPARE(32);
+    CREATE_INT128_OPERATOR_ORDER(8);
+    CREATE_INT128_OPERATOR_ORDER(16);
+    CREATE_INT128_OPERATOR_ORDER(32);
+
+    CREATE_INT_OPERATOR_SATURATE(128, _mm, si128, 8);
+    CREATE_INT_OPERATOR_SATURATE(128, _mm, si128, 16);
+
+    CREATE_INT_OPERATOR_BITWISE(128, _mm, si128, 8);
+    CREATE_INT_OPERATOR_BITWISE(128, _mm, si128, 16);
+    CREATE_INT_OPERATOR_BITWISE(128, _mm, si128, 32);
+    CREATE_INT_OPERATOR_BITWISE(128, _mm, si128, 64);
+    CREATE_INT_OPERATOR_SHIFT(128, _mm, si128, 8);
+    CREATE_INT_OPERATOR_SHIFT(128, _mm, si128, 16);
+    CREATE_INT_OPERATOR_SHIFT(128, _mm, si128, 32);
+    CREATE_INT_OPERATOR_SHIFT(128, _mm, si128, 64);
+    
+    #if defined(SVML_COMPATIBLE_COMPILER)
+        CREATE_INT128_OPERATOR_DIVIDE(8);
+        CREATE_INT128_OPERATOR_DIVIDE(16);
+        CREATE_INT128_OPERATOR_DIVIDE(32);
+        CREATE_INT128_OPERATOR_DIVIDE(64);
+    #else
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(128, 8);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(128, 16);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(128, 32);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(128, 64);
+    #endif
+#endif
+
+#if defined(SSE4_1_AVAILABLE)
+    
+    CREATE_INT128_OPERATOR_EQUAL(64)
+    CREATE_INT128_OPERATOR_MULTIPLY(32);
+    CREATE_INT128_OPERATOR_COMPARE(64);
+
+    CREATE_INT_OPERATOR_REDUCE_ORDER(128, _mm, si128, 8);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(128, _mm, si128, 16);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(128, _mm, si128, 32);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(128, _mm, si128, 8);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(128, _mm, si128, 16);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(128, _mm, si128, 32);
+
+    CREATE_INT_OPERATOR_WIDEN(128, _mm, si128, 8, 16);
+    CREATE_INT_OPERATOR_WIDEN(128, _mm, si128, 16, 32);
+    CREATE_INT_OPERATOR_WIDEN(128, _mm, si128, 32, 64);
+    CREATE_INT_OPERATOR_NARROW(128, _mm, si128, 16, 8);
+    CREATE_INT_OPERATOR_NARROW(128, _mm, si128, 32, 16);
+
+#endif
+
+#if defined(SSE4_2_AVAILABLE)
+    CREATE_INT128_OPERATOR_ORDER(64);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(128, _mm, si128, 64);
+#endif
+
+#if defined(AVX2_AVAILABLE)
+
+    CREATE_INT256_OPERATOR_PLUS(8);
+    CREATE_INT256_OPERATOR_PLUS(16);
+    CREATE_INT256_OPERATOR_PLUS(32);
+    CREATE_INT256_OPERATOR_PLUS(64);
+
+    CREATE_INT256_OPERATOR_MINUS(8);
+    CREATE_INT256_OPERATOR_MINUS(16);
+    CREATE_INT256_OPERATOR_MINUS(32);
+    CREATE_INT256_OPERATOR_MINUS(64);
+
+    CREATE_INT256_OPERATOR_EQUAL(8);
+    CREATE_INT256_OPERATOR_EQUAL(16);
+    CREATE_INT256_OPERATOR_EQUAL(32);
+    CREATE_INT256_OPERATOR_EQUAL(64);
+
+    CREATE_INT256_OPERATOR_MULTIPLY(16);
+    CREATE_INT256_OPERATOR_MULTIPLY(32);
+
+    CREATE_INT256_OPERATOR_REDUCE(8);
+    CREATE_INT256_OPERATOR_REDUCE(16);
+    CREATE_INT256_OPERATOR_REDUCE(32);
+    CREATE_INT256_OPERATOR_REDUCE(64);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(256, _mm256, si256, 8);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(256, _mm256, si256, 16);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(256, _mm256, si256, 32);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(256, _mm256, si256, 64);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(256, _mm256, si256, 8);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(256, _mm256, si256, 16);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(256, _mm256, si256, 32);
+
+    CREATE_INT256_OPERATOR_COMPARE(8);
+    CREATE_INT256_OPERATOR_COMPARE(16);
+    CREATE_INT256_OPERATOR_COMPARE(32);
+    CREATE_INT256_OPERATOR_COMPARE(64);
+    CREATE_INT256_OPERATOR_ORDER(8);
+    CREATE_INT256_OPERATOR_ORDER(16);
+    CREATE_INT256_OPERATOR_ORDER(32);
+    CREATE_INT256_OPERATOR_ORDER(64);
+
+    CREATE_INT_OPERATOR_SATURATE(256, _mm256, si256, 8);
+    CREATE_INT_OPERATOR_SATURATE(256, _mm256, si256, 16);
+
+    CREATE_INT_OPERATOR_BITWISE(256, _mm256, si256, 8);
+    CREATE_INT_OPERATOR_BITWISE(256, _mm256, si256, 16);
+    CREATE_INT_OPERATOR_BITWISE(256, _mm256, si256, 32);
+    CREATE_INT_OPERATOR_BITWISE(256, _mm256, si256, 64);
+    CREATE_INT_OPERATOR_SHIFT(256, _mm256, si256, 8);
+    CREATE_INT_OPERATOR_SHIFT(256, _mm256, si256, 16);
+    CREATE_INT_OPERATOR_SHIFT(256, _mm256, si256, 32);
+    CREATE_INT_OPERATOR_SHIFT(256, _mm256, si256, 64);
+    // Per lane shifts of 8 and 16 bit lanes stay lane by lane, sllv_epi16 needs AVX-512
+    CREATE_INT_OPERATOR_SHIFT_LANES(128, _mm, si128, 32, _mm_srav_epi32);
+    CREATE_INT_OPERATOR_SHIFT_LANES(128, _mm, si128, 64, BASIC_SIMD_NAMESPACE::Lanes::ShiftRightI64);
+    CREATE_INT_OPERATOR_SHIFT_LANES(256, _mm256, si256, 32, _mm256_srav_epi32);
+    CREATE_INT_OPERATOR_SHIFT_LANES(256, _mm256, si256, 64, BASIC_SIMD_NAMESPACE::Lanes::ShiftRightI64);
+
+    CREATE_INT_OPERATOR_WIDEN(256, _mm256, si256, 8, 16);
+    CREATE_INT_OPERATOR_WIDEN(256, _mm256, si256, 16, 32);
+    CREATE_INT_OPERATOR_WIDEN(256, _mm256, si256, 32, 64);
+    CREATE_INT_OPERATOR_NARROW(256, _mm256, si256, 16, 8);
+    CREATE_INT_OPERATOR_NARROW(256, _mm256, si256, 32, 16);
+
+    CREATE_INT_OPERATOR_MASKED_MEMORY(128, _mm, si128, 32, int);
+    CREATE_INT_OPERATOR_MASKED_MEMORY(128, _mm, si128, 64, long long);
+    CREATE_INT_OPERATOR_MASKED_MEMORY(256, _mm256, si256, 32, int);
+    CREATE_INT_OPERATOR_MASKED_MEMORY(256, _mm256, si256, 64, long long);
+    CREATE_MASKED_PERMUTE_KERNEL(int, int32_t);
+    CREATE_MASKED_PERMUTE_KERNEL(int, uint32_t);
+    CREATE_MASKED_PERMUTE_KERNEL(int, int64_t);
+    CREATE_MASKED_PERMUTE_KERNEL(int, uint64_t);
+#endif
+
+#if defined(AVX_AVAILABLE)
+    CREATE_FLOAT_OPERATOR_PLUS(256);
+    CREATE_FLOAT_OPERATOR_MINUS(256);
+    CREATE_FLOAT_OPERATOR_MULTIPLY(256);
+    CREATE_FLOAT_OPERATOR_DIVIDE(256);
+
+    CREATE_DOUBLE_OPERATOR_PLUS(256);
+    CREATE_DOUBLE_OPERATOR_MINUS(256);
+    CREATE_DOUBLE_OPERATOR_MULTIPLY(256);
+    CREATE_DOUBLE_OPERATOR_DIVIDE(256);
+
+    CREATE_FLOAT_OPERATOR_REDUCE(256);
+    CREATE_DOUBLE_OPERATOR_REDUCE(256);
+
+    CREATE_FLOAT_OPERATOR_COMPARE(256);
+    CREATE_DOUBLE_OPERATOR_COMPARE(256);
+
+    CREATE_FLOATING_MASKED_MEMORY_KERNEL(float, ps);
+    CREATE_FLOATING_MASKED_MEMORY_KERNEL(double, pd);
+
+    #if defined(FMA_AVAILABLE)
+        CREATE_FLOAT_OPERATOR_FMA(256);
+        CREATE_DOUBLE_OPERATOR_FMA(256);
+    #endif
+
+    #if defined(AVX2_AVAILABLE)
+        CREATE_FLOAT_OPERATOR_MATH(256);
+        CREATE_DOUBLE_OPERATOR_MATH(256);
+        CREATE_FLOATING_OPERATOR_CONVERT(256);
+        CREATE_MASKED_PERMUTE_KERNEL(float, float);
+        CREATE_MASKED_PERMUTE_KERNEL(double, double);
+    #endif
+
+    #if defined(SVML_COMPATIBLE_COMPILER)
+        CREATE_INT256_OPERATOR_DIVIDE(8);
+        CREATE_INT256_OPERATOR_DIVIDE(16);
+        CREATE_INT256_OPERATOR_DIVIDE(32);
+        CREATE_INT256_OPERATOR_DIVIDE(64);
+    #else
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(256, 8);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(256, 16);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(256, 32);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(256, 64);
+    #endif
+#endif
+
+#if defined(AVX512BW_AVAILABLE)
+    CREATE_INT512_OPERATOR_PLUS(8);
+    CREATE_INT512_OPERATOR_PLUS(16);
+    CREATE_INT512_OPERATOR_MINUS(8);
+    CREATE_INT512_OPERATOR_MINUS(16);
+
+    CREATE_INT512_OPERATOR_MULTIPLY(16);
+
+    CREATE_INT512_OPERATOR_REDUCE(8);
+    CREATE_INT512_OPERATOR_REDUCE(16);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(512, _mm512, si512, 8);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(512, _mm512, si512, 16);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(512, _mm512, si512, 8);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(512, _mm512, si512, 16);
+
+    CREATE_INT512_OPERATOR_COMPARE(8);
+    CREATE_INT512_OPERATOR_COMPARE(16);
+
+    CREATE_INT_OPERATOR_SATURATE(512, _mm512, si512, 8);
+    CREATE_INT_OPERATOR_SATURATE(512, _mm512, si512, 16);
+
+    CREATE_INT_OPERATOR_SHIFT(512, _mm512, si512, 8);
+    CREATE_INT_OPERATOR_SHIFT(512, _mm512, si512, 16);
+    // Same GCC 12 false positive as in Horizontal for the unmasked variable shifts
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    CREATE_INT_OPERATOR_SHIFT_LANES(512, _mm512, si512, 16, _mm512_srav_epi16);
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+
+    CREATE_INT_OPERATOR_WIDEN(512, _mm512, si512, 8, 16);
+    CREATE_INT_OPERATOR_NARROW(512, _mm512, si512, 16, 8);
+    CREATE_INT_OPERATOR_NARROW(512, _mm512, si512, 32, 16);
+
+    CREATE_INT512_OPERATOR_MASKED(8);
+    CREATE_INT512_OPERATOR_MASKED(16);
+    CREATE_INT512_OPERATOR_MASKED_MULTIPLY(16);
+#endif
+
+#if defined(AVX512F_AVAILABLE)
+
+    CREATE_INT128_OPERATOR_MULTIPLY(64);
+    CREATE_INT256_OPERATOR_MULTIPLY(64);
+
+    CREATE_INT512_OPERATOR_PLUS(32);
+    CREATE_INT512_OPERATOR_PLUS(64);
+    
+    CREATE_INT512_OPERATOR_MINUS(32);
+    CREATE_INT512_OPERATOR_MINUS(64);
+
+    CREATE_INT512_OPERATOR_MULTIPLY(32);
+    CREATE_INT512_OPERATOR_MULTIPLY(64);
+
+    CREATE_INT512_OPERATOR_REDUCE(32);
+    CREATE_INT512_OPERATOR_REDUCE(64);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(512, _mm512, si512, 32);
+    CREATE_INT_OPERATOR_REDUCE_ORDER(512, _mm512, si512, 64);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(512, _mm512, si512, 32);
+    CREATE_INT_OPERATOR_REDUCE_PRODUCT(512, _mm512, si512, 64);
+
+    CREATE_INT512_OPERATOR_COMPARE(32);
+    CREATE_INT512_OPERATOR_COMPARE(64);
+
+    CREATE_INT_OPERATOR_BITWISE(512, _mm512, si512, 8);
+    CREATE_INT_OPERATOR_BITWISE(512, _mm512, si512, 16);
+    CREATE_INT_OPERATOR_BITWISE(512, _mm512, si512, 32);
+    CREATE_INT_OPERATOR_BITWISE(512, _mm512, si512, 64);
+    CREATE_INT_OPERATOR_SHIFT(512, _mm512, si512, 32);
+    CREATE_INT_OPERATOR_SHIFT(512, _mm512, si512, 64);
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    CREATE_INT_OPERATOR_SHIFT_LANES(512, _mm512, si512, 32, _mm512_srav_epi32);
+    CREATE_INT_OPERATOR_SHIFT_LANES(512, _mm512, si512, 64, _mm512_srav_epi64);
+
+    CREATE_INT_OPERATOR_WIDEN(512, _mm512, si512, 16, 32);
+    CREATE_INT_OPERATOR_WIDEN(512, _mm512, si512, 32, 64);
+    CREATE_INT_NARROW_KERNEL(512, _mm512, si512, int64_t, int32_t, BASIC_SIMD_NAMESPACE::Lanes::PackII64);
+    CREATE_INT_NARROW_KERNEL(512, _mm512, si512, uint64_t, uint32_t, BASIC_SIMD_NAMESPACE::Lanes::PackUU64);
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+
+    CREATE_FLOAT_OPERATOR_PLUS(512);
+    CREATE_FLOAT_OPERATOR_MINUS(512);
+    CREATE_FLOAT_OPERATOR_MULTIPLY(512);
+    CREATE_FLOAT_OPERATOR_DIVIDE(512);
+    CREATE_FLOAT_OPERATOR_FMA(512);
+    CREATE_FLOAT_OPERATOR_REDUCE(512);
+
+    CREATE_FLOAT_OPERATOR_EQUAL(512);
+    CREATE_FLOAT_OPERATOR_COMPARE(512);
+    
+    CREATE_DOUBLE_OPERATOR_PLUS(512);
+    CREATE_DOUBLE_OPERATOR_MINUS(512);
+    CREATE_DOUBLE_OPERATOR_MULTIPLY(512);
+    CREATE_DOUBLE_OPERATOR_DIVIDE(512);
+    CREATE_DOUBLE_OPERATOR_FMA(512);
+    CREATE_DOUBLE_OPERATOR_REDUCE(512);
+
+    CREATE_DOUBLE_OPERATOR_EQUAL(512);
+    CREATE_DOUBLE_OPERATOR_COMPARE(512);
+
+    CREATE_INT512_OPERATOR_MASKED(32);
+    CREATE_INT512_OPERATOR_MASKED(64);
+    CREATE_INT512_OPERATOR_MASKED_MULTIPLY(32);
+    #if defined(AVX512DQ_AVAILABLE)
+        CREATE_INT512_OPERATOR_MASKED_MULTIPLY(64);
+    #endif
+    CREATE_INT512_OPERATOR_COMPRESS(32);
+    CREATE_INT512_OPERATOR_COMPRESS(64);
+    CREATE_FLOATING512_OPERATOR_MASKED(float, ps);
+    CREATE_FLOATING512_OPERATOR_MASKED(double, pd);
+
+    CREATE_FLOAT_OPERATOR_MATH(512);
+    CREATE_DOUBLE_OPERATOR_MATH(512);
+    // Same GCC 12 false positive as in Horizontal for the unmasked conversions
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    CREATE_FLOATING_OPERATOR_CONVERT(512);
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+
+    #if defined(SVML_COMPATIBLE_COMPILER)
+        CREATE_INT512_OPERATOR_DIVIDE(8);
+        CREATE_INT512_OPERATOR_DIVIDE(16);
+        CREATE_INT512_OPERATOR_DIVIDE(32);
+        CREATE_INT512_OPERATOR_DIVIDE(64);
+    #else
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(512, 8);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(512, 16);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(512, 32);
+        CREATE_INT_OPERATOR_PORTABLE_DIVIDE(512, 64);
+    #endif
+#endif
+
+    
+// ██████╗  █████╗ ██████╗  █████╗ ██╗     ██╗     ███████╗██╗
+// ██╔══██╗██╔══██╗██╔══██╗██╔══██╗██║     ██║     ██╔════╝██║
+// ██████╔╝███████║██████╔╝███████║██║     ██║     █████╗  ██║
+// ██╔═══╝ ██╔══██║██╔══██╗██╔══██║██║     ██║     ██╔══╝  ██║
+// ██║     ██║  ██║██║  ██║██║  ██║███████╗███████╗███████╗███████╗
+// ╚═╝     ╚═╝  ╚═╝╚═╝  ╚═╝╚═╝  ╚═╝╚══════╝╚══════╝╚══════╝╚══════╝
+
+// Splits large buffers into cache line aligned chunks and runs them on a reusable worker pool.
+// Off by default, SetThreadCount turns it on; buffers below the threshold always stay on the calling thread.
+
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Parallel
+{
+
+class ThreadPool
+{
+public:
+    // 'threads' includes the calling thread, so threads - 1 workers are started
+    explicit ThreadPool(unsigned int threads) : Task(nullptr), TaskCount(0), Pinned(false), Next(0), Busy(0), Generation(0), Stop(false)
+    {
+        for (unsigned int i = 1; i < threads; i++)
+        {
+            Workers.emplace_back(&ThreadPool::Work, this, i);
+        }
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Stop = true;
+        }
+        Wake.notify_all();
+        for (std::thread& worker : Workers)
+        {
+            worker.join();
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int Threads() const
+    {
+        return static_cast<unsigned int>(Workers.size()) + 1;
+    }
+
+    // True on a thread that is running a task of any pool
+    static bool InTask()
+    {
+        return Participant();
+    }
+
+    // Calls task(index) for every index in [0, tasks) and returns once all of them finished.
+    // The calling thread takes part, concurrent calls are serialized, and every free thread takes the next task.
+    // Calls made from inside a task run all their tasks inline on that thread.
+    void Run(unsigned int tasks, const std::function<void(unsigned int)>& task)
+    {
+        Start(tasks, task, false);
+    }
+
+    // Like Run, but task i always runs on participant i % Threads(), the caller being participant 0. Repeated For
+    // calls over a buffer give every thread the same chunks, so the pages it touched first stay on its NUMA node
+    // (see FirstTouch).
+    void RunPinned(unsigned int tasks, const std::function<void(unsigned int)>& task)
+    {
+        Start(tasks, task, true);
+    }
+
+private:
+    // Marks the thread as a participant while it runs tasks, restoring the previous state on exit
+    struct ParticipantScope
+    {
+        ParticipantScope() : Previous(Participant()) { Participant() = true; }
+        ~ParticipantScope() { Participant() = Previous; }
+        bool Previous;
+    };
+    static bool& Participant()
+    {
+        static thread_local bool participant = false;
+        return participant;
+    }
+
+    void Start(unsigned int tasks, const std::function<void(unsigned int)>& task, bool pinned)
+    {
+        if (Workers.empty() || tasks <= 1 || InTask())
+        {
+            for (unsigned int i = 0; i < tasks; i++) task(i);
+            return;
+        }
+        std::lock_guard<std::mutex> run(RunMutex);
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Task = &task;
+            TaskCount = tasks;
+            Pinned = pinned;
+            Next.store(0, std::memory_order_relaxed);
+            Busy = static_cast<unsigned int>(Workers.size());
+            Generation++;
+        }
+        Wake.notify_all();
+        Drain(task, tasks, pinned, 0);
+        // Every worker has to check out before the next Run may reset the counter or the task goes out of scope,
+        // even when a task threw
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            Done.wait(lock, [this] { return Busy == 0; });
+            Task = nullptr;
+            std::swap(error, Error);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    void Work(unsigned int participant)
+    {
+        size_t seen = 0;
+        for (;;)
+        {
+            const std::function<void(unsigned int)>* task;
+            unsigned int tasks;
+            bool pinned;
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                Wake.wait(lock, [&] { return Stop || Generation != seen; });
+                if (Stop) return;
+                seen = Generation;
+                task = Task;
+                tasks = TaskCount;
+                pinned = Pinned;
+            }
+            Drain(*task, tasks, pinned, participant);
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                if (--Busy == 0) Done.notify_one();
+            }
+        }
+    }
+    // Runs this participant's share of the tasks. The first exception of any participant is kept for the caller to
+    // rethrow, and the participant that caught it stops taking tasks.
+    void Drain(const std::function<void(unsigned int)>& task, unsigned int tasks, bool pinned, unsigned int participant)
+    {
+        ParticipantScope scope;
+        try
+        {
+            if (pinned)
+            {
+                for (unsigned int index = participant; index < tasks; index += Threads())
+                {
+                    task(index);
+                }
+                return;
+            }
+            for (unsigned int index = Next.fetch_add(1); index < tasks; index = Next.fetch_add(1))
+            {
+                task(index);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (!Error) Error = std::current_exception();
+        }
+    }
+
+    std::vector<std::thread> Workers;
+    std::mutex RunMutex;
+    std::mutex Mutex;
+    std::condition_variable Wake;
+    std::condition_variable Done;
+    const std::function<void(unsigned int)>* Task;
+    std::exception_ptr Error;
+    unsigned int TaskCount;
+    bool Pinned;
+    std::atomic<unsigned int> Next;
+    unsigned int Busy;
+    size_t Generation;
+    bool Stop;
+};
+
+static constexpr size_t CacheLineSize = 64;
+
+class Settings
+{
+public:
+    static unsigned int GetThreadCount()
+    {
+        return Threads().load(std::memory_order_relaxed);
+    }
+    // 0 selects std::thread::hardware_concurrency(), 1 (the default) keeps everything on the calling thread.
+    // Runs in progress finish on the pool they started on, which is released after the last of them.
+    static unsigned int SetThreadCount(unsigned int threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::lock_guard<std::mutex> lock(PoolMutex());
+        Threads().store(threads, std::memory_order_relaxed);
+        PoolInstance().reset();
+        return threads;
+    }
+    // Minimum size in bytes of the written buffer before the work is split
+    static size_t GetThreshold()
+    {
+        return Threshold().load(std::memory_order_relaxed);
+    }
+    static void SetThreshold(size_t bytes)
+    {
+        Threshold().store(bytes, std::memory_order_relaxed);
+    }
+    // The pool of GetThreadCount() threads. Callers keep the pool alive while they use it, so a resize never
+    // destroys a pool that is running tasks.
+    static std::shared_ptr<ThreadPool> Pool()
+    {
+        std::lock_guard<std::mutex> lock(PoolMutex());
+        std::shared_ptr<ThreadPool>& pool = PoolInstance();
+        if (!pool || pool->Threads() != GetThreadCount())
+        {
+            pool = std::make_shared<ThreadPool>(GetThreadCount());
+        }
+        return pool;
+    }
+private:
+    static std::atomic<unsigned int>& Threads()
+    {
+        static std::atomic<unsigned int> threads(1);
+        return threads;
+    }
+    static std::atomic<size_t>& Threshold()
+    {
+        static std::atomic<size_t> threshold(size_t(1) << 21);
+        return threshold;
+    }
+    static std::mutex& PoolMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+    static std::shared_ptr<ThreadPool>& PoolInstance()
+    {
+        static std::shared_ptr<ThreadPool> pool;
+        return pool;
+    }
+};
+
+// Calls kernel(begin, count) over [0, count) of 'to', in at most one chunk per thread of the pool. Chunk boundaries
+// fall on cache lines of 'to', so no two threads ever write the same line, and chunk i always goes to participant i
+// of the pool (see ThreadPool::RunPinned).
+template<typename E, typename Kernel>
+void For(E* to, size_t count, Kernel kernel)
+{
+    if (Settings::GetThreadCount() <= 1 || count * sizeof(E) < Settings::GetThreshold() || ThreadPool::InTask())
+    {
+        kernel(0, count);
+        return;
+    }
+    const std::shared_ptr<ThreadPool> pool = Settings::Pool();
+    const size_t threads = pool->Threads();
+    const size_t lineElements = CacheLineSize / sizeof(E);
+    // Elements of 'to' that sit before its first cache line boundary are added to the first chunk. The chunks are
+    // counted from the line boundary before 'to', so the lead does not add a chunk.
+    const size_t lead = (reinterpret_cast<uintptr_t>(to) % CacheLineSize) / sizeof(E);
+    size_t chunk = (count + lead + threads - 1) / threads;
+    chunk = (chunk + lineElements - 1) / lineElements * lineElements;
+    const unsigned int tasks = static_cast<unsigned int>((count + lead + chunk - 1) / chunk);
+    pool->RunPinned(tasks, [&](unsigned int index)
+    {
+        const size_t begin = index == 0 ? 0 : index * chunk - lead;
+        const size_t end = std::min(count, (index + 1) * chunk - lead);
+        kernel(begin, end - begin);
+    });
+}
+
+// Zero fills [data, data + count) with the chunking of For, so every page is first touched, and with the default
+// first touch policy of the OS placed, on the NUMA node of the thread that later computes on it
+template<typename E>
+void FirstTouch(E* data, size_t count)
+{
+    For(data, count, [=](size_t begin, size_t length) { memset(static_cast<void*>(data + begin), 0, length * sizeof(E)); });
+}
+
+// Mask of the NUMA nodes the kernel considers possible, from /sys/devices/system/node/possible ("0", "0-3" or
+// "0,2-5"). mbind fails with EINVAL for a mask with bits past the kernel's MAX_NUMNODES, so only these bits are set
+// and MaxNode is passed as the mask size. Node 0 alone when the file cannot be read.
+struct NodeMask
+{
+    std::vector<unsigned long> Bits;
+    unsigned long MaxNode;
+
+    static const NodeMask& Possible()
+    {
+        static const NodeMask mask = Read("/sys/devices/system/node/possible");
+        return mask;
+    }
+
+    static NodeMask Read(const char* path)
+    {
+        const size_t bitsPerLong = sizeof(unsigned long) * 8;
+        NodeMask mask;
+        mask.MaxNode = 0;
+        char line[4096] = {};
+        FILE* file = fopen(path, "r");
+        if (file != nullptr)
+        {
+            if (fgets(line, sizeof(line), file) == nullptr) line[0] = 0;
+            fclose(file);
+        }
+        for (char* cursor = line; *cursor >= '0' && *cursor <= '9';)
+        {
+            const unsigned long first = strtoul(cursor, &cursor, 10);
+            const unsigned long last = *cursor == '-' ? strtoul(cursor + 1, &cursor, 10) : first;
+            for (unsigned long node = first; node <= last; node++)
+            {
+                mask.Bits.resize(std::max(mask.Bits.size(), static_cast<size_t>(node / bitsPerLong + 1)), 0UL);
+                mask.Bits[node / bitsPerLong] |= 1UL << (node % bitsPerLong);
+                mask.MaxNode = std::max(mask.MaxNode, node + 1);
+            }
+            if (*cursor == ',') cursor++;
+        }
+        if (mask.Bits.empty())
+        {
+            mask.Bits.push_back(1UL);
+            mask.MaxNode = 1;
+        }
+        return mask;
+    }
+};
+
+// Sets an interleaved policy over the possible memory nodes for the whole pages inside [data, data + bytes), so their
+// pages are spread round robin over the nodes when they are first touched. Returns false where mbind is not available
+// (other platforms, or a sandbox that blocks the system call) or the range holds no whole page, the pages then keep the
+// default policy.
+inline bool Interleave(void* data, size_t bytes)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + page - 1) / page * page;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) / page * page;
+    if (end <= begin)
+    {
+        return false;
+    }
+    // MPOL_INTERLEAVE from <linux/mempolicy.h>, the kernel drops the nodes of the mask that have no memory. The
+    // kernel reads maxnode - 1 bits.
+    const int interleave = 3;
+    const NodeMask& nodes = NodeMask::Possible();
+    return syscall(SYS_mbind, begin, end - begin, interleave, nodes.Bits.data(), nodes.MaxNode + 1, 0) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    return false;
+#endif
+}
+
+enum class NumaPlacement
+{
+    FirstTouch,     // every chunk on the node of the thread that computes on it
+    Interleave      // pages round robin over all nodes, for data every thread reads
+};
+
+// Allocator policy (see AlignedMemory) that zero fills new blocks in parallel with FirstTouch, after setting the
+// interleaved policy when Placement is Interleave. Placement needs whole pages, so Base defaults to the huge page
+// allocator, whose blocks of MinimumBytes and more are page aligned mappings of their own. Smaller blocks share their
+// pages with other heap blocks and are not interleaved. Placed() tells whether the last block of the calling thread got
+// its placement. Inside a parallel task the block is zero filled by that task's thread.
+template<NumaPlacement Placement = NumaPlacement::FirstTouch, typename Base = AlignedMemory::HugePageAllocator>
+struct NumaAllocator
+{
+    static constexpr size_t MinimumBytes = AlignedMemory::HugePageAllocator::HugePageBytes;
+
+    static void* Allocate(size_t bytes, size_t alignment)
+    {
+        void* block = Base::Allocate(bytes, alignment);
+        LastPlaced() = Placement != NumaPlacement::Interleave || (bytes >= MinimumBytes && Interleave(block, bytes));
+        FirstTouch(static_cast<char*>(block), bytes);
+        return block;
+    }
+    static bool Placed()
+    {
+        return LastPlaced();
+    }
+    static void Deallocate(void* pointer, size_t bytes, size_t alignment)
+    {
+        Base::Deallocate(pointer, bytes, alignment);
+    }
+private:
+    static bool& LastPlaced()
+    {
+        static thread_local bool placed = false;
+        return placed;
+    }
+};
+
+}
+}
+
+// ██████╗ ██╗███████╗██████╗  █████╗ ████████╗ ██████╗██╗  ██╗
+// ██╔══██╗██║██╔════╝██╔══██╗██╔══██╗╚══██╔══╝██╔════╝██║  ██║
+// ██║  ██║██║███████╗██████╔╝███████║   ██║   ██║     ███████║
+// ██║  ██║██║╚════██║██╔═══╝ ██╔══██║   ██║   ██║     ██╔══██║
+// ██████╔╝██║███████║██║     ██║  ██║   ██║   ╚██████╗██║  ██║
+// ╚═════╝ ╚═╝╚══════╝╚═╝     ╚═╝  ╚═╝   ╚═╝    ╚═════╝╚═╝  ╚═╝
+
+// Kernels for every ISA level are compiled regardless of the compiler flags and the
+// fastest one supported by the running CPU is picked once, so a portable build still
+// runs AVX2/AVX-512 code where it is available.
+
+// Float and double operations of one ISA level, PFX is the intrinsic prefix (empty, 256 or 512) and BITS the register width.
+// The namespace must define MultiplyAccumulate for both register types before using this macro, it is fused only with FMA.
+#define CREATE_DISPATCH_FLOATING_OPS(PFX, BITS) \
+template<> struct Ops<float> \
+{ \
+    typedef __m##BITS Reg; \
+    static constexpr unsigned int Lanes = (BITS / 8) / sizeof(float); \
+    static _SIMD_INL_ Reg Load(const float* from) { return _mm##PFX##_loadu_ps(from); } \
+    static _SIMD_INL_ void Store(float* to, Reg value) { _mm##PFX##_storeu_ps(to, value); } \
+    static _SIMD_INL_ void StoreAligned(float* to, Reg value) { _mm##PFX##_store_ps(to, value); } \
+    static _SIMD_INL_ void Stream(float* to, Reg value) { _mm##PFX##_stream_ps(to, value); } \
+    static _SIMD_INL_ Reg Broadcast(float value) { return _mm##PFX##_set1_ps(value); } \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_ps(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_ps(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return _mm##PFX##_mul_ps(a, b); } \
+    static _SIMD_INL_ Reg Divide(Reg a, Reg b) { return _mm##PFX##_div_ps(a, b); } \
+    static _SIMD_INL_ Reg MultiplyAdd(Reg a, Reg b, Reg c) { return MultiplyAccumulate(a, b, c); } \
+}; \
+template<> struct Ops<double> \
+{ \
+    typedef __m##BITS##d Reg; \
+    static constexpr unsigned int Lanes = (BITS / 8) / sizeof(double); \
+    static _SIMD_INL_ Reg Load(const double* from) { return _mm##PFX##_loadu_pd(from); } \
+    static _SIMD_INL_ void Store(double* to, Reg value) { _mm##PFX##_storeu_pd(to, value); } \
+    static _SIMD_INL_ void StoreAligned(double* to, Reg value) { _mm##PFX##_store_pd(to, value); } \
+    static _SIMD_INL_ void Stream(double* to, Reg value) { _mm##PFX##_stream_pd(to, value); } \
+    static _SIMD_INL_ Reg Broadcast(double value) { return _mm##PFX##_set1_pd(value); } \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_pd(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_pd(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return _mm##PFX##_mul_pd(a, b); } \
+    static _SIMD_INL_ Reg Divide(Reg a, Reg b) { return _mm##PFX##_div_pd(a, b); } \
+    static _SIMD_INL_ Reg MultiplyAdd(Reg a, Reg b, Reg c) { return MultiplyAccumulate(a, b, c); } \
+};
+
+// Register level operations of one ISA level, PFX is the intrinsic prefix (empty, 256 or 512) and BITS the register width.
+// The namespace must define Mullo32, Mullo64 and the Quotient kernels of Division before using this macro since those
+// differ between ISA levels.
+#define CREATE_DISPATCH_OPS(PFX, BITS) \
+struct IntBase \
+{ \
+    typedef __m##BITS##i Reg; \
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm##PFX##_loadu_si##BITS((const __m##BITS##i*)from); } \
+    static _SIMD_INL_ void Store(void* to, Reg value) { _mm##PFX##_storeu_si##BITS((__m##BITS##i*)to, value); } \
+    static _SIMD_INL_ void StoreAligned(void* to, Reg value) { _mm##PFX##_store_si##BITS((__m##BITS##i*)to, value); } \
+    static _SIMD_INL_ void Stream(void* to, Reg value) { _mm##PFX##_stream_si##BITS((__m##BITS##i*)to, value); } \
+}; \
+template<unsigned int Size> struct IntOps; \
+template<> struct IntOps<1> : IntBase \
+{ \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_epi8(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_epi8(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) \
+    { \
+        /* No 8 bit multiply exists, multiply even and odd bytes as 16 bit lanes and merge the low bytes */ \
+        Reg even = _mm##PFX##_mullo_epi16(a, b); \
+        Reg odd = _mm##PFX##_mullo_epi16(_mm##PFX##_srli_epi16(a, 8), _mm##PFX##_srli_epi16(b, 8)); \
+        return _mm##PFX##_or_si##BITS(_mm##PFX##_slli_epi16(odd, 8), _mm##PFX##_and_si##BITS(even, _mm##PFX##_set1_epi16(0x00FF))); \
+    } \
+}; \
+template<> struct IntOps<2> : IntBase \
+{ \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_epi16(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_epi16(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return _mm##PFX##_mullo_epi16(a, b); } \
+}; \
+template<> struct IntOps<4> : IntBase \
+{ \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_epi32(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_epi32(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return Mullo32(a, b); } \
+}; \
+template<> struct IntOps<8> : IntBase \
+{ \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_epi64(a, b); } \
+    static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return _mm##PFX##_sub_epi64(a, b); } \
+    static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return Mullo64(a, b); } \
+}; \
+template<typename E> struct Ops : IntOps<sizeof(E)> \
+{ \
+    static constexpr unsigned int Lanes = (BITS / 8) / sizeof(E); \
+    /* There is no integer divide instruction, the lanes go through the quotient kernel of the level */ \
+    static _SIMD_INL_ IntBase::Reg Divide(IntBase::Reg a, IntBase::Reg b) \
+    { \
+        alignas(BITS / 8) E x[Lanes]; \
+        alignas(BITS / 8) E y[Lanes]; \
+        IntBase::StoreAligned(x, a); \
+        IntBase::StoreAligned(y, b); \
+        Quotient<E>::Apply(x, x, y, Lanes); \
+        return IntBase::Load(x); \
+    } \
+}; \
+CREATE_DISPATCH_FLOATING_OPS(PFX, BITS)
+
+// Loop body shared by the kernels, starts at element i. Four registers are processed per iteration and both
+// operands are prefetched Dispatcher::GetPrefetchDistance() bytes ahead; leftover registers and elements follow.
+#define CREATE_DISPATCH_LOOP(NAME, STORE) \
+{ \
+    const size_t ahead = Dispatcher::GetPrefetchDistance(); \
+    const size_t unrolledCount = count - (count - i) % (4 * O::Lanes); \
+    for (; i < unrolledCount; i += 4 * O::Lanes) \
+    { \
+        if (ahead != 0) \
+        { \
+            PrefetchAhead(a + i, ahead, 4 * O::Lanes * sizeof(E)); \
+            PrefetchAhead(b + i, ahead, 4 * O::Lanes * sizeof(E)); \
+        } \
+        O::STORE(to + i, O::NAME(O::Load(a + i), O::Load(b + i))); \
+        O::STORE(to + i + O::Lanes, O::NAME(O::Load(a + i + O::Lanes), O::Load(b + i + O::Lanes))); \
+        O::STORE(to + i + 2 * O::Lanes, O::NAME(O::Load(a + i + 2 * O::Lanes), O::Load(b + i + 2 * O::Lanes))); \
+        O::STORE(to + i + 3 * O::Lanes, O::NAME(O::Load(a + i + 3 * O::Lanes), O::Load(b + i + 3 * O::Lanes))); \
+    } \
+    const size_t vectorCount = count - (count - i) % O::Lanes; \
+    for (; i < vectorCount; i += O::Lanes) \
+    { \
+        O::STORE(to + i, O::NAME(O::Load(a + i), O::Load(b + i))); \
+    } \
+    for (; i < count; i++) \
+    { \
+        to[i] = Element::NAME(a[i], b[i]); \
+    } \
+}
+
+// Element-wise to[i] = a[i] OP b[i] over count elements, any of the pointers may be misaligned. The head is peeled with
+// scalar code until 'to' reaches a register boundary, so the body stores aligned (or streams) and only the loads of a
+// and b may cross cache lines. A 'to' that is not even aligned to its element size runs unaligned throughout.
+#define CREATE_DISPATCH_KERNEL(NAME) \
+template<typename E> \
+void NAME(E* to, const E* a, const E* b, size_t count, bool stream) \
+{ \
+    typedef Ops<E> O; \
+    size_t i = 0; \
+    if (reinterpret_cast<uintptr_t>(to) % sizeof(E) != 0) \
+    { \
+        CREATE_DISPATCH_LOOP(NAME, Store) \
+        return; \
+    } \
+    for (; i < count && reinterpret_cast<uintptr_t>(to + i) % (O::Lanes * sizeof(E)) != 0; i++) \
+    { \
+        to[i] = Element::NAME(a[i], b[i]); \
+    } \
+    if (stream) \
+    { \
+        CREATE_DISPATCH_LOOP(NAME, Stream) \
+        _mm_sfence(); \
+    } \
+    else \
+    { \
+        CREATE_DISPATCH_LOOP(NAME, StoreAligned) \
+    } \
+}
+
+#define CREATE_DISPATCH_KERNELS() \
+    CREATE_DISPATCH_KERNEL(Add) \
+    CREATE_DISPATCH_KERNEL(Subtract) \
+    CREATE_DISPATCH_KERNEL(Multiply) \
+    CREATE_DISPATCH_KERNEL(Divide)
+
+// Loop of the float and double to[i] = a * b[i] + c[i] kernels, A is the multiplier register at element k and
+// A_LANE the same for a single element. Like the binary loop four registers are processed per iteration, the
+// leftover elements go through MultiplyAccumulate as well so every element of one level rounds the same way.
+#define CREATE_DISPATCH_MULTIPLY_ADD_LOOP(A, A_LANE) \
+{ \
+    typedef Ops<E> O; \
+    const size_t ahead = Dispatcher::GetPrefetchDistance(); \
+    const size_t unrolledCount = count - count % (4 * O::Lanes); \
+    for (size_t i = 0; i < unrolledCount; i += 4 * O::Lanes) \
+    { \
+        if (ahead != 0) \
+        { \
+            PrefetchAhead(b + i, ahead, 4 * O::Lanes * sizeof(E)); \
+            PrefetchAhead(c + i, ahead, 4 * O::Lanes * sizeof(E)); \
+        } \
+        for (size_t k = i; k < i + 4 * O::Lanes; k += O::Lanes) \
+        { \
+            O::Store(to + k, O::MultiplyAdd(A, O::Load(b + k), O::Load(c + k))); \
+        } \
+    } \
+    size_t k = unrolledCount; \
+    for (; k + O::Lanes <= count; k += O::Lanes) \
+    { \
+        O::Store(to + k, O::MultiplyAdd(A, O::Load(b + k), O::Load(c + k))); \
+    } \
+    for (; k < count; k++) \
+    { \
+        to[k] = MultiplyAccumulate(A_LANE, b[k], c[k]); \
+    } \
+}
+
+#define CREATE_DISPATCH_MULTIPLY_ADD_KERNELS() \
+template<typename E> \
+void MultiplyAdd(E* to, const E* a, const E* b, const E* c, size_t count) \
+CREATE_DISPATCH_MULTIPLY_ADD_LOOP(O::Load(a + k), a[k]) \
+template<typename E> \
+void Axpy(E alpha, const E* b, E* c, size_t count) \
+{ \
+    E* to = c; \
+    const typename Ops<E>::Reg scale = Ops<E>::Broadcast(alpha); \
+    CREATE_DISPATCH_MULTIPLY_ADD_LOOP(scale, alpha) \
+}
+
+namespace BASIC_SIMD_NAMESPACE
+{
+namespace Dispatch
+{
+
+// Temporal (default) always stores through the cache, NonTemporal always streams and Auto decides by output size
+enum class StoreMode
+{
+    Temporal,
+    NonTemporal,
+    Auto
+};
+
+class Dispatcher
+{
+public:
+    // Best level the running CPU supports, AVX-512 kernels also need the BW and DQ extensions
+    static InstructionSet Detect()
+    {
+        if (CPUFeatures::hasAVX512() && CPUFeatures::hasAVX512BW() && CPUFeatures::hasAVX512DQ()) return InstructionSet::AVX512;
+        if (CPUFeatures::hasAVX2()) return InstructionSet::AVX2;
+        if (CPUFeatures::hasSSE2()) return InstructionSet::SSE2;
+        return InstructionSet::NONE;
+    }
+    static InstructionSet Get()
+    {
+        return Active().load(std::memory_order_relaxed);
+    }
+    // Forces a lower level, requests above what the CPU supports are clamped. Returns the level in use.
+    static InstructionSet Set(InstructionSet set)
+    {
+        InstructionSet detected = Detect();
+        if (static_cast<int>(set) > static_cast<int>(detected))
+        {
+            set = detected;
+        }
+        Active().store(set, std::memory_order_relaxed);
+        return set;
+    }
+    static InstructionSet Reset()
+    {
+        return Set(Detect());
+    }
+    // Bytes ahead of the current position the kernels prefetch, 0 disables the prefetches
+    static size_t GetPrefetchDistance()
+    {
+        return PrefetchDistance().load(std::memory_order_relaxed);
+    }
+    static void SetPrefetchDistance(size_t bytes)
+    {
+        PrefetchDistance().store(bytes, std::memory_order_relaxed);
+    }
+    static StoreMode GetStoreMode()
+    {
+        return ActiveStoreMode().load(std::memory_order_relaxed);
+    }
+    static void SetStoreMode(StoreMode mode)
+    {
+        ActiveStoreMode().store(mode, std::memory_order_relaxed);
+    }
+    // Whether an operation writing 'bytes' should use non temporal stores under the current mode.
+    // Auto streams once the output no longer fits in the last level cache, it would only evict the working set.
+    static bool UseStreamingStores(size_t bytes)
+    {
+        switch (GetStoreMode())
+        {
+        case StoreMode::NonTemporal: return true;
+        case StoreMode::Auto: return bytes > CPUFeatures::lastLevelCacheSize();
+        default: return false;
+        }
+    }
+private:
+    static std::atomic<size_t>& PrefetchDistance()
+    {
+        static std::atomic<size_t> distance(1024);
+        return distance;
+    }
+    static std::atomic<StoreMode>& ActiveStoreMode()
+    {
+        static std::atomic<StoreMode> mode(StoreMode::Temporal);
+        return mode;
+    }
+    static std::atomic<InstructionSet>& Active()
+    {
+        static std::atomic<InstructionSet> active(Detect());
+        return active;
+    }
+};
+
+// Prefetches 'span' bytes starting 'distance' bytes past 'at'. Prefetches never fault, so running past the end of the buffer is fine.
+static _SIMD_INL_ void PrefetchAhead(const void* at, size_t distance, size_t span)
+{
+    const uintptr_t first = reinterpret_cast<uintptr_t>(at) + distance;
+    for (size_t line = 0; line < span; line += Parallel::CacheLineSize)
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(first + line), _MM_HINT_T0);
+    }
+}
+
+// Single elements of the scalar heads and tails. Integer quotients wrap INT_MIN / -1 like the register kernels
+// instead of trapping
+struct Element
+{
+    template<typename E> static _SIMD_INL_ E Add(E a, E b) { return static_cast<E>(a + b); }
+    template<typename E> static _SIMD_INL_ E Subtract(E a, E b) { return static_cast<E>(a - b); }
+    template<typename E> static _SIMD_INL_ E Multiply(E a, E b) { return static_cast<E>(a * b); }
+    template<typename E> static _SIMD_INL_ E Divide(E a, E b) { return Divide(a, b, std::is_integral<E>()); }
+    template<typename E> static _SIMD_INL_ E Divide(E a, E b, std::true_type /*integer*/) { return Division::Lane(a, b); }
+    template<typename E> static _SIMD_INL_ E Divide(E a, E b, std::false_type /*floating*/) { return a / b; }
+};
+
+namespace Scalar
+{
+    template<typename E> static _SIMD_INL_ E MultiplyAccumulate(E a, E b, E c) { return a * b + c; }
+    // Used when not even SSE2 is available, every element goes through plain C++
+    template<typename E> struct Ops
+    {
+        typedef E Reg;
+        static constexpr unsigned int Lanes = 1;
+        static _SIMD_INL_ Reg Load(const E* from) { return *from; }
+        static _SIMD_INL_ void Store(E* to, Reg value) { *to = value; }
+        static _SIMD_INL_ void StoreAligned(E* to, Reg value) { *to = value; }
+        static _SIMD_INL_ void Stream(E* to, Reg value) { *to = value; }
+        static _SIMD_INL_ Reg Add(Reg a, Reg b) { return Element::Add(a, b); }
+        static _SIMD_INL_ Reg Subtract(Reg a, Reg b) { return Element::Subtract(a, b); }
+        static _SIMD_INL_ Reg Multiply(Reg a, Reg b) { return Element::Multiply(a, b); }
+        static _SIMD_INL_ Reg Divide(Reg a, Reg b) { return Element::Divide(a, b); }
+        static _SIMD_INL_ Reg Broadcast(E value) { return value; }
+        static _SIMD_INL_ Reg MultiplyAdd(Reg a, Reg b, Reg c) { return MultiplyAccumulate(a, b, c); }
+    };
+    CREATE_DISPATCH_KERNELS()
+    CREATE_DISPATCH_MULTIPLY_ADD_KERNELS()
+}
+
+_SIMD_BEGIN_TARGET_SSE2_
+namespace SSE2
+{
+    static _SIMD_INL_ __m128i Mullo32(__m128i a, __m128i b)
+    {
+        /* _mm_mullo_epi32 is SSE4.1, multiply even and odd lanes with _mm_mul_epu32 and interleave the low halves */
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+    static _SIMD_INL_ __m128i Mullo64(__m128i a, __m128i b)
+    {
+        /* lo(a)*lo(b) + ((lo(a)*hi(b) + hi(a)*lo(b)) << 32) */
+        __m128i cross = _mm_add_epi64(_mm_mul_epu32(a, _mm_srli_epi64(b, 32)), _mm_mul_epu32(_mm_srli_epi64(a, 32), b));
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+    static _SIMD_INL_ __m128 MultiplyAccumulate(__m128 a, __m128 b, __m128 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static _SIMD_INL_ __m128d MultiplyAccumulate(__m128d a, __m128d b, __m128d c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    template<typename E> static _SIMD_INL_ E MultiplyAccumulate(E a, E b, E c) { return a * b + c; }
+    template<typename E> using Quotient = Division::Scalar<E>;
+    CREATE_DISPATCH_OPS(, 128)
+    CREATE_DISPATCH_KERNELS()
+    CREATE_DISPATCH_MULTIPLY_ADD_KERNELS()
+}
+_SIMD_END_TARGET_
+
+_SIMD_BEGIN_TARGET_AVX2_
+namespace AVX2
+{
+    static _SIMD_INL_ __m256i Mullo32(__m256i a, __m256i b)
+    {
+        return _mm256_mullo_epi32(a, b);
+    }
+    static _SIMD_INL_ __m256i Mullo64(__m256i a, __m256i b)
+    {
+        /* _mm256_mullo_epi64 needs AVX-512, same decomposition as SSE2 */
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)), _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+    }
+    static _SIMD_INL_ __m256 MultiplyAccumulate(__m256 a, __m256 b, __m256 c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    static _SIMD_INL_ __m256d MultiplyAccumulate(__m256d a, __m256d b, __m256d c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+    template<typename E> static _SIMD_INL_ E MultiplyAccumulate(E a, E b, E c) { return a * b + c; }
+    template<typename E> using Quotient = Division::AVX2::Quotient<E>;
+    CREATE_DISPATCH_OPS(256, 256)
+    CREATE_DISPATCH_KERNELS()
+    CREATE_DISPATCH_MULTIPLY_ADD_KERNELS()
+}
+_SIMD_END_TARGET_
+
+// FMA has its own CPUID bit next to AVX2 (and virtual machines may hide it), so the fused kernels are picked by
+// CPUFeatures::hasFMA() at the AVX2 level. Only the multiply add kernels differ, the other operations stay in AVX2.
+_SIMD_BEGIN_TARGET_AVX2_FMA_
+namespace AVX2FMA
+{
+    static _SIMD_INL_ __m256 MultiplyAccumulate(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+    static _SIMD_INL_ __m256d MultiplyAccumulate(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+    template<typename E> static _SIMD_INL_ E MultiplyAccumulate(E a, E b, E c) { return std::fma(a, b, c); }
+    template<typename E> struct Ops;
+    CREATE_DISPATCH_FLOATING_OPS(256, 256)
+    CREATE_DISPATCH_MULTIPLY_ADD_KERNELS()
+}
+_SIMD_END_TARGET_
+
+_SIMD_BEGIN_TARGET_AVX512_
+namespace AVX512
+{
+    static _SIMD_INL_ __m512i Mullo32(__m512i a, __m512i b)
+    {
+        return _mm512_mullo_epi32(a, b);
+    }
+    static _SIMD_INL_ __m512i Mullo64(__m512i a, __m512i b)
+    {
+        return _mm512_mullo_epi64(a, b);
+    }
+    static _SIMD_INL_ __m512 MultiplyAccumulate(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+    static _SIMD_INL_ __m512d MultiplyAccumulate(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+    template<typename E> static _SIMD_INL_ E MultiplyAccumulate(E a, E b, E c) { return std::fma(a, b, c); }
+    template<typename E> using Quotient = Division::AVX2::Quotient<E>;
+    CREATE_DISPATCH_OPS(512, 512)
+    CREATE_DISPATCH_KERNELS()
+    CREATE_DISPATCH_MULTIPLY_ADD_KERNELS()
+}
+_SIMD_END_TARGET_
+
+#define CREATE_DISPATCH_ENTRY(NAME) \
+template<typename E> \
+void NAME##Range(E* to, const E* a, const E* b, size_t count, bool stream) \
+{ \
+    switch (Dispatcher::Get()) \
+    { \
+    case InstructionSet::AVX512: AVX512::NAME(to, a, b, count, stream); break; \
+    case InstructionSet::AVX2: AVX2::NAME(to, a, b, count, stream); break; \
+    case InstructionSet::SSE2: \
+    case InstructionSet::AVX: SSE2::NAME(to, a, b, count, stream); break; \
+    default: Scalar::NAME(to, a, b, count, false); break; \
+    } \
+} \
+/* to[i] = a[i] OP b[i], the pointers need no alignment and may come straight from external buffers */ \
+template<typename E> \
+void NAME(E* to, const E* a, const E* b, size_t count) \
+{ \
+    /* Decided once for the whole output, the parallel chunks are each only a part of it */ \
+    const bool stream = Dispatcher::UseStreamingStores(count * sizeof(E)); \
+    Parallel::For(to, count, [=](size_t begin, size_t length) { NAME##Range(to + begin, a + begin, b + begin, length, stream); }); \
+} \
+/* to[i] = to[i] OP from[i] */ \
+template<typename E> \
+void NAME(E* to, const E* from, size_t count) \
+{ \
+    NAME(to, static_cast<const E*>(to), from, count); \
+}
+
+CREATE_DISPATCH_ENTRY(Add)
+CREATE_DISPATCH_ENTRY(Subtract)
+CREATE_DISPATCH_ENTRY(Multiply)
+CREATE_DISPATCH_ENTRY(Divide)
+
+// Same selection as CREATE_DISPATCH_ENTRY, except that the AVX2 level only fuses the multiply add where the CPU has FMA
+#define CREATE_DISPATCH_MULTIPLY_ADD_ENTRY(NAME, PARAMETERS, ARGUMENTS) \
+template<typename E> \
+void NAME##Range PARAMETERS \
+{ \
+    switch (Dispatcher::Get()) \
+    { \
+    case InstructionSet::AVX512: AVX512::NAME ARGUMENTS; break; \
+    case InstructionSet::AVX2: \
+        if (CPUFeatures::hasFMA()) AVX2FMA::NAME ARGUMENTS; \
+        else AVX2::NAME ARGUMENTS; \
+        break; \
+    case InstructionSet::SSE2: \
+    case InstructionSet::AVX: SSE2::NAME ARGUMENTS; break; \
+    default: Scalar::NAME ARGUMENTS; break; \
+    } \
+}
+
+CREATE_DISPATCH_MULTIPLY_ADD_ENTRY(MultiplyAdd, (E* to, const E* a, const E* b, const E* c, size_t count), (to, a, b, c, count))
+CREATE_DISPATCH_MULTIPLY_ADD_ENTRY(Axpy, (E alpha, const E* b, E* c, size_t count), (alpha, b, c, count))
+
+// to[i] = a[i] * b[i] + c[i] for float and double, rounded once where the CPU has FMA and twice below that
+template<typename E>
+void MultiplyAdd(E* to, const E* a, const E* b, const E* c, size_t count)
+{
+    static_assert(std::is_floating_point<E>::value, "MultiplyAdd supports float and double");
+    Parallel::For(to, count, [=](size_t begin, size_t length) { MultiplyAddRange(to + begin, a + begin, b + begin, c + begin, length); });
+}
+// y[i] += alpha * x[i], rounded like MultiplyAdd
+template<typename E>
+void Axpy(E alpha, const E* x, E* y, size_t count)
+{
+    static_assert(std::is_floating_point<E>::value, "Axpy supports float and double");
+    Parallel::For(y, count, [=](size_t begin, size_t length) { AxpyRange(alpha, x + begin, y + begin, length); });
+}
+
+}
+}
+
+//SIMD::int_XXX checks are not ideal...
+template<typename T>
+using IsSIMDType = typename std::enable_if<
+    (std::is_same<int, typename T::Type>::value && (T::BitWidth == 128) && IsElementAnyOfInts<typename T::ElementType>::value) || ( std::is_same<int, typename T::Type>::value && (T::BitWidth == 256) && IsElementAnyOfInts<typename T::ElementType>::value) ||
+    std::is_same<T, SIMD::float_256>::value || std::is_same<T, SIMD::double_256>::value ||
+    ( std::is_same<int, typename T::Type>::value && (T::BitWidth == 512) && IsElementAnyOfInts<typename T::ElementType>::value) || std::is_same<T, SIMD::float_512>::value || std::is_same<T, SIMD::double_512>::value,
+    int>::type;
+
+namespace BASIC_SIMD_NAMESPACE
+{
+// Multiplier and shifts for dividing by an invariant integer (Granlund & Montgomery). With t the high half of
+// Multiplier * n, unsigned lanes compute q = (t + ((n - t) >> Shift1)) >> Shift2 and signed lanes
+// q = ((n + t) >> Shift2) - (n >> (N - 1)), negated through Sign for negative divisors.
+template<typename E>
+struct DividerMagic
+{
+    E Multiplier;
+    int Shift1;
+    int Shift2;
+    E Sign;
+};
+
+// Lane loop fallback, also used for 64 bit lanes which have no vector high multiply
+template<int Bits, typename E>
+struct DividerScalar
+{
+    static _SIMD_INL_ void Apply(E* to, const E* from, E divisor, const DividerMagic<E>&)
+    {
+        for (unsigned int i = 0; i < Bits / 8 / sizeof(E); i++)
+        {
+            to[i] = Division::Lane(from[i], divisor);
+        }
+    }
+};
+template<int Bits, typename E>
+struct DividerKernel : DividerScalar<Bits, E> {};
+
+// 8 bit lanes are widened to 16 bits with the multiplier pre shifted by 8, so mulhi_epi16 yields (m * n) >> 8
+#define CREATE_DIVIDER_KERNELS(PFX, BITS) \
+struct DividerOps##BITS \
+{ \
+    typedef __m##BITS##i V; \
+    static _SIMD_INL_ V Narrow16To8(V lo, V hi) \
+    { \
+        const V low = _mm##PFX##_set1_epi16(0xFF); \
+        return _mm##PFX##_packus_epi16(_mm##PFX##_and_si##BITS(lo, low), _mm##PFX##_and_si##BITS(hi, low)); \
+    } \
+    static _SIMD_INL_ V Unsigned16(V n, V m, __m128i s1, __m128i s2) \
+    { \
+        const V t = _mm##PFX##_mulhi_epu16(m, n); \
+        return _mm##PFX##_srl_epi16(_mm##PFX##_add_epi16(t, _mm##PFX##_srl_epi16(_mm##PFX##_sub_epi16(n, t), s1)), s2); \
+    } \
+    static _SIMD_INL_ V Signed16(V n, V m, __m128i s2, V sign) \
+    { \
+        V q = _mm##PFX##_sra_epi16(_mm##PFX##_add_epi16(n, _mm##PFX##_mulhi_epi16(m, n)), s2); \
+        q = _mm##PFX##_sub_epi16(q, _mm##PFX##_srai_epi16(n, 15)); \
+        return _mm##PFX##_sub_epi16(_mm##PFX##_xor_si##BITS(q, sign), sign); \
+    } \
+    static _SIMD_INL_ V HighHalves32(V even, V odd) \
+    { \
+        return _mm##PFX##_or_si##BITS(_mm##PFX##_srli_epi64(even, 32), _mm##PFX##_and_si##BITS(odd, _mm##PFX##_slli_epi64(_mm##PFX##_set1_epi32(-1), 32))); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<uint8_t>& magic) \
+    { \
+        const V m = _mm##PFX##_set1_epi16(static_cast<short>(magic.Multiplier << 8)); \
+        const __m128i s1 = _mm_cvtsi32_si128(magic.Shift1), s2 = _mm_cvtsi32_si128(magic.Shift2); \
+        const V zero = _mm##PFX##_setzero_si##BITS(); \
+        return Narrow16To8(Unsigned16(_mm##PFX##_unpacklo_epi8(n, zero), m, s1, s2), Unsigned16(_mm##PFX##_unpackhi_epi8(n, zero), m, s1, s2)); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<int8_t>& magic) \
+    { \
+        const V m = _mm##PFX##_set1_epi16(static_cast<short>(magic.Multiplier * 256)); \
+        const V sign = _mm##PFX##_set1_epi16(magic.Sign); \
+        const __m128i s2 = _mm_cvtsi32_si128(magic.Shift2); \
+        const V lo = _mm##PFX##_srai_epi16(_mm##PFX##_unpacklo_epi8(n, n), 8); \
+        const V hi = _mm##PFX##_srai_epi16(_mm##PFX##_unpackhi_epi8(n, n), 8); \
+        return Narrow16To8(Signed16(lo, m, s2, sign), Signed16(hi, m, s2, sign)); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<uint16_t>& magic) \
+    { \
+        return Unsigned16(n, _mm##PFX##_set1_epi16(static_cast<short>(magic.Multiplier)), _mm_cvtsi32_si128(magic.Shift1), _mm_cvtsi32_si128(magic.Shift2)); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<int16_t>& magic) \
+    { \
+        return Signed16(n, _mm##PFX##_set1_epi16(magic.Multiplier), _mm_cvtsi32_si128(magic.Shift2), _mm##PFX##_set1_epi16(magic.Sign)); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<uint32_t>& magic) \
+    { \
+        const V m = _mm##PFX##_set1_epi32(static_cast<int>(magic.Multiplier)); \
+        const V t = HighHalves32(_mm##PFX##_mul_epu32(m, n), _mm##PFX##_mul_epu32(m, _mm##PFX##_srli_epi64(n, 32))); \
+        const V q = _mm##PFX##_add_epi32(t, _mm##PFX##_srl_epi32(_mm##PFX##_sub_epi32(n, t), _mm_cvtsi32_si128(magic.Shift1))); \
+        return _mm##PFX##_srl_epi32(q, _mm_cvtsi32_si128(magic.Shift2)); \
+    } \
+    static _SIMD_INL_ V Divide(V n, const DividerMagic<int32_t>& magic) \
+    { \
+        const V m = _mm##PFX##_set1_epi32(magic.Multiplier); \
+        const V sign = _mm##PFX##_set1_epi32(magic.Sign); \
+        const V t = HighHalves32(_mm##PFX##_mul_epi32(m, n), _mm##PFX##_mul_epi32(m, _mm##PFX##_srli_epi64(n, 32))); \
+        V q = _mm##PFX##_sra_epi32(_mm##PFX##_add_epi32(n, t), _mm_cvtsi32_si128(magic.Shift2)); \
+        q = _mm##PFX##_sub_epi32(q, _mm##PFX##_srai_epi32(n, 31)); \
+        return _mm##PFX##_sub_epi32(_mm##PFX##_xor_si##BITS(q, sign), sign); \
+    } \
+}; \
+template<typename E> \
+struct DividerKernel<BITS, E> \
+{ \
+    static _SIMD_INL_ void Apply(E* to, const E* from, E, const DividerMagic<E>& magic) \
+    { \
+        _mm##PFX##_store_si##BITS((__m##BITS##i*)to, DividerOps##BITS::Divide(_mm##PFX##_load_si##BITS((const __m##BITS##i*)from), magic)); \
+    } \
+}; \
+template<> struct DividerKernel<BITS, int64_t> : DividerScalar<BITS, int64_t> {}; \
+template<> struct DividerKernel<BITS, uint64_t> : DividerScalar<BITS, uint64_t> {};
+
+#if defined(SSE4_1_AVAILABLE)
+    CREATE_DIVIDER_KERNELS(, 128)
+#endif
+#if defined(AVX2_AVAILABLE)
+    CREATE_DIVIDER_KERNELS(256, 256)
+#endif
+#if defined(AVX512BW_AVAILABLE)
+    // Same GCC 12 false positive as in Horizontal, for the undefined passthrough of the unmasked shifts and multiplies
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+    CREATE_DIVIDER_KERNELS(512, 512)
+    #if defined(__GNUC__) && !defined(__clang__)
+        #pragma GCC diagnostic pop
+    #endif
+#endif
+
+// Divides integer lanes by a runtime constant with multiplies and shifts, the multiplier is computed once in the
+// constructor. Meant for whole Arrays (a /= divider) where a division per register would dominate.
+template<typename T>
+class Divider
+{
+public:
+    using ElementType = typename T::ElementType;
+
+    explicit Divider(ElementType divisor) : Value(divisor), Magic()
+    {
+        static_assert(std::is_integral<ElementType>::value, "Divider is only available for integer types.");
+        if (divisor == 0)
+        {
+            throw std::runtime_error("Divider can not be created for a divisor of zero.");
+        }
+        Magic = Compute(divisor, std::is_signed<ElementType>(), std::integral_constant<bool, (sizeof(ElementType) <= 4)>());
+    }
+
+    _SIMD_INL_ T Divide(const T& n) const
+    {
+        T result = n;
+        DividerKernel<T::BitWidth, ElementType>::Apply(result.Data, n.Data, Value, Magic);
+        return result;
+    }
+    _SIMD_INL_ ElementType Divisor() const
+    {
+        return Value;
+    }
+    _SIMD_INL_ const DividerMagic<ElementType>& Parameters() const
+    {
+        return Magic;
+    }
+
+private:
+    static unsigned int CeilLog2(uint64_t value)
+    {
+        unsigned int log = 0;
+        while ((uint64_t(1) << log) < value)
+        {
+            log++;
+        }
+        return log;
+    }
+    // 64 bit lanes divide lane by lane and need no multiplier
+    template<typename Signed>
+    static DividerMagic<ElementType> Compute(ElementType, Signed, std::false_type /*32 bits or less*/)
+    {
+        return DividerMagic<ElementType>();
+    }
+    static DividerMagic<ElementType> Compute(ElementType divisor, std::false_type /*signed*/, std::true_type /*32 bits or less*/)
+    {
+        const unsigned int bits = sizeof(ElementType) * 8;
+        const uint64_t d = static_cast<uint64_t>(divisor);
+        const unsigned int l = CeilLog2(d);
+        DividerMagic<ElementType> magic;
+        magic.Multiplier = static_cast<ElementType>((((uint64_t(1) << l) - d) << bits) / d + 1);
+        magic.Shift1 = l < 1 ? l : 1;
+        magic.Shift2 = l < 1 ? 0 : l - 1;
+        magic.Sign = 0;
+        return magic;
+    }
+    static DividerMagic<ElementType> Compute(ElementType divisor, std::true_type /*signed*/, std::true_type /*32 bits or less*/)
+    {
+        const unsigned int bits = sizeof(ElementType) * 8;
+        const uint64_t d = divisor < 0 ? uint64_t(0) - static_cast<uint64_t>(static_cast<int64_t>(divisor)) : static_cast<uint64_t>(divisor);
+        const unsigned int l = std::max(CeilLog2(d), 1u);
+        DividerMagic<ElementType> magic;
+        magic.Multiplier = static_cast<ElementType>((uint64_t(1) << (bits + l - 1)) / d + 1 - (uint64_t(1) << bits));
+        magic.Shift1 = 0;
+        magic.Shift2 = l - 1;
+        magic.Sign = divisor < 0 ? -1 : 0;
+        return magic;
+    }
+
+    ElementType Value;
+    DividerMagic<ElementType> Magic;
+};
+}
+
+namespace BASIC_SIMD_NAMESPACE
+{
+// Base of Array and of the lazy expressions built from Array operators. Derived types provide
+// Evaluate(index) which returns register 'index' of the result as a T value, Prefetch(index) which
+// prefetches that register of every operand and Operands, the number of arrays the expression reads.
+template<typename T, unsigned int Length, typename Derived>
+struct ArrayExpression
+{
+    _SIMD_INL_ const Derived& Self() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+struct ArrayAddOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Add(a, b); }
+};
+struct ArraySubtractOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Subtract(a, b); }
+};
+struct ArrayMultiplyOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Multiply(a, b); }
+};
+struct ArrayDivideOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Divide(a, b); }
+};
+
+// Arrays are referenced by the expressions, sub expressions are temporaries and are held by value
+template<typename E>
+struct ArrayExpressionStorage
+{
+    typedef const E type;
+};
+
+template<typename T, unsigned int Length, typename Op, typename L, typename R>
+class ArrayBinaryExpression : public ArrayExpression<T, Length, ArrayBinaryExpression<T, Length, Op, L, R> >
+{
+public:
+    ArrayBinaryExpression(const L& left, const R& right) : Left(left), Right(right)
+    {
+    }
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return Op::Apply(Left.Evaluate(index), Right.Evaluate(index));
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        Left.Prefetch(index);
+        Right.Prefetch(index);
+    }
+    static constexpr unsigned int Operands = L::Operands + R::Operands;
+private:
+    typename ArrayExpressionStorage<L>::type Left;
+    typename ArrayExpressionStorage<R>::type Right;
+};
+
+#define CREATE_ARRAY_EXPRESSION_OPERATOR(OPERATOR, OP) \
+template<typename T, unsigned int Length, typename L, typename R> \
+_SIMD_INL_ ArrayBinaryExpression<T, Length, OP, L, R> operator OPERATOR(const ArrayExpression<T, Length, L>& left, const ArrayExpression<T, Length, R>& right) \
+{ \
+    return ArrayBinaryExpression<T, Length, OP, L, R>(left.Self(), right.Self()); \
+}
+
+CREATE_ARRAY_EXPRESSION_OPERATOR(+, ArrayAddOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(-, ArraySubtractOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(*, ArrayMultiplyOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(/, ArrayDivideOp)
+
+struct ArrayAndOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::And(a, b); }
+};
+struct ArrayOrOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Or(a, b); }
+};
+struct ArrayXorOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::Xor(a, b); }
+};
+// Shifts by the counts of a second operand or, in ArrayShiftExpression, by one count
+struct ArrayShiftLeftOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& counts) { return T::ShiftLeft(a, counts); }
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, unsigned int count) { return T::ShiftLeft(a, count); }
+};
+struct ArrayShiftRightOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& counts) { return T::ShiftRight(a, counts); }
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, unsigned int count) { return T::ShiftRight(a, count); }
+};
+
+CREATE_ARRAY_EXPRESSION_OPERATOR(&, ArrayAndOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(|, ArrayOrOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(^, ArrayXorOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(<<, ArrayShiftLeftOp)
+CREATE_ARRAY_EXPRESSION_OPERATOR(>>, ArrayShiftRightOp)
+
+struct ArrayFusedMultiplyAddOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b, const T& c) { return T::FusedMultiplyAdd(a, b, c); }
+};
+struct ArrayFusedMultiplySubtractOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b, const T& c) { return T::FusedMultiplySubtract(a, b, c); }
+};
+
+// acc + a * b, fused where the type provides it
+template<typename T, bool Fused = std::is_floating_point<typename T::ElementType>::value &&
+#if defined(FMA_AVAILABLE)
+    true
+#else
+    (T::BitWidth == 512)
+#endif
+    >
+struct ArrayMultiplyAccumulate
+{
+    static _SIMD_INL_ T Apply(const T& a, const T& b, const T& acc) { return T::Add(T::Multiply(a, b), acc); }
+};
+template<typename T>
+struct ArrayMultiplyAccumulate<T, true>
+{
+    static _SIMD_INL_ T Apply(const T& a, const T& b, const T& acc) { return T::FusedMultiplyAdd(a, b, acc); }
+};
+
+template<typename T, unsigned int Length, typename Op, typename A, typename B, typename C>
+class ArrayTernaryExpression : public ArrayExpression<T, Length, ArrayTernaryExpression<T, Length, Op, A, B, C> >
+{
+public:
+    ArrayTernaryExpression(const A& a, const B& b, const C& c) : First(a), Second(b), Third(c)
+    {
+    }
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return Op::Apply(First.Evaluate(index), Second.Evaluate(index), Third.Evaluate(index));
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        First.Prefetch(index);
+        Second.Prefetch(index);
+        Third.Prefetch(index);
+    }
+    static constexpr unsigned int Operands = A::Operands + B::Operands + C::Operands;
+private:
+    typename ArrayExpressionStorage<A>::type First;
+    typename ArrayExpressionStorage<B>::type Second;
+    typename ArrayExpressionStorage<C>::type Third;
+};
+
+// a * b + c with a single rounding, only for types providing FusedMultiplyAdd (float and double)
+template<typename T, unsigned int Length, typename A, typename B, typename C>
+_SIMD_INL_ ArrayTernaryExpression<T, Length, ArrayFusedMultiplyAddOp, A, B, C> FusedMultiplyAdd(const ArrayExpression<T, Length, A>& a, const ArrayExpression<T, Length, B>& b, const ArrayExpression<T, Length, C>& c)
+{
+    return ArrayTernaryExpression<T, Length, ArrayFusedMultiplyAddOp, A, B, C>(a.Self(), b.Self(), c.Self());
+}
+
+// a * b - c with a single rounding
+template<typename T, unsigned int Length, typename A, typename B, typename C>
+_SIMD_INL_ ArrayTernaryExpression<T, Length, ArrayFusedMultiplySubtractOp, A, B, C> FusedMultiplySubtract(const ArrayExpression<T, Length, A>& a, const ArrayExpression<T, Length, B>& b, const ArrayExpression<T, Length, C>& c)
+{
+    return ArrayTernaryExpression<T, Length, ArrayFusedMultiplySubtractOp, A, B, C>(a.Self(), b.Self(), c.Self());
+}
+
+template<typename T, unsigned int Length, typename Op, typename A>
+class ArrayUnaryExpression : public ArrayExpression<T, Length, ArrayUnaryExpression<T, Length, Op, A> >
+{
+public:
+    explicit ArrayUnaryExpression(const A& a) : Operand(a)
+    {
+    }
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return Op::Apply(Operand.Evaluate(index));
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        Operand.Prefetch(index);
+    }
+    static constexpr unsigned int Operands = A::Operands;
+private:
+    typename ArrayExpressionStorage<A>::type Operand;
+};
+
+// Elementary functions of float and double arrays, e.g. a = Exp(b * c) evaluates the product and the exponential
+// register by register
+#define CREATE_ARRAY_MATH_EXPRESSION(NAME) \
+struct Array##NAME##Op \
+{ \
+    template<typename T> static _SIMD_INL_ T Apply(const T& a) { return T::NAME(a); } \
+}; \
+template<typename T, unsigned int Length, typename A> \
+_SIMD_INL_ ArrayUnaryExpression<T, Length, Array##NAME##Op, A> NAME(const ArrayExpression<T, Length, A>& a) \
+{ \
+    return ArrayUnaryExpression<T, Length, Array##NAME##Op, A>(a.Self()); \
+}
+
+CREATE_ARRAY_MATH_EXPRESSION(Exp)
+CREATE_ARRAY_MATH_EXPRESSION(Log)
+CREATE_ARRAY_MATH_EXPRESSION(Sin)
+CREATE_ARRAY_MATH_EXPRESSION(Cos)
+CREATE_ARRAY_MATH_EXPRESSION(Tanh)
+CREATE_ARRAY_MATH_EXPRESSION(Sqrt)
+CREATE_ARRAY_MATH_EXPRESSION(RSqrt)
+
+// Lane wise functions of two operands, e.g. y = AddSaturate(x, y) or z = Pow(x, y)
+#define CREATE_ARRAY_BINARY_FUNCTION(NAME) \
+struct Array##NAME##Op \
+{ \
+    template<typename T> static _SIMD_INL_ T Apply(const T& a, const T& b) { return T::NAME(a, b); } \
+}; \
+template<typename T, unsigned int Length, typename L, typename R> \
+_SIMD_INL_ ArrayBinaryExpression<T, Length, Array##NAME##Op, L, R> NAME(const ArrayExpression<T, Length, L>& a, const ArrayExpression<T, Length, R>& b) \
+{ \
+    return ArrayBinaryExpression<T, Length, Array##NAME##Op, L, R>(a.Self(), b.Self()); \
+}
+
+CREATE_ARRAY_BINARY_FUNCTION(Pow)
+CREATE_ARRAY_BINARY_FUNCTION(AddSaturate)
+CREATE_ARRAY_BINARY_FUNCTION(SubtractSaturate)
+CREATE_ARRAY_BINARY_FUNCTION(Average)
+CREATE_ARRAY_BINARY_FUNCTION(AbsDiff)
+CREATE_ARRAY_BINARY_FUNCTION(AndNot)
+
+struct ArrayNotOp
+{
+    template<typename T> static _SIMD_INL_ T Apply(const T& a) { return T::Not(a); }
+};
+
+template<typename T, unsigned int Length, typename A>
+_SIMD_INL_ ArrayUnaryExpression<T, Length, ArrayNotOp, A> operator~(const ArrayExpression<T, Length, A>& a)
+{
+    return ArrayUnaryExpression<T, Length, ArrayNotOp, A>(a.Self());
+}
+
+// Shift of every lane by the same count, e.g. h = (h << 5) ^ (h >> 27)
+template<typename T, unsigned int Length, typename Op, typename A>
+class ArrayShiftExpression : public ArrayExpression<T, Length, ArrayShiftExpression<T, Length, Op, A> >
+{
+public:
+    ArrayShiftExpression(const A& a, unsigned int count) : Operand(a), Count(count)
+    {
+    }
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return Op::Apply(Operand.Evaluate(index), Count);
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        Operand.Prefetch(index);
+    }
+    static constexpr unsigned int Operands = A::Operands;
+private:
+    typename ArrayExpressionStorage<A>::type Operand;
+    unsigned int Count;
+};
+
+template<typename T, unsigned int Length, typename A>
+_SIMD_INL_ ArrayShiftExpression<T, Length, ArrayShiftLeftOp, A> operator<<(const ArrayExpression<T, Length, A>& a, unsigned int count)
+{
+    return ArrayShiftExpression<T, Length, ArrayShiftLeftOp, A>(a.Self(), count);
+}
+
+template<typename T, unsigned int Length, typename A>
+_SIMD_INL_ ArrayShiftExpression<T, Length, ArrayShiftRightOp, A> operator>>(const ArrayExpression<T, Length, A>& a, unsigned int count)
+{
+    return ArrayShiftExpression<T, Length, ArrayShiftRightOp, A>(a.Self(), count);
+}
+
+// Base of the lazy comparisons, Evaluate(index) returns the T::MaskType of register 'index'. Masks are
+// consumed by Select, Any, All and CountTrue and are never stored.
+template<typename T, unsigned int Length, typename Derived>
+struct ArrayMaskExpression
+{
+    _SIMD_INL_ const Derived& Self() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+template<typename T, unsigned int Length, typename Op, typename L, typename R>
+class ArrayCompareExpression : public ArrayMaskExpression<T, Length, ArrayCompareExpression<T, Length, Op, L, R> >
+{
+public:
+    ArrayCompareExpression(const L& left, const R& right) : Left(left), Right(right)
+    {
+    }
+    _SIMD_INL_ typename T::MaskType Evaluate(unsigned int index) const
+    {
+        return Op::Apply(Left.Evaluate(index), Right.Evaluate(index));
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        Left.Prefetch(index);
+        Right.Prefetch(index);
+    }
+    static constexpr unsigned int Operands = L::Operands + R::Operands;
+private:
+    typename ArrayExpressionStorage<L>::type Left;
+    typename ArrayExpressionStorage<R>::type Right;
+};
+
+#define CREATE_ARRAY_COMPARE_EXPRESSION(NAME) \
+struct ArrayCompare##NAME##Op \
+{ \
+    template<typename T> static _SIMD_INL_ typename T::MaskType Apply(const T& a, const T& b) { return T::Compare##NAME(a, b); } \
+}; \
+template<typename T, unsigned int Length, typename L, typename R> \
+_SIMD_INL_ ArrayCompareExpression<T, Length, ArrayCompare##NAME##Op, L, R> Compare##NAME(const ArrayExpression<T, Length, L>& left, const ArrayExpression<T, Length, R>& right) \
+{ \
+    return ArrayCompareExpression<T, Length, ArrayCompare##NAME##Op, L, R>(left.Self(), right.Self()); \
+}
+
+CREATE_ARRAY_COMPARE_EXPRESSION(Eq)
+CREATE_ARRAY_COMPARE_EXPRESSION(Ne)
+CREATE_ARRAY_COMPARE_EXPRESSION(Lt)
+CREATE_ARRAY_COMPARE_EXPRESSION(Gt)
+CREATE_ARRAY_COMPARE_EXPRESSION(Le)
+CREATE_ARRAY_COMPARE_EXPRESSION(Ge)
+
+struct ArraySelectOp
+{
+    template<typename M, typename T> static _SIMD_INL_ T Apply(const M& mask, const T& a, const T& b) { return T::Select(mask, a, b); }
+};
+
+// Lanes of a where the mask is set and of b elsewhere, e.g. a = Select(CompareGt(x, limit), limit, x) clamps without branches
+template<typename T, unsigned int Length, typename M, typename A, typename B>
+_SIMD_INL_ ArrayTernaryExpression<T, Length, ArraySelectOp, M, A, B> Select(const ArrayMaskExpression<T, Length, M>& mask, const ArrayExpression<T, Length, A>& a, const ArrayExpression<T, Length, B>& b)
+{
+    return ArrayTernaryExpression<T, Length, ArraySelectOp, M, A, B>(mask.Self(), a.Self(), b.Self());
+}
+
+template<typename T, unsigned int Length, typename M>
+_SIMD_INL_ bool Any(const ArrayMaskExpression<T, Length, M>& mask)
+{
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        if (T::Any(mask.Self().Evaluate(i)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename T, unsigned int Length, typename M>
+_SIMD_INL_ bool All(const ArrayMaskExpression<T, Length, M>& mask)
+{
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        if (!T::All(mask.Self().Evaluate(i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T, unsigned int Length, typename M>
+_SIMD_INL_ size_t CountTrue(const ArrayMaskExpression<T, Length, M>& mask)
+{
+    size_t count = 0;
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        count += T::CountTrue(mask.Self().Evaluate(i));
+    }
+    return count;
+}
+
+// Reductions over the first 'count' registers of a source with Evaluate(index), four independent accumulators hide
+// the add latency and the registers are reduced horizontally only once at the end
+template<typename T>
+struct ArrayReduce
+{
+    template<typename E>
+    static _SIMD_INL_ typename T::ReduceType Sum(const E& e, size_t count)
+    {
+        return Sum(e, count, std::is_same<typename T::ReduceType, typename T::ElementType>());
+    }
+
+    template<typename A, typename B>
+    static _SIMD_INL_ typename T::ElementType Dot(const A& a, const B& b, size_t count)
+    {
+        static_assert(std::is_same<typename T::ReduceType, typename T::ElementType>::value, "Dot is not supported for 8 and 16 bit lanes, the products would overflow the lanes.");
+        T acc0, acc1, acc2, acc3;
+        const size_t unrolled = count - count % 4;
+        for (size_t i = 0; i < unrolled; i += 4)
+        {
+            acc0 = ArrayMultiplyAccumulate<T>::Apply(a.Evaluate(i), b.Evaluate(i), acc0);
+            acc1 = ArrayMultiplyAccumulate<T>::Apply(a.Evaluate(i + 1), b.Evaluate(i + 1), acc1);
+            acc2 = ArrayMultiplyAccumulate<T>::Apply(a.Evaluate(i + 2), b.Evaluate(i + 2), acc2);
+            acc3 = ArrayMultiplyAccumulate<T>::Apply(a.Evaluate(i + 3), b.Evaluate(i + 3), acc3);
+        }
+        for (size_t i = unrolled; i < count; i++)
+        {
+            acc0 = ArrayMultiplyAccumulate<T>::Apply(a.Evaluate(i), b.Evaluate(i), acc0);
+        }
+        return T::ReduceSum(T::Add(T::Add(acc0, acc1), T::Add(acc2, acc3)));
+    }
+
+private:
+    template<typename E>
+    static _SIMD_INL_ typename T::ReduceType Sum(const E& e, size_t count, std::true_type /*same width*/)
+    {
+        T acc0, acc1, acc2, acc3;
+        const size_t unrolled = count - count % 4;
+        for (size_t i = 0; i < unrolled; i += 4)
+        {
+            acc0 = T::Add(acc0, e.Evaluate(i));
+            acc1 = T::Add(acc1, e.Evaluate(i + 1));
+            acc2 = T::Add(acc2, e.Evaluate(i + 2));
+            acc3 = T::Add(acc3, e.Evaluate(i + 3));
+        }
+        for (size_t i = unrolled; i < count; i++)
+        {
+            acc0 = T::Add(acc0, e.Evaluate(i));
+        }
+        return T::ReduceSum(T::Add(T::Add(acc0, acc1), T::Add(acc2, acc3)));
+    }
+    template<typename E>
+    static _SIMD_INL_ typename T::ReduceType Sum(const E& e, size_t count, std::false_type /*widened*/)
+    {
+        // Narrow lanes would wrap if they were accumulated vertically, every register is widened by ReduceSum instead
+        typename T::ReduceType acc0 = 0, acc1 = 0;
+        const size_t unrolled = count - count % 2;
+        for (size_t i = 0; i < unrolled; i += 2)
+        {
+            acc0 += T::ReduceSum(e.Evaluate(i));
+            acc1 += T::ReduceSum(e.Evaluate(i + 1));
+        }
+        for (size_t i = unrolled; i < count; i++)
+        {
+            acc0 += T::ReduceSum(e.Evaluate(i));
+        }
+        return acc0 + acc1;
+    }
+};
+
+/* Sum of all elements of an Array, a packed or mapped array or an expression, 8 and 16 bit lanes are widened to 32 bits */
+template<typename T, unsigned int Length, typename E>
+_SIMD_INL_ typename T::ReduceType Sum(const ArrayExpression<T, Length, E>& expression)
+{
+    return ArrayReduce<T>::Sum(expression.Self(), Length);
+}
+
+/* Sum of the element wise products of two arrays or expressions of the same shape */
+template<typename T, unsigned int Length, typename A, typename B>
+_SIMD_INL_ typename T::ElementType Dot(const ArrayExpression<T, Length, A>& a, const ArrayExpression<T, Length, B>& b)
+{
+    return ArrayReduce<T>::Dot(a.Self(), b.Self(), Length);
+}
+
+// Allocator is one of the AlignedMemory policies, PoolAllocator reuses the blocks of short lived arrays and puts
+// arrays of 2 MiB and more on huge pages
+template<typename T, unsigned int _Length, typename Allocator = AlignedMemory::SystemAllocator, IsSIMDType<T> = 0>
+class Array : public ArrayExpression<T, _Length, Array<T, _Length, Allocator> >
+{
+public:
+    Array() : Data(nullptr)
+    {
+        AlignedData = AlignedMemory::make_aligned<typename T::ElementType, Allocator>(static_cast<size_t>(T::ElementCount) * Length, T::Alignment);
+        Data = static_cast<typename T::ElementType*>(AlignedData.get());
+    }
+    
+    Array(const Array& other) : Array()
+    {
+        memcpy((void*)Data, (void*)other.Data, T::SizeBytes * Length);
+    }
+
+    Array(Array&& other) noexcept : Data(other.Data), AlignedData(std::move(other.AlignedData))
+    {
+        other.Data = nullptr;
+    }
+    Array& operator=(Array&& other)
+    {
+        if (this != &other)
+        {
+            Data = other.Data;
+            AlignedData = std::move(other.AlignedData);
+            other.Data = nullptr;
+        }
+        return *this;
+    }
+
+    Array& operator=(const Array& other)
+    {
+        memcpy((void*)Data, (void*)other.Data, T::SizeBytes * Length);
+        return *this;
+    }
+
+    // Expressions like a = b * c + d are evaluated in a single pass, each register of every operand is loaded once
+    template<typename E>
+    Array(const ArrayExpression<T, _Length, E>& expression) : Array()
+    {
+        *this = expression;
+    }
+
+    template<typename E>
+    _SIMD_INL_ Array& operator=(const ArrayExpression<T, _Length, E>& expression)
+    {
+        const E& e = expression.Self();
+        if (Dispatch::Dispatcher::UseStreamingStores(static_cast<size_t>(T::SizeBytes) * Length))
+        {
+            for (unsigned int i = 0; i < Length; i++)
+            {
+                e.Evaluate(i).Stream(Data + i*T::ElementCount);
+            }
+            _mm_sfence();
+            return *this;
+        }
+        // Evaluated in tiles whose operands fit in half of a 32 KiB L1, the next tile of every operand is
+        // prefetched while the current one is computed. A prefetch distance of 0 turns the prefetches off.
+        const unsigned int length = Length;
+        const unsigned int tile = std::max(4u, 16384u / (E::Operands * T::SizeBytes));
+        const unsigned int lineStep = std::max(1u, static_cast<unsigned int>(Parallel::CacheLineSize / T::SizeBytes));
+        const bool prefetch = Dispatch::Dispatcher::GetPrefetchDistance() != 0;
+        for (unsigned int begin = 0; begin < length; begin += tile)
+        {
+            const unsigned int end = std::min(length, begin + tile);
+            if (prefetch)
+            {
+                const unsigned int next = std::min(length, end + tile);
+                for (unsigned int i = end; i < next; i += lineStep)
+                {
+                    e.Prefetch(i);
+                }
+            }
+            for (unsigned int i = begin; i < end; i++)
+            {
+                e.Evaluate(i).Store(Data + i*T::ElementCount);
+            }
+        }
+        return *this;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator+=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs + rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator-=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs - rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator*=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs * rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator/=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs / rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator&=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs & rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator|=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs | rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator^=(Array& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs ^ rhs;
+    }
+
+    _SIMD_INL_ friend void operator<<=(Array& lhs, unsigned int count)
+    {
+        lhs = lhs << count;
+    }
+
+    _SIMD_INL_ friend void operator>>=(Array& lhs, unsigned int count)
+    {
+        lhs = lhs >> count;
+    }
+
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return T::Load(Data + index*T::ElementCount);
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(Data + index*T::ElementCount), _MM_HINT_T0);
+    }
+    static constexpr unsigned int Operands = 1;
+
+    //Arithmetic operators run through the runtime dispatched kernels
+    _SIMD_INL_ friend void operator+=(Array& lhs, const Array& rhs)
+    {
+        Dispatch::Add(lhs.Data, rhs.Data, Length * T::ElementCount);
+    }
+
+    _SIMD_INL_ friend void operator-=(Array& lhs, const Array& rhs)
+    {
+        Dispatch::Subtract(lhs.Data, rhs.Data, Length * T::ElementCount);
+    }
+
+    _SIMD_INL_ friend void operator*=(Array& lhs, const Array& rhs)
+    {
+        Dispatch::Multiply(lhs.Data, rhs.Data, Length * T::ElementCount);
+    }
+
+    _SIMD_INL_ friend void operator/=(Array& lhs, const Array& rhs)
+    {
+        Dispatch::Divide(lhs.Data, rhs.Data, Length * T::ElementCount);
+    }
+
+    // Integer division by a runtime constant, multiplies and shifts only (see Divider)
+    _SIMD_INL_ friend void operator/=(Array& lhs, const Divider<T>& divider)
+    {
+        const typename T::ElementType divisor = divider.Divisor();
+        const DividerMagic<typename T::ElementType> magic = divider.Parameters();
+        for (unsigned int i = 0; i < Length; i++)
+        {
+            DividerKernel<T::BitWidth, typename T::ElementType>::Apply(lhs.Data + i*T::ElementCount, lhs.Data + i*T::ElementCount, divisor, magic);
+        }
+    }
+
+    _SIMD_INL_ typename T::ElementType* operator[](unsigned int index)
+    {
+        return Data + index*T::ElementCount;
+    }
+    _SIMD_INL_ const typename T::ElementType* operator[](unsigned int index) const
+    {
+        return Data + index*T::ElementCount;
+    }
+
+    static constexpr unsigned int Length = _Length;
+private:
+    typename T::ElementType* Data;
+    AlignedMemory::AlignedPtr<typename T::ElementType, Allocator> AlignedData;
+    
+};
+
+template<typename T, unsigned int Length, typename Allocator>
+struct ArrayExpressionStorage<Array<T, Length, Allocator> >
+{
+    typedef const Array<T, Length, Allocator>& type;
+};
+
+// y = alpha * x + y, one fused multiply add and one store per register
+template<typename T, unsigned int Length, typename AllocatorX, typename AllocatorY>
+_SIMD_INL_ void Axpy(typename T::ElementType alpha, const Array<T, Length, AllocatorX>& x, Array<T, Length, AllocatorY>& y)
+{
+    const T scale = T::Broadcast(alpha);
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        T::FusedMultiplyAdd(scale, x.Evaluate(i), y.Evaluate(i)).Store(y[i]);
+    }
+}
+
+// Whole buffer conversions between Arrays of the same register width that keep the element order: register i of
+// from widens into registers 2i and 2i + 1 of to, and Narrow joins registers 2i and 2i + 1 into register i
+template<typename To, typename From, unsigned int Length, typename AllocatorFrom, typename AllocatorTo>
+_SIMD_INL_ void Widen(const Array<From, Length, AllocatorFrom>& from, Array<To, Length * 2, AllocatorTo>& to)
+{
+    To low, high;
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        To::Widen(from.Evaluate(i), low, high);
+        low.Store(to[2 * i]);
+        high.Store(to[2 * i + 1]);
+    }
+}
+
+template<typename To, typename From, unsigned int Length, typename AllocatorFrom, typename AllocatorTo>
+_SIMD_INL_ void Narrow(const Array<From, Length * 2, AllocatorFrom>& from, Array<To, Length, AllocatorTo>& to)
+{
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        To::Narrow(from.Evaluate(2 * i), from.Evaluate(2 * i + 1)).Store(to[i]);
+    }
+}
+
+template<typename To, typename From, unsigned int Length, typename AllocatorFrom, typename AllocatorTo>
+_SIMD_INL_ void Convert(const Array<From, Length, AllocatorFrom>& from, Array<To, Length, AllocatorTo>& to)
+{
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        To::Convert(from.Evaluate(i)).Store(to[i]);
+    }
+}
+
+// IEEE 754 binary16 storage element. Conversions round to nearest even, NaNs stay NaN with the quiet bit set.
+struct half
+{
+    uint16_t Bits;
+
+    half() : Bits(0) {}
+    half(float value) : Bits(FromFloat(value)) {}
+    operator float() const { return ToFloat(Bits); }
+
+    static _SIMD_INL_ uint16_t FromFloat(float value)
+    {
+#if defined(F16C_AVAILABLE)
+        return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+        uint32_t x;
+        memcpy(&x, &value, sizeof(x));
+        const uint32_t sign = (x >> 16) & 0x8000;
+        x &= 0x7FFFFFFF;
+        if (x >= 0x7F800000)
+        {
+            return static_cast<uint16_t>(sign | (x > 0x7F800000 ? 0x7E00 | ((x >> 13) & 0x3FF) : 0x7C00));
+        }
+        if (x >= 0x477FF000)
+        {
+            // 65520 and above round to infinity
+            return static_cast<uint16_t>(sign | 0x7C00);
+        }
+        if (x < 0x38800000)
+        {
+            // Below the smallest normal half, adding 0.5f aligns the denormal bits at the bottom of the mantissa
+            // and lets the FPU round them
+            float f;
+            memcpy(&f, &x, sizeof(f));
+            f += 0.5f;
+            memcpy(&x, &f, sizeof(x));
+            return static_cast<uint16_t>(sign | (x - 0x3F000000));
+        }
+        x += 0xC8000FFF + ((x >> 13) & 1); // rebias the exponent by 15 - 127 and round to nearest even
+        return static_cast<uint16_t>(sign | (x >> 13));
+#endif
+    }
+    static _SIMD_INL_ float ToFloat(uint16_t bits)
+    {
+#if defined(F16C_AVAILABLE)
+        return _cvtsh_ss(bits);
+#else
+        const uint32_t sign = static_cast<uint32_t>(bits & 0x8000) << 16;
+        const uint32_t exponent = (bits >> 10) & 0x1F;
+        const uint32_t mantissa = bits & 0x3FF;
+        uint32_t x;
+        if (exponent == 0)
+        {
+            const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+            memcpy(&x, &magnitude, sizeof(x));
+        }
+        else
+        {
+            x = (exponent == 31 ? 0x7F800000 : (exponent + 112) << 23) | (mantissa << 13);
+        }
+        x |= sign;
+        float value;
+        memcpy(&value, &x, sizeof(value));
+        return value;
+#endif
+    }
+};
+
+// bfloat16 storage element, the upper half of a float. Conversions round to nearest even, NaNs are quieted.
+struct bfloat16
+{
+    uint16_t Bits;
+
+    bfloat16() : Bits(0) {}
+    bfloat16(float value) : Bits(FromFloat(value)) {}
+    operator float() const { return ToFloat(Bits); }
+
+    static _SIMD_INL_ uint16_t FromFloat(float value)
+    {
+        uint32_t x;
+        memcpy(&x, &value, sizeof(x));
+        if ((x & 0x7FFFFFFF) > 0x7F800000)
+        {
+            return static_cast<uint16_t>((x >> 16) | 0x40);
+        }
+        return static_cast<uint16_t>((x + 0x7FFF + ((x >> 16) & 1)) >> 16);
+    }
+    static _SIMD_INL_ float ToFloat(uint16_t bits)
+    {
+        const uint32_t x = static_cast<uint32_t>(bits) << 16;
+        float value;
+        memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+};
+
+// Conversion of one register of 16 bit floats to and from float. The generic version converts lane by lane,
+// Supported() tells whether the CPU runs the instructions the specialization was compiled with.
+template<typename S, int Bits>
+struct PackedFloat
+{
+    static constexpr unsigned int ElementCount = Bits / 32;
+    static _SIMD_INL_ bool Supported() { return true; }
+    static _SIMD_INL_ void Load(float* to, const uint16_t* from)
+    {
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            to[i] = S::ToFloat(from[i]);
+        }
+    }
+    static _SIMD_INL_ void Store(uint16_t* to, const float* from)
+    {
+        for (unsigned int i = 0; i < ElementCount; i++)
+        {
+            to[i] = S::FromFloat(from[i]);
+        }
+    }
+};
+#if defined(F16C_AVAILABLE)
+template<>
+struct PackedFloat<half, 256>
+{
+    static _SIMD_INL_ bool Supported() { return CPUFeatures::hasF16C(); }
+    static _SIMD_INL_ void Load(float* to, const uint16_t* from) { _mm256_store_ps(to, _mm256_cvtph_ps(_mm_load_si128((const __m128i*)from))); }
+    static _SIMD_INL_ void Store(uint16_t* to, const float* from) { _mm_store_si128((__m128i*)to, _mm256_cvtps_ph(_mm256_load_ps(from), _MM_FROUND_TO_NEAREST_INT)); }
+};
+#endif
+#if defined(AVX2_AVAILABLE)
+// bfloat16 is the upper half of a float, loads shift the bits up and stores round with x + 0x7FFF + lsb
+template<>
+struct PackedFloat<bfloat16, 256>
+{
+    static _SIMD_INL_ bool Supported() { return true; }
+    static _SIMD_INL_ void Load(float* to, const uint16_t* from)
+    {
+        _mm256_store_si256((__m256i*)to, _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_load_si128((const __m128i*)from)), 16));
+    }
+    static _SIMD_INL_ void Store(uint16_t* to, const float* from)
+    {
+        const __m256 v = _mm256_load_ps(from);
+        const __m256i x = _mm256_castps_si256(v);
+        const __m256i rounded = _mm256_add_epi32(x, _mm256_add_epi32(_mm256_set1_epi32(0x7FFF), _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1))));
+        const __m256i quiet = _mm256_or_si256(x, _mm256_set1_epi32(0x400000));
+        const __m256i bits = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q))), 16);
+        _mm_store_si128((__m128i*)to, _mm256_castsi256_si128(BASIC_SIMD_NAMESPACE::Lanes::OrderPacked(_mm256_packus_epi32(bits, bits))));
+    }
+};
+#endif
+#if defined(AVX512F_AVAILABLE)
+// Same GCC 12 false positive as in Horizontal for the unmasked conversions
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+template<>
+struct PackedFloat<half, 512>
+{
+    static _SIMD_INL_ bool Supported() { return true; }
+    static _SIMD_INL_ void Load(float* to, const uint16_t* from) { _mm512_store_ps(to, _mm512_cvtph_ps(_mm256_load_si256((const __m256i*)from))); }
+    // The zero masked form, the unmasked one passes an undefined source that GCC 12 warns about at every call site
+    static _SIMD_INL_ void Store(uint16_t* to, const float* from) { _mm256_store_si256((__m256i*)to, _mm512_maskz_cvtps_ph(0xFFFF, _mm512_load_ps(from), _MM_FROUND_TO_NEAREST_INT)); }
+};
+// With AVX512_BF16 the store is vcvtneps2bf16, which also rounds to nearest even but flushes denormals to zero
+template<>
+struct PackedFloat<bfloat16, 512>
+{
+#if defined(AVX512BF16_AVAILABLE)
+    static _SIMD_INL_ bool Supported() { return CPUFeatures::hasAVX512BF16(); }
+#else
+    static _SIMD_INL_ bool Supported() { return true; }
+#endif
+    static _SIMD_INL_ void Load(float* to, const uint16_t* from)
+    {
+        _mm512_store_si512(to, _mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_load_si256((const __m256i*)from)), 16));
+    }
+    static _SIMD_INL_ void Store(uint16_t* to, const float* from)
+    {
+#if defined(AVX512BF16_AVAILABLE)
+        _mm256_store_si256((__m256i*)to, (__m256i)_mm512_cvtneps_pbh(_mm512_load_ps(from)));
+#else
+        const __m512 v = _mm512_load_ps(from);
+        const __m512i x = _mm512_castps_si512(v);
+        const __m512i rounded = _mm512_add_epi32(x, _mm512_add_epi32(_mm512_set1_epi32(0x7FFF), _mm512_and_si512(_mm512_srli_epi32(x, 16), _mm512_set1_epi32(1))));
+        const __m512i bits = _mm512_mask_or_epi32(rounded, _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q), x, _mm512_set1_epi32(0x400000));
+        _mm256_store_si256((__m256i*)to, _mm512_cvtepi32_epi16(_mm512_srli_epi32(bits, 16)));
+#endif
+    }
+};
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+#endif
+
+// Array of 16 bit floats (S is half or bfloat16) that computes in float registers T (float_256 or float_512).
+// Registers are widened when an expression reads them and rounded back when they are stored, so the arithmetic
+// is float while the memory traffic is halved. Packed arrays mix with Array<T, Length> in the same expressions.
+template<typename T, typename S, unsigned int _Length>
+class PackedArray : public ArrayExpression<T, _Length, PackedArray<T, S, _Length> >
+{
+    static_assert(std::is_same<typename T::ElementType, float>::value, "Packed arrays compute in float registers.");
+    static_assert(std::is_same<S, half>::value || std::is_same<S, bfloat16>::value, "Packed arrays store half or bfloat16 elements.");
+    typedef PackedFloat<S, T::BitWidth> Kernel;
+    static constexpr size_t SizeBytes = static_cast<size_t>(T::ElementCount) * sizeof(S);
+public:
+    typedef S StorageType;
+
+    PackedArray() : Data(nullptr)
+    {
+        if (!Kernel::Supported())
+        {
+            throw std::runtime_error("The 16 bit float conversions this packed array was compiled with are not supported by this device.");
+        }
+        AlignedData = std::move(AlignedMemory::make_aligned<S>(static_cast<size_t>(T::ElementCount) * Length, SizeBytes));
+        Data = AlignedData.get();
+    }
+
+    PackedArray(const PackedArray& other) : PackedArray()
+    {
+        memcpy((void*)Data, (void*)other.Data, SizeBytes * Length);
+    }
+
+    PackedArray(PackedArray&& other) noexcept : Data(other.Data), AlignedData(std::move(other.AlignedData))
+    {
+        other.Data = nullptr;
+    }
+
+    PackedArray& operator=(PackedArray&& other)
+    {
+        if (this != &other)
+        {
+            Data = other.Data;
+            AlignedData = std::move(other.AlignedData);
+            other.Data = nullptr;
+        }
+        return *this;
+    }
+
+    PackedArray& operator=(const PackedArray& other)
+    {
+        memcpy((void*)Data, (void*)other.Data, SizeBytes * Length);
+        return *this;
+    }
+
+    template<typename E>
+    PackedArray(const ArrayExpression<T, _Length, E>& expression) : PackedArray()
+    {
+        *this = expression;
+    }
+
+    // Evaluated in L1 sized tiles with the next tile prefetched, like Array
+    template<typename E>
+    _SIMD_INL_ PackedArray& operator=(const ArrayExpression<T, _Length, E>& expression)
+    {
+        const E& e = expression.Self();
+        const unsigned int length = Length;
+        const unsigned int tile = std::max(4u, 16384u / (E::Operands * T::SizeBytes));
+        const unsigned int lineStep = std::max(1u, static_cast<unsigned int>(Parallel::CacheLineSize / SizeBytes));
+        const bool prefetch = Dispatch::Dispatcher::GetPrefetchDistance() != 0;
+        for (unsigned int begin = 0; begin < length; begin += tile)
+        {
+            const unsigned int end = std::min(length, begin + tile);
+            if (prefetch)
+            {
+                const unsigned int next = std::min(length, end + tile);
+                for (unsigned int i = end; i < next; i += lineStep)
+                {
+                    e.Prefetch(i);
+                }
+            }
+            for (unsigned int i = begin; i < end; i++)
+            {
+                Store(i, e.Evaluate(i));
+            }
+        }
+        return *this;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator+=(PackedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs + rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator-=(PackedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs - rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator*=(PackedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs * rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator/=(PackedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs / rhs;
+    }
+
+    /* Register 'index' widened to float */
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        alignas(T::Alignment) float lanes[T::ElementCount];
+        Kernel::Load(lanes, &Data[index*T::ElementCount].Bits);
+        return T::Load(lanes);
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(Data + index*T::ElementCount), _MM_HINT_T0);
+    }
+    static constexpr unsigned int Operands = 1;
+
+    /* Rounds value to the storage type and writes it to register 'index' */
+    _SIMD_INL_ void Store(unsigned int index, const T& value)
+    {
+        alignas(T::Alignment) float lanes[T::ElementCount];
+        value.Store(lanes);
+        Kernel::Store(&Data[index*T::ElementCount].Bits, lanes);
+    }
+
+    _SIMD_INL_ S* operator[](unsigned int index)
+    {
+        return Data + index*T::ElementCount;
+    }
+
+    static constexpr unsigned int Length = _Length;
+private:
+    S* Data;
+    AlignedMemory::AlignedPtr<S> AlignedData;
+};
+
+template<typename T, typename S, unsigned int Length>
+struct ArrayExpressionStorage<PackedArray<T, S, Length> >
+{
+    typedef const PackedArray<T, S, Length>& type;
+};
+
+template<typename T, unsigned int Length>
+using HalfArray = PackedArray<T, half, Length>;
+
+template<typename T, unsigned int Length>
+using BFloat16Array = PackedArray<T, bfloat16, Length>;
+
+/* y = alpha * x + y on 16 bit storage, the fused multiply add runs in float and is rounded once on the store */
+template<typename T, typename S, unsigned int Length>
+_SIMD_INL_ void Axpy(float alpha, const PackedArray<T, S, Length>& x, PackedArray<T, S, Length>& y)
+{
+    const T scale = T::Broadcast(alpha);
+    for (unsigned int i = 0; i < Length; i++)
+    {
+        y.Store(i, T::FusedMultiplyAdd(scale, x.Evaluate(i), y.Evaluate(i)));
+    }
+}
+
+// Runtime sized counterpart of Array, the size is given in elements and does not need to be a multiple of T::ElementCount.
+// Storage is always allocated in whole registers, the operators process full registers and finish the tail with scalar code.
+template<typename T, IsSIMDType<T> = 0>
+class Vector
+{
+public:
+    using ElementType = typename T::ElementType;
+
+    Vector() : Data_(nullptr), Size_(0), Capacity_(0)
+    {
+    }
+
+    explicit Vector(size_t size, ElementType value = ElementType()) : Data_(nullptr), Size_(0), Capacity_(0)
+    {
+        Resize(size, value);
+    }
+
+    Vector(const ElementType* data, size_t size) : Data_(nullptr), Size_(0), Capacity_(0)
+    {
+        Assign(data, size);
+    }
+
+    Vector(const Vector& other) : Vector(other.Data_, other.Size_)
+    {
+    }
+
+    Vector(Vector&& other) noexcept : Data_(other.Data_), Size_(other.Size_), Capacity_(other.Capacity_), AlignedData_(std::move(other.AlignedData_))
+    {
+        other.Data_ = nullptr;
+        other.Size_ = 0;
+        other.Capacity_ = 0;
+    }
+
+    Vector& operator=(const Vector& other)
+    {
+        if (this != &other)
+        {
+            Assign(other.Data_, other.Size_);
+        }
+        return *this;
+    }
+
+    Vector& operator=(Vector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            AlignedData_ = std::move(other.AlignedData_);
+            Data_ = other.Data_;
+            Size_ = other.Size_;
+            Capacity_ = other.Capacity_;
+            other.Data_ = nullptr;
+            other.Size_ = 0;
+            other.Capacity_ = 0;
+        }
+        return *this;
+    }
+
+    void Reserve(size_t capacity)
+    {
+        if (capacity > Capacity_)
+        {
+            Grow(capacity, Size_);
+        }
+    }
+
+    void Resize(size_t size, ElementType value = ElementType())
+    {
+        Reserve(size);
+        if (size > Size_)
+        {
+            std::fill(Data_ + Size_, Data_ + size, value);
+        }
+        Size_ = size;
+    }
+
+    void PushBack(ElementType value)
+    {
+        if (Size_ == Capacity_)
+        {
+            Reserve(Capacity_ == 0 ? T::ElementCount : Capacity_ * 2);
+        }
+        Data_[Size_++] = value;
+    }
+
+    void Clear()
+    {
+        Size_ = 0;
+    }
+
+    _SIMD_INL_ friend void operator+=(Vector& lhs, const Vector& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Add(lhs.Data_, rhs.Data_, lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator-=(Vector& lhs, const Vector& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Subtract(lhs.Data_, rhs.Data_, lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator*=(Vector& lhs, const Vector& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Multiply(lhs.Data_, rhs.Data_, lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator/=(Vector& lhs, const Vector& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Divide(lhs.Data_, rhs.Data_, lhs.Size_);
+    }
+
+    _SIMD_INL_ ElementType& operator[](size_t index)
+    {
+        return Data_[index];
+    }
+
+    _SIMD_INL_ const ElementType& operator[](size_t index) const
+    {
+        return Data_[index];
+    }
+
+    ElementType* Data() { return Data_; }
+    const ElementType* Data() const { return Data_; }
+    size_t Size() const { return Size_; }
+    size_t Capacity() const { return Capacity_; }
+    bool Empty() const { return Size_ == 0; }
+
+    ElementType* begin() { return Data_; }
+    ElementType* end() { return Data_ + Size_; }
+    const ElementType* begin() const { return Data_; }
+    const ElementType* end() const { return Data_ + Size_; }
+
+private:
+    /* Moves to a buffer of at least 'capacity' elements, rounded up to whole registers so the buffer size is a
+       multiple of the alignment, that starts with the first 'keep' elements of the current one. The copy is
+       bounded by both buffers, which also tells the compiler it cannot run past the old one */
+    void Grow(size_t capacity, size_t keep)
+    {
+        capacity = (capacity + T::ElementCount - 1) / T::ElementCount * T::ElementCount;
+        AlignedMemory::AlignedPtr<ElementType> newData = AlignedMemory::make_aligned<ElementType>(capacity, T::Alignment);
+        keep = std::min(keep, std::min(Capacity_, capacity));
+        if (keep > 0)
+        {
+            memcpy(static_cast<void*>(newData.get()), static_cast<const void*>(Data_), keep * sizeof(ElementType));
+        }
+        AlignedData_ = std::move(newData);
+        Data_ = AlignedData_.get();
+        Capacity_ = capacity;
+    }
+
+    /* Replaces the contents by 'size' elements of 'data', growing without keeping the old ones */
+    void Assign(const ElementType* data, size_t size)
+    {
+        if (size > Capacity_)
+        {
+            Grow(size, 0);
+        }
+        if (size > 0)
+        {
+            memcpy(static_cast<void*>(Data_), static_cast<const void*>(data), size * sizeof(ElementType));
+        }
+        Size_ = size;
+    }
+
+    void CheckSize(const Vector& other) const
+    {
+        if (Size_ != other.Size_)
+        {
+            throw std::runtime_error("Vector sizes do not match.");
+        }
+    }
+
+    ElementType* Data_;
+    size_t Size_;
+    size_t Capacity_;
+    AlignedMemory::AlignedPtr<ElementType> AlignedData_;
+};
+
+// Registers of an ArrayView as a source for ArrayReduce, the loads are unaligned
+template<typename T>
+struct ArrayViewRegisters
+{
+    explicit ArrayViewRegisters(const typename T::ElementType* data) : Data(data)
+    {
+    }
+    _SIMD_INL_ T Evaluate(size_t index) const
+    {
+        return T::LoadUnaligned(Data + index*T::ElementCount);
+    }
+    const typename T::ElementType* Data;
+};
+
+// Read only counterpart of ArrayView for memory that must not be written, such as read only shared memory, a
+// const container or a read only MappedArray. It has the reductions of ArrayView, and ArrayView, MappedArray, const
+// Arrays, Vectors and containers with data() and size() convert to it.
+template<typename T, IsSIMDType<T> = 0>
+class ConstArrayView
+{
+public:
+    using ElementType = typename T::ElementType;
+
+    ConstArrayView() : Data_(nullptr), Size_(0)
+    {
+    }
+
+    ConstArrayView(const ElementType* data, size_t size) : Data_(data), Size_(size)
+    {
+    }
+
+    template<unsigned int Length, typename Allocator>
+    ConstArrayView(const Array<T, Length, Allocator>& array) : Data_(array[0]), Size_(static_cast<size_t>(Length) * T::ElementCount)
+    {
+    }
+
+    ConstArrayView(const Vector<T>& vector) : Data_(vector.Data()), Size_(vector.Size())
+    {
+    }
+
+    template<typename C, typename std::enable_if<std::is_same<decltype(std::declval<const C&>().data()), const ElementType*>::value, int>::type = 0>
+    ConstArrayView(const C& container) : Data_(container.data()), Size_(container.size())
+    {
+    }
+
+    /* Elements [offset, offset + size) of this view */
+    ConstArrayView Subview(size_t offset, size_t size) const
+    {
+        if (offset > Size_ || size > Size_ - offset)
+        {
+            throw std::runtime_error("Subview is out of the bounds of the ConstArrayView.");
+        }
+        return ConstArrayView(Data_ + offset, size);
+    }
+
+    _SIMD_INL_ const ElementType& operator[](size_t index) const
+    {
+        return Data_[index];
+    }
+
+    /* Sum of all elements, 8 and 16 bit lanes are widened to 32 bits */
+    _SIMD_INL_ typename T::ReduceType Sum() const
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        typename T::ReduceType sum = ArrayReduce<T>::Sum(ArrayViewRegisters<T>(Data_), vectorCount / T::ElementCount);
+        if (vectorCount < Size_)
+        {
+            sum += T::ReduceSum(Tail(Data_));
+        }
+        return sum;
+    }
+
+    /* Sum of the element wise products */
+    _SIMD_INL_ ElementType Dot(const ConstArrayView& other) const
+    {
+        if (Size_ != other.Size_)
+        {
+            throw std::runtime_error("ArrayView sizes do not match.");
+        }
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        ElementType dot = ArrayReduce<T>::Dot(ArrayViewRegisters<T>(Data_), ArrayViewRegisters<T>(other.Data_), vectorCount / T::ElementCount);
+        if (vectorCount < Size_)
+        {
+            dot += T::ReduceSum(T::Multiply(Tail(Data_), Tail(other.Data_)));
+        }
+        return dot;
+    }
+
+    const ElementType* Data() const { return Data_; }
+    size_t Size() const { return Size_; }
+    bool Empty() const { return Size_ == 0; }
+
+    const ElementType* begin() const { return Data_; }
+    const ElementType* end() const { return Data_ + Size_; }
+
+private:
+    /* The elements past the last whole register, padded with zeros to a full register */
+    _SIMD_INL_ T Tail(const ElementType* data) const
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        alignas(T::Alignment) ElementType lanes[T::ElementCount];
+        std::fill(lanes, lanes + T::ElementCount, ElementType(0));
+        std::copy(data + vectorCount, data + Size_, lanes);
+        return T::Load(lanes);
+    }
+
+    const ElementType* Data_;
+    size_t Size_;
+};
+
+// Integer division of every register by one Divider, for ArrayView
+template<typename T>
+struct ArrayViewDividerOp
+{
+    static _SIMD_INL_ T Apply(const T& a, const Divider<T>& divider) { return divider.Divide(a); }
+};
+
+// Non owning view of memory owned elsewhere (ring buffers, shared memory, std::vector), a pointer and an element count.
+// The memory needs no alignment: the arithmetic operators run the peeling dispatched kernels, the other operators use
+// unaligned loads and stores and finish the tail in a zero padded register. Array, Vector, containers with data()
+// and size() and CopyOnWrite MappedArrays convert to a view implicitly, the view must not outlive them. Read only
+// memory takes a ConstArrayView, which the operators also accept as their right hand side.
+template<typename T, IsSIMDType<T> = 0>
+class ArrayView
+{
+public:
+    using ElementType = typename T::ElementType;
+
+    ArrayView() : Data_(nullptr), Size_(0)
+    {
+    }
+
+    ArrayView(ElementType* data, size_t size) : Data_(data), Size_(size)
+    {
+    }
+
+    template<unsigned int Length, typename Allocator>
+    ArrayView(Array<T, Length, Allocator>& array) : Data_(array[0]), Size_(static_cast<size_t>(Length) * T::ElementCount)
+    {
+    }
+
+    ArrayView(Vector<T>& vector) : Data_(vector.Data()), Size_(vector.Size())
+    {
+    }
+
+    template<typename C, typename std::enable_if<std::is_same<decltype(std::declval<C&>().data()), ElementType*>::value, int>::type = 0>
+    ArrayView(C& container) : Data_(container.data()), Size_(container.size())
+    {
+    }
+
+    /* Elements [offset, offset + size) of this view */
+    ArrayView Subview(size_t offset, size_t size) const
+    {
+        if (offset > Size_ || size > Size_ - offset)
+        {
+            throw std::runtime_error("Subview is out of the bounds of the ArrayView.");
+        }
+        return ArrayView(Data_ + offset, size);
+    }
+
+    _SIMD_INL_ friend void operator+=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Add(lhs.Data_, rhs.Data(), lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator-=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Subtract(lhs.Data_, rhs.Data(), lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator*=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Multiply(lhs.Data_, rhs.Data(), lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator/=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        Dispatch::Divide(lhs.Data_, rhs.Data(), lhs.Size_);
+    }
+
+    _SIMD_INL_ friend void operator&=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        lhs.template Apply<ArrayAndOp>(rhs.Data(), 0);
+    }
+
+    _SIMD_INL_ friend void operator|=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        lhs.template Apply<ArrayOrOp>(rhs.Data(), 0);
+    }
+
+    _SIMD_INL_ friend void operator^=(ArrayView& lhs, const ConstArrayView<T>& rhs)
+    {
+        lhs.CheckSize(rhs);
+        lhs.template Apply<ArrayXorOp>(rhs.Data(), 0);
+    }
+
+    _SIMD_INL_ friend void operator<<=(ArrayView& lhs, unsigned int count)
+    {
+        lhs.template Apply<ArrayShiftLeftOp>(count);
+    }
+
+    _SIMD_INL_ friend void operator>>=(ArrayView& lhs, unsigned int count)
+    {
+        lhs.template Apply<ArrayShiftRightOp>(count);
+    }
+
+    // Integer division by a runtime constant, multiplies and shifts only (see Divider)
+    _SIMD_INL_ friend void operator/=(ArrayView& lhs, const Divider<T>& divider)
+    {
+        lhs.template Apply<ArrayViewDividerOp<T> >(divider);
+    }
+
+    _SIMD_INL_ ElementType& operator[](size_t index) const
+    {
+        return Data_[index];
+    }
+
+    /* Sum of all elements, 8 and 16 bit lanes are widened to 32 bits */
+    _SIMD_INL_ typename T::ReduceType Sum() const
+    {
+        return ConstArrayView<T>(Data_, Size_).Sum();
+    }
+
+    /* Sum of the element wise products, the other view may be read only */
+    _SIMD_INL_ ElementType Dot(const ConstArrayView<T>& other) const
+    {
+        return ConstArrayView<T>(Data_, Size_).Dot(other);
+    }
+
+    operator ConstArrayView<T>() const
+    {
+        return ConstArrayView<T>(Data_, Size_);
+    }
+
+    ElementType* Data() const { return Data_; }
+    size_t Size() const { return Size_; }
+    bool Empty() const { return Size_ == 0; }
+
+    ElementType* begin() const { return Data_; }
+    ElementType* end() const { return Data_ + Size_; }
+
+private:
+    void CheckSize(const ConstArrayView<T>& other) const
+    {
+        if (Size_ != other.Size())
+        {
+            throw std::runtime_error("ArrayView sizes do not match.");
+        }
+    }
+
+    /* The elements past the last whole register, padded with 'padding' to a full register */
+    _SIMD_INL_ T Tail(const ElementType* data, ElementType padding) const
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        alignas(T::Alignment) ElementType lanes[T::ElementCount];
+        std::fill(lanes, lanes + T::ElementCount, padding);
+        std::copy(data + vectorCount, data + Size_, lanes);
+        return T::Load(lanes);
+    }
+    _SIMD_INL_ void StoreTail(const T& value)
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        alignas(T::Alignment) ElementType lanes[T::ElementCount];
+        value.Store(lanes);
+        std::copy(lanes, lanes + (Size_ - vectorCount), Data_ + vectorCount);
+    }
+
+    /* this[i] = Op(this[i], other[i]), the tail lanes of other past Size are filled with 'padding' */
+    template<typename Op>
+    _SIMD_INL_ void Apply(const ElementType* other, ElementType padding)
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        for (size_t i = 0; i < vectorCount; i += T::ElementCount)
+        {
+            Op::Apply(T::LoadUnaligned(Data_ + i), T::LoadUnaligned(other + i)).StoreUnaligned(Data_ + i);
+        }
+        if (vectorCount < Size_)
+        {
+            StoreTail(Op::Apply(Tail(Data_, 0), Tail(other, padding)));
+        }
+    }
+    /* this[i] = Op(this[i], argument) */
+    template<typename Op, typename Argument>
+    _SIMD_INL_ void Apply(const Argument& argument)
+    {
+        const size_t vectorCount = Size_ - Size_ % T::ElementCount;
+        for (size_t i = 0; i < vectorCount; i += T::ElementCount)
+        {
+            Op::Apply(T::LoadUnaligned(Data_ + i), argument).StoreUnaligned(Data_ + i);
+        }
+        if (vectorCount < Size_)
+        {
+            StoreTail(Op::Apply(Tail(Data_, 0), argument));
+        }
+    }
+
+    ElementType* Data_;
+    size_t Size_;
+};
+
+// On disk layout of a mapped array: this 64 byte header, zero padding up to PayloadOffset and the registers of the
+// array in memory order. PayloadOffset is a multiple of Alignment, which is at least the page size, so the mapped
+// payload is register aligned and is used in place. Fields are little endian, like the x86 targets that read them.
+struct MappedHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t ElementKind;   // 0 signed integer, 1 unsigned integer, 2 floating point
+    uint32_t ElementBytes;
+    uint32_t RegisterBits;
+    uint64_t Length;        // registers
+    uint64_t Alignment;
+    uint64_t PayloadOffset;
+    uint64_t PayloadBytes;
+    uint64_t Reserved;
+
+    static constexpr uint32_t CurrentVersion = 1;
+    static constexpr uint64_t PageAlignment = 4096;
+
+    template<typename T>
+    static MappedHeader Create(uint64_t length)
+    {
+        typedef typename T::ElementType E;
+        MappedHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.Magic, "BSIMDARR", sizeof(header.Magic));
+        header.Version = CurrentVersion;
+        header.ElementKind = std::is_floating_point<E>::value ? 2 : (std::is_signed<E>::value ? 0 : 1);
+        header.ElementBytes = sizeof(E);
+        header.RegisterBits = T::BitWidth;
+        header.Length = length;
+        header.Alignment = T::Alignment > PageAlignment ? static_cast<uint64_t>(T::Alignment) : PageAlignment;
+        header.PayloadOffset = header.Alignment;
+        header.PayloadBytes = length * T::SizeBytes;
+        return header;
+    }
+};
+static_assert(sizeof(MappedHeader) == 64, "The mapped header is a fixed 64 bytes on disk.");
+
+enum class MapMode
+{
+    ReadOnly,       // pages are shared with the page cache and with other processes mapping the file
+    CopyOnWrite     // written pages become private copies, the file is never modified
+};
+
+// Whole file memory mapping, unmapped when destroyed. The platform calls are confined to Map and Unmap.
+class MappedFile
+{
+public:
+    MappedFile(const std::string& path, MapMode mode) : Address(nullptr), Size(0)
+    {
+        Address = Map(path, mode, Size);
+    }
+
+    MappedFile(MappedFile&& other) noexcept : Address(other.Address), Size(other.Size)
+    {
+        other.Address = nullptr;
+        other.Size = 0;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if (Address != nullptr)
+        {
+            Unmap(Address, Size);
+        }
+    }
+
+    void* Data() const { return Address; }
+    size_t Bytes() const { return Size; }
+
+private:
+    /* Maps all of 'path' and stores its size in 'size', throws std::runtime_error when it cannot */
+    static void* Map(const std::string& path, MapMode mode, size_t& size)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Mapped file " + path + " could not be opened.");
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            throw std::runtime_error("Mapped file " + path + " is empty.");
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, mode == MapMode::ReadOnly ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            throw std::runtime_error("Mapped file " + path + " could not be mapped.");
+        }
+        void* address = MapViewOfFile(mapping, mode == MapMode::ReadOnly ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(mapping);
+        if (address == nullptr)
+        {
+            throw std::runtime_error("Mapped file " + path + " could not be mapped.");
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return address;
+#else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            throw std::runtime_error("Mapped file " + path + " could not be opened.");
+        }
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size == 0)
+        {
+            close(file);
+            throw std::runtime_error("Mapped file " + path + " is empty.");
+        }
+        void* address = mmap(nullptr, static_cast<size_t>(status.st_size), mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        close(file);
+        if (address == MAP_FAILED)
+        {
+            throw std::runtime_error("Mapped file " + path + " could not be mapped.");
+        }
+        size = static_cast<size_t>(status.st_size);
+        return address;
+#endif
+    }
+
+    static void Unmap(void* address, size_t size)
+    {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(address);
+#else
+        munmap(address, size);
+#endif
+    }
+
+    void* Address;
+    size_t Size;
+};
+
+// Writes the registers of an Array, or of any expression of that shape, in the mapped layout
+template<typename T, unsigned int Length, typename E>
+void SaveMapped(const std::string& path, const ArrayExpression<T, Length, E>& expression)
+{
+    const MappedHeader header = MappedHeader::Create<T>(Length);
+    std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(path.c_str(), "wb"), fclose);
+    if (!file)
+    {
+        throw std::runtime_error("Mapped file " + path + " could not be created.");
+    }
+    std::vector<char> padding(static_cast<size_t>(header.PayloadOffset) - sizeof(header), 0);
+    bool written = fwrite(&header, sizeof(header), 1, file.get()) == 1 && fwrite(padding.data(), 1, padding.size(), file.get()) == padding.size();
+    const E& e = expression.Self();
+    for (unsigned int i = 0; written && i < Length; i++)
+    {
+        const T value = e.Evaluate(i);
+        written = fwrite(value.Data, T::SizeBytes, 1, file.get()) == 1;
+    }
+    if (!written || fflush(file.get()) != 0)
+    {
+        throw std::runtime_error("Mapped file " + path + " could not be written.");
+    }
+}
+
+// Array whose registers live in a file written by SaveMapped. Loading maps the file and checks the header, there is no
+// parse or copy step: pages are read on first access and stay in the page cache for the next process. Mapped arrays
+// are operands of Array expressions. A CopyOnWrite mapping can also be assigned, the changes stay private to the process.
+template<typename T, unsigned int _Length, IsSIMDType<T> = 0>
+class MappedArray : public ArrayExpression<T, _Length, MappedArray<T, _Length> >
+{
+public:
+    explicit MappedArray(const std::string& path, MapMode mode = MapMode::ReadOnly) : File(path, mode), Mode(mode), Data(nullptr)
+    {
+        const MappedHeader expected = MappedHeader::Create<T>(Length);
+        MappedHeader header;
+        if (File.Bytes() < sizeof(header))
+        {
+            throw std::runtime_error("Mapped file " + path + " is too small for the header.");
+        }
+        memcpy(&header, File.Data(), sizeof(header));
+        if (memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) != 0 || header.Version != expected.Version)
+        {
+            throw std::runtime_error("Mapped file " + path + " is not a SIMD array file of a supported version.");
+        }
+        if (header.ElementKind != expected.ElementKind || header.ElementBytes != expected.ElementBytes || header.RegisterBits != expected.RegisterBits || header.Length != expected.Length)
+        {
+            throw std::runtime_error("Mapped file " + path + " holds a different element type, register width or length.");
+        }
+        if (header.Alignment % T::Alignment != 0 || header.PayloadOffset % header.Alignment != 0 || header.PayloadBytes != expected.PayloadBytes ||
+            header.PayloadOffset + header.PayloadBytes > File.Bytes())
+        {
+            throw std::runtime_error("Mapped file " + path + " has a misaligned or truncated payload.");
+        }
+        Data = reinterpret_cast<typename T::ElementType*>(static_cast<char*>(File.Data()) + header.PayloadOffset);
+    }
+
+    MappedArray(MappedArray&& other) noexcept : File(std::move(other.File)), Mode(other.Mode), Data(other.Data)
+    {
+        other.Data = nullptr;
+    }
+
+    template<typename E>
+    _SIMD_INL_ MappedArray& operator=(const ArrayExpression<T, _Length, E>& expression)
+    {
+        if (Mode == MapMode::ReadOnly)
+        {
+            throw std::runtime_error("A read only MappedArray can not be assigned, map it with MapMode::CopyOnWrite.");
+        }
+        const E& e = expression.Self();
+        for (unsigned int i = 0; i < Length; i++)
+        {
+            e.Evaluate(i).Store(Data + i*T::ElementCount);
+        }
+        return *this;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator+=(MappedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs + rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator-=(MappedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs - rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator*=(MappedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs * rhs;
+    }
+
+    template<typename E>
+    _SIMD_INL_ friend void operator/=(MappedArray& lhs, const ArrayExpression<T, _Length, E>& rhs)
+    {
+        lhs = lhs / rhs;
+    }
+
+    _SIMD_INL_ T Evaluate(unsigned int index) const
+    {
+        return T::Load(Data + index*T::ElementCount);
+    }
+    _SIMD_INL_ void Prefetch(unsigned int index) const
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(Data + index*T::ElementCount), _MM_HINT_T0);
+    }
+    static constexpr unsigned int Operands = 1;
+
+    _SIMD_INL_ const typename T::ElementType* operator[](unsigned int index) const
+    {
+        return Data + index*T::ElementCount;
+    }
+
+    MapMode GetMode() const { return Mode; }
+
+    operator ConstArrayView<T>() const
+    {
+        return ConstArrayView<T>(Data, static_cast<size_t>(Length) * T::ElementCount);
+    }
+    /* Only a CopyOnWrite mapping can be written through a view */
+    operator ArrayView<T>()
+    {
+        if (Mode == MapMode::ReadOnly)
+        {
+            throw std::runtime_error("A read only MappedArray has no writable view, map it with MapMode::CopyOnWrite or use ConstArrayView.");
+        }
+        return ArrayView<T>(Data, static_cast<size_t>(Length) * T::ElementCount);
+    }
+
+    static constexpr unsigned int Length = _Length;
+private:
+    MappedFile File;
+    MapMode Mode;
+    typename T::ElementType* Data;
+};
+
+template<typename T, unsigned int Length>
+struct ArrayExpressionStorage<MappedArray<T, Length> >
+{
+    typedef const MappedArray<T, Length>& type;
+};
+
+// Conversion between records interleaved in memory (x0 y0 z0 x1 y1 z1 ...) and one column per field. The generic
+// version copies element by element, Supported() tells whether a specialization is compiled in.
+template<int Bits, size_t ElementBytes>
+struct RecordShuffle
+{
+    static _SIMD_INL_ bool Supported() { return false; }
+    template<typename E>
+    static void ToColumns(E* const* columns, const E* records, unsigned int fields, size_t count)
+    {
+        for (size_t j = 0; j < count; j++)
+        {
+            for (unsigned int f = 0; f < fields; f++)
+            {
+                columns[f][j] = records[j * fields + f];
+            }
+        }
+    }
+    template<typename E>
+    static void ToRecords(E* records, const E* const* columns, unsigned int fields, size_t count)
+    {
+        for (size_t j = 0; j < count; j++)
+        {
+            for (unsigned int f = 0; f < fields; f++)
+            {
+                records[j * fields + f] = columns[f][j];
+            }
+        }
+    }
+};
+
+// A block is 'fields' registers of records. Every output register of a block is a blend of one lane permute per input
+// register it takes elements from, the permute indices and blend masks depend only on the field count and are built
+// once per call. Ops provides the masked 32 bit lane permute of one register width, 64 bit elements move as pairs
+// of 32 bit lanes. Records left over after the last whole block are copied by the generic version.
+template<typename Ops, size_t ElementBytes>
+struct RecordShuffleKernel
+{
+    static constexpr unsigned int Lanes = Ops::Lanes;
+    static constexpr unsigned int PerElement = static_cast<unsigned int>(ElementBytes / 4);
+    static constexpr unsigned int Elements = Lanes / PerElement;
+    static constexpr unsigned int MaxFields = 8;
+    typedef typename Ops::Reg Reg;
+    typedef typename Ops::Mask Mask;
+
+    static _SIMD_INL_ bool Supported() { return true; }
+
+    template<typename E>
+    static void ToColumns(E* const* columns, const E* records, unsigned int fields, size_t count)
+    {
+        if (fields > MaxFields)
+        {
+            RecordShuffle<0, ElementBytes>::ToColumns(columns, records, fields, count);
+            return;
+        }
+        Table table(fields, true);
+        const size_t blocks = count / Elements;
+        Reg in[MaxFields];
+        for (size_t b = 0; b < blocks; b++)
+        {
+            const E* block = records + b * Elements * fields;
+            for (unsigned int r = 0; r < fields; r++)
+            {
+                in[r] = Ops::Load(block + r * Elements);
+            }
+            for (unsigned int f = 0; f < fields; f++)
+            {
+                Ops::Store(columns[f] + b * Elements, table.Gather(f, in));
+            }
+        }
+        E* rest[MaxFields];
+        for (unsigned int f = 0; f < fields; f++)
+        {
+            rest[f] = columns[f] + blocks * Elements;
+        }
+        RecordShuffle<0, ElementBytes>::ToColumns(rest, records + blocks * Elements * fields, fields, count - blocks * Elements);
+    }
+
+    template<typename E>
+    static void ToRecords(E* records, const E* const* columns, unsigned int fields, size_t count)
+    {
+        if (fields > MaxFields)
+        {
+            RecordShuffle<0, ElementBytes>::ToRecords(records, columns, fields, count);
+            return;
+        }
+        Table table(fields, false);
+        const size_t blocks = count / Elements;
+        Reg in[MaxFields];
+        for (size_t b = 0; b < blocks; b++)
+        {
+            E* block = records + b * Elements * fields;
+            for (unsigned int f = 0; f < fields; f++)
+            {
+                in[f] = Ops::Load(columns[f] + b * Elements);
+            }
+            for (unsigned int r = 0; r < fields; r++)
+            {
+                Ops::Store(block + r * Elements, table.Gather(r, in));
+            }
+        }
+        const E* rest[MaxFields];
+        for (unsigned int f = 0; f < fields; f++)
+        {
+            rest[f] = columns[f] + blocks * Elements;
+        }
+        RecordShuffle<0, ElementBytes>::ToRecords(records + blocks * Elements * fields, rest, fields, count - blocks * Elements);
+    }
+
+private:
+    // Indices[o][i] permutes input register i so that its elements land in their lanes of output register o, Masks[o][i]
+    // selects those lanes and Used[o][i] is false where input i has nothing for output o
+    struct Table
+    {
+        Reg Indices[MaxFields][MaxFields];
+        Mask Masks[MaxFields][MaxFields];
+        bool Used[MaxFields][MaxFields];
+        unsigned int Fields;
+
+        Table(unsigned int fields, bool toColumns) : Fields(fields)
+        {
+            for (unsigned int o = 0; o < fields; o++)
+            {
+                int32_t indices[MaxFields][Lanes];
+                bool selected[MaxFields][Lanes];
+                memset(indices, 0, sizeof(indices));
+                memset(selected, 0, sizeof(selected));
+                for (unsigned int lane = 0; lane < Lanes; lane++)
+                {
+                    const unsigned int part = lane % PerElement;
+                    unsigned int input, element;
+                    if (toColumns)
+                    {
+                        // Output o is field o, its element j is element j * fields + o of the block
+                        const unsigned int e = (lane / PerElement) * fields + o;
+                        input = e / Elements;
+                        element = e % Elements;
+                    }
+                    else
+                    {
+                        // Output o is register o of the records, its element e is field e % fields of record e / fields
+                        const unsigned int e = o * Elements + lane / PerElement;
+                        input = e % fields;
+                        element = e / fields;
+                    }
+                    indices[input][lane] = static_cast<int32_t>(element * PerElement + part);
+                    selected[input][lane] = true;
+                }
+                for (unsigned int i = 0; i < fields; i++)
+                {
+                    Used[o][i] = std::find(selected[i], selected[i] + Lanes, true) != selected[i] + Lanes;
+                    Indices[o][i] = Ops::Indices(indices[i]);
+                    Masks[o][i] = Ops::Select(selected[i]);
+                }
+            }
+        }
 
-    CREATE_INT512_OPERATOR_MULTIPLY(16);
-#endif
+        _SIMD_INL_ Reg Gather(unsigned int output, const Reg* in) const
+        {
+            Reg result = Ops::Zero();
+            for (unsigned int i = 0; i < Fields; i++)
+            {
+                if (Used[output][i])
+                {
+                    result = Ops::PermuteInto(result, in[i], Indices[output][i], Masks[output][i]);
+                }
+            }
+            return result;
+        }
+    };
+};
 
+#if defined(AVX2_AVAILABLE)
+struct RecordShuffleOps256
+{
+    static constexpr unsigned int Lanes = 8;
+    typedef __m256i Reg;
+    typedef __m256i Mask;
+    static _SIMD_INL_ Reg Zero() { return _mm256_setzero_si256(); }
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm256_loadu_si256((const __m256i*)from); }
+    static _SIMD_INL_ void Store(void* to, Reg v) { _mm256_storeu_si256((__m256i*)to, v); }
+    static _SIMD_INL_ Reg Indices(const int32_t* indices) { return _mm256_loadu_si256((const __m256i*)indices); }
+    static _SIMD_INL_ Mask Select(const bool* lanes)
+    {
+        int32_t mask[Lanes];
+        for (unsigned int i = 0; i < Lanes; i++) mask[i] = lanes[i] ? -1 : 0;
+        return _mm256_loadu_si256((const __m256i*)mask);
+    }
+    static _SIMD_INL_ Reg PermuteInto(Reg to, Reg v, Reg indices, Mask mask) { return _mm256_blendv_epi8(to, _mm256_permutevar8x32_epi32(v, indices), mask); }
+};
+template<> struct RecordShuffle<256, 4> : RecordShuffleKernel<RecordShuffleOps256, 4> {};
+template<> struct RecordShuffle<256, 8> : RecordShuffleKernel<RecordShuffleOps256, 8> {};
+#endif
 #if defined(AVX512F_AVAILABLE)
-    #define SIMD_USE_TYPE_INT_512 1
-    #define SIMD_USE_TYPE_FLOAT_512 1
-    #define SIMD_USE_TYPE_DOUBLE_512 1
+struct RecordShuffleOps512
+{
+    static constexpr unsigned int Lanes = 16;
+    typedef __m512i Reg;
+    typedef __mmask16 Mask;
+    static _SIMD_INL_ Reg Zero() { return _mm512_setzero_si512(); }
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm512_loadu_si512(from); }
+    static _SIMD_INL_ void Store(void* to, Reg v) { _mm512_storeu_si512(to, v); }
+    static _SIMD_INL_ Reg Indices(const int32_t* indices) { return _mm512_loadu_si512(indices); }
+    static _SIMD_INL_ Mask Select(const bool* lanes)
+    {
+        unsigned int mask = 0;
+        for (unsigned int i = 0; i < Lanes; i++) mask |= lanes[i] ? 1u << i : 0u;
+        return static_cast<Mask>(mask);
+    }
+    static _SIMD_INL_ Reg PermuteInto(Reg to, Reg v, Reg indices, Mask mask) { return _mm512_mask_permutexvar_epi32(to, mask, indices, v); }
+};
+template<> struct RecordShuffle<512, 4> : RecordShuffleKernel<RecordShuffleOps512, 4> {};
+template<> struct RecordShuffle<512, 8> : RecordShuffleKernel<RecordShuffleOps512, 8> {};
+#endif
 
-    CREATE_INT128_OPERATOR_MULTIPLY(64);
-    CREATE_INT256_OPERATOR_MULTIPLY(64);
+/* columns[f][j] = records[j * fields + f] for count records, with the permutes of registers of type T */
+template<typename T>
+void RecordsToColumns(typename T::ElementType* const* columns, const typename T::ElementType* records, unsigned int fields, size_t count)
+{
+    RecordShuffle<T::BitWidth, sizeof(typename T::ElementType)>::ToColumns(columns, records, fields, count);
+}
 
-    CREATE_INT512_OPERATOR_PLUS(32);
-    CREATE_INT512_OPERATOR_PLUS(64);
-    
-    CREATE_INT512_OPERATOR_MINUS(32);
-    CREATE_INT512_OPERATOR_MINUS(64);
+/* records[j * fields + f] = columns[f][j] for count records, with the permutes of registers of type T */
+template<typename T>
+void ColumnsToRecords(typename T::ElementType* records, const typename T::ElementType* const* columns, unsigned int fields, size_t count)
+{
+    RecordShuffle<T::BitWidth, sizeof(typename T::ElementType)>::ToRecords(records, columns, fields, count);
+}
 
-    CREATE_INT512_OPERATOR_MULTIPLY(32);
-    CREATE_INT512_OPERATOR_MULTIPLY(64);
+// Structure of arrays of Fields columns, column f holds field f of every record. Columns are ordinary Arrays and take
+// part in Array expressions and operators. Load and Store convert from and to interleaved records, e.g. xyz positions
+// or OHLC ticks, with RecordsToColumns and ColumnsToRecords. Naming the fields with an enum keeps the code readable:
+// enum { X, Y, Z }; positions.Get<Z>() -= positions.Get<Y>();
+template<typename T, unsigned int Fields, unsigned int Length, typename Allocator = AlignedMemory::SystemAllocator>
+class StructOfArrays
+{
+    static_assert(Fields > 0, "A structure of arrays needs at least one field.");
+public:
+    typedef Array<T, Length, Allocator> Column;
+    static constexpr size_t Records = static_cast<size_t>(Length) * T::ElementCount;
 
-    CREATE_FLOAT_OPERATOR_PLUS(512);
-    CREATE_FLOAT_OPERATOR_MINUS(512);
-    CREATE_FLOAT_OPERATOR_MULTIPLY(512);
-    CREATE_FLOAT_OPERATOR_DIVIDE(512);
+    _SIMD_INL_ Column& operator[](unsigned int field)
+    {
+        return Columns[field];
+    }
+    _SIMD_INL_ const Column& operator[](unsigned int field) const
+    {
+        return Columns[field];
+    }
 
-    CREATE_FLOAT_OPERATOR_EQUAL(512);
-    
-    CREATE_DOUBLE_OPERATOR_PLUS(512);
-    CREATE_DOUBLE_OPERATOR_MINUS(512);
-    CREATE_DOUBLE_OPERATOR_MULTIPLY(512);
-    CREATE_DOUBLE_OPERATOR_DIVIDE(512);
+    template<unsigned int Field>
+    _SIMD_INL_ Column& Get()
+    {
+        static_assert(Field < Fields, "The field index is out of range.");
+        return Columns[Field];
+    }
+    template<unsigned int Field>
+    _SIMD_INL_ const Column& Get() const
+    {
+        static_assert(Field < Fields, "The field index is out of range.");
+        return Columns[Field];
+    }
 
-    CREATE_DOUBLE_OPERATOR_EQUAL(512);
+    /* Reads 'count' records of Fields elements each, the remaining records keep their values */
+    void Load(const typename T::ElementType* records, size_t count = Records)
+    {
+        CheckCount(count);
+        typename T::ElementType* columns[Fields];
+        for (unsigned int f = 0; f < Fields; f++)
+        {
+            columns[f] = Columns[f][0];
+        }
+        RecordsToColumns<T>(columns, records, Fields, count);
+    }
 
-    #if defined(SVML_COMPATIBLE_COMPILER)
-        CREATE_INT512_OPERATOR_DIVIDE(8);
-        CREATE_INT512_OPERATOR_DIVIDE(16);
-        CREATE_INT512_OPERATOR_DIVIDE(32);
-        CREATE_INT512_OPERATOR_DIVIDE(64);
-    #endif
-#endif
+    /* Writes the first 'count' records */
+    void Store(typename T::ElementType* records, size_t count = Records) const
+    {
+        CheckCount(count);
+        const typename T::ElementType* columns[Fields];
+        for (unsigned int f = 0; f < Fields; f++)
+        {
+            columns[f] = Columns[f][0];
+        }
+        ColumnsToRecords<T>(records, columns, Fields, count);
+    }
 
-#if defined(SIMD_USE_TYPE_INT_512)
-    DECLARE_SIMD_USE_TYPE_INT(int, 512);
-#endif
+private:
+    static void CheckCount(size_t count)
+    {
+        if (count > Records)
+        {
+            throw std::runtime_error("The record count exceeds the capacity of the structure of arrays.");
+        }
+    }
 
-#if defined(SIMD_USE_TYPE_FLOAT_512)
-    DECLARE_SIMD_USE_TYPE_FLOATING(float, 512);
-#endif
+    std::array<Column, Fields> Columns;
+};
 
-#if defined(SIMD_USE_TYPE_DOUBLE_512)
-    DECLARE_SIMD_USE_TYPE_FLOATING(double, 512);
-#endif
-    
-//SIMD::int_XXX checks are not ideal...
+// Blocking of MatMul for register type T. The micro kernel keeps an MR x NR tile of C in MR * 2 registers, NR being
+// two registers. A KC x NR sliver of packed B stays in L1, an MC x KC block of packed A in L2 and a KC x NC panel of
+// packed B in L3. AVX-512 has 32 registers and takes 8 rows, 256 bit registers take 6 (12 accumulators, 2 B loads
+// and the broadcast A element fill 15 of 16). KC sizes the B sliver to 16 KiB, half of a 32 KiB L1 so the A
+// elements and the C tile fit next to it: 256 for 256 bit registers and 128 for 512 bit ones.
 template<typename T>
-using IsSIMDType = typename std::enable_if<
-#if defined(SSE2_AVAILABLE) || defined(AVX_AVAILABLE) || defined(AVX2_AVAILABLE) || defined(AVX512F_AVAILABLE)
-    (std::is_same<int, typename T::Type>::value && (T::BitWidth == 128) && IsElementAnyOfInts<typename T::ElementType>::value) || ( std::is_same<int, typename T::Type>::value && (T::BitWidth == 256) && IsElementAnyOfInts<typename T::ElementType>::value) ||
+struct MatMulBlocking
+{
+    static constexpr size_t MR = T::BitWidth == 512 ? 8 : 6;
+    static constexpr size_t NR = 2 * T::ElementCount;
+    static constexpr size_t KC = 16 * 1024 / (NR * sizeof(typename T::ElementType));
+    static constexpr size_t MC = MR * (sizeof(typename T::ElementType) == 4 ? 24 : 12);
+    static constexpr size_t NC = NR * (sizeof(typename T::ElementType) == 4 ? 256 : 128);
+};
+template<typename T> constexpr size_t MatMulBlocking<T>::MR;
+template<typename T> constexpr size_t MatMulBlocking<T>::NR;
+template<typename T> constexpr size_t MatMulBlocking<T>::KC;
+template<typename T> constexpr size_t MatMulBlocking<T>::MC;
+template<typename T> constexpr size_t MatMulBlocking<T>::NC;
+
+// Register operations of the MatMul micro kernel. The SIMD types round trip their lanes through memory on every
+// operation, which the compiler does not remove for a 12 to 16 register accumulator tile, so the micro kernel works on
+// the raw registers. The generic version goes through T for widths the build has no instructions for.
+template<typename T>
+struct MatMulOps
+{
+    typedef T Reg;
+    typedef typename T::ElementType E;
+    static _SIMD_INL_ Reg Zero() { return T(); }
+    static _SIMD_INL_ Reg Load(const E* from) { return T::Load(from); }
+    static _SIMD_INL_ Reg LoadUnaligned(const E* from) { return T::LoadUnaligned(from); }
+    static _SIMD_INL_ void StoreUnaligned(E* to, const Reg& v) { v.StoreUnaligned(to); }
+    static _SIMD_INL_ Reg Broadcast(E value) { return T::Broadcast(value); }
+    static _SIMD_INL_ Reg Add(const Reg& a, const Reg& b) { return T::Add(a, b); }
+    static _SIMD_INL_ Reg MultiplyAdd(const Reg& a, const Reg& b, const Reg& acc) { return ArrayMultiplyAccumulate<T>::Apply(a, b, acc); }
+};
+
+#define CREATE_MATMUL_OPS(TYPE, E, REG, PFX, SFX, MULTIPLY_ADD) \
+template<> \
+struct MatMulOps<TYPE> \
+{ \
+    typedef REG Reg; \
+    static _SIMD_INL_ Reg Zero() { return _mm##PFX##_setzero_##SFX(); } \
+    static _SIMD_INL_ Reg Load(const E* from) { return _mm##PFX##_load_##SFX(from); } \
+    static _SIMD_INL_ Reg LoadUnaligned(const E* from) { return _mm##PFX##_loadu_##SFX(from); } \
+    static _SIMD_INL_ void StoreUnaligned(E* to, Reg v) { _mm##PFX##_storeu_##SFX(to, v); } \
+    static _SIMD_INL_ Reg Broadcast(E value) { return _mm##PFX##_set1_##SFX(value); } \
+    static _SIMD_INL_ Reg Add(Reg a, Reg b) { return _mm##PFX##_add_##SFX(a, b); } \
+    static _SIMD_INL_ Reg MultiplyAdd(Reg a, Reg b, Reg acc) { return MULTIPLY_ADD; } \
+};
+
+#if defined(AVX_AVAILABLE)
+#if defined(FMA_AVAILABLE)
+    CREATE_MATMUL_OPS(float_256, float, __m256, 256, ps, _mm256_fmadd_ps(a, b, acc))
+    CREATE_MATMUL_OPS(double_256, double, __m256d, 256, pd, _mm256_fmadd_pd(a, b, acc))
+#else
+    CREATE_MATMUL_OPS(float_256, float, __m256, 256, ps, _mm256_add_ps(_mm256_mul_ps(a, b), acc))
+    CREATE_MATMUL_OPS(double_256, double, __m256d, 256, pd, _mm256_add_pd(_mm256_mul_pd(a, b), acc))
 #endif
-#if defined(AVX_AVAILABLE) || defined(AVX2_AVAILABLE) || defined(AVX512F_AVAILABLE)
-    std::is_same<T, SIMD::float_256>::value || std::is_same<T, SIMD::double_256>::value ||
 #endif
 #if defined(AVX512F_AVAILABLE)
-    ( std::is_same<int, typename T::Type>::value && (T::BitWidth == 512) && IsElementAnyOfInts<typename T::ElementType>::value) || std::is_same<T, SIMD::float_512>::value || std::is_same<T, SIMD::double_512>::value ||
+    CREATE_MATMUL_OPS(float_512, float, __m512, 512, ps, _mm512_fmadd_ps(a, b, acc))
+    CREATE_MATMUL_OPS(double_512, double, __m512d, 512, pd, _mm512_fmadd_pd(a, b, acc))
 #endif
-    std::is_same<int,float>::value, //dummy
-    int>::type;
 
-namespace BASIC_SIMD_NAMESPACE
-{
-template<typename T, unsigned int _Length, IsSIMDType<T> = 0>
-class Array
+// MatMul building blocks, row major with leading dimensions in elements
+template<typename T>
+struct MatMulKernel
 {
-public:
-    Array() : Data(nullptr)
+    typedef typename T::ElementType E;
+    typedef MatMulBlocking<T> Blocking;
+    static constexpr size_t MR = Blocking::MR;
+    static constexpr size_t NR = Blocking::NR;
+
+    /* Copies B[0..kc)[0..nc) into slivers of NR columns, each kc x NR and contiguous, zero padding the last one */
+    static void PackB(E* packed, const E* B, size_t ldb, size_t kc, size_t nc)
     {
-        AlignedData = std::move(AlignedMemory::make_aligned<typename T::ElementType>(T::SizeBytes * Length, T::Alignment));
-        Data = static_cast<typename T::ElementType*>(AlignedData.get());
+        for (size_t j = 0; j < nc; j += NR)
+        {
+            const size_t columns = std::min(NR, nc - j);
+            for (size_t p = 0; p < kc; p++)
+            {
+                const E* from = B + p * ldb + j;
+                std::copy(from, from + columns, packed);
+                std::fill(packed + columns, packed + NR, E(0));
+                packed += NR;
+            }
+        }
     }
-    
-    Array(const Array& other) : Data(nullptr)
+
+    /* Copies A[0..mc)[0..kc) into slivers of MR rows stored column by column, zero padding the last one */
+    static void PackA(E* packed, const E* A, size_t lda, size_t mc, size_t kc)
     {
-        AlignedData = std::move(AlignedMemory::make_aligned<typename T::ElementType>(T::SizeBytes * Length, T::Alignment));
-        Data = static_cast<typename T::ElementType*>(AlignedData.get());
-        memcpy((void*)Data, (void*)other.Data, T::SizeBytes * Length);
+        for (size_t i = 0; i < mc; i += MR)
+        {
+            const size_t rows = std::min(MR, mc - i);
+            for (size_t p = 0; p < kc; p++)
+            {
+                for (size_t r = 0; r < rows; r++)
+                {
+                    packed[r] = A[(i + r) * lda + p];
+                }
+                std::fill(packed + rows, packed + MR, E(0));
+                packed += MR;
+            }
+        }
     }
 
-    Array(Array&& other) noexcept : Data(other.Data)
+    /* C[0..rows)[0..columns) (+)= packed A sliver * packed B sliver, 'add' keeps the previous C */
+    static _SIMD_INL_ void Micro(const E* a, const E* b, size_t kc, E* C, size_t ldc, size_t rows, size_t columns, bool add)
     {
-        other.Data = nullptr;
+        typedef MatMulOps<T> Ops;
+        typename Ops::Reg acc[MR][2];
+        for (size_t r = 0; r < MR; r++)
+        {
+            acc[r][0] = Ops::Zero();
+            acc[r][1] = Ops::Zero();
+        }
+        for (size_t p = 0; p < kc; p++)
+        {
+            const typename Ops::Reg b0 = Ops::Load(b);
+            const typename Ops::Reg b1 = Ops::Load(b + T::ElementCount);
+            for (size_t r = 0; r < MR; r++)
+            {
+                const typename Ops::Reg ar = Ops::Broadcast(a[r]);
+                acc[r][0] = Ops::MultiplyAdd(ar, b0, acc[r][0]);
+                acc[r][1] = Ops::MultiplyAdd(ar, b1, acc[r][1]);
+            }
+            a += MR;
+            b += NR;
+        }
+        if (rows == MR && columns == NR)
+        {
+            for (size_t r = 0; r < MR; r++)
+            {
+                E* row = C + r * ldc;
+                if (add)
+                {
+                    acc[r][0] = Ops::Add(acc[r][0], Ops::LoadUnaligned(row));
+                    acc[r][1] = Ops::Add(acc[r][1], Ops::LoadUnaligned(row + T::ElementCount));
+                }
+                Ops::StoreUnaligned(row, acc[r][0]);
+                Ops::StoreUnaligned(row + T::ElementCount, acc[r][1]);
+            }
+            return;
+        }
+        // Edge tiles go through a full tile on the stack. All MR rows are stored so that the accumulators are only
+        // indexed by constants, a runtime row count would keep a copy of them in memory during the k loop.
+        alignas(T::Alignment) E tile[MR][NR];
+        for (size_t r = 0; r < MR; r++)
+        {
+            Ops::StoreUnaligned(tile[r], acc[r][0]);
+            Ops::StoreUnaligned(tile[r] + T::ElementCount, acc[r][1]);
+        }
+        for (size_t r = 0; r < rows; r++)
+        {
+            E* row = C + r * ldc;
+            for (size_t c = 0; c < columns; c++)
+            {
+                row[c] = add ? row[c] + tile[r][c] : tile[r][c];
+            }
+        }
     }
-    Array& operator=(Array&& other)
+
+    /* C[0..mc)[0..nc) (+)= A block * B panel, both packed */
+    static void Block(const E* packedA, const E* packedB, size_t mc, size_t nc, size_t kc, E* C, size_t ldc, bool add)
     {
-        if (this != &other)
+        for (size_t j = 0; j < nc; j += NR)
         {
-            Data = other.Data;
-            other.Data = nullptr;
+            for (size_t i = 0; i < mc; i += MR)
+            {
+                Micro(packedA + i * kc, packedB + j * kc, kc, C + i * ldc + j, ldc, std::min(MR, mc - i), std::min(NR, nc - j), add);
+            }
         }
-        return *this;
     }
+};
+template<typename T> constexpr size_t MatMulKernel<T>::MR;
+template<typename T> constexpr size_t MatMulKernel<T>::NR;
 
-    Array& operator=(const Array& other)
+// C = A * B, or C += A * B with accumulate, for row major M x K A, K x N B and M x N C with leading dimensions lda,
+// ldb and ldc. T selects the register type (float_256, float_512, double_256 or double_512). Blocks of MC rows of
+// C are split across the Parallel pool once C is larger than the parallel threshold, every thread packs its own A.
+// The slivers of each B panel are packed in parallel as well before the row blocks start.
+template<typename T>
+void MatMul(const typename T::ElementType* A, const typename T::ElementType* B, typename T::ElementType* C,
+            size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc, bool accumulate = false)
+{
+    static_assert(std::is_floating_point<typename T::ElementType>::value, "MatMul is implemented for float and double registers.");
+    typedef typename T::ElementType E;
+    typedef MatMulKernel<T> Kernel;
+    typedef MatMulBlocking<T> Blocking;
+    if (M == 0 || N == 0)
     {
-        memcpy((void*)Data, (void*)other.Data, T::SizeBytes * Length);
-        return *this;
+        return;
+    }
+    if (K == 0)
+    {
+        for (size_t i = 0; !accumulate && i < M; i++)
+        {
+            std::fill(C + i * ldc, C + i * ldc + N, E(0));
+        }
+        return;
+    }
+    const size_t rowBlocks = (M + Blocking::MC - 1) / Blocking::MC;
+    const unsigned int threads = Parallel::Settings::GetThreadCount();
+    const bool parallel = threads > 1 && !Parallel::ThreadPool::InTask() && M * N * sizeof(E) >= Parallel::Settings::GetThreshold();
+    const unsigned int tasks = parallel ? static_cast<unsigned int>(std::min<size_t>(threads, rowBlocks)) : 1u;
+    const size_t panelWidth = std::min(Blocking::NC, (N + Blocking::NR - 1) / Blocking::NR * Blocking::NR);
+    AlignedMemory::AlignedPtr<E> packedB = AlignedMemory::make_aligned<E>(Blocking::KC * panelWidth, T::Alignment);
+    AlignedMemory::AlignedPtr<E> packedA = AlignedMemory::make_aligned<E>(Blocking::MC * Blocking::KC * tasks, T::Alignment);
+    for (size_t jc = 0; jc < N; jc += Blocking::NC)
+    {
+        const size_t nc = std::min(Blocking::NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += Blocking::KC)
+        {
+            const size_t kc = std::min(Blocking::KC, K - pc);
+            const bool add = accumulate || pc > 0;
+            const size_t slivers = (nc + Blocking::NR - 1) / Blocking::NR;
+            const unsigned int packTasks = parallel ? static_cast<unsigned int>(std::min<size_t>(threads, slivers)) : 1u;
+            auto pack = [&](unsigned int task)
+            {
+                for (size_t sliver = task * slivers / packTasks; sliver < (task + 1) * slivers / packTasks; sliver++)
+                {
+                    const size_t j = sliver * Blocking::NR;
+                    Kernel::PackB(packedB.get() + j * kc, B + pc * ldb + jc + j, ldb, kc, std::min(Blocking::NR, nc - j));
+                }
+            };
+            if (packTasks > 1)
+            {
+                Parallel::Settings::Pool()->Run(packTasks, pack);
+            }
+            else
+            {
+                pack(0);
+            }
+            auto rows = [&](unsigned int task)
+            {
+                E* packed = packedA.get() + task * Blocking::MC * Blocking::KC;
+                for (size_t block = task; block < rowBlocks; block += tasks)
+                {
+                    const size_t ic = block * Blocking::MC;
+                    const size_t mc = std::min(Blocking::MC, M - ic);
+                    Kernel::PackA(packed, A + ic * lda + pc, lda, mc, kc);
+                    Kernel::Block(packed, packedB.get(), mc, nc, kc, C + ic * ldc + jc, ldc, add);
+                }
+            };
+            if (tasks > 1)
+            {
+                Parallel::Settings::Pool()->Run(tasks, rows);
+            }
+            else
+            {
+                rows(0);
+            }
+        }
     }
+}
 
-    //Add + and - operators
-    _SIMD_INL_ friend void operator+=(Array& lhs, const Array& rhs)
+/* Dense operands, lda = K, ldb = N and ldc = N */
+template<typename T>
+void MatMul(const typename T::ElementType* A, const typename T::ElementType* B, typename T::ElementType* C, size_t M, size_t N, size_t K)
+{
+    MatMul<T>(A, B, C, M, N, K, K, N, N);
+}
+
+// Transpose of an N x N tile, N being the number of ElementBytes elements in a Bits wide register. Row r is read from
+// from + r * fromStride and column r is written to to + r * toStride, strides in bytes, from == to transposes in place.
+// The generic version transposes a copy of the tile as four quadrants of half the width, and 128 bit tiles element by
+// element.
+template<int Bits, size_t ElementBytes>
+struct TransposeKernel
+{
+    static constexpr unsigned int N = static_cast<unsigned int>(Bits / 8 / ElementBytes);
+    static void Apply(const void* from, size_t fromStride, void* to, size_t toStride)
     {
-        for (unsigned int i = 0; i < Length; i++)
+        typedef TransposeKernel<Bits / 2, ElementBytes> Half;
+        const size_t rowBytes = Bits / 8;
+        alignas(64) unsigned char tile[N][Bits / 8];
+        for (unsigned int r = 0; r < N; r++)
         {
-            T::AddInplaceRaw(lhs.Data + i*T::ElementCount, rhs.Data + i*T::ElementCount);
+            memcpy(tile[r], static_cast<const unsigned char*>(from) + r * fromStride, rowBytes);
+        }
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            for (unsigned int j = 0; j < 2; j++)
+            {
+                Half::Apply(&tile[i * N / 2][j * rowBytes / 2], rowBytes,
+                            static_cast<unsigned char*>(to) + j * (N / 2) * toStride + i * rowBytes / 2, toStride);
+            }
         }
     }
+};
 
-    _SIMD_INL_ friend void operator-=(Array& lhs, const Array& rhs)
+template<size_t ElementBytes>
+struct TransposeKernel<128, ElementBytes>
+{
+    static constexpr unsigned int N = static_cast<unsigned int>(16 / ElementBytes);
+    static void Apply(const void* from, size_t fromStride, void* to, size_t toStride)
     {
-        for (unsigned int i = 0; i < Length; i++)
+        unsigned char tile[N][16];
+        for (unsigned int r = 0; r < N; r++)
+        {
+            memcpy(tile[r], static_cast<const unsigned char*>(from) + r * fromStride, 16);
+        }
+        for (unsigned int r = 0; r < N; r++)
         {
-            T::SubtractInplaceRaw(lhs.Data + i*T::ElementCount, rhs.Data + i*T::ElementCount);            
+            for (unsigned int c = 0; c < N; c++)
+            {
+                memcpy(static_cast<unsigned char*>(to) + c * toStride + r * ElementBytes, &tile[r][c * ElementBytes], ElementBytes);
+            }
         }
     }
+};
 
-    _SIMD_INL_ friend void operator*=(Array& lhs, const Array& rhs)
+// In register transpose: log2(N) rounds of interleaving register pairs. Inside the 128 bit chunks, the unpacks of
+// elements, then of pairs, quads and so on build the transposed chunks, the rounds of Ops::Chunks move whole chunks
+// between the registers of 256 and 512 bit tiles. Register k then holds column k with the bits of k below the chunk
+// rounds reversed, which is corrected by the row it is stored to.
+template<typename Ops, size_t ElementBytes>
+struct TransposeNetwork
+{
+    static constexpr unsigned int N = static_cast<unsigned int>(Ops::Bytes / ElementBytes);
+    /* log2 of the elements in a chunk, the number of unpack rounds */
+    static constexpr unsigned int ChunkBits = ElementBytes == 1 ? 4 : ElementBytes == 2 ? 3 : ElementBytes == 4 ? 2 : 1;
+    typedef typename Ops::Reg Reg;
+
+    static constexpr unsigned int Reverse(unsigned int k, unsigned int bits) { return bits == 0 ? 0 : ((k & 1u) << (bits - 1)) | Reverse(k >> 1, bits - 1); }
+    static constexpr unsigned int Row(unsigned int k) { return (k >> ChunkBits << ChunkBits) | Reverse(k & ((1u << ChunkBits) - 1), ChunkBits); }
+
+    static _SIMD_INL_ void Apply(const void* from, size_t fromStride, void* to, size_t toStride)
     {
-        for (unsigned int i = 0; i < Length; i++)
+        Reg r[N], next[N];
+        for (unsigned int k = 0; k < N; k++)
+        {
+            r[k] = Ops::Load(static_cast<const unsigned char*>(from) + k * fromStride);
+        }
+        for (size_t width = ElementBytes; width < 16; width *= 2)
+        {
+            for (unsigned int j = 0; j < N / 2; j++)
+            {
+                Ops::Unpack(r[2 * j], r[2 * j + 1], width, next[j], next[j + N / 2]);
+            }
+            for (unsigned int k = 0; k < N; k++)
+            {
+                r[k] = next[k];
+            }
+        }
+        for (unsigned int round = 0; round < Ops::ChunkRounds; round++)
+        {
+            for (unsigned int j = 0; j < N / 2; j++)
+            {
+                Ops::Chunks(r[2 * j], r[2 * j + 1], next[j], next[j + N / 2]);
+            }
+            for (unsigned int k = 0; k < N; k++)
+            {
+                r[k] = next[k];
+            }
+        }
+        for (unsigned int k = 0; k < N; k++)
         {
-            T::MultiplyInplaceRaw(lhs.Data + i*T::ElementCount, rhs.Data + i*T::ElementCount);
+            Ops::Store(static_cast<unsigned char*>(to) + Row(k) * toStride, r[k]);
         }
     }
+};
 
-    _SIMD_INL_ friend void operator/=(Array& lhs, const Array& rhs)
+#if defined(SSE2_AVAILABLE)
+struct TransposeOps128
+{
+    static constexpr size_t Bytes = 16;
+    static constexpr unsigned int ChunkRounds = 0;
+    typedef __m128i Reg;
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm_loadu_si128((const __m128i*)from); }
+    static _SIMD_INL_ void Store(void* to, Reg v) { _mm_storeu_si128((__m128i*)to, v); }
+    static _SIMD_INL_ void Unpack(Reg a, Reg b, size_t width, Reg& low, Reg& high)
     {
-        for (unsigned int i = 0; i < Length; i++)
+        switch (width)
+        {
+        case 1: low = _mm_unpacklo_epi8(a, b); high = _mm_unpackhi_epi8(a, b); break;
+        case 2: low = _mm_unpacklo_epi16(a, b); high = _mm_unpackhi_epi16(a, b); break;
+        case 4: low = _mm_unpacklo_epi32(a, b); high = _mm_unpackhi_epi32(a, b); break;
+        default: low = _mm_unpacklo_epi64(a, b); high = _mm_unpackhi_epi64(a, b); break;
+        }
+    }
+    static _SIMD_INL_ void Chunks(Reg a, Reg b, Reg& low, Reg& high) { low = a; high = b; }
+};
+template<> struct TransposeKernel<128, 1> : TransposeNetwork<TransposeOps128, 1> {};
+template<> struct TransposeKernel<128, 2> : TransposeNetwork<TransposeOps128, 2> {};
+template<> struct TransposeKernel<128, 4> : TransposeNetwork<TransposeOps128, 4> {};
+template<> struct TransposeKernel<128, 8> : TransposeNetwork<TransposeOps128, 8> {};
+#endif
+#if defined(AVX2_AVAILABLE)
+struct TransposeOps256
+{
+    static constexpr size_t Bytes = 32;
+    static constexpr unsigned int ChunkRounds = 1;
+    typedef __m256i Reg;
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm256_loadu_si256((const __m256i*)from); }
+    static _SIMD_INL_ void Store(void* to, Reg v) { _mm256_storeu_si256((__m256i*)to, v); }
+    static _SIMD_INL_ void Unpack(Reg a, Reg b, size_t width, Reg& low, Reg& high)
+    {
+        switch (width)
+        {
+        case 1: low = _mm256_unpacklo_epi8(a, b); high = _mm256_unpackhi_epi8(a, b); break;
+        case 2: low = _mm256_unpacklo_epi16(a, b); high = _mm256_unpackhi_epi16(a, b); break;
+        case 4: low = _mm256_unpacklo_epi32(a, b); high = _mm256_unpackhi_epi32(a, b); break;
+        default: low = _mm256_unpacklo_epi64(a, b); high = _mm256_unpackhi_epi64(a, b); break;
+        }
+    }
+    static _SIMD_INL_ void Chunks(Reg a, Reg b, Reg& low, Reg& high)
+    {
+        low = _mm256_permute2x128_si256(a, b, 0x20);
+        high = _mm256_permute2x128_si256(a, b, 0x31);
+    }
+};
+// 8 bit tiles are 32 x 32, more registers than AVX2 has, and go through four 16 x 16 tiles
+template<> struct TransposeKernel<256, 2> : TransposeNetwork<TransposeOps256, 2> {};
+template<> struct TransposeKernel<256, 4> : TransposeNetwork<TransposeOps256, 4> {};
+template<> struct TransposeKernel<256, 8> : TransposeNetwork<TransposeOps256, 8> {};
+#endif
+#if defined(AVX512F_AVAILABLE)
+// Same GCC 12 false positive as in Horizontal, for the undefined passthrough of the unmasked unpacks and shuffles
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+struct TransposeOps512
+{
+    static constexpr size_t Bytes = 64;
+    static constexpr unsigned int ChunkRounds = 2;
+    typedef __m512i Reg;
+    static _SIMD_INL_ Reg Load(const void* from) { return _mm512_loadu_si512(from); }
+    static _SIMD_INL_ void Store(void* to, Reg v) { _mm512_storeu_si512(to, v); }
+    static _SIMD_INL_ void Unpack(Reg a, Reg b, size_t width, Reg& low, Reg& high)
+    {
+        if (width == 4)
+        {
+            low = _mm512_unpacklo_epi32(a, b);
+            high = _mm512_unpackhi_epi32(a, b);
+        }
+        else
         {
-            T::DivideInplaceRaw(lhs.Data + i*T::ElementCount, rhs.Data + i*T::ElementCount);
+            low = _mm512_unpacklo_epi64(a, b);
+            high = _mm512_unpackhi_epi64(a, b);
         }
     }
+    /* Even and odd chunks, two rounds of them interleave the chunks of four registers */
+    static _SIMD_INL_ void Chunks(Reg a, Reg b, Reg& low, Reg& high)
+    {
+        low = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        high = _mm512_shuffle_i64x2(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+};
+// 8 and 16 bit tiles would need 64 and 32 registers and go through quadrants
+template<> struct TransposeKernel<512, 4> : TransposeNetwork<TransposeOps512, 4> {};
+template<> struct TransposeKernel<512, 8> : TransposeNetwork<TransposeOps512, 8> {};
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+#endif
 
-    _SIMD_INL_ typename T::ElementType* operator[](unsigned int index)
+/* Transposes the N x N tile held by N = T::ElementCount registers, rows[k] becomes column k */
+template<typename T>
+_SIMD_INL_ void Transpose(T* rows)
+{
+    TransposeKernel<T::BitWidth, sizeof(typename T::ElementType)>::Apply(rows, sizeof(T), rows, sizeof(T));
+}
+
+// to = transpose of the row major rows x columns matrix 'from', with leading dimensions in elements. The matrices must
+// not overlap. The walk uses the 128 bit tile transpose whatever the width of T: a wider tile writes its N destination
+// rows N elements apart, and once the rows are more than a page apart (1000 x 1000 doubles) the extra lines and TLB
+// entries per block cost more than the wider loads save. N x N tiles are visited in blocks of 4 tile columns by 2 KiB
+// of rows, going down the rows first, so every destination row is written in 2 KiB runs and the source lines of a block
+// are reused from cache by its next tile columns. Rows and columns past the last whole tile are copied element by
+// element.
+template<typename T>
+void Transpose(const typename T::ElementType* from, size_t rows, size_t columns, size_t ldFrom, typename T::ElementType* to, size_t ldTo)
+{
+    typedef typename T::ElementType E;
+    typedef TransposeKernel<128, sizeof(E)> Kernel;
+    const size_t N = 16 / sizeof(E);
+    const size_t BlockRows = std::max<size_t>(N, 2048 / sizeof(E));
+    const size_t BlockColumns = 4 * N;
+    const size_t tileRows = rows / N * N;
+    const size_t tileColumns = columns / N * N;
+    for (size_t ib = 0; ib < tileRows; ib += BlockRows)
     {
-        return Data + index*T::ElementCount;
+        const size_t iEnd = std::min(ib + BlockRows, tileRows);
+        for (size_t jb = 0; jb < tileColumns; jb += BlockColumns)
+        {
+            const size_t jEnd = std::min(jb + BlockColumns, tileColumns);
+            for (size_t j = jb; j < jEnd; j += N)
+            {
+                for (size_t i = ib; i < iEnd; i += N)
+                {
+                    Kernel::Apply(from + i * ldFrom + j, ldFrom * sizeof(E), to + j * ldTo + i, ldTo * sizeof(E));
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < rows; i++)
+    {
+        for (size_t j = i < tileRows ? tileColumns : 0; j < columns; j++)
+        {
+            to[j * ldTo + i] = from[i * ldFrom + j];
+        }
     }
+}
 
-    static constexpr unsigned int Length = _Length;
-private:
-    typename T::ElementType* Data;
-    AlignedMemory::AlignedPtr<typename T::ElementType> AlignedData;
-    
-};
+/* Dense matrices, ldFrom = columns and ldTo = rows */
+template<typename T>
+void Transpose(const typename T::ElementType* from, size_t rows, size_t columns, typename T::ElementType* to)
+{
+    Transpose<T>(from, rows, columns, columns, to, rows);
+}
+
+/* The rows x columns matrix stored in 'from' into 'to', both dense */
+template<typename T, unsigned int FromLength, typename FromAllocator, unsigned int ToLength, typename ToAllocator>
+void Transpose(const Array<T, FromLength, FromAllocator>& from, Array<T, ToLength, ToAllocator>& to, size_t rows, size_t columns)
+{
+    const size_t capacity = static_cast<size_t>(std::min(FromLength, ToLength)) * T::ElementCount;
+    if (rows * columns > capacity)
+    {
+        throw std::runtime_error("The matrix does not fit in the array.");
+    }
+    if (static_cast<const void*>(to[0]) == static_cast<const void*>(from[0]))
+    {
+        throw std::runtime_error("An array cannot be transposed into itself.");
+    }
+    Transpose<T>(from[0], rows, columns, to[0]);
+}
 }
 
 #undef _SIMD_INL_
+#undef _SIMD_ASSUME_ALIGNED_
 #undef GENERATE_SIMD
 #undef INTERNAL_SIMD_TYPE_NAME
 #undef CREATE_INT128_OPERATOR_PLUS
@@ -1724,4 +8808,94 @@ private:
 #undef CREATE_DOUBLE_OPERATOR_MINUS
 #undef CREATE_DOUBLE_OPERATOR_MULTIPLY
 #undef CREATE_DOUBLE_OPERATOR_DIVIDE
+#undef CREATE_FLOAT_OPERATOR_FMA
+#undef CREATE_FLOAT_OPERATOR_REDUCE
+#undef CREATE_DOUBLE_OPERATOR_REDUCE
+#undef CREATE_INT128_OPERATOR_REDUCE
+#undef CREATE_INT256_OPERATOR_REDUCE
+#undef CREATE_INT512_OPERATOR_REDUCE
+#undef CREATE_INT_REDUCE_KERNEL
+#undef CREATE_INT_OPERATOR_REDUCE_ORDER
+#undef CREATE_INT_OPERATOR_REDUCE_PRODUCT
+#undef CREATE_DOUBLE_OPERATOR_FMA
+#undef CREATE_INT_OPERATOR_PORTABLE_DIVIDE
+#undef CREATE_LANES_AVERAGE_ABSDIFF
+#undef CREATE_INT_BINARY_KERNEL
+#undef CREATE_INT_OPERATOR_SATURATE
+#undef CREATE_LANES_SHIFT
+#undef CREATE_LANES_SHIFT_ARITHMETIC
+#undef CREATE_LANES_SHIFT8
+#undef CREATE_INT_NOT_KERNEL
+#undef CREATE_INT_OPERATOR_BITWISE
+#undef CREATE_INT_SHIFT_KERNEL
+#undef CREATE_INT_OPERATOR_SHIFT
+#undef CREATE_INT_OPERATOR_SHIFT_LANES
+#undef CREATE_LANES_PACK
+#undef CREATE_INT_WIDEN_KERNEL
+#undef CREATE_INT_OPERATOR_WIDEN
+#undef CREATE_INT_NARROW_KERNEL
+#undef CREATE_INT_OPERATOR_NARROW
+#undef CREATE_FLOATING_OPERATOR_CONVERT
+#undef CREATE_MASKED_BINARY_KERNEL
+#undef CREATE_MASKED_MEMORY_KERNEL
+#undef CREATE_MASKED_COMPRESS_KERNEL
+#undef CREATE_INT512_OPERATOR_MASKED
+#undef CREATE_INT512_OPERATOR_MASKED_MULTIPLY
+#undef CREATE_INT512_OPERATOR_COMPRESS
+#undef CREATE_FLOATING512_OPERATOR_MASKED
+#undef CREATE_INT_MASKED_MEMORY_KERNEL
+#undef CREATE_INT_OPERATOR_MASKED_MEMORY
+#undef CREATE_FLOATING_MASKED_MEMORY_KERNEL
+#undef CREATE_MASKED_PERMUTE_KERNEL
+#undef CREATE_DIVIDER_KERNELS
+#undef CREATE_INT128_COMPARE
+#undef CREATE_INT128_ORDER
+#undef CREATE_INT128_OPERATOR_COMPARE
+#undef CREATE_INT128_OPERATOR_ORDER
+#undef CREATE_INT256_COMPARE
+#undef CREATE_INT256_ORDER
+#undef CREATE_INT256_OPERATOR_COMPARE
+#undef CREATE_INT256_OPERATOR_ORDER
+#undef CREATE_INT512_COMPARE
+#undef CREATE_INT512_OPERATOR_COMPARE
+#undef CREATE_FLOAT_COMPARE_256
+#undef CREATE_FLOAT_COMPARE_512
+#undef CREATE_FLOAT_OPERATOR_COMPARE
+#undef CREATE_DOUBLE_COMPARE_256
+#undef CREATE_DOUBLE_COMPARE_512
+#undef CREATE_DOUBLE_OPERATOR_COMPARE
+#undef CREATE_MATH_OPS_ARITHMETIC
+#undef CREATE_MATH_OPS_BITS
+#undef CREATE_MATH_OPS_256
+#undef CREATE_MATH_OPS_512
+#undef FUSED_OR_SEPARATE_256
+#undef CREATE_MATH_FUNCTION
+#undef CREATE_MATH_TRIG_FUNCTION
+#undef CREATE_FLOATING_OPERATOR_MATH
+#undef CREATE_FLOAT_OPERATOR_MATH
+#undef CREATE_DOUBLE_OPERATOR_MATH
+#undef CREATE_ARRAY_EXPRESSION_OPERATOR
+#undef CREATE_ARRAY_COMPARE_EXPRESSION
+#undef CREATE_ARRAY_MATH_EXPRESSION
+#undef CREATE_ARRAY_BINARY_FUNCTION
+#undef CREATE_MATMUL_OPS
+#undef CREATE_DISPATCH_FLOATING_OPS
+#undef CREATE_DISPATCH_OPS
+#undef CREATE_DISPATCH_LOOP
+#undef CREATE_DISPATCH_KERNEL
+#undef CREATE_DISPATCH_KERNELS
+#undef CREATE_DISPATCH_MULTIPLY_ADD_LOOP
+#undef CREATE_DISPATCH_MULTIPLY_ADD_KERNELS
+#undef CREATE_DISPATCH_ENTRY
+#undef CREATE_DISPATCH_MULTIPLY_ADD_ENTRY
+#undef _SIMD_BEGIN_TARGET_SSE2_
+#undef _SIMD_BEGIN_TARGET_AVX2_
+#undef _SIMD_BEGIN_TARGET_AVX2_FMA_
+#undef _SIMD_BEGIN_TARGET_AVX512_
+#undef _SIMD_END_TARGET_
+
+#ifdef _WIN32
+#pragma pop_macro("max")
+#pragma pop_macro("min")
+#endif
 
@@ -5,6 +5,11 @@
 #include <cmath>
 #include <random>
 #include <memory>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
 
 static const uint32_t TEST_ARRAY_SIZE = 10000;
 
@@ -109,6 +114,39 @@ TEST(SIMDTest, SIMD_TYPE##WIDTH##_##OP_NAME) \
     } \
 }
 
+// Macro for runtime dispatch tests, runs the kernel on every instruction set level the CPU supports
+// with an element count that is not a multiple of any register width so the scalar tail is covered too
+#define TEST_SIMD_DISPATCH_OPERATION(ELEMENT_TYPE, OPERATION, OP_NAME, VALUE_RANGE) \
+TEST(SIMDDispatchTest, ELEMENT_TYPE##_##OP_NAME) \
+{ \
+    const InstructionSet levels[] = { InstructionSet::NONE, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 }; \
+    for (InstructionSet level : levels) \
+    { \
+        if (SIMD::Dispatch::Dispatcher::Set(level) != level) \
+        { \
+            continue; \
+        } \
+        std::vector<ELEMENT_TYPE> simd_array(1003); \
+        std::vector<ELEMENT_TYPE> simd_array_2(1003); \
+        std::vector<ELEMENT_TYPE> plain_array(1003); \
+        std::mt19937 rng(42); \
+        std::uniform_int_distribution<int> dist(1, VALUE_RANGE); \
+        for (size_t i = 0; i < simd_array.size(); i++) \
+        { \
+            simd_array[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            simd_array_2[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            plain_array[i] = simd_array[i]; \
+            plain_array[i] OPERATION simd_array_2[i]; \
+        } \
+        SIMD::Dispatch::OP_NAME(simd_array.data(), simd_array_2.data(), simd_array.size()); \
+        for (size_t i = 0; i < simd_array.size(); i++) \
+        { \
+            EXPECT_EQ(simd_array[i], plain_array[i]) << "level " << static_cast<int>(level) << " index " << i; \
+        } \
+    } \
+    SIMD::Dispatch::Dispatcher::Reset(); \
+}
+
 // Benchmark macros to reduce boilerplate code in benchmark functions
 #define BENCHMARK_SIMD_FLOAT_OPERATION(SIMD_TYPE, WIDTH, OPERATION, OP_NAME, ARRAY_SIZE) \
 static void BM_SIMD_##SIMD_TYPE##WIDTH##_##OP_NAME##_##ARRAY_SIZE(benchmark::State& state) { \
@@ -265,22 +303,111 @@ BENCHMARK(BM_Plain_##SIMD_TYPE##WIDTH##_with_int8_t_##OP_NAME##_##ARRAY_SIZE)->U
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 128, +=, Addition, 1000)
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 128, -=, Subtraction, 1000)
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 128, *=, Multiplication, 50)
-#if defined(SVML_COMPATIBLE_COMPILER)
-    TEST_SIMD_INTEGER_OPERATION(int, int32_t, 128, /=, DivisionSVML_Only, 50)
-#endif
+TEST_SIMD_INTEGER_OPERATION(int, int32_t, 128, /=, Division, 50)
 // Integer tests - Int256
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 256, +=, Addition, 1000)
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 256, -=, Subtraction, 1000)
 TEST_SIMD_INTEGER_OPERATION(int, int32_t, 256, *=, Multiplication, 50)
-#if defined(SVML_COMPATIBLE_COMPILER)
-    TEST_SIMD_INTEGER_OPERATION(int, int32_t, 256, /=, DivisionSVML_Only, 50)
-#endif
+TEST_SIMD_INTEGER_OPERATION(int, int32_t, 256, /=, Division, 50)
 // Float tests - Float256
 TEST_SIMD_FLOAT_OPERATION(float, 256, +=, Addition)
 TEST_SIMD_FLOAT_OPERATION(float, 256, -=, Subtraction)
 TEST_SIMD_FLOAT_OPERATION(float, 256, *=, Multiplication)
 TEST_SIMD_FLOAT_OPERATION(float, 256, /=, Division)
 
+// Runtime dispatch tests
+TEST_SIMD_DISPATCH_OPERATION(int8_t, +=, Add, 100)
+TEST_SIMD_DISPATCH_OPERATION(int8_t, -=, Subtract, 100)
+TEST_SIMD_DISPATCH_OPERATION(int8_t, *=, Multiply, 100)
+TEST_SIMD_DISPATCH_OPERATION(uint16_t, +=, Add, 1000)
+TEST_SIMD_DISPATCH_OPERATION(uint16_t, *=, Multiply, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int32_t, +=, Add, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int32_t, -=, Subtract, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int32_t, *=, Multiply, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int64_t, +=, Add, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int64_t, *=, Multiply, 100000)
+TEST_SIMD_DISPATCH_OPERATION(float, *=, Multiply, 1000)
+TEST_SIMD_DISPATCH_OPERATION(float, /=, Divide, 1000)
+TEST_SIMD_DISPATCH_OPERATION(double, -=, Subtract, 1000)
+TEST_SIMD_DISPATCH_OPERATION(double, /=, Divide, 1000)
+TEST_SIMD_DISPATCH_OPERATION(int8_t, /=, Divide, 100)
+TEST_SIMD_DISPATCH_OPERATION(uint16_t, /=, Divide, 60000)
+TEST_SIMD_DISPATCH_OPERATION(int32_t, /=, Divide, 1000000)
+TEST_SIMD_DISPATCH_OPERATION(uint32_t, /=, Divide, 2000000000)
+TEST_SIMD_DISPATCH_OPERATION(int64_t, /=, Divide, 1000000)
+
+TEST(SIMDDispatchTest, Set_Clamps_To_Detected_Level) {
+    InstructionSet detected = SIMD::Dispatch::Dispatcher::Detect();
+    EXPECT_EQ(SIMD::Dispatch::Dispatcher::Set(InstructionSet::AVX512), detected);
+    EXPECT_EQ(SIMD::Dispatch::Dispatcher::Set(InstructionSet::NONE), InstructionSet::NONE);
+    EXPECT_EQ(SIMD::Dispatch::Dispatcher::Reset(), detected);
+    EXPECT_EQ(SIMD::Dispatch::Dispatcher::Get(), detected);
+}
+
+// Small integers are exact with and without FMA, so every level has to match the plain loop
+#define TEST_SIMD_DISPATCH_MULTIPLY_ADD(ELEMENT_TYPE) \
+TEST(SIMDDispatchTest, ELEMENT_TYPE##_MultiplyAdd_And_Axpy) \
+{ \
+    const InstructionSet levels[] = { InstructionSet::NONE, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 }; \
+    for (InstructionSet level : levels) \
+    { \
+        if (SIMD::Dispatch::Dispatcher::Set(level) != level) \
+        { \
+            continue; \
+        } \
+        std::vector<ELEMENT_TYPE> a(1003), b(1003), c(1003), to(1003), y(1003); \
+        std::mt19937 rng(42); \
+        std::uniform_int_distribution<int> dist(-1000, 1000); \
+        for (size_t i = 0; i < a.size(); i++) \
+        { \
+            a[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            b[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            c[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            y[i] = c[i]; \
+        } \
+        SIMD::Dispatch::MultiplyAdd(to.data(), a.data(), b.data(), c.data(), to.size()); \
+        SIMD::Dispatch::Axpy(ELEMENT_TYPE(3), a.data(), y.data(), y.size()); \
+        for (size_t i = 0; i < a.size(); i++) \
+        { \
+            EXPECT_EQ(to[i], a[i] * b[i] + c[i]) << "level " << static_cast<int>(level) << " index " << i; \
+            EXPECT_EQ(y[i], 3 * a[i] + c[i]) << "level " << static_cast<int>(level) << " index " << i; \
+        } \
+    } \
+    SIMD::Dispatch::Dispatcher::Reset(); \
+}
+
+TEST_SIMD_DISPATCH_MULTIPLY_ADD(float)
+TEST_SIMD_DISPATCH_MULTIPLY_ADD(double)
+
+TEST(SIMDDispatchTest, MultiplyAdd_Fuses_With_FMA) {
+    // (1 + 2^-12)^2 needs 25 significant bits, a separate multiply rounds the 2^-24 away before the add
+    const float a = 1.0f + std::ldexp(1.0f, -12);
+    const float c = -(1.0f + std::ldexp(1.0f, -11));
+    const InstructionSet levels[] = { InstructionSet::NONE, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 };
+    for (InstructionSet level : levels)
+    {
+        if (SIMD::Dispatch::Dispatcher::Set(level) != level)
+        {
+            continue;
+        }
+        const bool fused = level == InstructionSet::AVX512 || (level == InstructionSet::AVX2 && CPUFeatures::hasFMA());
+#if defined(FMA_AVAILABLE)
+        // The compiler may contract the separate multiply and add of the lower levels itself
+        if (!fused)
+        {
+            continue;
+        }
+#endif
+        std::vector<float> as(37, a), cs(37, c), to(37);
+        SIMD::Dispatch::MultiplyAdd(to.data(), as.data(), as.data(), cs.data(), to.size());
+        for (float value : to)
+        {
+            EXPECT_EQ(value, fused ? std::ldexp(1.0f, -24) : 0.0f) << "level " << static_cast<int>(level);
+        }
+    }
+    SIMD::Dispatch::Dispatcher::Reset();
+}
+
 // Define benchmarks using the macros
 // Float benchmarks
 REGISTER_FLOAT_BENCHMARKS(float, 256, +=, Addition, 100000)
@@ -319,63 +446,2981 @@ REGISTER_INT_BENCHMARKS(int, int16_t, 256, *=, Multiplication, 100000, 50)
 REGISTER_INT8_BENCHMARKS(int, 256, +=, Addition, 100000)
 REGISTER_INT8_BENCHMARKS(int, 256, -=, Subtraction, 100000)
 
-TEST(SIMDTest, SIMD_int256_with_int32_t_Operators_and_Import) {
-    SIMD::int_256<int32_t> a(1,2,3,4,5,6,7,8);
-    SIMD::int_256<int32_t> b(-1, -1, -1, -1, -1, -1, -1, -1);
+// Macro for runtime sized vector tests, the size leaves a partial register at the end
+#define TEST_SIMD_VECTOR_OPERATION(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE, OPERATION, OP_NAME, VALUE_RANGE) \
+TEST(SIMDVectorTest, TYPE_NAME##_##OP_NAME) \
+{ \
+    const size_t size = 1000 * SIMD::SIMD_TYPE::ElementCount + SIMD::SIMD_TYPE::ElementCount / 2 + 1; \
+    SIMD::Vector<SIMD::SIMD_TYPE> simd_vector(size); \
+    SIMD::Vector<SIMD::SIMD_TYPE> simd_vector_2(size); \
+    std::vector<ELEMENT_TYPE> plain_array(size); \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int> dist(1, VALUE_RANGE); \
+    for (size_t i = 0; i < size; i++) \
+    { \
+        simd_vector[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+        simd_vector_2[i] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+        plain_array[i] = simd_vector[i]; \
+        plain_array[i] OPERATION simd_vector_2[i]; \
+    } \
+    simd_vector OPERATION simd_vector_2; \
+    for (size_t i = 0; i < size; i++) \
+    { \
+        EXPECT_EQ(simd_vector[i], plain_array[i]) << "index " << i; \
+    } \
+}
 
-    SIMD::int_256<int32_t> c = a + b;
-    for (int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
-        EXPECT_EQ(c[i], i);
+TEST_SIMD_VECTOR_OPERATION(int128_with_int16_t, int_128<int16_t>, int16_t, +=, Addition, 1000)
+TEST_SIMD_VECTOR_OPERATION(int256_with_int32_t, int_256<int32_t>, int32_t, -=, Subtraction, 1000)
+TEST_SIMD_VECTOR_OPERATION(int256_with_int32_t, int_256<int32_t>, int32_t, *=, Multiplication, 1000)
+TEST_SIMD_VECTOR_OPERATION(int256_with_int32_t, int_256<int32_t>, int32_t, /=, Division, 1000)
+TEST_SIMD_VECTOR_OPERATION(float256, float_256, float, *=, Multiplication, 1000)
+TEST_SIMD_VECTOR_OPERATION(double256, double_256, double, /=, Division, 1000)
+
+// INT_MIN / -1 wraps in every lane, whether it falls in a whole register or in the partial one at the end
+TEST(SIMDVectorTest, Division_Wraps_In_Tail) {
+    SIMD::Vector<SIMD::int_256<int32_t> > a(19), b(19);
+    for (size_t i = 0; i < a.Size(); i++) {
+        a[i] = std::numeric_limits<int32_t>::min();
+        b[i] = -1;
     }
+    a /= b;
+    for (size_t i = 0; i < a.Size(); i++) {
+        EXPECT_EQ(a[i], std::numeric_limits<int32_t>::min()) << "index " << i;
+    }
+}
 
-    SIMD::int_256<int32_t> d = a - b;
-    for(int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
-        EXPECT_EQ(d[i], i + 2);
+TEST(SIMDVectorTest, Growth_Keeps_Alignment_And_Values) {
+    SIMD::Vector<SIMD::float_256> v;
+    EXPECT_TRUE(v.Empty());
+    for (int i = 0; i < 1001; i++) {
+        v.PushBack(static_cast<float>(i));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(v.Data()) % SIMD::float_256::Alignment, 0u);
     }
+    EXPECT_EQ(v.Size(), 1001u);
+    EXPECT_EQ(v.Capacity() % SIMD::float_256::ElementCount, 0u);
 
-    SIMD::int_256<int32_t> e = a * b;
-    for(int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
-        EXPECT_EQ(e[i], -i - 1);
+    SIMD::Vector<SIMD::float_256> copy = v;
+    copy += v;
+    for (int i = 0; i < 1001; i++) {
+        EXPECT_FLOAT_EQ(copy[i], 2.0f * i);
+        EXPECT_FLOAT_EQ(v[i], static_cast<float>(i));
     }
 
-    alignas(SIMD::int_256<int32_t>::Alignment) int32_t data[SIMD::int_256<int32_t>::ElementCount] = { 1, 2, 3, 4, 5, 6, 7, 8 };
-    SIMD::int_256<int32_t> f = SIMD::int_256<int32_t>::Import(data);
-    EXPECT_TRUE(f == a);
+    v.Resize(3);
+    EXPECT_THROW(v += copy, std::runtime_error);
+}
 
-    a += b;
-    EXPECT_TRUE(a == c);
+TEST(SIMDExpressionTest, float256_Fused_Expression) {
+    SIMD::Array<SIMD::float_256, 1000> a, b, c, d, e;
+    std::vector<float> plain(1000 * SIMD::float_256::ElementCount);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(1.0f, 2.0f);
+    for (int i = 0; i < 1000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            a[i][j] = dist(rng);
+            b[i][j] = dist(rng);
+            c[i][j] = dist(rng);
+            d[i][j] = dist(rng);
+            e[i][j] = dist(rng);
+            plain[i * SIMD::float_256::ElementCount + j] = ((a[i][j] * b[i][j] + c[i][j]) - d[i][j]) / e[i][j];
+        }
+    }
+
+    SIMD::Array<SIMD::float_256, 1000> result = (a * b + c - d) / e;
+    // Aliasing the destination is fine since every register only depends on the same register of the operands
+    a = (a * b + c - d) / e;
+    for (int i = 0; i < 1000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            EXPECT_FLOAT_EQ(result[i][j], plain[i * SIMD::float_256::ElementCount + j]);
+            EXPECT_FLOAT_EQ(a[i][j], plain[i * SIMD::float_256::ElementCount + j]);
+        }
+    }
 }
 
-TEST(SIMDTest, SIMD_float256_Operators_and_Import) {
+TEST(SIMDExpressionTest, int256_with_int32_t_Compound_Expression) {
+    SIMD::Array<SIMD::int_256<int32_t>, 100> a, b, c;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) {
+            a[i][j] = i;
+            b[i][j] = j;
+            c[i][j] = i + j;
+        }
+    }
+    a += b * c - b;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) {
+            EXPECT_EQ(a[i][j], i + j * (i + j) - j);
+        }
+    }
+}
+
+// Expression benchmarks, the fused form streams every array once while the chained form makes one pass per operator
+#define BENCHMARK_EXPRESSION_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::float_256, ARRAY_SIZE> a, b, c, d, e; \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) { \
+            b[i][j] = 1.0f; c[i][j] = 2.0f; d[i][j] = 3.0f; e[i][j] = 4.0f; \
+        } \
+    }
+
+static void BM_SIMD_float256_FusedExpression_1000000(benchmark::State& state) {
+    BENCHMARK_EXPRESSION_SETUP(1000000)
+    for (auto _ : state) {
+        a = b * c + d - e;
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_SIMD_float256_FusedExpression_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_float256_ChainedExpression_1000000(benchmark::State& state) {
+    BENCHMARK_EXPRESSION_SETUP(1000000)
+    for (auto _ : state) {
+        a = b;
+        a *= c;
+        a += d;
+        a -= e;
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_SIMD_float256_ChainedExpression_1000000)->Unit(benchmark::kMillisecond);
+
+#if defined(FMA_AVAILABLE)
+TEST(SIMDFusedMultiplyAddTest, float256_Single_Rounding) {
     SIMD::float_256 a(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
-    SIMD::float_256 b(5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f);
+    SIMD::float_256 b = SIMD::float_256::Broadcast(1.0f + 1.0f / 4096.0f);
+    SIMD::float_256 c = SIMD::float_256::Broadcast(-1.0f);
 
-    SIMD::float_256 c = a + b;
+    SIMD::float_256 fma = SIMD::float_256::FusedMultiplyAdd(a, b, c);
+    SIMD::float_256 fms = SIMD::float_256::FusedMultiplySubtract(a, b, c);
     for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
-        EXPECT_FLOAT_EQ(c[i], i + 6.0f);
+        EXPECT_EQ(fma[i], std::fma(a[i], b[i], c[i]));
+        EXPECT_EQ(fms[i], std::fma(a[i], b[i], -c[i]));
     }
 
-    SIMD::float_256 d = a - b;
+    SIMD::float_256::FusedMultiplyAddInplace(a, b, c);
     for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
-        EXPECT_FLOAT_EQ(d[i], i - 4.0f);
+        EXPECT_EQ(a[i], fma[i]);
     }
+}
 
-    SIMD::float_256 e = a * b;
-    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
-        EXPECT_FLOAT_EQ(e[i], (i + 1.0f) * 5.0f);
+TEST(SIMDFusedMultiplyAddTest, double256_Array_Fma_and_Axpy) {
+    SIMD::Array<SIMD::double_256, 100> a, b, c, y;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::double_256::ElementCount; j++) {
+            a[i][j] = dist(rng);
+            b[i][j] = dist(rng);
+            c[i][j] = dist(rng);
+        }
     }
 
-    SIMD::float_256 f = a / b;
-    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
-        EXPECT_FLOAT_EQ(f[i], (i + 1.0f) / 5.0f);
+    SIMD::Array<SIMD::double_256, 100> result = SIMD::FusedMultiplyAdd(a, b, c);
+    y = c;
+    SIMD::Axpy(0.5, a, y);
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::double_256::ElementCount; j++) {
+            EXPECT_EQ(result[i][j], std::fma(a[i][j], b[i][j], c[i][j]));
+            EXPECT_EQ(y[i][j], std::fma(0.5, a[i][j], c[i][j]));
+        }
     }
+}
 
-    alignas(SIMD::float_256::Alignment) float data[SIMD::float_256::ElementCount] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
-    SIMD::float_256 g = SIMD::float_256::Import(data);
-    for(int i = 0; i < SIMD::float_256::ElementCount; i++) {
-        EXPECT_FLOAT_EQ(g[i], a[i]);
+// AXPY benchmarks, y = alpha * x + y as one fused instruction against a separate multiply and add
+static void BM_SIMD_float256_Axpy_1000000(benchmark::State& state) {
+    SIMD::Array<SIMD::float_256, 1000000> x, y;
+    for (int i = 0; i < 1000000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            x[i][j] = 1.0f; y[i][j] = 0.0f;
+        }
+    }
+    for (auto _ : state) {
+        SIMD::Axpy(0.5f, x, y);
+        benchmark::DoNotOptimize(y);
+    }
+}
+BENCHMARK(BM_SIMD_float256_Axpy_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_float256_Axpy_1000000(benchmark::State& state) {
+    std::vector<float> x(1000000 * SIMD::float_256::ElementCount, 1.0f);
+    std::vector<float> y(1000000 * SIMD::float_256::ElementCount, 0.0f);
+    for (auto _ : state) {
+        for (size_t i = 0; i < x.size(); i++) {
+            y[i] += 0.5f * x[i];
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(BM_Plain_float256_Axpy_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_Dispatch_float_Axpy_8000000(benchmark::State& state) {
+    std::vector<float> x(8000000, 1.0f);
+    std::vector<float> y(8000000, 0.0f);
+    for (auto _ : state) {
+        SIMD::Dispatch::Axpy(0.5f, x.data(), y.data(), y.size());
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(BM_SIMD_Dispatch_float_Axpy_8000000)->Unit(benchmark::kMillisecond);
+#endif
+
+// Integer division has no instruction, the dispatched kernel divides through double lanes from the AVX2 level on
+static void BM_SIMD_Dispatch_int32_Divide_1000000(benchmark::State& state) {
+    std::vector<int32_t> a(1000000, 1000000007), b(1000000, 97), to(1000000);
+    for (auto _ : state) {
+        SIMD::Dispatch::Divide(to.data(), a.data(), b.data(), to.size());
+        benchmark::DoNotOptimize(to.data());
+    }
+}
+BENCHMARK(BM_SIMD_Dispatch_int32_Divide_1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Plain_int32_Divide_1000000(benchmark::State& state) {
+    std::vector<int32_t> a(1000000, 1000000007), b(1000000, 97), to(1000000);
+    for (auto _ : state) {
+        for (size_t i = 0; i < to.size(); i++) {
+            to[i] = a[i] / b[i];
+        }
+        benchmark::DoNotOptimize(to.data());
+    }
+}
+BENCHMARK(BM_Plain_int32_Divide_1000000)->Unit(benchmark::kMicrosecond);
+
+// Horizontal reduction tests on full range lanes. Signed types are only used where the sum is widened,
+// wider signed sums could overflow and the unsigned ones wrap the same way the lanes do
+#define TEST_SIMD_REDUCE_SUM(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDReduceTest, TYPE_NAME##_ReduceSum) \
+{ \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<uint64_t> dist; \
+    for (int n = 0; n < 100; n++) { \
+        SIMD_TYPE a; \
+        SIMD_TYPE::ReduceType expected = 0; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            a[j] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            expected += a[j]; \
+        } \
+        EXPECT_EQ(SIMD_TYPE::ReduceSum(a), expected); \
+    } \
+}
+
+TEST_SIMD_REDUCE_SUM(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_REDUCE_SUM(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t)
+TEST_SIMD_REDUCE_SUM(int128_with_int16_t, SIMD::int_128<int16_t>, int16_t)
+TEST_SIMD_REDUCE_SUM(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_SUM(int128_with_uint32_t, SIMD::int_128<uint32_t>, uint32_t)
+TEST_SIMD_REDUCE_SUM(int128_with_uint64_t, SIMD::int_128<uint64_t>, uint64_t)
+TEST_SIMD_REDUCE_SUM(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_REDUCE_SUM(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_REDUCE_SUM(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_REDUCE_SUM(int256_with_uint16_t, SIMD::int_256<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_SUM(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+TEST_SIMD_REDUCE_SUM(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_REDUCE_SUM(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_REDUCE_SUM(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_SUM(int512_with_uint32_t, SIMD::int_512<uint32_t>, uint32_t)
+#endif
+
+// Horizontal min, max and product against the lane loops on full range lanes. The expected product is
+// taken in the unsigned ReduceType so it wraps the same way the 32 and 64 bit multiplies do
+#define TEST_SIMD_REDUCE_ORDER(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDReduceTest, TYPE_NAME##_ReduceMinMaxProduct) \
+{ \
+    using Unsigned = std::make_unsigned<SIMD_TYPE::ReduceType>::type; \
+    std::mt19937 rng(7); \
+    std::uniform_int_distribution<uint64_t> dist; \
+    for (int n = 0; n < 100; n++) { \
+        SIMD_TYPE a; \
+        ELEMENT_TYPE low = std::numeric_limits<ELEMENT_TYPE>::max(), high = std::numeric_limits<ELEMENT_TYPE>::min(); \
+        Unsigned product = 1; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            a[j] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+            low = std::min(low, a[j]); \
+            high = std::max(high, a[j]); \
+            product *= static_cast<Unsigned>(static_cast<SIMD_TYPE::ReduceType>(a[j])); \
+        } \
+        EXPECT_EQ(SIMD_TYPE::ReduceMin(a), low); \
+        EXPECT_EQ(SIMD_TYPE::ReduceMax(a), high); \
+        EXPECT_EQ(static_cast<Unsigned>(SIMD_TYPE::ReduceProduct(a)), product); \
+    } \
+}
+
+TEST_SIMD_REDUCE_ORDER(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_int16_t, SIMD::int_128<int16_t>, int16_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_int32_t, SIMD::int_128<int32_t>, int32_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_uint32_t, SIMD::int_128<uint32_t>, uint32_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_int64_t, SIMD::int_128<int64_t>, int64_t)
+TEST_SIMD_REDUCE_ORDER(int128_with_uint64_t, SIMD::int_128<uint64_t>, uint64_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_uint16_t, SIMD::int_256<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_int64_t, SIMD::int_256<int64_t>, int64_t)
+TEST_SIMD_REDUCE_ORDER(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_REDUCE_ORDER(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_uint8_t, SIMD::int_512<uint8_t>, uint8_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_int16_t, SIMD::int_512<int16_t>, int16_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_uint32_t, SIMD::int_512<uint32_t>, uint32_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_int64_t, SIMD::int_512<int64_t>, int64_t)
+TEST_SIMD_REDUCE_ORDER(int512_with_uint64_t, SIMD::int_512<uint64_t>, uint64_t)
+#endif
+
+TEST(SIMDReduceTest, float256_and_double256_Reductions) {
+    SIMD::float_256 a(3.0f, -1.0f, 4.0f, 1.0f, -5.0f, 9.0f, 2.0f, 6.0f);
+    EXPECT_FLOAT_EQ(SIMD::float_256::ReduceSum(a), 19.0f);
+    EXPECT_FLOAT_EQ(SIMD::float_256::ReduceProduct(a), 6480.0f);
+    EXPECT_FLOAT_EQ(SIMD::float_256::ReduceMin(a), -5.0f);
+    EXPECT_FLOAT_EQ(SIMD::float_256::ReduceMax(a), 9.0f);
+
+    SIMD::double_256 b(2.5, -7.0, 0.5, 3.0);
+    EXPECT_DOUBLE_EQ(SIMD::double_256::ReduceSum(b), -1.0);
+    EXPECT_DOUBLE_EQ(SIMD::double_256::ReduceProduct(b), -26.25);
+    EXPECT_DOUBLE_EQ(SIMD::double_256::ReduceMin(b), -7.0);
+    EXPECT_DOUBLE_EQ(SIMD::double_256::ReduceMax(b), 3.0);
+
+    SIMD::int_256<int16_t> c(5, -3, 7, 1, 0, 2, -9, 4, 8, 1, 1, 1, 1, 1, 1, 1);
+    EXPECT_EQ(SIMD::int_256<int16_t>::ReduceMin(c), -9);
+    EXPECT_EQ(SIMD::int_256<int16_t>::ReduceMax(c), 8);
+
+    SIMD::int_256<int8_t> low = SIMD::int_256<int8_t>::Broadcast(-128);
+    SIMD::int_128<uint16_t> high = SIMD::int_128<uint16_t>::Broadcast(65535);
+    EXPECT_EQ(SIMD::int_256<int8_t>::ReduceSum(low), -128 * 32);
+    EXPECT_EQ(SIMD::int_128<uint16_t>::ReduceSum(high), 65535u * 8);
+}
+
+TEST(SIMDReduceTest, Array_Sum_and_Dot) {
+    SIMD::Array<SIMD::float_256, 1001> a, b;
+    SIMD::Array<SIMD::int_256<int32_t>, 1001> c, d;
+    SIMD::Array<SIMD::int_256<int8_t>, 1001> e;
+    double plainSum = 0.0, plainDot = 0.0;
+    int32_t intSum = 0, intDot = 0, narrowSum = 0;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int i = 0; i < 1001; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            a[i][j] = dist(rng);
+            b[i][j] = dist(rng);
+            plainSum += a[i][j];
+            plainDot += static_cast<double>(a[i][j]) * b[i][j];
+            c[i][j] = i - j;
+            d[i][j] = j;
+            intSum += i - j;
+            intDot += (i - j) * j;
+        }
+        for (int j = 0; j < SIMD::int_256<int8_t>::ElementCount; j++) {
+            e[i][j] = 127;
+            narrowSum += 127;
+        }
+    }
+    EXPECT_NEAR(SIMD::Sum(a), plainSum, 1e-2);
+    EXPECT_NEAR(SIMD::Dot(a, b), plainDot, 1e-2);
+    EXPECT_NEAR(SIMD::Sum(a * b), plainDot, 1e-2);
+    EXPECT_EQ(SIMD::Sum(c), intSum);
+    EXPECT_EQ(SIMD::Dot(c, d), intDot);
+    EXPECT_EQ(SIMD::Sum(e), narrowSum);
+}
+
+// Reduction benchmarks on an L2 resident array, the plain loops are serialized on a single accumulator
+#define BENCHMARK_REDUCE_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::float_256, ARRAY_SIZE> a, b; \
+    std::vector<float> plain_a(ARRAY_SIZE * SIMD::float_256::ElementCount, 0.5f); \
+    std::vector<float> plain_b(ARRAY_SIZE * SIMD::float_256::ElementCount, 2.0f); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) { \
+            a[i][j] = 0.5f; b[i][j] = 2.0f; \
+        } \
+    }
+
+static void BM_SIMD_float256_Sum_10000(benchmark::State& state) {
+    BENCHMARK_REDUCE_SETUP(10000)
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SIMD::Sum(a));
+    }
+}
+BENCHMARK(BM_SIMD_float256_Sum_10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Plain_float256_Sum_10000(benchmark::State& state) {
+    BENCHMARK_REDUCE_SETUP(10000)
+    for (auto _ : state) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < plain_a.size(); i++) {
+            sum += plain_a[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_Plain_float256_Sum_10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_SIMD_float256_Dot_10000(benchmark::State& state) {
+    BENCHMARK_REDUCE_SETUP(10000)
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SIMD::Dot(a, b));
+    }
+}
+BENCHMARK(BM_SIMD_float256_Dot_10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Plain_float256_Dot_10000(benchmark::State& state) {
+    BENCHMARK_REDUCE_SETUP(10000)
+    for (auto _ : state) {
+        float dot = 0.0f;
+        for (size_t i = 0; i < plain_a.size(); i++) {
+            dot += plain_a[i] * plain_b[i];
+        }
+        benchmark::DoNotOptimize(dot);
+    }
+}
+BENCHMARK(BM_Plain_float256_Dot_10000)->Unit(benchmark::kMicrosecond);
+
+// Parallel tests force a zero threshold so even small buffers are split across the pool
+TEST(SIMDParallelTest, Chunks_Cover_Every_Element_Once) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(4);
+    SIMD::Parallel::Settings::SetThreshold(0);
+
+    // Odd counts and a start that is not on a cache line exercise the first and last chunk
+    std::vector<int32_t> to(100003, 1), from(100003, 2);
+    for (size_t offset = 0; offset < 3; offset++) {
+        for (size_t count : { size_t(1), size_t(17), size_t(1000), size_t(99999) }) {
+            std::fill(to.begin(), to.end(), 1);
+            SIMD::Dispatch::Add(to.data() + offset, from.data() + offset, count);
+            for (size_t i = 0; i < to.size(); i++) {
+                ASSERT_EQ(to[i], (i >= offset && i < offset + count) ? 3 : 1);
+            }
+        }
+    }
+
+    SIMD::Array<SIMD::float_256, 1001> a, b;
+    for (int i = 0; i < 1001; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            a[i][j] = static_cast<float>(i);
+            b[i][j] = static_cast<float>(j + 1);
+        }
+    }
+    a *= b;
+    a -= b;
+    a /= b;
+    for (int i = 0; i < 1001; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            EXPECT_FLOAT_EQ(a[i][j], (static_cast<float>(i) * (j + 1) - (j + 1)) / (j + 1));
+        }
+    }
+
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+TEST(SIMDParallelTest, Thread_Count_Knob) {
+    EXPECT_EQ(SIMD::Parallel::Settings::GetThreadCount(), 1u);
+    EXPECT_EQ(SIMD::Parallel::Settings::SetThreadCount(3), 3u);
+    EXPECT_EQ(SIMD::Parallel::Settings::Pool()->Threads(), 3u);
+    EXPECT_GE(SIMD::Parallel::Settings::SetThreadCount(0), 1u);
+    SIMD::Parallel::Settings::SetThreadCount(1);
+}
+
+// A For inside a parallel kernel runs inline on the thread of the outer chunk instead of waiting for the pool
+TEST(SIMDParallelTest, Nested_For_Runs_Inline) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(4);
+    SIMD::Parallel::Settings::SetThreshold(0);
+    std::vector<int32_t> outer(4096, 0), inner(4096 * 16, 0);
+    SIMD::Parallel::For(outer.data(), outer.size(), [&](size_t begin, size_t count) {
+        const std::thread::id owner = std::this_thread::get_id();
+        for (size_t i = begin; i < begin + count; i++) {
+            outer[i] = 1;
+        }
+        SIMD::Parallel::For(inner.data() + begin * 16, count * 16, [&](size_t b, size_t c) {
+            EXPECT_EQ(std::this_thread::get_id(), owner);
+            for (size_t i = 0; i < c; i++) {
+                inner[begin * 16 + b + i] += 1;
+            }
+        });
+    });
+    EXPECT_EQ(std::count(outer.begin(), outer.end(), 1), 4096);
+    EXPECT_EQ(std::count(inner.begin(), inner.end(), 1), 4096 * 16);
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+// A task that throws on any participant reaches the caller once every worker is done, and the pool stays usable
+TEST(SIMDParallelTest, Task_Exception_Reaches_Caller) {
+    SIMD::Parallel::ThreadPool pool(4);
+    std::atomic<unsigned int> ran(0);
+    auto throwing = [&](unsigned int index) {
+        ran++;
+        if (index % 4 == 1) throw std::runtime_error("task");
+    };
+    EXPECT_THROW(pool.Run(64, throwing), std::runtime_error);
+    // Task 1 is pinned to a worker thread
+    EXPECT_THROW(pool.RunPinned(64, throwing), std::runtime_error);
+    EXPECT_GT(ran.load(), 0u);
+    std::vector<int> hits(64, 0);
+    pool.Run(64, [&](unsigned int index) { hits[index]++; });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 64);
+}
+
+// Resizing the pool while another thread runs on it leaves the running pool alive until its Run returns
+TEST(SIMDParallelTest, Resize_During_Run) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(3);
+    SIMD::Parallel::Settings::SetThreshold(0);
+    std::vector<float> data(100000, 0.0f);
+    std::atomic<bool> done(false);
+    std::thread runner([&] {
+        for (int round = 0; round < 200; round++) {
+            SIMD::Parallel::For(data.data(), data.size(), [&](size_t begin, size_t count) {
+                for (size_t i = begin; i < begin + count; i++) data[i] += 1.0f;
+            });
+        }
+        done = true;
+    });
+    for (unsigned int threads = 2; !done; threads = threads == 2 ? 4 : 2) {
+        SIMD::Parallel::Settings::SetThreadCount(threads);
+    }
+    runner.join();
+    EXPECT_EQ(std::count(data.begin(), data.end(), 200.0f), 100000);
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+// Scaling benchmark, one run per thread count from 1 to the number of hardware threads
+static void BM_SIMD_float256_ParallelAdd_1000000(benchmark::State& state) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(static_cast<unsigned int>(state.range(0)));
+    SIMD::Parallel::Settings::SetThreshold(0);
+    SIMD::Array<SIMD::float_256, 1000000> a, b;
+    for (int i = 0; i < 1000000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            a[i][j] = 1.0f; b[i][j] = 2.0f;
+        }
+    }
+    for (auto _ : state) {
+        a += b;
+        benchmark::DoNotOptimize(a);
+    }
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+BENCHMARK(BM_SIMD_float256_ParallelAdd_1000000)->Unit(benchmark::kMillisecond)->UseRealTime()->ArgName("threads")
+    ->DenseRange(1, std::max(1u, std::thread::hardware_concurrency()));
+
+// First touch placement only helps if a chunk is computed by the thread that touched it, on a single node machine that
+// assignment is what can be checked
+TEST(SIMDParallelTest, Chunks_Stay_On_The_Same_Thread) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(4);
+    SIMD::Parallel::Settings::SetThreshold(0);
+    std::vector<float> data(100003);
+    std::mutex mutex;
+    std::vector<std::pair<size_t, std::thread::id> > first, second;
+    for (std::vector<std::pair<size_t, std::thread::id> >* owners : { &first, &second }) {
+        SIMD::Parallel::For(data.data() + 1, data.size() - 1, [&](size_t begin, size_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            owners->push_back(std::make_pair(begin, std::this_thread::get_id()));
+        });
+        std::sort(owners->begin(), owners->end(), [](const std::pair<size_t, std::thread::id>& a, const std::pair<size_t, std::thread::id>& b) { return a.first < b.first; });
+    }
+    // A start that is not on a cache line does not add a chunk, every thread gets exactly one
+    EXPECT_EQ(first.size(), 4u);
+    std::vector<std::thread::id> ids;
+    for (const std::pair<size_t, std::thread::id>& owner : first) ids.push_back(owner.second);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_TRUE(std::unique(ids.begin(), ids.end()) == ids.end());
+    EXPECT_TRUE(first == second);
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+TEST(SIMDParallelTest, Numa_Allocated_Arrays_Are_Zero_Filled) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(4);
+    SIMD::Parallel::Settings::SetThreshold(0);
+    {
+        SIMD::Array<SIMD::float_256, 100000, SIMD::Parallel::NumaAllocator<> > local;
+        SIMD::Array<SIMD::float_256, 100000, SIMD::Parallel::NumaAllocator<SIMD::Parallel::NumaPlacement::Interleave> > shared;
+        EXPECT_FLOAT_EQ(SIMD::Sum(local), 0.0f);
+        EXPECT_FLOAT_EQ(SIMD::Sum(shared), 0.0f);
+        for (unsigned int i = 0; i < 100000; i++) {
+            SIMD::float_256::Broadcast(2.0f).Store(shared[i]);
+        }
+        local = local + shared;
+        EXPECT_FLOAT_EQ(SIMD::Sum(local), 1600000.0f);
+    }
+    std::vector<double> plain(1001, 1.0);
+    SIMD::Parallel::FirstTouch(plain.data() + 1, 999);
+    EXPECT_EQ(plain[0], 1.0);
+    EXPECT_EQ(std::count(plain.begin(), plain.end(), 0.0), 999);
+    EXPECT_EQ(plain[1000], 1.0);
+#if !defined(__linux__)
+    EXPECT_FALSE(SIMD::Parallel::Interleave(plain.data(), plain.size() * sizeof(double)));
+#endif
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+TEST(SIMDParallelTest, Numa_Placement_Is_Reported) {
+    typedef SIMD::Parallel::NumaAllocator<SIMD::Parallel::NumaPlacement::Interleave> Interleaved;
+    typedef SIMD::Parallel::NumaAllocator<> Local;
+    // Whether mbind works here, probed on a block of its own
+    void* probe = AlignedMemory::HugePageAllocator::Allocate(Interleaved::MinimumBytes, 64);
+    const bool available = SIMD::Parallel::Interleave(probe, Interleaved::MinimumBytes);
+    AlignedMemory::HugePageAllocator::Deallocate(probe, Interleaved::MinimumBytes, 64);
+    {
+        SIMD::Array<SIMD::float_256, 16, Interleaved> small;
+        EXPECT_FALSE(Interleaved::Placed());
+        SIMD::Array<SIMD::float_256, 100000, Interleaved> large;
+        EXPECT_EQ(Interleaved::Placed(), available);
+        SIMD::Array<SIMD::float_256, 16, Local> local;
+        EXPECT_TRUE(Local::Placed());
+    }
+
+    // Allocations inside a parallel task are zero filled by the task's thread
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(4);
+    SIMD::Parallel::Settings::SetThreshold(0);
+    std::vector<float> sums(64, -1.0f);
+    SIMD::Parallel::For(sums.data(), sums.size(), [&](size_t begin, size_t count) {
+        for (size_t i = begin; i < begin + count; i++) {
+            SIMD::Array<SIMD::float_256, 1000, Local> scratch;
+            sums[i] = SIMD::Sum(scratch);
+        }
+    });
+    EXPECT_EQ(std::count(sums.begin(), sums.end(), 0.0f), 64);
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+
+#if defined(__linux__)
+    // Only the listed nodes are set, the mask size follows the highest of them
+    char path[] = "/tmp/simd_nodes_XXXXXX";
+    const int descriptor = mkstemp(path);
+    ASSERT_GE(descriptor, 0);
+    const char ranges[] = "0,2-3,70\n";
+    ASSERT_EQ(write(descriptor, ranges, sizeof(ranges) - 1), static_cast<ssize_t>(sizeof(ranges) - 1));
+    close(descriptor);
+    const SIMD::Parallel::NodeMask mask = SIMD::Parallel::NodeMask::Read(path);
+    unlink(path);
+    const size_t bitsPerLong = sizeof(unsigned long) * 8;
+    ASSERT_EQ(mask.Bits.size(), 70 / bitsPerLong + 1);
+    EXPECT_EQ(mask.Bits[0] & 0xFUL, 0xDUL);
+    EXPECT_EQ(mask.Bits[70 / bitsPerLong] >> (70 % bitsPerLong), 1UL);
+    EXPECT_EQ(mask.MaxNode, 71UL);
+    EXPECT_EQ(SIMD::Parallel::NodeMask::Read("/nonexistent").Bits, std::vector<unsigned long>(1, 1UL));
+    EXPECT_EQ(SIMD::Parallel::NodeMask::Possible().Bits[0] & 1UL, 1UL);
+#endif
+}
+
+// Allocation and initialization of a 32 MiB array, first touched by the pool or zero filled by one thread
+static void BM_SIMD_float256_NumaAllocate_1000000(benchmark::State& state) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(0);
+    for (auto _ : state) {
+        SIMD::Array<SIMD::float_256, 1000000, SIMD::Parallel::NumaAllocator<> > a;
+        benchmark::DoNotOptimize(a[0]);
+    }
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+BENCHMARK(BM_SIMD_float256_NumaAllocate_1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SIMD_float256_SerialAllocate_1000000(benchmark::State& state) {
+    for (auto _ : state) {
+        SIMD::Array<SIMD::float_256, 1000000, AlignedMemory::HugePageAllocator> a;
+        memset(a[0], 0, 1000000 * SIMD::float_256::SizeBytes);
+        benchmark::DoNotOptimize(a[0]);
+    }
+}
+BENCHMARK(BM_SIMD_float256_SerialAllocate_1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+TEST(SIMDStreamingTest, NonTemporal_Stores_Match_Temporal) {
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::NonTemporal);
+    const InstructionSet levels[] = { InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 };
+    for (InstructionSet level : levels) {
+        SIMD::Dispatch::Dispatcher::Set(level);
+        // Starting one element in forces the scalar head before the first aligned stream
+        std::vector<double> to(1003, 1.5), from(1003, 2.0);
+        std::vector<int16_t> ito(1003, 7), ifrom(1003, 3);
+        SIMD::Dispatch::Multiply(to.data() + 1, from.data() + 1, 1001);
+        SIMD::Dispatch::Subtract(ito.data() + 1, ifrom.data() + 1, 1001);
+        for (size_t i = 0; i < to.size(); i++) {
+            bool inside = i >= 1 && i < 1002;
+            EXPECT_DOUBLE_EQ(to[i], inside ? 3.0 : 1.5);
+            EXPECT_EQ(ito[i], inside ? 4 : 7);
+        }
+    }
+    SIMD::Dispatch::Dispatcher::Reset();
+
+    SIMD::Array<SIMD::float_256, 100> a, b, c;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            b[i][j] = static_cast<float>(i);
+            c[i][j] = static_cast<float>(j);
+        }
+    }
+    a = b * c + b;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            EXPECT_FLOAT_EQ(a[i][j], static_cast<float>(i) * j + i);
+        }
+    }
+
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::Auto);
+    EXPECT_FALSE(SIMD::Dispatch::Dispatcher::UseStreamingStores(4096));
+    EXPECT_TRUE(SIMD::Dispatch::Dispatcher::UseStreamingStores(CPUFeatures::lastLevelCacheSize() + 1));
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::Temporal);
+    EXPECT_FALSE(SIMD::Dispatch::Dispatcher::UseStreamingStores(CPUFeatures::lastLevelCacheSize() + 1));
+}
+
+// Store mode benchmarks on arrays larger than most last level caches, the destination is write only
+#define BENCHMARK_STORE_MODE(MODE, ARRAY_SIZE) \
+static void BM_SIMD_float256_##MODE##Store_##ARRAY_SIZE(benchmark::State& state) { \
+    SIMD::Array<SIMD::float_256, ARRAY_SIZE> a, b, c; \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) { \
+            a[i][j] = 0.0f; b[i][j] = 1.0f; c[i][j] = 2.0f; \
+        } \
+    } \
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::MODE); \
+    for (auto _ : state) { \
+        a = b + c; \
+        benchmark::DoNotOptimize(a); \
+    } \
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::Temporal); \
+    state.SetBytesProcessed(int64_t(state.iterations()) * 3 * ARRAY_SIZE * SIMD::float_256::SizeBytes); \
+} \
+BENCHMARK(BM_SIMD_float256_##MODE##Store_##ARRAY_SIZE)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_STORE_MODE(Temporal, 4000000)
+BENCHMARK_STORE_MODE(NonTemporal, 4000000)
+
+TEST(SIMDPrefetchTest, Results_Do_Not_Depend_On_Prefetch_Distance) {
+    const size_t distance = SIMD::Dispatch::Dispatcher::GetPrefetchDistance();
+    for (size_t ahead : { size_t(0), size_t(64), size_t(4096) }) {
+        SIMD::Dispatch::Dispatcher::SetPrefetchDistance(ahead);
+        // 1003 int8 lanes leave leftover registers and elements after the unrolled part
+        std::vector<int8_t> to(1003), from(1003);
+        for (int i = 0; i < 1003; i++) { to[i] = static_cast<int8_t>(i); from[i] = static_cast<int8_t>(3 * i); }
+        SIMD::Dispatch::Add(to.data(), from.data(), to.size());
+        for (int i = 0; i < 1003; i++) {
+            ASSERT_EQ(to[i], static_cast<int8_t>(4 * i));
+        }
+
+        SIMD::Array<SIMD::int_256<int16_t>, 999> a, b, c;
+        for (int i = 0; i < 999; i++) {
+            for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+                b[i][j] = static_cast<int16_t>(i + j);
+                c[i][j] = static_cast<int16_t>(j);
+            }
+        }
+        a = b * c + b - c;
+        for (int i = 0; i < 999; i++) {
+            for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+                ASSERT_EQ(a[i][j], static_cast<int16_t>((i + j) * j + (i + j) - j));
+            }
+        }
+    }
+    SIMD::Dispatch::Dispatcher::SetPrefetchDistance(distance);
+}
+
+// Prefetch benchmarks, narrow lanes on an array well beyond L2 with the default distance and with prefetching off
+#define BENCHMARK_PREFETCH(NAME, DISTANCE, ARRAY_SIZE) \
+static void BM_SIMD_int256_with_int8_t_##NAME##_##ARRAY_SIZE(benchmark::State& state) { \
+    SIMD::Array<SIMD::int_256<int8_t>, ARRAY_SIZE> a, b; \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::int_256<int8_t>::ElementCount; j++) { \
+            a[i][j] = 1; b[i][j] = 2; \
+        } \
+    } \
+    const size_t distance = SIMD::Dispatch::Dispatcher::GetPrefetchDistance(); \
+    SIMD::Dispatch::Dispatcher::SetPrefetchDistance(DISTANCE); \
+    for (auto _ : state) { \
+        a += b; \
+        benchmark::DoNotOptimize(a); \
+    } \
+    SIMD::Dispatch::Dispatcher::SetPrefetchDistance(distance); \
+} \
+BENCHMARK(BM_SIMD_int256_with_int8_t_##NAME##_##ARRAY_SIZE)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_PREFETCH(PrefetchedAddition, 1024, 1000000)
+BENCHMARK_PREFETCH(UnprefetchedAddition, 0, 1000000)
+
+// Vector division and Divider against scalar division, over the whole value range of the lanes.
+// 8 bit lanes are checked exhaustively, wider lanes with random dividends and divisors plus the edges.
+#define TEST_SIMD_DIVIDE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDDivideTest, TYPE_NAME##_Divide_and_Divider) \
+{ \
+    typedef std::numeric_limits<ELEMENT_TYPE> Limits; \
+    std::mt19937_64 rng(42); \
+    const bool exhaustive = sizeof(ELEMENT_TYPE) == 1; \
+    const int divisors = exhaustive ? 256 : 2000; \
+    for (int n = 0; n < divisors; n++) { \
+        ELEMENT_TYPE divisor = exhaustive ? static_cast<ELEMENT_TYPE>(n) : static_cast<ELEMENT_TYPE>(rng() >> (rng() % (sizeof(ELEMENT_TYPE) * 8))); \
+        if (n < 4) { \
+            const ELEMENT_TYPE edges[] = { Limits::min(), Limits::max(), static_cast<ELEMENT_TYPE>(-1), 1 }; \
+            divisor = edges[n]; \
+        } \
+        if (divisor == 0) { continue; } \
+        const SIMD::Divider<SIMD_TYPE> divider(divisor); \
+        const SIMD_TYPE divisors_ = SIMD_TYPE::Broadcast(divisor); \
+        for (int k = 0; k < (exhaustive ? 256 / SIMD_TYPE::ElementCount : 8); k++) { \
+            SIMD_TYPE dividend; \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                dividend.Data[j] = exhaustive ? static_cast<ELEMENT_TYPE>(k * SIMD_TYPE::ElementCount + j) : static_cast<ELEMENT_TYPE>(rng()); \
+            } \
+            if (k == 0) { \
+                /* 128 bit registers of 64 bit lanes only hold two of the edge dividends */ \
+                const ELEMENT_TYPE edges[] = { Limits::min(), Limits::max(), 0, static_cast<ELEMENT_TYPE>(-1) }; \
+                for (int j = 0; j < 4 && j < SIMD_TYPE::ElementCount; j++) { dividend.Data[j] = edges[j]; } \
+            } \
+            const SIMD_TYPE quotient = SIMD_TYPE::Divide(dividend, divisors_); \
+            const SIMD_TYPE constant = divider.Divide(dividend); \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                /* INT_MIN / -1 overflows, the lanes wrap */ \
+                const bool overflow = Limits::is_signed && dividend.Data[j] == Limits::min() && divisor == static_cast<ELEMENT_TYPE>(-1); \
+                const ELEMENT_TYPE expected = overflow ? Limits::min() : static_cast<ELEMENT_TYPE>(dividend.Data[j] / divisor); \
+                ASSERT_EQ(quotient.Data[j], expected) << +dividend.Data[j] << " / " << +divisor; \
+                ASSERT_EQ(constant.Data[j], expected) << +dividend.Data[j] << " / " << +divisor; \
+            } \
+        } \
+    } \
+}
+
+TEST_SIMD_DIVIDE(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_DIVIDE(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_DIVIDE(int128_with_int32_t, SIMD::int_128<int32_t>, int32_t)
+TEST_SIMD_DIVIDE(int128_with_uint64_t, SIMD::int_128<uint64_t>, uint64_t)
+TEST_SIMD_DIVIDE(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_DIVIDE(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_DIVIDE(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+TEST_SIMD_DIVIDE(int256_with_int64_t, SIMD::int_256<int64_t>, int64_t)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_DIVIDE(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_DIVIDE(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+TEST_SIMD_DIVIDE(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+#endif
+
+// Array by Array integer division goes through the dispatched kernel, INT_MIN / -1 wraps
+TEST(SIMDDivideTest, Array_Divided_By_Array) {
+    SIMD::Array<SIMD::int_256<int16_t>, 101> a, b;
+    for (int i = 0; i < 101; i++) {
+        for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+            a[i][j] = static_cast<int16_t>((i * 16 + j) * 37 - 30000);
+            b[i][j] = static_cast<int16_t>((i + j) % 2 == 0 ? j - 17 : i + 1);
+        }
+    }
+    a[0][0] = std::numeric_limits<int16_t>::min();
+    b[0][0] = -1;
+    a /= b;
+    EXPECT_EQ(a[0][0], std::numeric_limits<int16_t>::min());
+    for (int i = 0; i < 101; i++) {
+        for (int j = (i == 0 ? 1 : 0); j < SIMD::int_256<int16_t>::ElementCount; j++) {
+            const int16_t divisor = static_cast<int16_t>((i + j) % 2 == 0 ? j - 17 : i + 1);
+            ASSERT_EQ(a[i][j], static_cast<int16_t>(static_cast<int16_t>((i * 16 + j) * 37 - 30000) / divisor));
+        }
+    }
+}
+
+TEST(SIMDDivideTest, Array_Divided_By_Constant) {
+    SIMD::Array<SIMD::int_256<int16_t>, 100> a;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+            a[i][j] = static_cast<int16_t>((i * 16 + j) * 37 - 30000);
+        }
+    }
+    a /= SIMD::Divider<SIMD::int_256<int16_t> >(-7);
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+            ASSERT_EQ(a[i][j], static_cast<int16_t>(static_cast<int16_t>((i * 16 + j) * 37 - 30000) / -7));
+        }
+    }
+    EXPECT_THROW(SIMD::Divider<SIMD::int_256<int16_t> >(0), std::runtime_error);
+}
+
+// Division benchmarks, lanes divided by lanes and an Array divided by a runtime constant
+#define BENCHMARK_DIVIDE_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::int_256<int32_t>, ARRAY_SIZE> a, b; \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int32_t> dist(1, 1 << 30); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) { \
+            a[i][j] = dist(rng); b[i][j] = dist(rng) % 1000 + 1; \
+        } \
+    }
+
+static void BM_SIMD_int256_with_int32_t_Division_100000(benchmark::State& state) {
+    BENCHMARK_DIVIDE_SETUP(100000)
+    SIMD::Array<SIMD::int_256<int32_t>, 100000> q;
+    for (auto _ : state) {
+        q = a;
+        q /= b;
+        benchmark::DoNotOptimize(q);
+    }
+}
+BENCHMARK(BM_SIMD_int256_with_int32_t_Division_100000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_int256_with_int32_t_ConstantDivision_100000(benchmark::State& state) {
+    BENCHMARK_DIVIDE_SETUP(100000)
+    SIMD::Array<SIMD::int_256<int32_t>, 100000> q;
+    const SIMD::Divider<SIMD::int_256<int32_t> > divider(b[0][0]);
+    for (auto _ : state) {
+        q = a;
+        q /= divider;
+        benchmark::DoNotOptimize(q);
+    }
+}
+BENCHMARK(BM_SIMD_int256_with_int32_t_ConstantDivision_100000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_int256_with_int32_t_ConstantDivision_100000(benchmark::State& state) {
+    BENCHMARK_DIVIDE_SETUP(100000)
+    std::vector<int32_t> q(100000 * SIMD::int_256<int32_t>::ElementCount);
+    volatile int32_t divisor = b[0][0];
+    for (auto _ : state) {
+        const int32_t d = divisor;
+        for (int i = 0; i < 100000; i++) {
+            for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) {
+                q[i * SIMD::int_256<int32_t>::ElementCount + j] = a[i][j] / d;
+            }
+        }
+        benchmark::DoNotOptimize(q);
+    }
+}
+BENCHMARK(BM_Plain_int256_with_int32_t_ConstantDivision_100000)->Unit(benchmark::kMillisecond);
+
+// Saturating, averaging and absolute difference arithmetic against a 64 bit reference. 8 bit lanes are checked
+// for every pair of values, wider lanes with random values plus the edges. 32 bit lanes use the lane loops.
+#define TEST_SIMD_SATURATE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDSaturateTest, TYPE_NAME##_Saturate_Average_AbsDiff) \
+{ \
+    typedef std::numeric_limits<ELEMENT_TYPE> Limits; \
+    std::mt19937_64 rng(42); \
+    const bool exhaustive = sizeof(ELEMENT_TYPE) == 1; \
+    const ELEMENT_TYPE edges[] = { Limits::min(), Limits::max(), 0, static_cast<ELEMENT_TYPE>(-1), 1 }; \
+    for (int n = 0; n < (exhaustive ? 65536 / SIMD_TYPE::ElementCount : 4000); n++) { \
+        SIMD_TYPE a, b; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            const int index = n * SIMD_TYPE::ElementCount + j; \
+            a.Data[j] = exhaustive ? static_cast<ELEMENT_TYPE>(index & 0xFF) : (rng() % 8 == 0 ? edges[rng() % 5] : static_cast<ELEMENT_TYPE>(rng())); \
+            b.Data[j] = exhaustive ? static_cast<ELEMENT_TYPE>(index >> 8) : (rng() % 8 == 0 ? edges[rng() % 5] : static_cast<ELEMENT_TYPE>(rng())); \
+        } \
+        const SIMD_TYPE sum = SIMD_TYPE::AddSaturate(a, b); \
+        const SIMD_TYPE difference = SIMD_TYPE::SubtractSaturate(a, b); \
+        const SIMD_TYPE average = SIMD_TYPE::Average(a, b); \
+        const SIMD_TYPE distance = SIMD_TYPE::AbsDiff(a, b); \
+        SIMD_TYPE inplace = a, raw = a; \
+        SIMD_TYPE::AddSaturateInplace(inplace, b); \
+        SIMD_TYPE::SubtractSaturateInplaceRaw(raw.Data, b.Data); \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            const int64_t x = a.Data[j], y = b.Data[j]; \
+            const int64_t low = Limits::min(), high = Limits::max(); \
+            ASSERT_EQ(sum.Data[j], static_cast<ELEMENT_TYPE>(std::min(high, std::max(low, x + y)))) << +a.Data[j] << " + " << +b.Data[j]; \
+            ASSERT_EQ(difference.Data[j], static_cast<ELEMENT_TYPE>(std::min(high, std::max(low, x - y)))) << +a.Data[j] << " - " << +b.Data[j]; \
+            ASSERT_EQ(average.Data[j], static_cast<ELEMENT_TYPE>((x + y + 1) >> 1)) << "Average " << +a.Data[j] << ", " << +b.Data[j]; \
+            ASSERT_EQ(distance.Data[j], static_cast<ELEMENT_TYPE>(x > y ? x - y : y - x)) << "AbsDiff " << +a.Data[j] << ", " << +b.Data[j]; \
+            ASSERT_EQ(inplace.Data[j], sum.Data[j]); \
+            ASSERT_EQ(raw.Data[j], difference.Data[j]); \
+        } \
+    } \
+}
+
+TEST_SIMD_SATURATE(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_SATURATE(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t)
+TEST_SIMD_SATURATE(int128_with_int16_t, SIMD::int_128<int16_t>, int16_t)
+TEST_SIMD_SATURATE(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_SATURATE(int128_with_int32_t, SIMD::int_128<int32_t>, int32_t)
+TEST_SIMD_SATURATE(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_SATURATE(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_SATURATE(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_SATURATE(int256_with_uint16_t, SIMD::int_256<uint16_t>, uint16_t)
+TEST_SIMD_SATURATE(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_SATURATE(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_SATURATE(int512_with_uint8_t, SIMD::int_512<uint8_t>, uint8_t)
+TEST_SIMD_SATURATE(int512_with_int16_t, SIMD::int_512<int16_t>, int16_t)
+TEST_SIMD_SATURATE(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+#endif
+
+TEST(SIMDSaturateTest, Array_Expressions) {
+    SIMD::Array<SIMD::int_256<uint8_t>, 100> x, y, z;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint8_t>::ElementCount; j++) {
+            x[i][j] = static_cast<uint8_t>(i * 32 + j * 7);
+            y[i][j] = static_cast<uint8_t>(j * 9);
+        }
+    }
+    z = SIMD::AddSaturate(SIMD::AbsDiff(x, y), SIMD::Average(x, y));
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint8_t>::ElementCount; j++) {
+            const int a = x[i][j], b = y[i][j];
+            ASSERT_EQ(z[i][j], std::min(255, std::abs(a - b) + (a + b + 1) / 2));
+        }
+    }
+    z = SIMD::SubtractSaturate(x, y);
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint8_t>::ElementCount; j++) {
+            ASSERT_EQ(z[i][j], std::max(0, x[i][j] - y[i][j]));
+        }
+    }
+}
+
+// Saturating addition of int16 samples, the plain loop widens to 32 bits, clamps and narrows again
+#define BENCHMARK_SATURATE_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::int_256<int16_t>, ARRAY_SIZE> a, b, sum; \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int> dist(-32768, 32767); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) { \
+            a[i][j] = static_cast<int16_t>(dist(rng)); b[i][j] = static_cast<int16_t>(dist(rng)); \
+        } \
+    }
+
+static void BM_SIMD_int256_with_int16_t_AddSaturate_1000000(benchmark::State& state) {
+    BENCHMARK_SATURATE_SETUP(1000000)
+    for (auto _ : state) {
+        sum = SIMD::AddSaturate(a, b);
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_SIMD_int256_with_int16_t_AddSaturate_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_int256_with_int16_t_AddSaturate_1000000(benchmark::State& state) {
+    BENCHMARK_SATURATE_SETUP(1000000)
+    for (auto _ : state) {
+        for (int i = 0; i < 1000000; i++) {
+            for (int j = 0; j < SIMD::int_256<int16_t>::ElementCount; j++) {
+                const int32_t wide = static_cast<int32_t>(a[i][j]) + b[i][j];
+                sum[i][j] = static_cast<int16_t>(std::min(32767, std::max(-32768, wide)));
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_Plain_int256_with_int16_t_AddSaturate_1000000)->Unit(benchmark::kMillisecond);
+
+// Scalar shifts with the lane semantics, counts of the lane width or more shift every bit out
+template<typename E>
+E ReferenceShiftLeft(E a, uint64_t n) {
+    typedef typename std::make_unsigned<E>::type U;
+    return n >= sizeof(E) * 8 ? 0 : static_cast<E>(static_cast<uint64_t>(static_cast<U>(a)) << n);
+}
+
+template<typename E>
+E ReferenceShiftRight(E a, uint64_t n) {
+    if (n >= sizeof(E) * 8) {
+        return a < 0 ? static_cast<E>(-1) : 0;
+    }
+    return static_cast<E>(std::is_signed<E>::value ? static_cast<int64_t>(a) >> n : static_cast<int64_t>(static_cast<uint64_t>(a) >> n));
+}
+
+// Bitwise logic and the three shift forms against scalar code. Scalar counts run past the lane width, per lane
+// counts are read as unsigned and include out of range and negative values.
+#define TEST_SIMD_BITWISE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDBitwiseTest, TYPE_NAME##_Logic_Shifts) \
+{ \
+    typedef typename std::make_unsigned<ELEMENT_TYPE>::type U; \
+    const unsigned int bits = sizeof(ELEMENT_TYPE) * 8; \
+    std::mt19937_64 rng(42); \
+    for (int n = 0; n < 500; n++) { \
+        SIMD_TYPE a, b, counts; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            a.Data[j] = static_cast<ELEMENT_TYPE>(rng()); \
+            b.Data[j] = static_cast<ELEMENT_TYPE>(rng()); \
+            counts.Data[j] = static_cast<ELEMENT_TYPE>(rng() % 8 == 0 ? rng() : rng() % (bits + 2)); \
+        } \
+        const SIMD_TYPE conjunction = a & b, disjunction = a | b, exclusive = a ^ b, complement = ~a; \
+        const SIMD_TYPE masked = SIMD_TYPE::AndNot(a, b); \
+        const SIMD_TYPE left = a << counts, right = a >> counts; \
+        SIMD_TYPE inplace = a, raw = a; \
+        inplace ^= b; \
+        SIMD_TYPE::ShiftRightInplaceRaw(raw.Data, counts.Data); \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            const uint64_t count = static_cast<U>(counts.Data[j]); \
+            ASSERT_EQ(conjunction.Data[j], static_cast<ELEMENT_TYPE>(a.Data[j] & b.Data[j])); \
+            ASSERT_EQ(disjunction.Data[j], static_cast<ELEMENT_TYPE>(a.Data[j] | b.Data[j])); \
+            ASSERT_EQ(exclusive.Data[j], static_cast<ELEMENT_TYPE>(a.Data[j] ^ b.Data[j])); \
+            ASSERT_EQ(complement.Data[j], static_cast<ELEMENT_TYPE>(~a.Data[j])); \
+            ASSERT_EQ(masked.Data[j], static_cast<ELEMENT_TYPE>(a.Data[j] & ~b.Data[j])); \
+            ASSERT_EQ(left.Data[j], ReferenceShiftLeft(a.Data[j], count)) << +a.Data[j] << " << " << count; \
+            ASSERT_EQ(right.Data[j], ReferenceShiftRight(a.Data[j], count)) << +a.Data[j] << " >> " << count; \
+            ASSERT_EQ(inplace.Data[j], exclusive.Data[j]); \
+            ASSERT_EQ(raw.Data[j], right.Data[j]); \
+        } \
+        for (unsigned int count = 0; count <= bits + 1; count++) { \
+            const SIMD_TYPE shiftedLeft = a << count, shiftedRight = a >> count; \
+            SIMD_TYPE inplaceLeft = a, rawRight = a; \
+            inplaceLeft <<= count; \
+            SIMD_TYPE::ShiftRightInplaceRaw(rawRight.Data, count); \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                ASSERT_EQ(shiftedLeft.Data[j], ReferenceShiftLeft(a.Data[j], count)) << +a.Data[j] << " << " << count; \
+                ASSERT_EQ(shiftedRight.Data[j], ReferenceShiftRight(a.Data[j], count)) << +a.Data[j] << " >> " << count; \
+                ASSERT_EQ(inplaceLeft.Data[j], shiftedLeft.Data[j]); \
+                ASSERT_EQ(rawRight.Data[j], shiftedRight.Data[j]); \
+            } \
+        } \
+        const SIMD_TYPE immediateLeft = SIMD_TYPE::template ShiftLeft<3>(a), immediateRight = SIMD_TYPE::template ShiftRight<bits - 1>(a); \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            ASSERT_EQ(immediateLeft.Data[j], ReferenceShiftLeft(a.Data[j], 3)); \
+            ASSERT_EQ(immediateRight.Data[j], ReferenceShiftRight(a.Data[j], bits - 1)); \
+        } \
+    } \
+}
+
+TEST_SIMD_BITWISE(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_BITWISE(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t)
+TEST_SIMD_BITWISE(int128_with_int16_t, SIMD::int_128<int16_t>, int16_t)
+TEST_SIMD_BITWISE(int128_with_uint32_t, SIMD::int_128<uint32_t>, uint32_t)
+TEST_SIMD_BITWISE(int128_with_int64_t, SIMD::int_128<int64_t>, int64_t)
+TEST_SIMD_BITWISE(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_BITWISE(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_BITWISE(int256_with_uint16_t, SIMD::int_256<uint16_t>, uint16_t)
+TEST_SIMD_BITWISE(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+TEST_SIMD_BITWISE(int256_with_int64_t, SIMD::int_256<int64_t>, int64_t)
+TEST_SIMD_BITWISE(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_BITWISE(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_BITWISE(int512_with_int16_t, SIMD::int_512<int16_t>, int16_t)
+#endif
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_BITWISE(int512_with_uint32_t, SIMD::int_512<uint32_t>, uint32_t)
+TEST_SIMD_BITWISE(int512_with_int64_t, SIMD::int_512<int64_t>, int64_t)
+#endif
+
+TEST(SIMDBitwiseTest, Array_Expressions) {
+    SIMD::Array<SIMD::int_256<uint32_t>, 100> x, y, z;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint32_t>::ElementCount; j++) {
+            x[i][j] = static_cast<uint32_t>(i * 2654435761u + j * 40503u);
+            y[i][j] = static_cast<uint32_t>(j * 4);
+        }
+    }
+    z = ((x << 5) ^ (x >> 27)) & ~y;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint32_t>::ElementCount; j++) {
+            ASSERT_EQ(z[i][j], ((x[i][j] << 5) ^ (x[i][j] >> 27)) & ~y[i][j]);
+        }
+    }
+    z = SIMD::AndNot(x, y) | (x << y);
+    z >>= 2;
+    z |= y;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::int_256<uint32_t>::ElementCount; j++) {
+            ASSERT_EQ(z[i][j], (((x[i][j] & ~y[i][j]) | (x[i][j] << y[i][j])) >> 2) | y[i][j]);
+        }
+    }
+}
+
+// Rotate and mix step of a 32 bit hash, h = rotl(a, 7) ^ (b & ~a), the plain loop runs the same step lane by lane
+#define BENCHMARK_BITWISE_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::int_256<uint32_t>, ARRAY_SIZE> a, b, hash; \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::int_256<uint32_t>::ElementCount; j++) { \
+            a[i][j] = static_cast<uint32_t>(i * 2654435761u + j); \
+            b[i][j] = static_cast<uint32_t>(i * 40503u + j * 7); \
+        } \
+    }
+
+static void BM_SIMD_int256_with_uint32_t_RotateMix_1000000(benchmark::State& state) {
+    BENCHMARK_BITWISE_SETUP(1000000)
+    for (auto _ : state) {
+        hash = ((a << 7) | (a >> 25)) ^ SIMD::AndNot(b, a);
+        benchmark::DoNotOptimize(hash);
+    }
+}
+BENCHMARK(BM_SIMD_int256_with_uint32_t_RotateMix_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_int256_with_uint32_t_RotateMix_1000000(benchmark::State& state) {
+    BENCHMARK_BITWISE_SETUP(1000000)
+    for (auto _ : state) {
+        for (int i = 0; i < 1000000; i++) {
+            for (int j = 0; j < SIMD::int_256<uint32_t>::ElementCount; j++) {
+                const uint32_t x = a[i][j];
+                hash[i][j] = ((x << 7) | (x >> 25)) ^ (b[i][j] & ~x);
+            }
+        }
+        benchmark::DoNotOptimize(hash);
+    }
+}
+BENCHMARK(BM_Plain_int256_with_uint32_t_RotateMix_1000000)->Unit(benchmark::kMillisecond);
+
+// Scalar conversion with the SIMD semantics: integer results saturate, floating sources truncate and NaN becomes 0.
+// long double holds every 64 bit integer exactly.
+template<typename To, typename From>
+To ReferenceConvert(From v) {
+    if (std::is_floating_point<To>::value) {
+        return static_cast<To>(v);
+    }
+    if (v != v) {
+        return 0;
+    }
+    const long double x = std::trunc(static_cast<long double>(v));
+    if (x < static_cast<long double>(std::numeric_limits<To>::min())) {
+        return std::numeric_limits<To>::min();
+    }
+    if (x > static_cast<long double>(std::numeric_limits<To>::max())) {
+        return std::numeric_limits<To>::max();
+    }
+    return static_cast<To>(x);
+}
+
+template<typename E>
+bool SameValue(E a, E b) {
+    return a == b || (a != a && b != b);
+}
+
+// Random lanes with a quarter of them taken from the edges of both lane types
+template<typename E, typename Other>
+E ConversionSample(std::mt19937_64& rng) {
+    const E edges[] = { std::numeric_limits<E>::min(), std::numeric_limits<E>::max(), 0, static_cast<E>(-1), 1,
+        ReferenceConvert<E>(std::numeric_limits<Other>::min()), ReferenceConvert<E>(std::numeric_limits<Other>::max()),
+        static_cast<E>(ReferenceConvert<E>(std::numeric_limits<Other>::max()) - 1), static_cast<E>(ReferenceConvert<E>(std::numeric_limits<Other>::max()) + 1) };
+    return rng() % 4 == 0 ? edges[rng() % 9] : static_cast<E>(rng() % 2 ? rng() : rng() % 1024);
+}
+
+// Widen NARROW_TYPE into WIDE_TYPE and Narrow back with saturation. Every pair is converted to and from, the element
+// types decide whether the specialized kernels or the saturating lane loops run.
+#define TEST_SIMD_WIDEN_NARROW(TYPE_NAME, NARROW_TYPE, WIDE_TYPE) \
+TEST(SIMDConvertTest, TYPE_NAME##_Widen_Narrow) \
+{ \
+    typedef NARROW_TYPE::ElementType N; \
+    typedef WIDE_TYPE::ElementType W; \
+    std::mt19937_64 rng(42); \
+    for (int n = 0; n < 2000; n++) { \
+        NARROW_TYPE a; \
+        WIDE_TYPE low, high; \
+        for (int j = 0; j < NARROW_TYPE::ElementCount; j++) { \
+            a.Data[j] = ConversionSample<N, W>(rng); \
+            low.Data[j % WIDE_TYPE::ElementCount] = ConversionSample<W, N>(rng); \
+            high.Data[j % WIDE_TYPE::ElementCount] = ConversionSample<W, N>(rng); \
+        } \
+        const NARROW_TYPE narrowed = NARROW_TYPE::Narrow(low, high); \
+        for (int j = 0; j < WIDE_TYPE::ElementCount; j++) { \
+            ASSERT_EQ(narrowed.Data[j], ReferenceConvert<N>(low.Data[j])) << +low.Data[j]; \
+            ASSERT_EQ(narrowed.Data[j + WIDE_TYPE::ElementCount], ReferenceConvert<N>(high.Data[j])) << +high.Data[j]; \
+        } \
+        WIDE_TYPE::Widen(a, low, high); \
+        for (int j = 0; j < WIDE_TYPE::ElementCount; j++) { \
+            ASSERT_EQ(low.Data[j], ReferenceConvert<W>(a.Data[j])) << +a.Data[j]; \
+            ASSERT_EQ(high.Data[j], ReferenceConvert<W>(a.Data[j + WIDE_TYPE::ElementCount])) << +a.Data[j + WIDE_TYPE::ElementCount]; \
+        } \
+    } \
+}
+
+TEST_SIMD_WIDEN_NARROW(int128_int8_t_int16_t, SIMD::int_128<int8_t>, SIMD::int_128<int16_t>)
+TEST_SIMD_WIDEN_NARROW(int128_uint8_t_uint16_t, SIMD::int_128<uint8_t>, SIMD::int_128<uint16_t>)
+TEST_SIMD_WIDEN_NARROW(int128_uint8_t_int16_t, SIMD::int_128<uint8_t>, SIMD::int_128<int16_t>)
+TEST_SIMD_WIDEN_NARROW(int128_int8_t_uint16_t, SIMD::int_128<int8_t>, SIMD::int_128<uint16_t>)
+TEST_SIMD_WIDEN_NARROW(int128_int16_t_int32_t, SIMD::int_128<int16_t>, SIMD::int_128<int32_t>)
+TEST_SIMD_WIDEN_NARROW(int128_uint16_t_int32_t, SIMD::int_128<uint16_t>, SIMD::int_128<int32_t>)
+TEST_SIMD_WIDEN_NARROW(int128_int32_t_int64_t, SIMD::int_128<int32_t>, SIMD::int_128<int64_t>)
+TEST_SIMD_WIDEN_NARROW(int128_uint32_t_uint64_t, SIMD::int_128<uint32_t>, SIMD::int_128<uint64_t>)
+TEST_SIMD_WIDEN_NARROW(int256_int8_t_int16_t, SIMD::int_256<int8_t>, SIMD::int_256<int16_t>)
+TEST_SIMD_WIDEN_NARROW(int256_uint8_t_int16_t, SIMD::int_256<uint8_t>, SIMD::int_256<int16_t>)
+TEST_SIMD_WIDEN_NARROW(int256_int8_t_uint16_t, SIMD::int_256<int8_t>, SIMD::int_256<uint16_t>)
+TEST_SIMD_WIDEN_NARROW(int256_uint16_t_uint32_t, SIMD::int_256<uint16_t>, SIMD::int_256<uint32_t>)
+TEST_SIMD_WIDEN_NARROW(int256_int16_t_int32_t, SIMD::int_256<int16_t>, SIMD::int_256<int32_t>)
+TEST_SIMD_WIDEN_NARROW(int256_int32_t_int64_t, SIMD::int_256<int32_t>, SIMD::int_256<int64_t>)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_WIDEN_NARROW(int512_int8_t_int16_t, SIMD::int_512<int8_t>, SIMD::int_512<int16_t>)
+TEST_SIMD_WIDEN_NARROW(int512_uint8_t_uint16_t, SIMD::int_512<uint8_t>, SIMD::int_512<uint16_t>)
+TEST_SIMD_WIDEN_NARROW(int512_uint16_t_int32_t, SIMD::int_512<uint16_t>, SIMD::int_512<int32_t>)
+TEST_SIMD_WIDEN_NARROW(int512_int32_t_int64_t, SIMD::int_512<int32_t>, SIMD::int_512<int64_t>)
+TEST_SIMD_WIDEN_NARROW(int512_uint32_t_uint64_t, SIMD::int_512<uint32_t>, SIMD::int_512<uint64_t>)
+#endif
+
+// int32 <-> float, int32 <-> double, int64 <-> double and float <-> double, the floating lanes include NaN,
+// infinities, the int32 and int64 limits and the values next to them
+#define TEST_SIMD_CONVERT_FLOATING(WIDTH, FLOAT_TYPE, DOUBLE_TYPE) \
+TEST(SIMDConvertTest, WIDTH##_Floating) \
+{ \
+    typedef SIMD::int_##WIDTH<int32_t> I32; \
+    typedef SIMD::int_##WIDTH<int64_t> I64; \
+    const double edges[] = { std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), \
+        -std::numeric_limits<double>::infinity(), 2147483648.0, 2147483647.0, 2147483647.5, 2147483520.0, -2147483648.0, \
+        -2147483648.5, -2147483649.0, 9223372036854775808.0, 9223372036854774784.0, -9223372036854775808.0, -1e19, 0.5, -0.5, -0.0, 1e300 }; \
+    std::mt19937_64 rng(42); \
+    std::uniform_real_distribution<double> dist(-3e9, 3e9); \
+    for (int n = 0; n < 2000; n++) { \
+        I32 ints; \
+        I64 longs; \
+        FLOAT_TYPE floats; \
+        DOUBLE_TYPE low, high; \
+        for (int j = 0; j < I32::ElementCount; j++) { \
+            ints.Data[j] = rng() % 4 == 0 ? static_cast<int32_t>(INT32_MIN + rng() % 3) : static_cast<int32_t>(rng()); \
+            floats.Data[j] = static_cast<float>(rng() % 4 == 0 ? edges[rng() % 18] : dist(rng)); \
+        } \
+        for (int j = 0; j < DOUBLE_TYPE::ElementCount; j++) { \
+            longs.Data[j] = static_cast<int64_t>(rng()); \
+            low.Data[j] = rng() % 4 == 0 ? edges[rng() % 18] : dist(rng); \
+            high.Data[j] = rng() % 4 == 0 ? edges[rng() % 18] : dist(rng) * 4e9; \
+        } \
+        const FLOAT_TYPE fromInts = FLOAT_TYPE::Convert(ints); \
+        const I32 fromFloats = I32::Convert(floats); \
+        const I32 fromDoubles = I32::Narrow(low, high); \
+        const FLOAT_TYPE narrowedDoubles = FLOAT_TYPE::Narrow(low, high); \
+        const I64 longsFromDoubles = I64::Convert(low); \
+        const DOUBLE_TYPE doublesFromLongs = DOUBLE_TYPE::Convert(longs); \
+        for (int j = 0; j < I32::ElementCount; j++) { \
+            ASSERT_EQ(fromInts.Data[j], static_cast<float>(ints.Data[j])); \
+            ASSERT_EQ(fromFloats.Data[j], ReferenceConvert<int32_t>(floats.Data[j])) << floats.Data[j]; \
+            const double source = j < DOUBLE_TYPE::ElementCount ? low.Data[j] : high.Data[j - DOUBLE_TYPE::ElementCount]; \
+            ASSERT_EQ(fromDoubles.Data[j], ReferenceConvert<int32_t>(source)) << source; \
+            ASSERT_TRUE(SameValue(narrowedDoubles.Data[j], static_cast<float>(source))) << source; \
+        } \
+        for (int j = 0; j < DOUBLE_TYPE::ElementCount; j++) { \
+            ASSERT_EQ(longsFromDoubles.Data[j], ReferenceConvert<int64_t>(low.Data[j])) << low.Data[j]; \
+            ASSERT_EQ(doublesFromLongs.Data[j], static_cast<double>(longs.Data[j])); \
+        } \
+        DOUBLE_TYPE::Widen(ints, low, high); \
+        for (int j = 0; j < DOUBLE_TYPE::ElementCount; j++) { \
+            ASSERT_EQ(low.Data[j], static_cast<double>(ints.Data[j])); \
+            ASSERT_EQ(high.Data[j], static_cast<double>(ints.Data[j + DOUBLE_TYPE::ElementCount])); \
+        } \
+        DOUBLE_TYPE::Widen(floats, low, high); \
+        for (int j = 0; j < DOUBLE_TYPE::ElementCount; j++) { \
+            ASSERT_TRUE(SameValue(low.Data[j], static_cast<double>(floats.Data[j]))); \
+            ASSERT_TRUE(SameValue(high.Data[j], static_cast<double>(floats.Data[j + DOUBLE_TYPE::ElementCount]))); \
+        } \
+    } \
+}
+
+TEST_SIMD_CONVERT_FLOATING(256, SIMD::float_256, SIMD::double_256)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_CONVERT_FLOATING(512, SIMD::float_512, SIMD::double_512)
+#endif
+
+TEST(SIMDConvertTest, Array_Pipeline) {
+    SIMD::Array<SIMD::int_256<int8_t>, 10> bytes;
+    SIMD::Array<SIMD::int_256<int16_t>, 20> shorts;
+    SIMD::Array<SIMD::int_256<int32_t>, 40> ints, rounded;
+    SIMD::Array<SIMD::float_256, 40> floats;
+    SIMD::Array<SIMD::int_256<uint8_t>, 10> clamped;
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 32; j++) {
+            bytes[i][j] = static_cast<int8_t>(i * 32 + j);
+        }
+    }
+    SIMD::Widen(bytes, shorts);
+    SIMD::Widen(shorts, ints);
+    SIMD::Convert(ints, floats);
+    floats = floats * floats;
+    SIMD::Convert(floats, rounded);
+    SIMD::Narrow(rounded, shorts);
+    SIMD::Narrow(shorts, clamped);
+    for (int k = 0; k < 320; k++) {
+        const int value = static_cast<int8_t>(k);
+        ASSERT_EQ(ints[k / 8][k % 8], value);
+        ASSERT_EQ(shorts[k / 16][k % 16], value * value);
+        ASSERT_EQ(clamped[k / 32][k % 32], std::min(255, value * value));
+    }
+}
+
+// Saturating int32 -> int16 narrowing of a buffer, e.g. mixed audio samples written back to 16 bits
+#define BENCHMARK_NARROW_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::int_256<int32_t>, ARRAY_SIZE> wide; \
+    SIMD::Array<SIMD::int_256<int16_t>, ARRAY_SIZE / 2> narrow; \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int32_t> dist(-40000, 40000); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) { \
+            wide[i][j] = dist(rng); \
+        } \
+    }
+
+static void BM_SIMD_int256_with_int32_t_Narrow_1000000(benchmark::State& state) {
+    BENCHMARK_NARROW_SETUP(1000000)
+    for (auto _ : state) {
+        SIMD::Narrow(wide, narrow);
+        benchmark::DoNotOptimize(narrow);
+    }
+}
+BENCHMARK(BM_SIMD_int256_with_int32_t_Narrow_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_int256_with_int32_t_Narrow_1000000(benchmark::State& state) {
+    BENCHMARK_NARROW_SETUP(1000000)
+    for (auto _ : state) {
+        for (int i = 0; i < 1000000; i++) {
+            for (int j = 0; j < SIMD::int_256<int32_t>::ElementCount; j++) {
+                narrow[i / 2][(i % 2) * 8 + j] = static_cast<int16_t>(std::min(32767, std::max(-32768, wide[i][j])));
+            }
+        }
+        benchmark::DoNotOptimize(narrow);
+    }
+}
+BENCHMARK(BM_Plain_int256_with_int32_t_Narrow_1000000)->Unit(benchmark::kMillisecond);
+
+static bool IsHalfNaN(uint16_t bits) { return (bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0; }
+static bool IsBFloat16NaN(uint16_t bits) { return (bits & 0x7F80) == 0x7F80 && (bits & 0x7F) != 0; }
+
+TEST(SIMDPackedFloatTest, Scalar_Roundtrip_and_Rounding) {
+    for (uint32_t bits = 0; bits < 65536; bits++) {
+        const uint16_t h = static_cast<uint16_t>(bits);
+        if (IsHalfNaN(h)) {
+            ASSERT_TRUE(std::isnan(SIMD::half::ToFloat(h)));
+            ASSERT_EQ(SIMD::half::FromFloat(SIMD::half::ToFloat(h)), h | 0x200);
+        } else {
+            ASSERT_EQ(SIMD::half::FromFloat(SIMD::half::ToFloat(h)), h) << bits;
+        }
+        if (IsBFloat16NaN(h)) {
+            ASSERT_EQ(SIMD::bfloat16::FromFloat(SIMD::bfloat16::ToFloat(h)), h | 0x40);
+        } else {
+            ASSERT_EQ(SIMD::bfloat16::FromFloat(SIMD::bfloat16::ToFloat(h)), h) << bits;
+        }
+    }
+    // Midpoints round to the even neighbour
+    EXPECT_EQ(SIMD::half::FromFloat(1.0f + std::ldexp(1.0f, -11)), 0x3C00);
+    EXPECT_EQ(SIMD::half::FromFloat(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02);
+    EXPECT_EQ(SIMD::half::FromFloat(std::ldexp(1.0f, -25)), 0x0000);
+    EXPECT_EQ(SIMD::half::FromFloat(3 * std::ldexp(1.0f, -25)), 0x0002);
+    EXPECT_EQ(SIMD::half::FromFloat(-65504.0f), 0xFBFF);
+    EXPECT_EQ(SIMD::half::FromFloat(65519.0f), 0x7BFF);
+    EXPECT_EQ(SIMD::half::FromFloat(65520.0f), 0x7C00);
+    EXPECT_EQ(SIMD::half::FromFloat(-std::numeric_limits<float>::infinity()), 0xFC00);
+    EXPECT_EQ(SIMD::bfloat16::FromFloat(1.0f + std::ldexp(1.0f, -8)), 0x3F80);
+    EXPECT_EQ(SIMD::bfloat16::FromFloat(1.0f + 3 * std::ldexp(1.0f, -8)), 0x3F82);
+    EXPECT_EQ(SIMD::bfloat16::FromFloat(std::numeric_limits<float>::max()), 0x7F80);
+    EXPECT_EQ(static_cast<float>(SIMD::half(0.5f)), 0.5f);
+    EXPECT_EQ(static_cast<float>(SIMD::bfloat16(-2.0f)), -2.0f);
+}
+
+// Vector conversions against the scalar ones on random bit patterns, NaNs only have to stay NaN
+#define TEST_SIMD_PACKED_FLOAT(TYPE_NAME, TYPE) \
+TEST(SIMDPackedFloatTest, TYPE_NAME##_Kernels) { \
+    constexpr int N = TYPE::ElementCount; \
+    alignas(64) float floats[N]; \
+    alignas(64) uint16_t halves[N]; \
+    alignas(64) uint16_t bf16s[N]; \
+    std::mt19937 rng(42); \
+    for (int round = 0; round < 20000; round++) { \
+        for (int j = 0; j < N; j++) { \
+            const uint32_t bits = rng(); \
+            memcpy(&floats[j], &bits, sizeof(float)); \
+        } \
+        SIMD::PackedFloat<SIMD::half, TYPE::BitWidth>::Store(halves, floats); \
+        SIMD::PackedFloat<SIMD::bfloat16, TYPE::BitWidth>::Store(bf16s, floats); \
+        for (int j = 0; j < N; j++) { \
+            if (std::isnan(floats[j])) { \
+                ASSERT_TRUE(IsHalfNaN(halves[j])); \
+                ASSERT_TRUE(IsBFloat16NaN(bf16s[j])); \
+            } else { \
+                ASSERT_EQ(halves[j], SIMD::half::FromFloat(floats[j])) << floats[j]; \
+                if (!PACKED_BF16_FLUSHES_DENORMALS(TYPE) || std::fpclassify(floats[j]) != FP_SUBNORMAL) { \
+                    ASSERT_EQ(bf16s[j], SIMD::bfloat16::FromFloat(floats[j])) << floats[j]; \
+                } \
+            } \
+        } \
+        SIMD::PackedFloat<SIMD::half, TYPE::BitWidth>::Load(floats, halves); \
+        for (int j = 0; j < N; j++) { \
+            ASSERT_TRUE(SameValue(floats[j], SIMD::half::ToFloat(halves[j]))); \
+        } \
+        SIMD::PackedFloat<SIMD::bfloat16, TYPE::BitWidth>::Load(floats, bf16s); \
+        for (int j = 0; j < N; j++) { \
+            ASSERT_TRUE(SameValue(floats[j], SIMD::bfloat16::ToFloat(bf16s[j]))); \
+        } \
+    } \
+} \
+TEST(SIMDPackedFloatTest, TYPE_NAME##_Array_Expressions) { \
+    constexpr int N = TYPE::ElementCount; \
+    SIMD::HalfArray<TYPE, 37> a, b, c; \
+    SIMD::BFloat16Array<TYPE, 37> d; \
+    SIMD::Array<TYPE, 37> x, wide; \
+    double sum = 0.0, dot = 0.0; \
+    for (int i = 0; i < 37; i++) { \
+        for (int j = 0; j < N; j++) { \
+            const float value = static_cast<float>((i * N + j) % 64) / 8.0f - 4.0f; \
+            a[i][j] = value; b[i][j] = 0.25f * value; x[i][j] = 1.0f + value; \
+            sum += value; dot += value * (1.0f + value); \
+        } \
+    } \
+    c = a * b + x; \
+    d = SIMD::FusedMultiplyAdd(a, x, b); \
+    wide = a - b; \
+    SIMD::Axpy(2.0f, a, b); \
+    for (int i = 0; i < 37; i++) { \
+        for (int j = 0; j < N; j++) { \
+            const float value = static_cast<float>((i * N + j) % 64) / 8.0f - 4.0f; \
+            ASSERT_EQ(static_cast<float>(c[i][j]), SIMD::half::ToFloat(SIMD::half::FromFloat(0.25f * value * value + 1.0f + value))); \
+            ASSERT_EQ(static_cast<float>(d[i][j]), SIMD::bfloat16::ToFloat(SIMD::bfloat16::FromFloat(value * (1.0f + value) + 0.25f * value))); \
+            ASSERT_EQ(wide[i][j], 0.75f * value); \
+            ASSERT_EQ(static_cast<float>(b[i][j]), 2.25f * value); \
+        } \
+    } \
+    EXPECT_EQ(SIMD::Sum(a), static_cast<float>(sum)); \
+    EXPECT_EQ(SIMD::Dot(a, x), static_cast<float>(dot)); \
+    SIMD::HalfArray<TYPE, 37> copy(a), moved(std::move(copy)); \
+    EXPECT_EQ(SIMD::Sum(moved), SIMD::Sum(a)); \
+}
+
+#define PACKED_BF16_FLUSHES_DENORMALS(TYPE) false
+TEST_SIMD_PACKED_FLOAT(float256, SIMD::float_256)
+#undef PACKED_BF16_FLUSHES_DENORMALS
+#if defined(AVX512F_AVAILABLE)
+#if defined(AVX512BF16_AVAILABLE)
+#define PACKED_BF16_FLUSHES_DENORMALS(TYPE) true
+#else
+#define PACKED_BF16_FLUSHES_DENORMALS(TYPE) false
+#endif
+TEST_SIMD_PACKED_FLOAT(float512, SIMD::float_512)
+#undef PACKED_BF16_FLUSHES_DENORMALS
+#endif
+
+// AXPY on half storage against BM_SIMD_float256_Axpy_1000000, half the bytes move through memory
+static void BM_SIMD_half256_Axpy_1000000(benchmark::State& state) {
+    SIMD::HalfArray<SIMD::float_256, 1000000> x, y;
+    for (int i = 0; i < 1000000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            x[i][j] = 1.0f; y[i][j] = 0.0f;
+        }
+    }
+    for (auto _ : state) {
+        SIMD::Axpy(0.5f, x, y);
+        benchmark::DoNotOptimize(y);
+    }
+}
+BENCHMARK(BM_SIMD_half256_Axpy_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_half256_Axpy_1000000(benchmark::State& state) {
+    std::vector<SIMD::half> x(1000000 * SIMD::float_256::ElementCount, SIMD::half(1.0f));
+    std::vector<SIMD::half> y(1000000 * SIMD::float_256::ElementCount, SIMD::half(0.0f));
+    for (auto _ : state) {
+        for (size_t i = 0; i < x.size(); i++) {
+            y[i] = SIMD::half(0.5f * x[i] + y[i]);
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+}
+BENCHMARK(BM_Plain_half256_Axpy_1000000)->Unit(benchmark::kMillisecond);
+
+// Masked arithmetic, memory access and Compress/Expand against lane loops. Masks come from comparisons of random
+// lanes, divisors are 0 in the inactive lanes, and a guard element behind every buffer must stay untouched.
+#define TEST_SIMD_MASKED(TYPE_NAME, TYPE, ELEMENT) \
+TEST(SIMDMaskedTest, TYPE_NAME##_Masked_Operations) { \
+    typedef ELEMENT E; \
+    constexpr unsigned int N = TYPE::ElementCount; \
+    const E low = std::is_signed<E>::value ? E(-100) : E(0); \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int> dist(0, 100); \
+    for (unsigned int count = 0; count <= N + 1; count++) { \
+        const auto mask = TYPE::FirstN(count); \
+        ASSERT_EQ(TYPE::CountTrue(mask), std::min(count, N)); \
+        const TYPE selected = TYPE::Select(mask, TYPE::Broadcast(E(1)), TYPE::Broadcast(E(0))); \
+        for (unsigned int j = 0; j < N; j++) { \
+            ASSERT_EQ(selected.Data[j], E(j < count ? 1 : 0)); \
+        } \
+    } \
+    for (int round = 0; round < 200; round++) { \
+        TYPE a, b, src, limit; \
+        for (unsigned int j = 0; j < N; j++) { \
+            a.Data[j] = static_cast<E>(low + dist(rng)); \
+            b.Data[j] = static_cast<E>(1 + dist(rng)); \
+            src.Data[j] = static_cast<E>(dist(rng)); \
+            limit.Data[j] = static_cast<E>(low + 50); \
+        } \
+        const auto mask = TYPE::CompareGt(a, limit); \
+        const TYPE divisor = TYPE::Select(mask, b, TYPE::Broadcast(E(0))); \
+        const TYPE sum = TYPE::MaskedAdd(mask, src, a, b); \
+        const TYPE difference = TYPE::MaskedSubtract(mask, src, a, b); \
+        const TYPE quotient = TYPE::MaskedDivide(mask, src, a, divisor); \
+        E memory[N + 2]; \
+        for (unsigned int j = 0; j < N + 2; j++) memory[j] = static_cast<E>(7); \
+        const TYPE loaded = TYPE::MaskedLoad(mask, a.Data); \
+        a.MaskedStore(mask, memory + 1); \
+        const TYPE compressed = TYPE::Compress(mask, a); \
+        const TYPE expanded = TYPE::Expand(mask, compressed); \
+        E packed[N + 1]; \
+        for (unsigned int j = 0; j < N + 1; j++) packed[j] = static_cast<E>(7); \
+        const unsigned int written = a.CompressStore(mask, packed); \
+        unsigned int active = 0; \
+        for (unsigned int j = 0; j < N; j++) { \
+            const bool on = a.Data[j] > limit.Data[j]; \
+            ASSERT_EQ(sum.Data[j], on ? static_cast<E>(a.Data[j] + b.Data[j]) : src.Data[j]); \
+            ASSERT_EQ(difference.Data[j], on ? static_cast<E>(a.Data[j] - b.Data[j]) : src.Data[j]); \
+            ASSERT_EQ(quotient.Data[j], on ? static_cast<E>(a.Data[j] / b.Data[j]) : src.Data[j]); \
+            ASSERT_EQ(loaded.Data[j], on ? a.Data[j] : E(0)); \
+            ASSERT_EQ(memory[j + 1], on ? a.Data[j] : E(7)); \
+            ASSERT_EQ(expanded.Data[j], on ? a.Data[j] : E(0)); \
+            if (on) { \
+                ASSERT_EQ(compressed.Data[active], a.Data[j]); \
+                ASSERT_EQ(packed[active], a.Data[j]); \
+                active++; \
+            } \
+        } \
+        ASSERT_EQ(written, active); \
+        for (unsigned int j = active; j < N; j++) ASSERT_EQ(compressed.Data[j], E(0)); \
+        ASSERT_EQ(packed[active], E(7)); \
+        ASSERT_EQ(memory[0], E(7)); \
+        ASSERT_EQ(memory[N + 1], E(7)); \
+    } \
+}
+
+TEST_SIMD_MASKED(int128_with_int32_t, SIMD::int_128<int32_t>, int32_t)
+TEST_SIMD_MASKED(int128_with_uint64_t, SIMD::int_128<uint64_t>, uint64_t)
+TEST_SIMD_MASKED(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_MASKED(int256_with_uint16_t, SIMD::int_256<uint16_t>, uint16_t)
+TEST_SIMD_MASKED(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+TEST_SIMD_MASKED(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+TEST_SIMD_MASKED(int256_with_int64_t, SIMD::int_256<int64_t>, int64_t)
+TEST_SIMD_MASKED(float256, SIMD::float_256, float)
+TEST_SIMD_MASKED(double256, SIMD::double_256, double)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_MASKED(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_MASKED(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+#endif
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_MASKED(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+TEST_SIMD_MASKED(int512_with_uint64_t, SIMD::int_512<uint64_t>, uint64_t)
+TEST_SIMD_MASKED(float512, SIMD::float_512, float)
+TEST_SIMD_MASKED(double512, SIMD::double_512, double)
+#endif
+
+// Multiply where the type has one, and a loop whose tail runs under FirstN instead of a scalar epilogue
+#define TEST_SIMD_MASKED_TAIL(TYPE_NAME, TYPE, ELEMENT) \
+TEST(SIMDMaskedTest, TYPE_NAME##_Multiply_and_Loop_Tail) { \
+    typedef ELEMENT E; \
+    constexpr unsigned int N = TYPE::ElementCount; \
+    TYPE a, b, src; \
+    for (unsigned int j = 0; j < N; j++) { \
+        a.Data[j] = static_cast<E>(j + 1); b.Data[j] = static_cast<E>(3); src.Data[j] = static_cast<E>(-1); \
+    } \
+    const TYPE product = TYPE::MaskedMultiply(TYPE::FirstN(N / 2), src, a, b); \
+    for (unsigned int j = 0; j < N; j++) { \
+        ASSERT_EQ(product.Data[j], j < N / 2 ? static_cast<E>(3 * (j + 1)) : static_cast<E>(-1)); \
+    } \
+    for (unsigned int length = 0; length <= 3 * N; length++) { \
+        std::vector<E> x(length), y(length); \
+        E expected = 0; \
+        for (unsigned int i = 0; i < length; i++) { \
+            x[i] = static_cast<E>(i % 7); y[i] = static_cast<E>(i % 5); \
+            expected = static_cast<E>(expected + x[i] * y[i]); \
+        } \
+        TYPE acc; \
+        for (unsigned int i = 0; i < length; i += N) { \
+            const auto mask = TYPE::FirstN(length - i); \
+            const TYPE xv = TYPE::MaskedLoad(mask, x.data() + i); \
+            const TYPE yv = TYPE::MaskedLoad(mask, y.data() + i); \
+            acc = TYPE::MaskedAdd(mask, acc, acc, TYPE::Multiply(xv, yv)); \
+            TYPE::MaskedAdd(mask, xv, xv, yv).MaskedStore(mask, x.data() + i); \
+        } \
+        ASSERT_EQ(static_cast<E>(TYPE::ReduceSum(acc)), expected); \
+        for (unsigned int i = 0; i < length; i++) { \
+            ASSERT_EQ(x[i], static_cast<E>(i % 7 + i % 5)); \
+        } \
+    } \
+}
+
+TEST_SIMD_MASKED_TAIL(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_MASKED_TAIL(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+TEST_SIMD_MASKED_TAIL(float256, SIMD::float_256, float)
+TEST_SIMD_MASKED_TAIL(double256, SIMD::double_256, double)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_MASKED_TAIL(int512_with_int16_t, SIMD::int_512<int16_t>, int16_t)
+#endif
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_MASKED_TAIL(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+TEST_SIMD_MASKED_TAIL(float512, SIMD::float_512, float)
+TEST_SIMD_MASKED_TAIL(double512, SIMD::double_512, double)
+#endif
+
+// Stream filtering, the positive lanes of 8M floats are packed into an output buffer with CompressStore
+#define BENCHMARK_FILTER_SETUP(ARRAY_SIZE) \
+    const size_t size = static_cast<size_t>(ARRAY_SIZE) * 8; \
+    auto input = AlignedMemory::make_aligned<float>(size, 64); \
+    std::vector<float> output(size + 16); \
+    std::mt19937 rng(42); \
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f); \
+    for (size_t i = 0; i < size; i++) input.get()[i] = dist(rng);
+
+#define BENCHMARK_SIMD_FILTER(TYPE_NAME, TYPE) \
+static void BM_SIMD_##TYPE_NAME##_Filter_1000000(benchmark::State& state) { \
+    BENCHMARK_FILTER_SETUP(1000000) \
+    const TYPE zero = TYPE::Broadcast(0.0f); \
+    for (auto _ : state) { \
+        size_t written = 0; \
+        for (size_t i = 0; i < size; i += TYPE::ElementCount) { \
+            const TYPE v = TYPE::Load(input.get() + i); \
+            written += v.CompressStore(TYPE::CompareGt(v, zero), output.data() + written); \
+        } \
+        benchmark::DoNotOptimize(written); \
+    } \
+} \
+BENCHMARK(BM_SIMD_##TYPE_NAME##_Filter_1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_SIMD_FILTER(float256, SIMD::float_256)
+#if defined(AVX512F_AVAILABLE)
+BENCHMARK_SIMD_FILTER(float512, SIMD::float_512)
+#endif
+
+static void BM_Plain_float256_Filter_1000000(benchmark::State& state) {
+    BENCHMARK_FILTER_SETUP(1000000)
+    for (auto _ : state) {
+        size_t written = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (input.get()[i] > 0.0f) output[written++] = input.get()[i];
+        }
+        benchmark::DoNotOptimize(written);
+    }
+}
+BENCHMARK(BM_Plain_float256_Filter_1000000)->Unit(benchmark::kMillisecond);
+
+// LoadUnaligned and StoreUnaligned at every element offset of an aligned buffer
+#define TEST_SIMD_UNALIGNED(TYPE_NAME, TYPE, ELEMENT) \
+TEST(SIMDUnalignedTest, TYPE_NAME##_Load_and_Store) { \
+    typedef ELEMENT E; \
+    constexpr unsigned int N = TYPE::ElementCount; \
+    alignas(64) E buffer[3 * N]; \
+    for (unsigned int offset = 0; offset <= N; offset++) { \
+        for (unsigned int j = 0; j < 3 * N; j++) buffer[j] = static_cast<E>(j); \
+        const TYPE v = TYPE::LoadUnaligned(buffer + offset); \
+        for (unsigned int j = 0; j < N; j++) ASSERT_EQ(v.Data[j], static_cast<E>(offset + j)); \
+        TYPE::Add(v, TYPE::Broadcast(E(100))).StoreUnaligned(buffer + offset + 1); \
+        for (unsigned int j = 0; j < 3 * N; j++) { \
+            const bool stored = j > offset && j <= offset + N; \
+            ASSERT_EQ(buffer[j], static_cast<E>(stored ? j + 99 : j)) << offset; \
+        } \
+    } \
+}
+
+TEST_SIMD_UNALIGNED(int128_with_int16_t, SIMD::int_128<int16_t>, int16_t)
+TEST_SIMD_UNALIGNED(int256_with_int8_t, SIMD::int_256<int8_t>, int8_t)
+TEST_SIMD_UNALIGNED(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+TEST_SIMD_UNALIGNED(float256, SIMD::float_256, float)
+TEST_SIMD_UNALIGNED(double256, SIMD::double_256, double)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_UNALIGNED(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+TEST_SIMD_UNALIGNED(float512, SIMD::float_512, float)
+#endif
+
+// Three pointer kernels with every combination of element offsets, so the peeled head, the aligned body and the
+// tail all see operands that are misaligned against each other. The elements around the output must stay as they were.
+#define TEST_SIMD_UNALIGNED_DISPATCH(ELEMENT_TYPE) \
+TEST(SIMDUnalignedTest, ELEMENT_TYPE##_Dispatch_Any_Pointer) { \
+    typedef ELEMENT_TYPE E; \
+    const InstructionSet levels[] = { InstructionSet::NONE, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 }; \
+    for (InstructionSet level : levels) { \
+        if (SIMD::Dispatch::Dispatcher::Set(level) != level) { \
+            continue; \
+        } \
+        for (size_t to_offset = 0; to_offset < 4; to_offset++) { \
+            for (size_t a_offset = 0; a_offset < 4; a_offset++) { \
+                for (size_t b_offset : { size_t(0), size_t(3) }) { \
+                    std::vector<E> to(260, E(9)), a(260), b(260); \
+                    for (size_t i = 0; i < 260; i++) { \
+                        a[i] = static_cast<E>(i % 50); \
+                        b[i] = static_cast<E>(i % 7 + 1); \
+                    } \
+                    const size_t count = 251; \
+                    SIMD::Dispatch::Add(to.data() + to_offset, a.data() + a_offset, b.data() + b_offset, count); \
+                    for (size_t i = 0; i < 260; i++) { \
+                        const bool inside = i >= to_offset && i < to_offset + count; \
+                        const size_t k = i - to_offset; \
+                        ASSERT_EQ(to[i], inside ? static_cast<E>(a[k + a_offset] + b[k + b_offset]) : E(9)) \
+                            << "level " << static_cast<int>(level) << " offsets " << to_offset << " " << a_offset << " " << b_offset; \
+                    } \
+                    SIMD::Dispatch::Multiply(to.data() + to_offset, b.data() + b_offset, count); \
+                    SIMD::Dispatch::Subtract(to.data() + to_offset, to.data() + to_offset, a.data() + a_offset, count); \
+                    for (size_t k = 0; k < count; k++) { \
+                        const E x = a[k + a_offset], y = b[k + b_offset]; \
+                        ASSERT_EQ(to[k + to_offset], static_cast<E>(static_cast<E>(static_cast<E>(x + y) * y) - x)); \
+                    } \
+                } \
+            } \
+        } \
+    } \
+    SIMD::Dispatch::Dispatcher::Reset(); \
+}
+
+TEST_SIMD_UNALIGNED_DISPATCH(int16_t)
+TEST_SIMD_UNALIGNED_DISPATCH(int32_t)
+TEST_SIMD_UNALIGNED_DISPATCH(float)
+TEST_SIMD_UNALIGNED_DISPATCH(double)
+
+TEST(SIMDUnalignedTest, Streaming_Three_Pointers) {
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::NonTemporal);
+    std::vector<float> to(1003, 1.0f), a(1003, 2.0f), b(1003, 3.0f);
+    SIMD::Dispatch::Multiply(to.data() + 1, a.data() + 2, b.data(), 1001);
+    SIMD::Dispatch::Divide(to.data() + 1, to.data() + 1, a.data() + 1, 1001);
+    SIMD::Dispatch::Dispatcher::SetStoreMode(SIMD::Dispatch::StoreMode::Temporal);
+    for (size_t i = 0; i < to.size(); i++) {
+        ASSERT_EQ(to[i], (i >= 1 && i < 1002) ? 3.0f : 1.0f);
+    }
+}
+
+// Sum of two buffers that start at odd element offsets, e.g. fields of received packets, into a third one
+#define BENCHMARK_UNALIGNED_SETUP(ARRAY_SIZE) \
+    std::vector<float> a(ARRAY_SIZE * 8 + 8, 1.0f), b(ARRAY_SIZE * 8 + 8, 2.0f), to(ARRAY_SIZE * 8 + 8); \
+    const size_t count = static_cast<size_t>(ARRAY_SIZE) * 8;
+
+static void BM_SIMD_float256_UnalignedAdd_1000000(benchmark::State& state) {
+    BENCHMARK_UNALIGNED_SETUP(1000000)
+    for (auto _ : state) {
+        SIMD::Dispatch::Add(to.data() + 1, a.data() + 3, b.data() + 5, count);
+        benchmark::DoNotOptimize(to.data());
+    }
+}
+BENCHMARK(BM_SIMD_float256_UnalignedAdd_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_float256_UnalignedAdd_1000000(benchmark::State& state) {
+    BENCHMARK_UNALIGNED_SETUP(1000000)
+    for (auto _ : state) {
+        float* out = to.data() + 1;
+        const float* x = a.data() + 3;
+        const float* y = b.data() + 5;
+        for (size_t i = 0; i < count; i++) {
+            out[i] = x[i] + y[i];
+        }
+        benchmark::DoNotOptimize(to.data());
+    }
+}
+BENCHMARK(BM_Plain_float256_UnalignedAdd_1000000)->Unit(benchmark::kMillisecond);
+
+// Views over std::vector memory at an odd element offset, the size leaves a partial register at the end
+#define TEST_SIMD_ARRAY_VIEW(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDArrayViewTest, TYPE_NAME##_Operators_In_Place) \
+{ \
+    const size_t size = 100 * SIMD_TYPE::ElementCount + SIMD_TYPE::ElementCount / 2 + 1; \
+    std::vector<ELEMENT_TYPE> a(size + 1), b(size + 3), expected(size); \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<int> dist(1, 100); \
+    for (size_t i = 0; i < size; i++) \
+    { \
+        a[i + 1] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+        b[i + 3] = static_cast<ELEMENT_TYPE>(dist(rng)); \
+    } \
+    SIMD::ArrayView<SIMD_TYPE> x(a.data() + 1, size); \
+    const SIMD::ArrayView<SIMD_TYPE> y = SIMD::ArrayView<SIMD_TYPE>(b).Subview(3, size); \
+    for (size_t i = 0; i < size; i++) expected[i] = static_cast<ELEMENT_TYPE>((x[i] + y[i]) * y[i] - y[i]); \
+    x += y; \
+    x *= y; \
+    x -= y; \
+    for (size_t i = 0; i < size; i++) ASSERT_EQ(x[i], expected[i]) << "index " << i; \
+    for (size_t i = 0; i < size; i++) expected[i] = static_cast<ELEMENT_TYPE>(expected[i] / y[i]); \
+    x /= y; \
+    for (size_t i = 0; i < size; i++) ASSERT_EQ(x[i], expected[i]) << "index " << i; \
+    ELEMENT_TYPE sum = 0, dot = 0; \
+    for (size_t i = 0; i < size; i++) \
+    { \
+        sum += x[i]; \
+        dot += x[i] * y[i]; \
+    } \
+    EXPECT_NEAR(static_cast<double>(x.Sum()), static_cast<double>(sum), 1e-5 * static_cast<double>(sum)); \
+    EXPECT_NEAR(static_cast<double>(x.Dot(y)), static_cast<double>(dot), 1e-5 * static_cast<double>(dot)); \
+    EXPECT_EQ(a[0], ELEMENT_TYPE(0)); \
+    EXPECT_THROW(x += y.Subview(1, size - 1), std::runtime_error); \
+}
+
+TEST_SIMD_ARRAY_VIEW(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+TEST_SIMD_ARRAY_VIEW(float256, SIMD::float_256, float)
+TEST_SIMD_ARRAY_VIEW(double256, SIMD::double_256, double)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_ARRAY_VIEW(int512_with_int64_t, SIMD::int_512<int64_t>, int64_t)
+TEST_SIMD_ARRAY_VIEW(float512, SIMD::float_512, float)
+#endif
+
+TEST(SIMDArrayViewTest, Integer_Logic_Shifts_And_Narrow_Sum) {
+    std::vector<uint16_t> a(1001), b(1001);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<uint16_t>(i * 37);
+        b[i] = static_cast<uint16_t>(i * 11 + 5);
+    }
+    std::vector<uint16_t> original = a;
+    SIMD::ArrayView<SIMD::int_256<uint16_t> > x(a.data() + 1, 999);
+    const SIMD::ArrayView<SIMD::int_256<uint16_t> > y(b.data(), 999);
+    x ^= y;
+    x &= y;
+    x |= y;
+    x <<= 3;
+    x >>= 1;
+    x /= SIMD::Divider<SIMD::int_256<uint16_t> >(7);
+    uint32_t sum = 0;
+    for (size_t i = 0; i < 999; i++) {
+        const uint16_t value = static_cast<uint16_t>(static_cast<uint16_t>(static_cast<uint16_t>(((original[i + 1] ^ b[i]) & b[i]) | b[i]) << 3) >> 1);
+        ASSERT_EQ(x[i], value / 7) << "index " << i;
+        sum += value / 7;
+    }
+    EXPECT_EQ(x.Sum(), sum);
+    EXPECT_EQ(a[0], original[0]);
+    EXPECT_EQ(a[1000], original[1000]);
+}
+
+// Read only memory goes through a ConstArrayView, which has the reductions and mixes with writable views
+TEST(SIMDArrayViewTest, Const_View_Of_Read_Only_Memory) {
+    const std::vector<float> constant(1001, 2.0f);
+    std::vector<float> values(1001, 3.0f);
+    const SIMD::ConstArrayView<SIMD::float_256> view(constant);
+    SIMD::ArrayView<SIMD::float_256> writable(values);
+    EXPECT_EQ(view.Size(), 1001u);
+    EXPECT_FLOAT_EQ(view.Sum(), 2002.0f);
+    EXPECT_FLOAT_EQ(view.Dot(writable), 6006.0f);
+    EXPECT_FLOAT_EQ(writable.Dot(view), 6006.0f);
+    EXPECT_FLOAT_EQ(view.Subview(1, 999).Sum(), 1998.0f);
+    EXPECT_THROW(view.Subview(2, 1000), std::runtime_error);
+    EXPECT_THROW(view.Dot(view.Subview(1, 1000)), std::runtime_error);
+    writable += view;
+    EXPECT_FLOAT_EQ(values[1000], 5.0f);
+
+    SIMD::Array<SIMD::int_256<int16_t>, 10> array;
+    for (unsigned int i = 0; i < 10; i++) {
+        SIMD::int_256<int16_t>::Broadcast(1000).Store(array[i]);
+    }
+    const SIMD::Array<SIMD::int_256<int16_t>, 10>& readOnly = array;
+    EXPECT_EQ(SIMD::ConstArrayView<SIMD::int_256<int16_t> >(readOnly).Sum(), 160000);
+}
+
+TEST(SIMDArrayViewTest, Converts_From_Owning_Containers) {
+    SIMD::Array<SIMD::float_256, 100> array;
+    SIMD::Vector<SIMD::float_256> vector(800, 2.0f);
+    std::vector<float> plain(800, 3.0f);
+    std::array<float, 800> fixed;
+    fixed.fill(4.0f);
+    for (unsigned int i = 0; i < 100; i++) {
+        SIMD::float_256::Broadcast(1.0f).Store(array[i]);
+    }
+    // Implicit conversions at the call site, the kernel runs on the memory of the owners
+    auto accumulate = [](SIMD::ArrayView<SIMD::float_256> to, SIMD::ArrayView<SIMD::float_256> from) { to += from; };
+    accumulate(array, vector);
+    accumulate(vector, plain);
+    accumulate(plain, fixed);
+    EXPECT_EQ(SIMD::ArrayView<SIMD::float_256>(array).Size(), 800u);
+    EXPECT_FLOAT_EQ(SIMD::ArrayView<SIMD::float_256>(array).Sum(), 800 * 3.0f);
+    EXPECT_FLOAT_EQ(vector[799], 5.0f);
+    EXPECT_FLOAT_EQ(plain[0], 7.0f);
+    EXPECT_FLOAT_EQ(fixed[0], 4.0f);
+    EXPECT_THROW(SIMD::ArrayView<SIMD::float_256>(plain).Subview(2, 799), std::runtime_error);
+}
+
+// In place work on a received buffer: the view runs on it directly, the Array needs a copy in and out
+#define BENCHMARK_ARRAY_VIEW_SETUP(ARRAY_SIZE) \
+    std::vector<float> buffer(ARRAY_SIZE * 8 + 1, 1.0f), gain(ARRAY_SIZE * 8 + 1, 0.5f); \
+    const size_t count = static_cast<size_t>(ARRAY_SIZE) * 8;
+
+static void BM_SIMD_float256_ViewMultiply_1000000(benchmark::State& state) {
+    BENCHMARK_ARRAY_VIEW_SETUP(1000000)
+    SIMD::ArrayView<SIMD::float_256> x(buffer.data() + 1, count);
+    const SIMD::ArrayView<SIMD::float_256> y(gain.data() + 1, count);
+    for (auto _ : state) {
+        x *= y;
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+BENCHMARK(BM_SIMD_float256_ViewMultiply_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_float256_CopyMultiply_1000000(benchmark::State& state) {
+    BENCHMARK_ARRAY_VIEW_SETUP(1000000)
+    SIMD::Array<SIMD::float_256, 1000000> x, y;
+    memcpy(y[0], gain.data() + 1, count * sizeof(float));
+    for (auto _ : state) {
+        memcpy(x[0], buffer.data() + 1, count * sizeof(float));
+        x *= y;
+        memcpy(buffer.data() + 1, x[0], count * sizeof(float));
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+BENCHMARK(BM_SIMD_float256_CopyMultiply_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_float256_ViewMultiply_1000000(benchmark::State& state) {
+    BENCHMARK_ARRAY_VIEW_SETUP(1000000)
+    for (auto _ : state) {
+        float* x = buffer.data() + 1;
+        const float* y = gain.data() + 1;
+        for (size_t i = 0; i < count; i++) {
+            x[i] *= y[i];
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+BENCHMARK(BM_Plain_float256_ViewMultiply_1000000)->Unit(benchmark::kMillisecond);
+
+TEST(SIMDMappedTest, float256_Round_Trip_And_Expressions) {
+    const std::string path = "simd_mapped_float256.bin";
+    SIMD::Array<SIMD::float_256, 1000> a, result;
+    for (unsigned int i = 0; i < 1000; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            a[i][j] = static_cast<float>(i * SIMD::float_256::ElementCount + j);
+        }
+    }
+    SIMD::SaveMapped(path, a);
+    {
+        const SIMD::MappedArray<SIMD::float_256, 1000> mapped(path);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped[0]) % SIMD::MappedHeader::PageAlignment, 0u);
+        result = mapped * a + mapped;
+        for (unsigned int i = 0; i < 1000; i++) {
+            for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+                ASSERT_EQ(mapped[i][j], a[i][j]);
+                ASSERT_EQ(result[i][j], a[i][j] * a[i][j] + a[i][j]);
+            }
+        }
+        EXPECT_FLOAT_EQ(SIMD::Sum(mapped), SIMD::Sum(a));
+        EXPECT_FLOAT_EQ(SIMD::Dot(mapped, a), SIMD::Dot(a, a));
+    }
+    {
+        // Copy on write changes stay in the process, the next mapping sees the saved values
+        SIMD::MappedArray<SIMD::float_256, 1000> copy(path, SIMD::MapMode::CopyOnWrite);
+        copy += a;
+        EXPECT_EQ(copy[999][7], 2.0f * a[999][7]);
+        SIMD::MappedArray<SIMD::float_256, 1000> readOnly(path);
+        EXPECT_EQ(readOnly[999][7], a[999][7]);
+        EXPECT_THROW(readOnly += a, std::runtime_error);
+        // Read only mappings are viewed through a ConstArrayView, copy on write mappings through an ArrayView too
+        const SIMD::ConstArrayView<SIMD::float_256> view = readOnly;
+        EXPECT_FLOAT_EQ(view.Sum(), SIMD::Sum(a));
+        EXPECT_THROW(static_cast<SIMD::ArrayView<SIMD::float_256> >(readOnly), std::runtime_error);
+        SIMD::ArrayView<SIMD::float_256> writable = copy;
+        writable -= view;
+        EXPECT_EQ(copy[999][7], a[999][7]);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(SIMDMappedTest, Header_Mismatches_Are_Rejected) {
+    const std::string path = "simd_mapped_uint8.bin";
+    SIMD::Array<SIMD::int_256<uint8_t>, 10> a;
+    for (unsigned int i = 0; i < 10; i++) {
+        SIMD::int_256<uint8_t>::Broadcast(static_cast<uint8_t>(200)).Store(a[i]);
+    }
+    SIMD::SaveMapped(path, a);
+    const SIMD::MappedArray<SIMD::int_256<uint8_t>, 10> mapped(path);
+    EXPECT_EQ(SIMD::Sum(mapped), 200u * 32u * 10u);
+    typedef SIMD::MappedArray<SIMD::int_256<int8_t>, 10> WrongSign;
+    typedef SIMD::MappedArray<SIMD::int_128<uint8_t>, 20> WrongWidth;
+    typedef SIMD::MappedArray<SIMD::int_256<uint8_t>, 11> WrongLength;
+    typedef SIMD::MappedArray<SIMD::int_256<uint8_t>, 10> Missing;
+    EXPECT_THROW(WrongSign(path.c_str()), std::runtime_error);
+    EXPECT_THROW(WrongWidth(path.c_str()), std::runtime_error);
+    EXPECT_THROW(WrongLength(path.c_str()), std::runtime_error);
+    EXPECT_THROW(Missing("simd_mapped_missing.bin"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+// Start up cost of a 32 MiB column: mapping against reading the file into make_aligned memory. The file is dropped
+// from the page cache before every iteration on Linux, so both variants start cold.
+#define BENCHMARK_MAPPED_SETUP(ARRAY_SIZE) \
+    const std::string path = "simd_mapped_benchmark.bin"; \
+    { \
+        SIMD::Array<SIMD::float_256, ARRAY_SIZE> column; \
+        for (unsigned int i = 0; i < ARRAY_SIZE; i++) SIMD::float_256::Broadcast(1.0f).Store(column[i]); \
+        SIMD::SaveMapped(path, column); \
+    }
+
+static void DropFromPageCache(benchmark::State& state, const std::string& path) {
+    state.PauseTiming();
+#if defined(__linux__)
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file >= 0) {
+        posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+        close(file);
+    }
+#endif
+    state.ResumeTiming();
+}
+
+static void BM_SIMD_float256_MappedOpen_1000000(benchmark::State& state) {
+    BENCHMARK_MAPPED_SETUP(1000000)
+    for (auto _ : state) {
+        DropFromPageCache(state, path);
+        SIMD::MappedArray<SIMD::float_256, 1000000> mapped(path);
+        benchmark::DoNotOptimize(mapped[0]);
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SIMD_float256_MappedOpen_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_float256_MappedSum_1000000(benchmark::State& state) {
+    BENCHMARK_MAPPED_SETUP(1000000)
+    for (auto _ : state) {
+        DropFromPageCache(state, path);
+        SIMD::MappedArray<SIMD::float_256, 1000000> mapped(path);
+        benchmark::DoNotOptimize(SIMD::Sum(mapped));
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SIMD_float256_MappedSum_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_float256_ReadSum_1000000(benchmark::State& state) {
+    BENCHMARK_MAPPED_SETUP(1000000)
+    const size_t count = static_cast<size_t>(1000000) * SIMD::float_256::ElementCount;
+    for (auto _ : state) {
+        DropFromPageCache(state, path);
+        AlignedMemory::AlignedPtr<float> column = AlignedMemory::make_aligned<float>(count, SIMD::float_256::Alignment);
+        FILE* file = fopen(path.c_str(), "rb");
+        fseek(file, static_cast<long>(SIMD::MappedHeader::PageAlignment), SEEK_SET);
+        const size_t read = fread(column.get(), sizeof(float), count, file);
+        fclose(file);
+        benchmark::DoNotOptimize(read);
+        benchmark::DoNotOptimize(SIMD::ArrayView<SIMD::float_256>(column.get(), count).Sum());
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SIMD_float256_ReadSum_1000000)->Unit(benchmark::kMillisecond);
+
+TEST(SIMDAllocatorTest, Pool_Reuses_Aligned_Blocks) {
+    void* first = AlignedMemory::PoolAllocator::Allocate(1000, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0u);
+    AlignedMemory::PoolAllocator::Deallocate(first, 1000, 64);
+    // Same size class (1 KiB), a smaller request with a larger alignment gets the cached block back
+    void* second = AlignedMemory::PoolAllocator::Allocate(600, 512);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 512, 0u);
+    AlignedMemory::PoolAllocator::Deallocate(second, 600, 512);
+
+    const size_t sizes[] = { 1, 64, 65, 4096, 65536, 65537, 3 << 20 };
+    for (size_t size : sizes) {
+        char* block = static_cast<char*>(AlignedMemory::PoolAllocator::Allocate(size, 64));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 64, 0u) << "size " << size;
+        memset(block, 0xAB, size);
+        AlignedMemory::PoolAllocator::Deallocate(block, size, 64);
+    }
+
+    // Blocks cached by a thread are released when it exits
+    std::thread worker([]() {
+        for (int i = 0; i < 200; i++) {
+            SIMD::Array<SIMD::float_256, 8, AlignedMemory::PoolAllocator> temporary;
+            benchmark::DoNotOptimize(temporary[0]);
+        }
+    });
+    worker.join();
+}
+
+TEST(SIMDAllocatorTest, Arrays_With_Pool_And_Huge_Pages) {
+    typedef SIMD::Array<SIMD::float_256, 100000, AlignedMemory::PoolAllocator> LargeArray;
+    typedef SIMD::Array<SIMD::float_256, 100, AlignedMemory::PoolAllocator> SmallArray;
+    LargeArray large;
+#if defined(MADV_HUGEPAGE)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large[0]) % AlignedMemory::HugePageAllocator::HugePageBytes, 0u);
+#endif
+    SmallArray small;
+    SIMD::Array<SIMD::float_256, 100> plain;
+    for (unsigned int i = 0; i < 100; i++) {
+        SIMD::float_256::Broadcast(static_cast<float>(i)).Store(small[i]);
+        SIMD::float_256::Broadcast(1.0f).Store(plain[i]);
+    }
+    SmallArray copy = small;
+    copy += plain;
+    SmallArray moved(std::move(copy));
+    moved = moved * plain + small;
+    for (unsigned int i = 0; i < 100; i++) {
+        ASSERT_FLOAT_EQ(moved[i][7], 2.0f * i + 1.0f);
+    }
+    for (unsigned int i = 0; i < 100000; i++) {
+        SIMD::float_256::Broadcast(1.0f).Store(large[i]);
+    }
+    EXPECT_FLOAT_EQ(SIMD::Sum(large), 800000.0f);
+}
+
+// Short lived arrays, e.g. scratch buffers inside a function, allocated and freed in a loop
+template<typename Allocator>
+static void BenchmarkTemporaries(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int i = 0; i < 1000; i++) {
+            SIMD::Array<SIMD::float_256, 16, Allocator> scratch;
+            benchmark::DoNotOptimize(scratch[0]);
+        }
+    }
+}
+
+static void BM_SIMD_float256_PoolTemporaries_1000(benchmark::State& state) {
+    BenchmarkTemporaries<AlignedMemory::PoolAllocator>(state);
+}
+BENCHMARK(BM_SIMD_float256_PoolTemporaries_1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_SIMD_float256_SystemTemporaries_1000(benchmark::State& state) {
+    BenchmarkTemporaries<AlignedMemory::SystemAllocator>(state);
+}
+BENCHMARK(BM_SIMD_float256_SystemTemporaries_1000)->Unit(benchmark::kMicrosecond);
+
+// Random register reads over 128 MiB, where 4 KiB pages miss the TLB on almost every access
+template<typename Allocator>
+static void BenchmarkRandomReads(benchmark::State& state) {
+    const unsigned int length = 1 << 22;
+    std::unique_ptr<SIMD::Array<SIMD::float_256, 1 << 22, Allocator> > column(new SIMD::Array<SIMD::float_256, 1 << 22, Allocator>());
+    for (unsigned int i = 0; i < length; i++) {
+        SIMD::float_256::Broadcast(1.0f).Store((*column)[i]);
+    }
+    for (auto _ : state) {
+        SIMD::float_256 sum;
+        uint32_t index = 12345;
+        for (int i = 0; i < 1000000; i++) {
+            index = index * 1664525u + 1013904223u;
+            sum += column->Evaluate(index >> 10);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void BM_SIMD_float256_HugePageRandomRead_1000000(benchmark::State& state) {
+    BenchmarkRandomReads<AlignedMemory::HugePageAllocator>(state);
+}
+BENCHMARK(BM_SIMD_float256_HugePageRandomRead_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SIMD_float256_SystemRandomRead_1000000(benchmark::State& state) {
+    BenchmarkRandomReads<AlignedMemory::SystemAllocator>(state);
+}
+BENCHMARK(BM_SIMD_float256_SystemRandomRead_1000000)->Unit(benchmark::kMillisecond);
+
+// Record shuffles against the scalar definition, for every field count up to past the vector limit and counts that
+// leave records after the last whole block
+#define TEST_SIMD_RECORD_SHUFFLE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDStructOfArraysTest, TYPE_NAME##_Records_To_Columns_And_Back) \
+{ \
+    for (unsigned int fields = 1; fields <= 10; fields++) \
+    { \
+        for (size_t count : { size_t(0), size_t(1), size_t(SIMD_TYPE::ElementCount), size_t(5 * SIMD_TYPE::ElementCount + 3) }) \
+        { \
+            std::vector<ELEMENT_TYPE> records(count * fields + 1), back(count * fields + 1, ELEMENT_TYPE(0)); \
+            for (size_t i = 0; i < records.size(); i++) records[i] = static_cast<ELEMENT_TYPE>(i % 113 + 1); \
+            std::vector<std::vector<ELEMENT_TYPE> > columns(fields, std::vector<ELEMENT_TYPE>(count + 1)); \
+            std::vector<ELEMENT_TYPE*> pointers; \
+            for (unsigned int f = 0; f < fields; f++) pointers.push_back(columns[f].data()); \
+            SIMD::RecordsToColumns<SIMD_TYPE>(pointers.data(), records.data() + 1, fields, count); \
+            for (unsigned int f = 0; f < fields; f++) \
+            { \
+                for (size_t j = 0; j < count; j++) \
+                { \
+                    ASSERT_EQ(columns[f][j], records[1 + j * fields + f]) << fields << " fields, record " << j << ", field " << f; \
+                } \
+                ASSERT_EQ(columns[f][count], ELEMENT_TYPE(0)); \
+            } \
+            std::vector<const ELEMENT_TYPE*> sources(pointers.begin(), pointers.end()); \
+            SIMD::ColumnsToRecords<SIMD_TYPE>(back.data() + 1, sources.data(), fields, count); \
+            ASSERT_EQ(back[0], ELEMENT_TYPE(0)); \
+            ASSERT_TRUE(std::equal(back.begin() + 1, back.end(), records.begin() + 1)) << fields << " fields"; \
+        } \
+    } \
+}
+
+TEST_SIMD_RECORD_SHUFFLE(float256, SIMD::float_256, float)
+TEST_SIMD_RECORD_SHUFFLE(double256, SIMD::double_256, double)
+TEST_SIMD_RECORD_SHUFFLE(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_RECORD_SHUFFLE(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_RECORD_SHUFFLE(float512, SIMD::float_512, float)
+TEST_SIMD_RECORD_SHUFFLE(double512, SIMD::double_512, double)
+#endif
+
+TEST(SIMDStructOfArraysTest, Columns_Work_With_Array_Operators) {
+    enum { Open, High, Low, Close };
+    std::vector<double> ticks(4 * 100 * SIMD::double_256::ElementCount);
+    for (size_t i = 0; i < ticks.size() / 4; i++) {
+        ticks[4 * i + Open] = 100.0 + i;
+        ticks[4 * i + High] = 110.0 + i;
+        ticks[4 * i + Low] = 90.0 + i;
+        ticks[4 * i + Close] = 105.0 + i;
+    }
+    SIMD::StructOfArrays<SIMD::double_256, 4, 100> soa;
+    soa.Load(ticks.data());
+    SIMD::Array<SIMD::double_256, 100> range = soa.Get<High>() - soa.Get<Low>();
+    soa[Close] -= soa[Open];
+    EXPECT_DOUBLE_EQ(SIMD::Sum(range), 20.0 * 400);
+    EXPECT_DOUBLE_EQ(SIMD::Sum(soa.Get<Close>()), 5.0 * 400);
+
+    std::vector<double> stored(ticks.size());
+    soa.Store(stored.data());
+    for (size_t i = 0; i < ticks.size() / 4; i++) {
+        ASSERT_EQ(stored[4 * i + High], ticks[4 * i + High]);
+        ASSERT_EQ(stored[4 * i + Close], 5.0);
+    }
+    EXPECT_THROW(soa.Load(ticks.data(), soa.Records + 1), std::runtime_error);
+}
+
+// xyz positions, interleaved records into three columns
+#define BENCHMARK_RECORDS_SETUP(ARRAY_SIZE) \
+    const size_t count = static_cast<size_t>(ARRAY_SIZE) * 8; \
+    std::vector<float> records(count * 3, 1.0f); \
+    SIMD::StructOfArrays<SIMD::float_256, 3, ARRAY_SIZE> soa;
+
+static void BM_SIMD_float256_RecordsToColumns_100000(benchmark::State& state) {
+    BENCHMARK_RECORDS_SETUP(100000)
+    for (auto _ : state) {
+        soa.Load(records.data());
+        benchmark::DoNotOptimize(soa[0][0]);
+    }
+}
+BENCHMARK(BM_SIMD_float256_RecordsToColumns_100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Plain_float256_RecordsToColumns_100000(benchmark::State& state) {
+    BENCHMARK_RECORDS_SETUP(100000)
+    for (auto _ : state) {
+        float* x = soa[0][0];
+        float* y = soa[1][0];
+        float* z = soa[2][0];
+        for (size_t j = 0; j < count; j++) {
+            x[j] = records[3 * j];
+            y[j] = records[3 * j + 1];
+            z[j] = records[3 * j + 2];
+        }
+        benchmark::DoNotOptimize(soa[0][0]);
+    }
+}
+BENCHMARK(BM_Plain_float256_RecordsToColumns_100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_SIMD_float256_ColumnsToRecords_100000(benchmark::State& state) {
+    BENCHMARK_RECORDS_SETUP(100000)
+    for (auto _ : state) {
+        soa.Store(records.data());
+        benchmark::DoNotOptimize(records.data());
+    }
+}
+BENCHMARK(BM_SIMD_float256_ColumnsToRecords_100000)->Unit(benchmark::kMicrosecond);
+
+// MatMul against a naive triple loop. Small integer operands keep every product and sum exact, the shapes cover edge
+// tiles on both sides, K past one KC block, N past one NC panel of every register type and operands inside larger
+// leading dimensions.
+template<typename E>
+static void NaiveMatMul(const E* A, const E* B, E* C, size_t M, size_t N, size_t K, size_t lda, size_t ldb, size_t ldc, bool accumulate)
+{
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            E sum = accumulate ? C[i * ldc + j] : E(0);
+            for (size_t k = 0; k < K; k++) {
+                sum += A[i * lda + k] * B[k * ldb + j];
+            }
+            C[i * ldc + j] = sum;
+        }
+    }
+}
+
+#define TEST_SIMD_MATMUL(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDMatMulTest, TYPE_NAME##_Matches_Naive_Product) \
+{ \
+    const size_t shapes[][3] = { { 1, 1, 1 }, { 7, 5, 3 }, { 37, 29, 71 }, { 64, 64, 64 }, { 100, 33, 300 }, { 3, 200, 257 }, { 5, 8200, 20 } }; \
+    for (const auto& shape : shapes) \
+    { \
+        const size_t M = shape[0], N = shape[1], K = shape[2]; \
+        const size_t lda = K + 3, ldb = N + 1, ldc = N + 5; \
+        std::vector<ELEMENT_TYPE> A(M * lda), B(K * ldb), C(M * ldc), expected(M * ldc); \
+        for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<ELEMENT_TYPE>(static_cast<int>(i * 7 % 13) - 6); \
+        for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<ELEMENT_TYPE>(static_cast<int>(i * 5 % 11) - 5); \
+        for (bool accumulate : { false, true }) \
+        { \
+            for (size_t i = 0; i < C.size(); i++) C[i] = expected[i] = static_cast<ELEMENT_TYPE>(i % 3); \
+            SIMD::MatMul<SIMD_TYPE>(A.data(), B.data(), C.data(), M, N, K, lda, ldb, ldc, accumulate); \
+            NaiveMatMul(A.data(), B.data(), expected.data(), M, N, K, lda, ldb, ldc, accumulate); \
+            ASSERT_TRUE(C == expected) << M << "x" << N << "x" << K << (accumulate ? " accumulated" : ""); \
+        } \
+    } \
+}
+
+TEST_SIMD_MATMUL(float256, SIMD::float_256, float)
+TEST_SIMD_MATMUL(double256, SIMD::double_256, double)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_MATMUL(float512, SIMD::float_512, float)
+TEST_SIMD_MATMUL(double512, SIMD::double_512, double)
+#endif
+
+TEST(SIMDMatMulTest, Threads_Split_Row_Blocks) {
+    const size_t threshold = SIMD::Parallel::Settings::GetThreshold();
+    SIMD::Parallel::Settings::SetThreadCount(3);
+    SIMD::Parallel::Settings::SetThreshold(0);
+
+    const size_t M = 1000, N = 70, K = 300;
+    std::vector<float> A(M * K), B(K * N), C(M * N), expected(M * N);
+    for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(static_cast<int>(i % 9) - 4);
+    for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+    SIMD::MatMul<SIMD::float_256>(A.data(), B.data(), C.data(), M, N, K);
+    NaiveMatMul(A.data(), B.data(), expected.data(), M, N, K, K, N, N, false);
+    EXPECT_TRUE(C == expected);
+
+    // A single row block with two B panels, only the packing of B is split
+    const size_t wideM = 20, wideN = 4200, wideK = 40;
+    std::vector<float> wideB(wideK * wideN), wideC(wideM * wideN), wideExpected(wideM * wideN);
+    for (size_t i = 0; i < wideB.size(); i++) wideB[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+    SIMD::MatMul<SIMD::float_256>(A.data(), wideB.data(), wideC.data(), wideM, wideN, wideK);
+    NaiveMatMul(A.data(), wideB.data(), wideExpected.data(), wideM, wideN, wideK, wideK, wideN, wideN, false);
+    EXPECT_TRUE(wideC == wideExpected);
+
+    SIMD::Parallel::Settings::SetThreadCount(1);
+    SIMD::Parallel::Settings::SetThreshold(threshold);
+}
+
+TEST(SIMDMatMulTest, Empty_Inner_Dimension) {
+    std::vector<double> C(6, 1.0);
+    SIMD::MatMul<SIMD::double_256>(nullptr, nullptr, C.data(), 2, 3, 0, 0, 3, 3, true);
+    EXPECT_EQ(C, std::vector<double>(6, 1.0));
+    SIMD::MatMul<SIMD::double_256>(nullptr, nullptr, C.data(), 2, 3, 0);
+    EXPECT_EQ(C, std::vector<double>(6, 0.0));
+}
+
+// Peak of this core for register type T, in FLOP/s: independent multiply add chains, enough of them to cover the
+// latency of every FMA port, so the loop runs at the issue rate. It is measured once rather than derived from the
+// nominal clock, which turbo and AVX-512 frequency licences make meaningless.
+template<typename T>
+static double MatMulPeak()
+{
+    typedef SIMD::MatMulOps<T> Ops;
+    typedef typename T::ElementType E;
+    const size_t iterations = 20000000;
+    typename Ops::Reg acc[12];
+    for (int c = 0; c < 12; c++) {
+        acc[c] = Ops::Broadcast(E(c));
+    }
+    const typename Ops::Reg a = Ops::Broadcast(E(0.999)), b = Ops::Broadcast(E(0.001));
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        for (int c = 0; c < 12; c++) {
+            acc[c] = Ops::MultiplyAdd(acc[c], a, b);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (int c = 0; c < 12; c++) {
+        benchmark::DoNotOptimize(acc[c]);
+    }
+    return 2.0 * 12 * T::ElementCount * iterations / seconds;
+}
+
+template<typename T>
+static void ReportMatMul(benchmark::State& state, size_t M, size_t N, size_t K)
+{
+    static const double peak = MatMulPeak<T>();
+    const double flops = 2.0 * M * N * K;
+    state.counters["GFLOPS"] = benchmark::Counter(flops / 1e9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["OfPeak"] = benchmark::Counter(flops / peak, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Square and tall skinny (a 64 wide projection of many rows) products, GFLOPS and the fraction of the measured peak
+#define BENCHMARK_MATMUL(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE, NAME, M, N, K) \
+static void BM_SIMD_##TYPE_NAME##_##NAME##_##M(benchmark::State& state) { \
+    std::vector<ELEMENT_TYPE> A(M * K, ELEMENT_TYPE(1)), B(K * N, ELEMENT_TYPE(2)), C(M * N); \
+    for (auto _ : state) { \
+        SIMD::MatMul<SIMD_TYPE>(A.data(), B.data(), C.data(), M, N, K); \
+        benchmark::DoNotOptimize(C.data()); \
+    } \
+    ReportMatMul<SIMD_TYPE>(state, M, N, K); \
+} \
+BENCHMARK(BM_SIMD_##TYPE_NAME##_##NAME##_##M)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MATMUL(float256, SIMD::float_256, float, MatMul, 512, 512, 512)
+BENCHMARK_MATMUL(float256, SIMD::float_256, float, MatMulTallSkinny, 8192, 64, 512)
+BENCHMARK_MATMUL(double256, SIMD::double_256, double, MatMul, 512, 512, 512)
+BENCHMARK_MATMUL(double256, SIMD::double_256, double, MatMulTallSkinny, 8192, 64, 512)
+#if defined(AVX512F_AVAILABLE)
+BENCHMARK_MATMUL(float512, SIMD::float_512, float, MatMul, 512, 512, 512)
+BENCHMARK_MATMUL(float512, SIMD::float_512, float, MatMulTallSkinny, 8192, 64, 512)
+BENCHMARK_MATMUL(double512, SIMD::double_512, double, MatMul, 512, 512, 512)
+BENCHMARK_MATMUL(double512, SIMD::double_512, double, MatMulTallSkinny, 8192, 64, 512)
+#endif
+
+static void BM_Plain_float256_MatMul_512(benchmark::State& state) {
+    const size_t M = 512, N = 512, K = 512;
+    std::vector<float> A(M * K, 1.0f), B(K * N, 2.0f), C(M * N);
+    for (auto _ : state) {
+        std::fill(C.begin(), C.end(), 0.0f);
+        for (size_t i = 0; i < M; i++) {
+            for (size_t k = 0; k < K; k++) {
+                const float a = A[i * K + k];
+                for (size_t j = 0; j < N; j++) {
+                    C[i * N + j] += a * B[k * N + j];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(C.data());
+    }
+    ReportMatMul<SIMD::float_256>(state, M, N, K);
+}
+BENCHMARK(BM_Plain_float256_MatMul_512)->Unit(benchmark::kMillisecond);
+
+// Register tile transposes, every lane gets a distinct value, and full matrices with edges and leading dimensions
+#define TEST_SIMD_TRANSPOSE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDTransposeTest, TYPE_NAME##_Tile_And_Matrix) \
+{ \
+    const unsigned int N = SIMD_TYPE::ElementCount; \
+    std::vector<SIMD_TYPE> tile(N); \
+    for (unsigned int r = 0; r < N; r++) \
+        for (unsigned int c = 0; c < N; c++) tile[r].Data[c] = static_cast<ELEMENT_TYPE>(r * N + c); \
+    SIMD::Transpose(tile.data()); \
+    for (unsigned int r = 0; r < N; r++) \
+        for (unsigned int c = 0; c < N; c++) ASSERT_EQ(tile[r].Data[c], static_cast<ELEMENT_TYPE>(c * N + r)) << r << ", " << c; \
+    const size_t shapes[][2] = { { 1, 1 }, { N, N }, { 3 * N + 1, 2 * N + 5 }, { 9 * N, 2 }, { 5, 9 * N } }; \
+    for (const auto& shape : shapes) \
+    { \
+        const size_t rows = shape[0], columns = shape[1], ldFrom = columns + 3, ldTo = rows + 1; \
+        std::vector<ELEMENT_TYPE> from(rows * ldFrom), to(columns * ldTo, ELEMENT_TYPE(0)); \
+        for (size_t i = 0; i < from.size(); i++) from[i] = static_cast<ELEMENT_TYPE>(i * 7 + 1); \
+        SIMD::Transpose<SIMD_TYPE>(from.data(), rows, columns, ldFrom, to.data(), ldTo); \
+        for (size_t j = 0; j < columns; j++) \
+        { \
+            for (size_t i = 0; i < rows; i++) ASSERT_EQ(to[j * ldTo + i], from[i * ldFrom + j]) << rows << "x" << columns; \
+            ASSERT_EQ(to[j * ldTo + rows], ELEMENT_TYPE(0)); \
+        } \
+    } \
+}
+
+TEST_SIMD_TRANSPOSE(float256, SIMD::float_256, float)
+TEST_SIMD_TRANSPOSE(double256, SIMD::double_256, double)
+TEST_SIMD_TRANSPOSE(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_TRANSPOSE(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_TRANSPOSE(int128_with_int64_t, SIMD::int_128<int64_t>, int64_t)
+TEST_SIMD_TRANSPOSE(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_TRANSPOSE(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_TRANSPOSE(int256_with_int32_t, SIMD::int_256<int32_t>, int32_t)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_TRANSPOSE(float512, SIMD::float_512, float)
+TEST_SIMD_TRANSPOSE(double512, SIMD::double_512, double)
+TEST_SIMD_TRANSPOSE(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_TRANSPOSE(int512_with_int16_t, SIMD::int_512<int16_t>, int16_t)
+#endif
+
+TEST(SIMDTransposeTest, Arrays_Hold_Dense_Matrices) {
+    SIMD::Array<SIMD::float_256, 12> image, rotated;
+    for (int i = 0; i < 12 * 8; i++) image[0][i] = static_cast<float>(i);
+    SIMD::Transpose(image, rotated, 8, 12);
+    for (int i = 0; i < 8; i++)
+        for (int j = 0; j < 12; j++) ASSERT_EQ(rotated[0][j * 8 + i], image[0][i * 12 + j]);
+    EXPECT_THROW(SIMD::Transpose(image, rotated, 10, 10), std::runtime_error);
+    EXPECT_THROW(SIMD::Transpose(image, image, 8, 12), std::runtime_error);
+}
+
+#define BENCHMARK_TRANSPOSE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE, SIZE) \
+static void BM_SIMD_##TYPE_NAME##_Transpose_##SIZE(benchmark::State& state) { \
+    std::vector<ELEMENT_TYPE> from(SIZE * SIZE, ELEMENT_TYPE(1)), to(SIZE * SIZE); \
+    for (auto _ : state) { \
+        SIMD::Transpose<SIMD_TYPE>(from.data(), SIZE, SIZE, to.data()); \
+        benchmark::DoNotOptimize(to.data()); \
+    } \
+} \
+BENCHMARK(BM_SIMD_##TYPE_NAME##_Transpose_##SIZE)->Unit(benchmark::kMicrosecond); \
+static void BM_Plain_##TYPE_NAME##_Transpose_##SIZE(benchmark::State& state) { \
+    std::vector<ELEMENT_TYPE> from(SIZE * SIZE, ELEMENT_TYPE(1)), to(SIZE * SIZE); \
+    for (auto _ : state) { \
+        for (size_t i = 0; i < SIZE; i++) \
+            for (size_t j = 0; j < SIZE; j++) to[j * SIZE + i] = from[i * SIZE + j]; \
+        benchmark::DoNotOptimize(to.data()); \
+    } \
+} \
+BENCHMARK(BM_Plain_##TYPE_NAME##_Transpose_##SIZE)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TRANSPOSE(float256, SIMD::float_256, float, 64)
+BENCHMARK_TRANSPOSE(float256, SIMD::float_256, float, 512)
+BENCHMARK_TRANSPOSE(float256, SIMD::float_256, float, 1000)
+BENCHMARK_TRANSPOSE(float256, SIMD::float_256, float, 4096)
+BENCHMARK_TRANSPOSE(double256, SIMD::double_256, double, 1000)
+BENCHMARK_TRANSPOSE(double256, SIMD::double_256, double, 2000)
+BENCHMARK_TRANSPOSE(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t, 1024)
+
+// Lane wise comparisons against the scalar operators, half of the lanes are made equal and floating lanes get NaNs
+#define TEST_SIMD_COMPARE_LANES(SIMD_TYPE, OP_NAME, OPERATOR) \
+    { \
+        const SIMD_TYPE::MaskType mask = SIMD_TYPE::Compare##OP_NAME(a, b); \
+        const SIMD_TYPE lanes = SIMD_TYPE::Select(mask, SIMD_TYPE::Broadcast(1), SIMD_TYPE::Broadcast(0)); \
+        unsigned int count = 0; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            const bool expected = a.Data[j] OPERATOR b.Data[j]; \
+            count += expected; \
+            ASSERT_EQ(lanes.Data[j], expected ? 1 : 0) << #OP_NAME << " lane " << j; \
+        } \
+        EXPECT_EQ(SIMD_TYPE::CountTrue(mask), count); \
+        EXPECT_EQ(SIMD_TYPE::Any(mask), count != 0); \
+        EXPECT_EQ(SIMD_TYPE::All(mask), count == SIMD_TYPE::ElementCount); \
+    }
+
+#define TEST_SIMD_COMPARE(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDCompareTest, TYPE_NAME##_Compare_and_Select) \
+{ \
+    std::mt19937 rng(42); \
+    std::uniform_int_distribution<uint64_t> dist; \
+    const ELEMENT_TYPE edges[] = { std::numeric_limits<ELEMENT_TYPE>::lowest(), std::numeric_limits<ELEMENT_TYPE>::max(), 0 }; \
+    for (int n = 0; n < 200; n++) { \
+        SIMD_TYPE a, b; \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            a.Data[j] = (rng() % 4 == 0) ? edges[rng() % 3] : static_cast<ELEMENT_TYPE>(dist(rng)); \
+            b.Data[j] = (rng() % 2 == 0) ? a.Data[j] : static_cast<ELEMENT_TYPE>(dist(rng)); \
+            if (std::numeric_limits<ELEMENT_TYPE>::has_quiet_NaN && rng() % 8 == 0) { \
+                b.Data[j] = std::numeric_limits<ELEMENT_TYPE>::quiet_NaN(); \
+            } \
+        } \
+        if (n == 0) { b = a; } \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Eq, ==) \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Ne, !=) \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Lt, <) \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Gt, >) \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Le, <=) \
+        TEST_SIMD_COMPARE_LANES(SIMD_TYPE, Ge, >=) \
+        const SIMD_TYPE selected = SIMD_TYPE::Select(SIMD_TYPE::CompareGt(a, b), a, b); \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            const ELEMENT_TYPE expected = a.Data[j] > b.Data[j] ? a.Data[j] : b.Data[j]; \
+            ASSERT_EQ(memcmp(&selected.Data[j], &expected, sizeof(ELEMENT_TYPE)), 0) << "Select lane " << j; \
+        } \
+    } \
+}
+
+TEST_SIMD_COMPARE(int128_with_int8_t, SIMD::int_128<int8_t>, int8_t)
+TEST_SIMD_COMPARE(int128_with_uint8_t, SIMD::int_128<uint8_t>, uint8_t)
+TEST_SIMD_COMPARE(int128_with_uint16_t, SIMD::int_128<uint16_t>, uint16_t)
+TEST_SIMD_COMPARE(int128_with_int32_t, SIMD::int_128<int32_t>, int32_t)
+TEST_SIMD_COMPARE(int128_with_int64_t, SIMD::int_128<int64_t>, int64_t)
+TEST_SIMD_COMPARE(int128_with_uint64_t, SIMD::int_128<uint64_t>, uint64_t)
+TEST_SIMD_COMPARE(int256_with_uint8_t, SIMD::int_256<uint8_t>, uint8_t)
+TEST_SIMD_COMPARE(int256_with_int16_t, SIMD::int_256<int16_t>, int16_t)
+TEST_SIMD_COMPARE(int256_with_uint32_t, SIMD::int_256<uint32_t>, uint32_t)
+TEST_SIMD_COMPARE(int256_with_int64_t, SIMD::int_256<int64_t>, int64_t)
+TEST_SIMD_COMPARE(int256_with_uint64_t, SIMD::int_256<uint64_t>, uint64_t)
+TEST_SIMD_COMPARE(float256, SIMD::float_256, float)
+TEST_SIMD_COMPARE(double256, SIMD::double_256, double)
+#if defined(AVX512BW_AVAILABLE)
+TEST_SIMD_COMPARE(int512_with_int8_t, SIMD::int_512<int8_t>, int8_t)
+TEST_SIMD_COMPARE(int512_with_uint16_t, SIMD::int_512<uint16_t>, uint16_t)
+TEST_SIMD_COMPARE(int512_with_int32_t, SIMD::int_512<int32_t>, int32_t)
+TEST_SIMD_COMPARE(int512_with_uint64_t, SIMD::int_512<uint64_t>, uint64_t)
+TEST_SIMD_COMPARE(float512, SIMD::float_512, float)
+TEST_SIMD_COMPARE(double512, SIMD::double_512, double)
+#endif
+
+TEST(SIMDCompareTest, Array_Clamp_and_Threshold) {
+    SIMD::Array<SIMD::float_256, 257> x, low, high, clamped;
+    for (int i = 0; i < 257; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            x[i][j] = static_cast<float>((i * 8 + j) % 200) - 100.0f;
+            low[i][j] = -50.0f;
+            high[i][j] = 50.0f;
+        }
+    }
+    clamped = SIMD::Select(SIMD::CompareGt(x, high), high, SIMD::Select(SIMD::CompareLt(x, low), low, x));
+    size_t above = 0;
+    for (int i = 0; i < 257; i++) {
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+            ASSERT_EQ(clamped[i][j], std::min(50.0f, std::max(-50.0f, x[i][j])));
+            above += x[i][j] > 50.0f;
+        }
+    }
+    EXPECT_EQ(SIMD::CountTrue(SIMD::CompareGt(x, high)), above);
+    EXPECT_TRUE(SIMD::Any(SIMD::CompareLt(x, low)));
+    EXPECT_FALSE(SIMD::All(SIMD::CompareLt(x, low)));
+    EXPECT_TRUE(SIMD::All(SIMD::CompareLe(clamped, high)));
+    EXPECT_FALSE(SIMD::Any(SIMD::CompareNe(clamped, clamped)));
+}
+
+// Clamp benchmarks, the plain loop branches per element on unpredictable data while Select blends whole registers
+#define BENCHMARK_CLAMP_SETUP(ARRAY_SIZE) \
+    SIMD::Array<SIMD::float_256, ARRAY_SIZE> x, low, high, clamped; \
+    std::mt19937 rng(42); \
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD::float_256::ElementCount; j++) { \
+            x[i][j] = dist(rng); low[i][j] = -50.0f; high[i][j] = 50.0f; \
+        } \
+    }
+
+static void BM_SIMD_float256_Clamp_1000000(benchmark::State& state) {
+    BENCHMARK_CLAMP_SETUP(1000000)
+    for (auto _ : state) {
+        clamped = SIMD::Select(SIMD::CompareGt(x, high), high, SIMD::Select(SIMD::CompareLt(x, low), low, x));
+        benchmark::DoNotOptimize(clamped);
+    }
+}
+BENCHMARK(BM_SIMD_float256_Clamp_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_float256_Clamp_1000000(benchmark::State& state) {
+    BENCHMARK_CLAMP_SETUP(1000000)
+    for (auto _ : state) {
+        for (int i = 0; i < 1000000; i++) {
+            for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+                const float v = x[i][j];
+                if (v > 50.0f) {
+                    clamped[i][j] = 50.0f;
+                } else if (v < -50.0f) {
+                    clamped[i][j] = -50.0f;
+                } else {
+                    clamped[i][j] = v;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(clamped);
+    }
+}
+BENCHMARK(BM_Plain_float256_Clamp_1000000)->Unit(benchmark::kMillisecond);
+
+// Distance in units in the last place, NaNs are equal to each other and infinities are one step past the largest finite value
+template<typename T>
+static int64_t UlpDistance(T a, T b) {
+    typedef typename std::conditional<sizeof(T) == 4, int32_t, int64_t>::type Bits;
+    if (std::isnan(a) || std::isnan(b)) {
+        return (std::isnan(a) && std::isnan(b)) ? 0 : std::numeric_limits<int64_t>::max();
+    }
+    Bits x, y;
+    memcpy(&x, &a, sizeof(T));
+    memcpy(&y, &b, sizeof(T));
+    const int64_t ordered_x = x < 0 ? static_cast<int64_t>(std::numeric_limits<Bits>::min()) - x : x;
+    const int64_t ordered_y = y < 0 ? static_cast<int64_t>(std::numeric_limits<Bits>::min()) - y : y;
+    return ordered_x > ordered_y ? ordered_x - ordered_y : ordered_y - ordered_x;
+}
+
+// Elementary functions against the long double C library over random arguments, logarithmically spread
+// ranges are given as powers of two
+#define TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, NAME, REFERENCE, LOW, HIGH, LOGARITHMIC, MAX_ULP) \
+    { \
+        std::uniform_real_distribution<double> dist(LOW, HIGH); \
+        int64_t worst = 0; \
+        for (int n = 0; n < 20000; n++) { \
+            SIMD_TYPE a; \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                const double u = dist(rng); \
+                a.Data[j] = static_cast<ELEMENT_TYPE>(LOGARITHMIC ? std::exp2(u) : u); \
+            } \
+            const SIMD_TYPE result = SIMD_TYPE::NAME(a); \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                const ELEMENT_TYPE expected = static_cast<ELEMENT_TYPE>(REFERENCE(static_cast<long double>(a.Data[j]))); \
+                const int64_t ulp = UlpDistance(result.Data[j], expected); \
+                ASSERT_LE(ulp, MAX_ULP) << #NAME << "(" << a.Data[j] << ") = " << result.Data[j] << ", expected " << expected; \
+                worst = std::max(worst, ulp); \
+            } \
+        } \
+        RecordProperty(#NAME "_max_ulp", static_cast<int>(worst)); \
+    }
+
+#define TEST_SIMD_MATH(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE) \
+TEST(SIMDMathTest, TYPE_NAME##_Elementary_Functions) \
+{ \
+    typedef std::numeric_limits<ELEMENT_TYPE> Limits; \
+    const bool single = sizeof(ELEMENT_TYPE) == 4; \
+    const double exp_limit = single ? 88.0 : 709.0; \
+    const double trig_limit = single ? 8192.0 : 1048576.0; \
+    const double max_exponent = Limits::max_exponent - 1; \
+    std::mt19937_64 rng(42); \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Exp, std::exp, -exp_limit, exp_limit, false, 1) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Exp, std::exp, -8.0, 3.0, true, 1) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Log, std::log, 0.0, 2.0, false, 1) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Log, std::log, Limits::min_exponent - Limits::digits, max_exponent, true, 1) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Sin, std::sin, -trig_limit, trig_limit, false, 2) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Sin, std::sin, -20.0, 4.0, true, 2) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Cos, std::cos, -trig_limit, trig_limit, false, 2) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Cos, std::cos, -20.0, 4.0, true, 2) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Sin, std::sin, trig_limit, 1e7, false, 1) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Tanh, std::tanh, -20.0, 20.0, false, single ? 2 : 3) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Tanh, std::tanh, -20.0, 3.0, true, single ? 2 : 3) \
+    /* Sqrt is correctly rounded, a long double reference would round twice */ \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, Sqrt, [](long double v) { return std::sqrt(static_cast<ELEMENT_TYPE>(v)); }, 0.0, 1e6, false, 0) \
+    TEST_SIMD_MATH_ULP(SIMD_TYPE, ELEMENT_TYPE, RSqrt, 1 / std::sqrt, Limits::min_exponent, max_exponent, true, single ? 5 : 1) \
+    { \
+        std::uniform_real_distribution<double> base(-20.0, 20.0), exponent(-40.0, 40.0); \
+        for (int n = 0; n < 20000; n++) { \
+            SIMD_TYPE x, y; \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                x.Data[j] = static_cast<ELEMENT_TYPE>(std::exp2(base(rng))); \
+                y.Data[j] = static_cast<ELEMENT_TYPE>(exponent(rng)); \
+                if (j % 4 == 0) { x.Data[j] = -x.Data[j]; y.Data[j] = std::round(y.Data[j]); } \
+            } \
+            const SIMD_TYPE result = SIMD_TYPE::Pow(x, y); \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                const ELEMENT_TYPE expected = static_cast<ELEMENT_TYPE>(std::pow(static_cast<long double>(x.Data[j]), static_cast<long double>(y.Data[j]))); \
+                ASSERT_LE(UlpDistance(result.Data[j], expected), 1) << "Pow(" << x.Data[j] << ", " << y.Data[j] << ") = " << result.Data[j] << ", expected " << expected; \
+            } \
+        } \
+    } \
+    /* Special values follow C99 Annex F */ \
+    const ELEMENT_TYPE inf = Limits::infinity(), nan = Limits::quiet_NaN(); \
+    const ELEMENT_TYPE specials[] = { 0, -0.0f, inf, -inf, nan, 1, -1, 0.5f, -2, 3, Limits::denorm_min(), Limits::max(), Limits::lowest() }; \
+    const int count = sizeof(specials) / sizeof(specials[0]); \
+    for (int p = 0; p < count; p++) { \
+        SIMD_TYPE a = SIMD_TYPE::Broadcast(specials[p]); \
+        EXPECT_LE(UlpDistance(SIMD_TYPE::Exp(a).Data[0], std::exp(specials[p])), 1) << "Exp(" << specials[p] << ")"; \
+        EXPECT_LE(UlpDistance(SIMD_TYPE::Log(a).Data[0], std::log(specials[p])), 1) << "Log(" << specials[p] << ")"; \
+        EXPECT_LE(UlpDistance(SIMD_TYPE::Sin(a).Data[0], std::sin(specials[p])), 1) << "Sin(" << specials[p] << ")"; \
+        EXPECT_LE(UlpDistance(SIMD_TYPE::Cos(a).Data[0], std::cos(specials[p])), 1) << "Cos(" << specials[p] << ")"; \
+        EXPECT_LE(UlpDistance(SIMD_TYPE::Tanh(a).Data[0], std::tanh(specials[p])), 1) << "Tanh(" << specials[p] << ")"; \
+        EXPECT_EQ(UlpDistance(SIMD_TYPE::Sqrt(a).Data[0], std::sqrt(specials[p])), 0) << "Sqrt(" << specials[p] << ")"; \
+        for (int q = 0; q < count; q++) { \
+            const ELEMENT_TYPE expected = std::pow(specials[p], specials[q]); \
+            EXPECT_LE(UlpDistance(SIMD_TYPE::Pow(a, SIMD_TYPE::Broadcast(specials[q])).Data[0], expected), 1) << "Pow(" << specials[p] << ", " << specials[q] << ")"; \
+        } \
+    } \
+}
+
+TEST_SIMD_MATH(float256, SIMD::float_256, float)
+TEST_SIMD_MATH(double256, SIMD::double_256, double)
+#if defined(AVX512F_AVAILABLE)
+TEST_SIMD_MATH(float512, SIMD::float_512, float)
+TEST_SIMD_MATH(double512, SIMD::double_512, double)
+#endif
+
+TEST(SIMDMathTest, Array_Expressions) {
+    SIMD::Array<SIMD::double_256, 100> x, y, z;
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::double_256::ElementCount; j++) {
+            x[i][j] = 0.01 * (i * 4 + j) + 0.001;
+            y[i][j] = 0.5 + 0.01 * j;
+        }
+    }
+    z = SIMD::Log(SIMD::Exp(x * y)) + SIMD::Pow(x, y) * SIMD::Sin(x) - SIMD::Cos(x) / SIMD::Sqrt(x) + SIMD::Tanh(SIMD::RSqrt(y));
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < SIMD::double_256::ElementCount; j++) {
+            const double a = x[i][j], b = y[i][j];
+            const double expected = std::log(std::exp(a * b)) + std::pow(a, b) * std::sin(a) - std::cos(a) / std::sqrt(a) + std::tanh(1 / std::sqrt(b));
+            ASSERT_NEAR(z[i][j], expected, 1e-14 * (1 + std::fabs(expected)));
+        }
+    }
+}
+
+// Elementary function benchmarks over an Array, elements per cycle are reported from the time stamp counter
+#define BENCHMARK_MATH_SETUP(SIMD_TYPE, ELEMENT_TYPE, ARRAY_SIZE, LOW, HIGH) \
+    SIMD::Array<SIMD_TYPE, ARRAY_SIZE> x, y, result; \
+    std::mt19937 rng(42); \
+    std::uniform_real_distribution<ELEMENT_TYPE> dist(LOW, HIGH); \
+    for (int i = 0; i < ARRAY_SIZE; i++) { \
+        for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+            x[i][j] = dist(rng); y[i][j] = dist(rng); \
+        } \
+    }
+
+#define BENCHMARK_MATH_COUNTERS(SIMD_TYPE, ARRAY_SIZE, START) \
+    state.SetItemsProcessed(state.iterations() * ARRAY_SIZE * SIMD_TYPE::ElementCount); \
+    state.counters["elements_per_cycle"] = static_cast<double>(state.iterations()) * ARRAY_SIZE * SIMD_TYPE::ElementCount / static_cast<double>(__rdtsc() - START);
+
+#define BENCHMARK_MATH(TYPE_NAME, SIMD_TYPE, ELEMENT_TYPE, NAME, EXPRESSION, REFERENCE, LOW, HIGH, ARRAY_SIZE) \
+static void BM_SIMD_##TYPE_NAME##_##NAME##_##ARRAY_SIZE(benchmark::State& state) { \
+    BENCHMARK_MATH_SETUP(SIMD_TYPE, ELEMENT_TYPE, ARRAY_SIZE, LOW, HIGH) \
+    const uint64_t start = __rdtsc(); \
+    for (auto _ : state) { \
+        result = EXPRESSION; \
+        benchmark::DoNotOptimize(result); \
+    } \
+    BENCHMARK_MATH_COUNTERS(SIMD_TYPE, ARRAY_SIZE, start) \
+} \
+BENCHMARK(BM_SIMD_##TYPE_NAME##_##NAME##_##ARRAY_SIZE)->Unit(benchmark::kMillisecond); \
+static void BM_Plain_##TYPE_NAME##_##NAME##_##ARRAY_SIZE(benchmark::State& state) { \
+    BENCHMARK_MATH_SETUP(SIMD_TYPE, ELEMENT_TYPE, ARRAY_SIZE, LOW, HIGH) \
+    const uint64_t start = __rdtsc(); \
+    for (auto _ : state) { \
+        for (int i = 0; i < ARRAY_SIZE; i++) { \
+            for (int j = 0; j < SIMD_TYPE::ElementCount; j++) { \
+                result[i][j] = REFERENCE; \
+            } \
+        } \
+        benchmark::DoNotOptimize(result); \
+    } \
+    BENCHMARK_MATH_COUNTERS(SIMD_TYPE, ARRAY_SIZE, start) \
+} \
+BENCHMARK(BM_Plain_##TYPE_NAME##_##NAME##_##ARRAY_SIZE)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MATH(float256, SIMD::float_256, float, Exp, SIMD::Exp(x), std::exp(x[i][j]), -80.0f, 80.0f, 100000)
+BENCHMARK_MATH(float256, SIMD::float_256, float, Log, SIMD::Log(x), std::log(x[i][j]), 0.0f, 1000.0f, 100000)
+BENCHMARK_MATH(float256, SIMD::float_256, float, Sin, SIMD::Sin(x), std::sin(x[i][j]), -100.0f, 100.0f, 100000)
+BENCHMARK_MATH(float256, SIMD::float_256, float, Tanh, SIMD::Tanh(x), std::tanh(x[i][j]), -10.0f, 10.0f, 100000)
+BENCHMARK_MATH(float256, SIMD::float_256, float, Pow, SIMD::Pow(x, y), std::pow(x[i][j], y[i][j]), 0.0f, 10.0f, 100000)
+BENCHMARK_MATH(double256, SIMD::double_256, double, Exp, SIMD::Exp(x), std::exp(x[i][j]), -700.0, 700.0, 100000)
+BENCHMARK_MATH(double256, SIMD::double_256, double, Log, SIMD::Log(x), std::log(x[i][j]), 0.0, 1000.0, 100000)
+BENCHMARK_MATH(double256, SIMD::double_256, double, Sin, SIMD::Sin(x), std::sin(x[i][j]), -100.0, 100.0, 100000)
+BENCHMARK_MATH(double256, SIMD::double_256, double, Pow, SIMD::Pow(x, y), std::pow(x[i][j], y[i][j]), 0.0, 10.0, 100000)
+#if defined(AVX512F_AVAILABLE)
+BENCHMARK_MATH(float512, SIMD::float_512, float, Exp, SIMD::Exp(x), std::exp(x[i][j]), -80.0f, 80.0f, 100000)
+BENCHMARK_MATH(double512, SIMD::double_512, double, Exp, SIMD::Exp(x), std::exp(x[i][j]), -700.0, 700.0, 100000)
+#endif
+
+TEST(SIMDTest, SIMD_int256_with_int32_t_Operators_and_Import) {
+    SIMD::int_256<int32_t> a(1,2,3,4,5,6,7,8);
+    SIMD::int_256<int32_t> b(-1, -1, -1, -1, -1, -1, -1, -1);
+
+    SIMD::int_256<int32_t> c = a + b;
+    for (int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
+        EXPECT_EQ(c[i], i);
+    }
+
+    SIMD::int_256<int32_t> d = a - b;
+    for(int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
+        EXPECT_EQ(d[i], i + 2);
+    }
+
+    SIMD::int_256<int32_t> e = a * b;
+    for(int i = 0; i < SIMD::int_256<int32_t>::ElementCount; i++) {
+        EXPECT_EQ(e[i], -i - 1);
+    }
+
+    alignas(SIMD::int_256<int32_t>::Alignment) int32_t data[SIMD::int_256<int32_t>::ElementCount] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    SIMD::int_256<int32_t> f = SIMD::int_256<int32_t>::Import(data);
+    EXPECT_TRUE(f == a);
+
+    a += b;
+    EXPECT_TRUE(a == c);
+}
+
+TEST(SIMDTest, SIMD_float256_Operators_and_Import) {
+    SIMD::float_256 a(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+    SIMD::float_256 b(5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f, 5.0f);
+
+    SIMD::float_256 c = a + b;
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(c[i], i + 6.0f);
+    }
+
+    SIMD::float_256 d = a - b;
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(d[i], i - 4.0f);
+    }
+
+    SIMD::float_256 e = a * b;
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(e[i], (i + 1.0f) * 5.0f);
+    }
+
+    SIMD::float_256 f = a / b;
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(f[i], (i + 1.0f) / 5.0f);
+    }
+
+    alignas(SIMD::float_256::Alignment) float data[SIMD::float_256::ElementCount] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+    SIMD::float_256 g = SIMD::float_256::Import(data);
+    for(int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(g[i], a[i]);
+    }
+}
+
+TEST(SIMDTest, SIMD_ValueTypes_Are_Register_Resident) {
+    EXPECT_EQ(sizeof(SIMD::int_128<int8_t>), SIMD::int_128<int8_t>::SizeBytes);
+    EXPECT_EQ(sizeof(SIMD::int_256<int32_t>), SIMD::int_256<int32_t>::SizeBytes);
+    EXPECT_EQ(sizeof(SIMD::float_256), SIMD::float_256::SizeBytes);
+    EXPECT_EQ(sizeof(SIMD::double_256), SIMD::double_256::SizeBytes);
+    EXPECT_TRUE(std::is_trivially_copyable<SIMD::int_256<int32_t>>::value);
+    EXPECT_TRUE(std::is_trivially_copyable<SIMD::float_256>::value);
+
+    SIMD::float_256 a(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+    SIMD::float_256 b = a;
+    b += a;
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(a[i], i + 1.0f);
+        EXPECT_FLOAT_EQ(b[i], 2.0f * (i + 1.0f));
+    }
+
+    alignas(SIMD::float_256::Alignment) float exported[SIMD::float_256::ElementCount];
+    b.Export(exported);
+    for (int i = 0; i < SIMD::float_256::ElementCount; i++) {
+        EXPECT_FLOAT_EQ(exported[i], b[i]);
+    }
+    // Import copies, the memory only changes through Export
+    SIMD::float_256 imported = SIMD::float_256::Import(exported);
+    imported += imported;
+    EXPECT_FLOAT_EQ(exported[0], b[0]);
+    EXPECT_TRUE(static_cast<bool>(imported));
+}
+
+// Value type benchmarks, every operator returns a new value so any per value allocation shows up here
+static void BM_SIMD_float256_ValueChain_1000000(benchmark::State& state) {
+    SIMD::float_256 a(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+    SIMD::float_256 b(0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f);
+    for (auto _ : state) {
+        SIMD::float_256 c = a;
+        for (int i = 0; i < 1000000; i++) {
+            c = (c + a) * b;
+        }
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_SIMD_float256_ValueChain_1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_Plain_float256_ValueChain_1000000(benchmark::State& state) {
+    float a[SIMD::float_256::ElementCount] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+    for (auto _ : state) {
+        float c[SIMD::float_256::ElementCount];
+        std::copy(a, a + SIMD::float_256::ElementCount, c);
+        for (int i = 0; i < 1000000; i++) {
+            for (int j = 0; j < SIMD::float_256::ElementCount; j++) {
+                c[j] = (c[j] + a[j]) * 0.5f;
+            }
+        }
+        benchmark::DoNotOptimize(c);
     }
 }
+BENCHMARK(BM_Plain_float256_ValueChain_1000000)->Unit(benchmark::kMillisecond);
 
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);